@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""This script compares surface velocities computed using the DIVA stress balance to the
+ones computed using the Blatter-Pattyn solver in ISMIP-HOM experiments A-D.
+
+It reports relative differences in the surface speed and the time spent by each solver.
+
+Example:
+
+mpiexec -n 2 python3 compare-diva.py -Mx 51 -My 51
+
+Options controlling the Blatter solver (see run-ismiphom.py) can be used here as well.
+"""
+
+import importlib.util
+import os
+import time
+
+import PISM
+
+# re-use the setup from run-ismiphom.py
+spec = importlib.util.spec_from_file_location("run_ismiphom",
+                                              os.path.join(os.path.dirname(__file__),
+                                                           "run-ismiphom.py"))
+hom = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(hom)
+
+config = hom.config
+
+def surface_speed(grid, model, test_name, L):
+    "Compute surface speed using a stress balance model, returning the speed and the wall time."
+    _, geometry, enthalpy, yield_stress = hom.init(test_name, L)
+
+    stress_balance = model(grid)
+
+    stress_balance.init()
+
+    inputs = PISM.StressBalanceInputs()
+
+    inputs.geometry = geometry
+    inputs.basal_yield_stress = yield_stress
+    inputs.enthalpy = enthalpy
+
+    start = time.time()
+    stress_balance.update(inputs, True)
+    wall_time = PISM.GlobalMax(grid.com, time.time() - start)
+
+    return stress_balance.diagnostics()["velsurf_mag"].compute(), wall_time
+
+def blatter(test_name):
+    def f(grid):
+        Mz = int(config.get_number("stress_balance.blatter.Mz"))
+        coarsening_factor = int(config.get_number("stress_balance.blatter.coarsening_factor"))
+
+        model = PISM.BlatterISMIPHOM(grid, Mz, coarsening_factor, hom.tests[test_name])
+
+        return PISM.StressBalance(grid, model, PISM.BlatterMod(model))
+    return f
+
+def diva(test_name):
+    def f(grid):
+        model = PISM.DIVAISMIPHOM(grid, hom.tests[test_name])
+
+        return PISM.StressBalance(grid, model, PISM.DIVAMod(model))
+    return f
+
+def compare(test_name, L):
+    grid, _, _, _ = hom.init(test_name, L)
+
+    speed_bp, time_bp = surface_speed(grid, blatter(test_name), test_name, L)
+    speed_diva, time_diva = surface_speed(grid, diva(test_name), test_name, L)
+
+    max_diff = 0.0
+    max_speed = 0.0
+    with PISM.vec.Access([speed_bp, speed_diva]):
+        for (i, j) in grid.points():
+            max_diff = max(max_diff, abs(speed_diva[i, j] - speed_bp[i, j]))
+            max_speed = max(max_speed, abs(speed_bp[i, j]))
+
+    max_diff = PISM.GlobalMax(grid.com, max_diff)
+    max_speed = PISM.GlobalMax(grid.com, max_speed)
+
+    PISM.verbPrintf(1, grid.com,
+                    "{} {:4d} km: max. relative difference {:8.4f}, time (s): Blatter {:8.3f}, DIVA {:8.3f}\n".format(
+                        test_name, int(L / 1e3), max_diff / max_speed, time_bp, time_diva))
+
+if __name__ == "__main__":
+    hom.set_constants(config)
+
+    # use the same flow law in DIVA
+    config.set_string("stress_balance.ssa.flow_law", "isothermal_glen")
+    config.set_number("stress_balance.ssa.Glen_exponent",
+                      config.get_number("stress_balance.blatter.Glen_exponent"))
+
+    for test in ["A", "B", "C", "D"]:
+        for L in [5, 10, 20, 40, 80, 160]:
+            compare(test, 1e3 * L)
@@ -120,6 +120,34 @@ class PythonOceanModel(PISM.PyOceanModel):
             traceback.print_exc()
             raise
 
+class GroundedAreaAnalysis(PISM.Analysis):
+    """In-situ analysis computing the area of grounded ice. Set `-analysis_file` and
+    `-analysis_times` to save results."""
+    def __init__(self, grid):
+        super().__init__()
+        self.cell_area = grid.cell_area()
+
+    def inputs(self):
+        "Names of model fields used by this analysis"
+        return ["mask"]
+
+    def outputs(self):
+        "Names of computed quantities"
+        return ["grounded_area"]
+
+    def units(self, name):
+        return "m2"
+
+    def compute(self, inputs):
+        "Compute the grounded area using a read-only NumPy view of the cell type mask."
+        try:
+            mask = inputs.get("mask").local_view()
+            local_area = (mask == PISM.MASK_GROUNDED).sum() * self.cell_area
+            return [PISM.GlobalSum(inputs.com(), float(local_area))]
+        except Exception:
+            traceback.print_exc()
+            raise
+
 def main():
     PISM.set_abort_on_sigint(True)
     context = PISM.Context().ctx
@@ -156,6 +184,10 @@ def main():
     # line option `-ocean` (if present).
     model.set_python_ocean_model(ocean)
 
+    # Register an in-situ analysis. As above, `analysis` has to outlive `model`.
+    analysis = GroundedAreaAnalysis(grid)
+    model.add_analysis(analysis)
+
     model.init()
 
     model.run()
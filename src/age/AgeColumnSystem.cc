@@ -45,13 +45,18 @@ AgeColumnSystem::AgeColumnSystem(const std::vector<double>& storage_grid,
 void AgeColumnSystem::init(int i, int j, double thickness) {
   init_column(i, j, thickness);
 
+  if (m_sigma) {
+    m_nu = m_dt / m_dz;
+  }
+
   if (m_ks == 0) {
     return;
   }
 
-  coarse_to_fine(m_u3, i, j, &m_u[0]);
-  coarse_to_fine(m_v3, i, j, &m_v[0]);
-  coarse_to_fine(m_w3, i, j, &m_w[0]);
+  input_to_fine(m_u3, i, j, &m_u[0]);
+  input_to_fine(m_v3, i, j, &m_v[0]);
+  input_to_fine(m_w3, i, j, &m_w[0]);
+  add_sigma_metric_terms();
 
   coarse_to_fine(m_age3, m_i, m_j,   &m_A[0]);
   coarse_to_fine(m_age3, m_i, m_j+1, &m_A_n[0]);
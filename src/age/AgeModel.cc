@@ -19,6 +19,8 @@
 
 #include "pism/age/AgeModel.hh"
 #include "pism/age/AgeColumnSystem.hh"
+#include "pism/util/SigmaCoordinate.hh"
+#include "pism/util/Vars.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
 #include <memory>
@@ -69,6 +71,55 @@ AgeModel::AgeModel(std::shared_ptr<const Grid> grid,
   m_ice_age.metadata()["valid_min"] = {0.0};
 
   m_work.metadata().units("s");
+
+  if (m_config->get_flag("grid.sigma.enabled")) {
+    m_ice_age_sigma = allocate_sigma_field(m_grid, "age_sigma", true);
+    m_ice_age_sigma->metadata(0)
+        .long_name("age of ice on sigma levels")
+        .units("s");
+
+    m_work_sigma = allocate_sigma_field(m_grid, "work_vector_sigma", false);
+    m_work_sigma->metadata(0).units("s");
+
+    m_sigma_ice_thickness = std::make_shared<array::Scalar>(m_grid, "age_sigma_thickness");
+    m_sigma_ice_thickness->metadata(0)
+        .long_name("ice thickness corresponding to age_sigma")
+        .units("m");
+
+    m_ice_thickness = std::make_shared<array::Scalar1>(m_grid, "thickness");
+    m_ice_thickness->metadata(0).units("m");
+  }
+}
+
+/*!
+ * Initialize age on sigma levels (if the sigma coordinate is used).
+ *
+ * Reads it from `input_file` (if not null and if it contains age on the same sigma
+ * levels). Otherwise interpolates `m_ice_age` to sigma levels.
+ */
+void AgeModel::init_sigma_state(const array::Scalar &ice_thickness,
+                                const File *input_file, unsigned int record) {
+  if (not m_ice_age_sigma) {
+    return;
+  }
+
+  bool done = false;
+  if (input_file != nullptr and
+      input_file->find_variable(m_sigma_ice_thickness->get_name())) {
+    done = read_sigma_field(*input_file, record, *m_ice_age_sigma);
+    if (done) {
+      m_sigma_ice_thickness->read(*input_file, record);
+    }
+  }
+
+  if (not done) {
+    z_to_sigma(m_ice_age, ice_thickness, *m_ice_age_sigma);
+    m_sigma_ice_thickness->copy_from(ice_thickness);
+  }
+
+  // make sure that these fields are included in copies of the model state
+  m_grid->add_state_field(*m_ice_age_sigma);
+  m_grid->add_state_field(*m_sigma_ice_thickness);
 }
 
 /*!
@@ -104,6 +155,8 @@ calculation.  Note that the columnSystemCtx methods coarse_to_fine() and
 fine_to_coarse() interpolate back and forth between this fine grid and
 the storage grid.  The storage grid may or may not be equally-spaced.  See
 AgeColumnSystem::solve() for the actual method.
+If `grid.sigma.enabled` is set the age is stored on sigma levels (see
+SigmaCoordinate.hh) and the age on the grid is computed by interpolation.
  */
 void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
 
@@ -119,16 +172,33 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
     &v3 = *inputs.v3,
     &w3 = *inputs.w3;
 
-  AgeColumnSystem system(m_grid->z(), "age",
+  const bool sigma = (m_ice_age_sigma != nullptr);
+
+  // the model state and the storage for the updated state
+  const array::Array3D &age = sigma ? *m_ice_age_sigma : m_ice_age;
+  array::Array3D &work = sigma ? *m_work_sigma : m_work;
+
+  AgeColumnSystem system(age.levels(), "age",
                          m_grid->dx(), m_grid->dy(), dt,
-                         m_ice_age, u3, v3, w3); // linear system to solve in each column
+                         age, u3, v3, w3); // linear system to solve in each column
 
   size_t Mz_fine = system.z().size();
   std::vector<double> x(Mz_fine);   // space for solution
 
-  array::AccessScope list{&ice_thickness, &u3, &v3, &w3, &m_ice_age, &m_work};
+  if (sigma) {
+    // the sigma coordinate transformation needs H with ghosts
+    m_ice_thickness->copy_from(ice_thickness);
 
-  unsigned int Mz = m_grid->Mz();
+    system.use_sigma_coordinate(m_grid->z(), *m_ice_thickness, *m_sigma_ice_thickness,
+                                m_config->get_number("geometry.ice_free_thickness_standard"));
+  }
+
+  array::AccessScope list{&ice_thickness, &u3, &v3, &w3, &age, &work};
+  if (sigma) {
+    list.add({m_ice_thickness.get(), m_sigma_ice_thickness.get()});
+  }
+
+  unsigned int Mz = age.levels().size();
 
   ParallelSection loop(m_grid->com);
   try {
@@ -139,7 +209,7 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
 
       if (system.ks() == 0) {
         // if no ice, set the entire column to zero age
-        m_work.set_column(i, j, 0.0);
+        work.set_column(i, j, 0.0);
       } else {
         // general case: solve advection PDE
 
@@ -147,13 +217,13 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
         system.solve(x);
 
         // put solution in array::Array3D
-        system.fine_to_coarse(x, i, j, m_work);
+        system.fine_to_coarse(x, i, j, work);
 
         // Ensure that the age of the ice is non-negative.
         //
         // FIXME: this is a kludge. We need to ensure that our numerical method has the maximum
         // principle instead. (We may still need this for correctness, though.)
-        double *column = m_work.get_column(i, j);
+        double *column = work.get_column(i, j);
         for (unsigned int k = 0; k < Mz; ++k) {
           if (column[k] < 0.0) {
             column[k] = 0.0;
@@ -166,6 +236,13 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
   }
   loop.check();
 
+  if (sigma) {
+    sigma_to_z(*m_work_sigma, ice_thickness, m_work);
+
+    m_ice_age_sigma->copy_from(*m_work_sigma);
+    m_sigma_ice_thickness->copy_from(ice_thickness);
+  }
+
   m_ice_age.copy_from(m_work);
 }
 
@@ -191,11 +268,13 @@ void AgeModel::init(const InputOptions &opts) {
 
   double initial_age_years = m_config->get_number("age.initial_value", "years");
 
+  std::unique_ptr<File> input_file;
+
   if (opts.type == INIT_RESTART) {
-    File input_file(m_grid->com, opts.filename, io::PISM_GUESS, io::PISM_READONLY);
+    input_file.reset(new File(m_grid->com, opts.filename, io::PISM_GUESS, io::PISM_READONLY));
 
-    if (input_file.find_variable("age")) {
-      m_ice_age.read(input_file, opts.record);
+    if (input_file->find_variable("age")) {
+      m_ice_age.read(*input_file, opts.record);
     } else {
       m_log->message(2,
                      "PISM WARNING: input file '%s' does not have the 'age' variable.\n"
@@ -208,15 +287,33 @@ void AgeModel::init(const InputOptions &opts) {
     m_ice_age.set(m_config->get_number("age.initial_value", "seconds"));
   }
 
+  const auto age_state = m_ice_age.state_counter();
+
   regrid("Age Model", m_ice_age, REGRID_WITHOUT_REGRID_VARS);
+
+  // Age on sigma levels in input_file is out of date if age was regridded.
+  const bool regridded = m_ice_age.state_counter() != age_state;
+
+  init_sigma_state(*m_grid->variables().get_2d_scalar("land_ice_thickness"),
+                   regridded ? nullptr : input_file.get(), opts.record);
 }
 
 void AgeModel::define_model_state_impl(const File &output) const {
   m_ice_age.define(output, io::PISM_DOUBLE);
+
+  if (m_ice_age_sigma) {
+    m_ice_age_sigma->define(output, io::PISM_DOUBLE);
+    m_sigma_ice_thickness->define(output, io::PISM_DOUBLE);
+  }
 }
 
 void AgeModel::write_model_state_impl(const File &output) const {
   m_ice_age.write(output);
+
+  if (m_ice_age_sigma) {
+    m_ice_age_sigma->write(output);
+    m_sigma_ice_thickness->write(output);
+  }
 }
 
 } // end of namespace pism
@@ -56,9 +56,21 @@ protected:
   void define_model_state_impl(const File &output) const;
   void write_model_state_impl(const File &output) const;
 
+  void init_sigma_state(const array::Scalar &ice_thickness,
+                        const File *input_file = nullptr, unsigned int record = 0);
+
   array::Array3D m_ice_age;
   array::Array3D m_work;
   std::shared_ptr<const stressbalance::StressBalance> m_stress_balance;
+
+  //! Ice age on sigma levels (allocated if `grid.sigma.enabled` is set).
+  std::shared_ptr<array::Array3D> m_ice_age_sigma;
+  //! Temporary storage for the updated age on sigma levels.
+  std::shared_ptr<array::Array3D> m_work_sigma;
+  //! Ice thickness corresponding to `m_ice_age_sigma`.
+  std::shared_ptr<array::Scalar> m_sigma_ice_thickness;
+  //! Copy of the current ice thickness (with ghosts).
+  std::shared_ptr<array::Scalar1> m_ice_thickness;
 };
 
 } // end of namespace pism
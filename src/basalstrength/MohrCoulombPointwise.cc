@@ -16,7 +16,7 @@
  * along with PISM; if not, write to the Free Software
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
-#include <cmath>                // pow, tan, atan
+#include <cmath>                // pow, exp, log, tan, atan
 
 #include "pism/basalstrength/MohrCoulombPointwise.hh"
 
@@ -28,6 +28,7 @@ MohrCoulombPointwise::MohrCoulombPointwise(Config::ConstPtr config) {
   m_reference_effective_pressure = config->get_number("basal_yield_stress.mohr_coulomb.till_reference_effective_pressure");
   m_reference_void_ratio         = config->get_number("basal_yield_stress.mohr_coulomb.till_reference_void_ratio");
   m_compressibility_coefficient  = config->get_number("basal_yield_stress.mohr_coulomb.till_compressibility_coefficient");
+  m_log_void_ratio_factor        = (m_reference_void_ratio / m_compressibility_coefficient) * log(10.0);
 }
 
 double MohrCoulombPointwise::effective_pressure(double delta,
@@ -35,10 +36,18 @@ double MohrCoulombPointwise::effective_pressure(double delta,
                                                 double water_thickness) const {
 
   double
-    s      = water_thickness / m_W_till_max,
-    N0     = m_reference_effective_pressure,
-    N_till = (N0 * pow(delta * P_overburden / N0, s) *
+    s = water_thickness / m_W_till_max,
+    N0 = m_reference_effective_pressure,
+    x = delta * P_overburden / N0,
+    N_till = 0.0;
+
+  if (x > 0.0) {
+    // N0 * x^s * 10^((e_0 / C_c) * (1 - s)), using one exp() instead of two calls of pow()
+    N_till = N0 * exp(s * log(x) + m_log_void_ratio_factor * (1.0 - s));
+  } else {
+    N_till = (N0 * pow(x, s) *
               pow(10.0, (m_reference_void_ratio / m_compressibility_coefficient) * (1.0 - s)));
+  }
 
   return std::min(P_overburden, N_till);
 }
@@ -53,6 +62,16 @@ double MohrCoulombPointwise::yield_stress(double delta,
   return m_till_cohesion + N_till * tan((M_PI / 180.0) * phi);
 }
 
+double MohrCoulombPointwise::yield_stress_tan_phi(double delta,
+                                                  double P_overburden,
+                                                  double water_thickness,
+                                                  double tan_phi) const {
+
+  double N_till = effective_pressure(delta, P_overburden, water_thickness);
+
+  return m_till_cohesion + N_till * tan_phi;
+}
+
 double MohrCoulombPointwise::till_friction_angle(double delta,
                                                  double P_overburden,
                                                  double water_thickness,
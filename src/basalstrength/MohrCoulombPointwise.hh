@@ -45,6 +45,23 @@ public:
                       double water_thickness,
                       double phi) const;
 
+  /*!
+   * Compute basal yield stress using the tangent of the till friction angle.
+   *
+   * Same as `yield_stress()`, but avoids computing `tan(phi)` at every call.
+   *
+   * @param[in] delta fraction of overburden pressure
+   * @param[in] P_overburden overburden pressure (Pa)
+   * @param[in] water_thickness till water thickness (m)
+   * @param[in] tan_phi tangent of the till friction angle
+   *
+   * returns basal yield stress in Pascal
+   */
+  double yield_stress_tan_phi(double delta,
+                              double P_overburden,
+                              double water_thickness,
+                              double tan_phi) const;
+
   /*!
    * Inverse of `yield_stress()`.
    *
@@ -83,6 +100,8 @@ private:
   double m_reference_void_ratio;
   //! Coefficient of compressibility of till
   double m_compressibility_coefficient;
+  //! Natural logarithm of 10^(e_0 / C_c), used by `effective_pressure()`
+  double m_log_void_ratio_factor;
 };
 
 } // end of namespace pism
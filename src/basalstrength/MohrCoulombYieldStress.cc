@@ -16,6 +16,9 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <cmath>                // tan
+#include <limits>
+
 #include "pism/basalstrength/MohrCoulombYieldStress.hh"
 #include "pism/basalstrength/MohrCoulombPointwise.hh"
 
@@ -89,7 +92,9 @@ read-in-from-file state or with a default constant value from the config file.
 */
 MohrCoulombYieldStress::MohrCoulombYieldStress(std::shared_ptr<const Grid> grid)
   : YieldStress(grid),
-  m_till_phi(m_grid, "tillphi") {
+  m_till_phi(m_grid, "tillphi"),
+  m_tan_till_phi(m_grid, "tan_tillphi"),
+  m_tan_till_phi_state(std::numeric_limits<uint64_t>::max()) {
 
   m_name = "Mohr-Coulomb yield stress model";
 
@@ -291,7 +296,9 @@ void MohrCoulombYieldStress::update_impl(const YieldStressInputs &inputs,
   const auto &bed_topography = inputs.geometry->bed_elevation;
   const auto &sea_level      = inputs.geometry->sea_level_elevation;
 
-  array::AccessScope list{&W_till, &m_till_phi, &m_basal_yield_stress, &cell_type,
+  update_tan_till_phi();
+
+  array::AccessScope list{&W_till, &m_tan_till_phi, &m_basal_yield_stress, &cell_type,
                                &bed_topography, &sea_level, &ice_thickness};
 
   if (add_transportable_water) {
@@ -324,14 +331,37 @@ void MohrCoulombYieldStress::update_impl(const YieldStressInputs &inputs,
 
       double P_overburden = ice_density * standard_gravity * ice_thickness(i, j);
 
-      m_basal_yield_stress(i, j) = mc.yield_stress(m_delta ? (*m_delta)(i, j) : delta,
-                                                   P_overburden, water, m_till_phi(i, j));
+      m_basal_yield_stress(i, j) = mc.yield_stress_tan_phi(m_delta ? (*m_delta)(i, j) : delta,
+                                                           P_overburden, water,
+                                                           m_tan_till_phi(i, j));
     }
   }
 
   m_basal_yield_stress.update_ghosts();
 }
 
+/*!
+ * Re-compute the tangent of the till friction angle if `m_till_phi` changed since the last
+ * call.
+ *
+ * Code modifying `m_till_phi` point-by-point has to call `m_till_phi.inc_state_counter()`.
+ */
+void MohrCoulombYieldStress::update_tan_till_phi() {
+  if (m_till_phi.state_counter() == m_tan_till_phi_state) {
+    return;
+  }
+
+  array::AccessScope list{&m_till_phi, &m_tan_till_phi};
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    m_tan_till_phi(i, j) = tan((M_PI / 180.0) * m_till_phi(i, j));
+  }
+
+  m_tan_till_phi_state = m_till_phi.state_counter();
+}
+
 //! Computes the till friction angle phi as a piecewise linear function of bed elevation, according to user options.
 /*!
 Computes the till friction angle \f$\phi(x,y)\f$ at a location as the following
@@ -396,6 +426,7 @@ void MohrCoulombYieldStress::till_friction_angle(const array::Scalar &bed_topogr
   // communicate ghosts so that the tauc computation can be performed locally
   // (including ghosts of tauc, that is)
   result.update_ghosts();
+  result.inc_state_counter();
 }
 
 /*!
@@ -439,6 +470,7 @@ void MohrCoulombYieldStress::till_friction_angle(const array::Scalar &basal_yiel
   }
 
   result.update_ghosts();
+  result.inc_state_counter();
 }
 
 DiagnosticList MohrCoulombYieldStress::diagnostics_impl() const {
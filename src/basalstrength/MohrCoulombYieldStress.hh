@@ -50,6 +50,13 @@ protected:
 
   std::shared_ptr<array::Forcing> m_delta;
 private:
+  void update_tan_till_phi();
+
+  //! Tangent of the till friction angle (re-computed when `m_till_phi` changes)
+  array::Scalar m_tan_till_phi;
+  //! State counter of `m_till_phi` corresponding to `m_tan_till_phi`
+  uint64_t m_tan_till_phi_state;
+
   void till_friction_angle(const array::Scalar &bed_topography,
                            array::Scalar &result);
 
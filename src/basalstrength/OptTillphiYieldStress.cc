@@ -18,6 +18,9 @@
 
 #include "pism/basalstrength/OptTillphiYieldStress.hh"
 
+#include <cmath>
+#include <vector>
+
 #include "pism/geometry/Geometry.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/Grid.hh"
@@ -27,9 +30,63 @@
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/Units.hh"
 
 namespace pism {
 
+namespace {
+
+/*!
+ * Solve a small dense linear system `A x = b` using Gaussian elimination with partial
+ * pivoting.
+ *
+ * Returns false if `A` is (numerically) singular.
+ */
+bool solve_dense(std::vector<double> A, std::vector<double> b, std::vector<double> &x) {
+  const int n = b.size();
+
+  for (int k = 0; k < n; ++k) {
+    int pivot = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (std::abs(A[i * n + k]) > std::abs(A[pivot * n + k])) {
+        pivot = i;
+      }
+    }
+
+    if (std::abs(A[pivot * n + k]) < 1e-300) {
+      return false;
+    }
+
+    if (pivot != k) {
+      for (int j = 0; j < n; ++j) {
+        std::swap(A[k * n + j], A[pivot * n + j]);
+      }
+      std::swap(b[k], b[pivot]);
+    }
+
+    for (int i = k + 1; i < n; ++i) {
+      double c = A[i * n + k] / A[k * n + k];
+      for (int j = k; j < n; ++j) {
+        A[i * n + j] -= c * A[k * n + j];
+      }
+      b[i] -= c * b[k];
+    }
+  }
+
+  x.resize(n);
+  for (int i = n - 1; i >= 0; --i) {
+    double sum = b[i];
+    for (int j = i + 1; j < n; ++j) {
+      sum -= A[i * n + j] * x[j];
+    }
+    x[i] = sum / A[i * n + i];
+  }
+
+  return true;
+}
+
+} // end of anonymous namespace
+
 /*! Optimization of till friction angle for given target surface elevation, analogous to
   Pollard et al. (2012), TC 6(5), "A simple inverse method for the distribution of basal
   sliding coefficients under ice sheets, applied to Antarctica"
@@ -38,7 +95,13 @@ OptTillphiYieldStress::OptTillphiYieldStress(std::shared_ptr<const Grid> grid)
   : MohrCoulombYieldStress(grid),
     m_mask(m_grid, "diff_mask"),
     m_usurf_difference(m_grid, "usurf_difference"),
-    m_usurf_target(m_grid, "usurf")
+    m_usurf_target(m_grid, "usurf"),
+    m_tillphi_previous(m_grid, "tillphi_previous"),
+    m_dphi(m_grid, "tillphi_adjustment"),
+    m_anderson_x(m_grid, "anderson_x"),
+    m_anderson_f(m_grid, "anderson_f"),
+    m_history_available(false),
+    m_residual(0.0)
 {
   // In this model tillphi is NOT time-independent.
   m_till_phi.metadata().set_time_independent(false);
@@ -91,11 +154,48 @@ OptTillphiYieldStress::OptTillphiYieldStress(std::shared_ptr<const Grid> grid)
     }
   }
 
+  {
+    auto method = m_config->get_string("basal_yield_stress.mohr_coulomb.tillphi_opt.method");
+    if (method == "proportional") {
+      m_method = PROPORTIONAL;
+    } else if (method == "secant") {
+      m_method = SECANT;
+    } else if (method == "anderson") {
+      m_method = ANDERSON;
+    } else {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "invalid basal_yield_stress.mohr_coulomb.tillphi_opt.method: '%s'",
+                                    method.c_str());
+    }
+
+    int depth = m_config->get_number("basal_yield_stress.mohr_coulomb.tillphi_opt.anderson_depth");
+    if (depth < 1) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "basal_yield_stress.mohr_coulomb.tillphi_opt.anderson_depth"
+                                    " has to be positive (got %d)", depth);
+    }
+    m_anderson_depth = depth;
+  }
+
   {
     m_time_name = m_config->get_string("time.dimension_name") + "_tillphi_opt";
     m_t_last = time().current();
-    m_update_interval = m_config->get_number("basal_yield_stress.mohr_coulomb.tillphi_opt.dt", "seconds");
+    m_update_interval_max = m_config->get_number("basal_yield_stress.mohr_coulomb.tillphi_opt.dt", "seconds");
+    m_update_interval_min = m_config->get_number("basal_yield_stress.mohr_coulomb.tillphi_opt.dt_min", "seconds");
+    m_adaptive_interval = m_config->get_flag("basal_yield_stress.mohr_coulomb.tillphi_opt.dt_adaptive");
     m_t_eps = m_config->get_number("time_stepping.resolution", "seconds");
+
+    if (m_adaptive_interval) {
+      if (m_update_interval_min <= 0.0 or m_update_interval_min > m_update_interval_max) {
+        throw RuntimeError(PISM_ERROR_LOCATION,
+                           "basal_yield_stress.mohr_coulomb.tillphi_opt: dt_min has to be positive"
+                           " and smaller than dt");
+      }
+      // start with frequent updates; the interval grows if iterations stop making progress
+      m_update_interval = m_update_interval_min;
+    } else {
+      m_update_interval = m_update_interval_max;
+    }
   }
 
   m_log->message(2,
@@ -107,6 +207,11 @@ OptTillphiYieldStress::OptTillphiYieldStress(std::shared_ptr<const Grid> grid)
                  m_phi0_min, m_topg_min,
                  m_phi0_min, m_topg_min, m_phi0_max - m_phi0_min, m_topg_max - m_topg_min, m_topg_min, m_topg_max,
                  m_phi0_max, m_topg_max);
+
+  if (m_method != PROPORTIONAL) {
+    m_log->message(2, "  Using the %s method to compute till friction angle adjustments.\n",
+                   m_method == SECANT ? "secant" : "Anderson mixing");
+  }
 }
 
 /*!
@@ -115,6 +220,13 @@ OptTillphiYieldStress::OptTillphiYieldStress(std::shared_ptr<const Grid> grid)
 void OptTillphiYieldStress::init_t_last(const File &input_file) {
   if (input_file.find_variable(m_time_name)) {
     input_file.read_variable(m_time_name, {0}, {1}, &m_t_last);
+
+    if (m_adaptive_interval) {
+      auto interval = input_file.read_double_attribute(m_time_name, "update_interval");
+      if (interval.size() == 1) {
+        m_update_interval = pism::clip(interval[0], m_update_interval_min, m_update_interval_max);
+      }
+    }
   } else {
     m_t_last = time().current();
   }
@@ -209,46 +321,227 @@ void OptTillphiYieldStress::update_impl(const YieldStressInputs &inputs,
   if (std::abs(t_next - t_final) < m_t_eps) { // reached the next update time
     update_tillphi(inputs.geometry->ice_surface_elevation,
                    inputs.geometry->bed_elevation,
-                   inputs.geometry->cell_type);
+                   inputs.geometry->cell_type,
+                   t_final - m_t_last);
     m_t_last = t_final;
   }
 
   MohrCoulombYieldStress::update_impl(inputs, t, dt);
 }
 
+//! Lower bound of the till friction angle as a function of bed elevation.
+double OptTillphiYieldStress::phi0(double bed_elevation) const {
+  // default value corresponds to "bed_elevation > topg_max":
+  double result = m_phi0_max;
+  if (bed_elevation <= m_topg_min) {
+    result = m_phi0_min;
+  } else if (bed_elevation <= m_topg_max) {
+    double slope = (m_phi0_max - m_phi0_min) / (m_topg_max - m_topg_min);
+    result = m_phi0_min + (bed_elevation - m_topg_min) * slope;
+  }
+  return result;
+}
+
+/*!
+ * Compute the tillphi adjustment using the secant approximation of the response of the
+ * surface elevation mismatch to the change in tillphi during the previous iteration.
+ *
+ * An increase in tillphi is expected to thicken the ice, i.e. *decrease* the mismatch. If
+ * the observed response does not have the expected sign (or tillphi did not change) we
+ * fall back to the proportional adjustment `dphi_proportional`.
+ */
+double OptTillphiYieldStress::secant_adjustment(double dh, double dh_previous,
+                                                double phi_change,
+                                                double dphi_proportional) const {
+  // changes in tillphi smaller than this are treated as "no change"
+  const double phi_change_min = 1e-6; // degrees
+
+  if (std::abs(phi_change) < phi_change_min) {
+    return dphi_proportional;
+  }
+
+  double slope = (dh - dh_previous) / phi_change;
+
+  if (not (slope < 0.0)) {
+    return dphi_proportional;
+  }
+
+  return -dh / slope;
+}
+
+/*!
+ * Accelerate the fixed point iteration `phi -> phi + dphi(phi)` using Anderson mixing
+ * (type II, see Walker and Ni, 2011).
+ *
+ * On entry `m_dphi` contains the residual of the fixed point iteration, on exit it
+ * contains the accelerated adjustment. Only locations marked in `m_mask` contribute.
+ */
+void OptTillphiYieldStress::anderson_mixing() {
+
+  if (m_history_available) {
+    std::shared_ptr<array::Scalar> dx, df;
+    if (m_anderson_df.size() == m_anderson_depth) {
+      // re-use storage of the oldest differences
+      dx = m_anderson_dx.front();
+      df = m_anderson_df.front();
+      m_anderson_dx.pop_front();
+      m_anderson_df.pop_front();
+    } else {
+      dx = std::make_shared<array::Scalar>(m_grid, "anderson_dx");
+      df = std::make_shared<array::Scalar>(m_grid, "anderson_df");
+    }
+
+    m_till_phi.add(-1.0, m_anderson_x, *dx);
+    m_dphi.add(-1.0, m_anderson_f, *df);
+
+    m_anderson_dx.push_back(dx);
+    m_anderson_df.push_back(df);
+  }
+
+  m_anderson_x.copy_from(m_till_phi);
+  m_anderson_f.copy_from(m_dphi);
+
+  const int m = m_anderson_df.size();
+  if (m == 0) {
+    return;
+  }
+
+  // Assemble normal equations of the least squares problem min |f - dF gamma|
+  std::vector<double> A(m * m, 0.0), b(m, 0.0), gamma;
+  {
+    std::vector<double> local(m * m + m, 0.0);
+
+    array::AccessScope list{ &m_mask, &m_dphi };
+    for (const auto &df : m_anderson_df) {
+      list.add(*df);
+    }
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      if (m_mask(i, j) < 0.5) {
+        continue;
+      }
+
+      for (int k = 0; k < m; ++k) {
+        double df_k = (*m_anderson_df[k])(i, j);
+        for (int l = 0; l < m; ++l) {
+          local[k * m + l] += df_k * (*m_anderson_df[l])(i, j);
+        }
+        local[m * m + k] += df_k * m_dphi(i, j);
+      }
+    }
+
+    std::vector<double> global(local.size());
+    GlobalSum(m_grid->com, local.data(), global.data(), local.size());
+
+    std::copy(global.begin(), global.begin() + m * m, A.begin());
+    std::copy(global.begin() + m * m, global.end(), b.begin());
+
+    // regularization
+    double trace = 0.0;
+    for (int k = 0; k < m; ++k) {
+      trace += A[k * m + k];
+    }
+    for (int k = 0; k < m; ++k) {
+      A[k * m + k] += 1e-10 * trace;
+    }
+  }
+
+  if (not solve_dense(A, b, gamma)) {
+    // the history is degenerate: start over
+    m_anderson_dx.clear();
+    m_anderson_df.clear();
+    return;
+  }
+
+  // f = f - (dX + dF) gamma
+  {
+    array::AccessScope list{ &m_mask, &m_dphi };
+    for (int k = 0; k < m; ++k) {
+      list.add(*m_anderson_dx[k]);
+      list.add(*m_anderson_df[k]);
+    }
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      if (m_mask(i, j) < 0.5) {
+        continue;
+      }
+
+      for (int k = 0; k < m; ++k) {
+        m_dphi(i, j) -= gamma[k] * ((*m_anderson_dx[k])(i, j) + (*m_anderson_df[k])(i, j));
+      }
+    }
+  }
+}
+
+/*!
+ * Adjust the update interval using the RMS surface elevation mismatch `residual`.
+ *
+ * Updates are done more often while iterations make good progress. If the mismatch stops
+ * decreasing (the ice geometry has not had enough time to respond to the previous
+ * adjustment) the interval is increased.
+ */
+void OptTillphiYieldStress::adapt_update_interval(double residual) {
+  if (not m_adaptive_interval) {
+    return;
+  }
+
+  if (m_residual > 0.0) {
+    if (residual > 0.9 * m_residual) {
+      m_update_interval *= 1.5;
+    } else {
+      m_update_interval *= 0.8;
+    }
+    m_update_interval = pism::clip(m_update_interval, m_update_interval_min, m_update_interval_max);
+
+    m_log->message(2, "  Next till friction angle update in %.2f years.\n",
+                   units::convert(m_sys, m_update_interval, "seconds", "years"));
+  }
+}
+
 //! Perform an iteration to adjust the till friction angle according to the difference
 //! between target and modeled surface elevations.
+/*!
+ * `interval` is the time since the last iteration (used to estimate the rate of change
+ * of the surface elevation mismatch).
+ */
 void OptTillphiYieldStress::update_tillphi(const array::Scalar &ice_surface_elevation,
                                            const array::Scalar &bed_topography,
-                                           const array::CellType &cell_type) {
+                                           const array::CellType &cell_type,
+                                           double interval) {
 
   m_log->message(2, "* Updating till friction angle...\n");
 
   array::AccessScope list
-    { &m_till_phi, &m_usurf_target, &m_usurf_difference, &m_mask, &ice_surface_elevation, &bed_topography, &cell_type };
+    { &m_till_phi, &m_usurf_target, &m_usurf_difference, &m_mask, &ice_surface_elevation,
+      &bed_topography, &cell_type, &m_tillphi_previous, &m_dphi };
 
   m_mask.set(0.0);
+  m_dphi.set(0.0);
 
-  double slope = (m_phi0_max - m_phi0_min) / (m_topg_max - m_topg_min);
+  const bool use_secant = m_method == SECANT and m_history_available;
+
+  // sum of squared surface elevation mismatches and the number of grounded cells
+  double residual[2] = {0.0, 0.0};
 
   for (auto p = m_grid->points(); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    // Compute the lower bound of the till friction angle (default value corresponds
-    // to "bed_topography(i, j) > topg_max"):
-    double phi0 = m_phi0_max;
-    if (bed_topography(i, j) <= m_topg_min) {
-      phi0 = m_phi0_min;
-    } else if (bed_topography(i, j) <= m_topg_max) {
-      phi0 = m_phi0_min + (bed_topography(i, j) - m_topg_min) * slope;
-    }
+    double phi_change        = m_till_phi(i, j) - m_tillphi_previous(i, j);
+    m_tillphi_previous(i, j) = m_till_phi(i, j);
 
     if (cell_type.grounded_ice(i, j)) {
       double dh_previous       = m_usurf_difference(i, j);
       m_usurf_difference(i, j) = m_usurf_target(i, j) - ice_surface_elevation(i, j);
       double dh_change         = std::abs(m_usurf_difference(i, j) - dh_previous);
 
-      if (dh_change / m_update_interval > m_dhdt_min) {
+      residual[0] += m_usurf_difference(i, j) * m_usurf_difference(i, j);
+      residual[1] += 1.0;
+
+      if (dh_change / interval > m_dhdt_min) {
         // Update tillphi if the rate of change of the surface elevation mismatch since
         // the last iteration is greater than the convergence threshold m_dhdt_min.
 
@@ -257,18 +550,50 @@ void OptTillphiYieldStress::update_tillphi(const array::Scalar &ice_surface_elev
 
         // Compute (and clip) the tillphi adjustment
         double dphi = m_usurf_difference(i, j) * m_dphi_scale;
-        dphi        = pism::clip(dphi, m_dphi_min, m_dphi_max);
 
-        // Update (and clip) the till friction angle:
-        m_till_phi(i, j) += dphi;
-        m_till_phi(i, j) = pism::clip(m_till_phi(i, j), phi0, m_phi_max);
+        if (use_secant) {
+          dphi = secant_adjustment(m_usurf_difference(i, j), dh_previous, phi_change, dphi);
+        }
+
+        m_dphi(i, j) = pism::clip(dphi, m_dphi_min, m_dphi_max);
       }
     } else if (cell_type.ocean(i, j)) {
       // Floating and ice free ocean: use the bed-elevation-dependent lower bound of
       // tillphi:
-      m_till_phi(i, j) = phi0;
+      m_till_phi(i, j) = phi0(bed_topography(i, j));
     }
   } // end of the loop over grid points
+
+  if (m_method == ANDERSON) {
+    anderson_mixing();
+  }
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (m_mask(i, j) > 0.5) {
+      // Update (and clip) the till friction angle:
+      double dphi = pism::clip(m_dphi(i, j), m_dphi_min, m_dphi_max);
+
+      m_till_phi(i, j) = pism::clip(m_till_phi(i, j) + dphi, phi0(bed_topography(i, j)), m_phi_max);
+    }
+  }
+  m_till_phi.inc_state_counter();
+
+  m_history_available = true;
+
+  {
+    double global[2];
+    GlobalSum(m_grid->com, residual, global, 2);
+
+    if (global[1] > 0.0) {
+      double rms = std::sqrt(global[0] / global[1]);
+      m_log->message(2, "  RMS surface elevation mismatch: %.2f m\n", rms);
+
+      adapt_update_interval(rms);
+      m_residual = rms;
+    }
+  }
 }
 
 void OptTillphiYieldStress::define_model_state_impl(const File &output) const {
@@ -282,6 +607,10 @@ void OptTillphiYieldStress::define_model_state_impl(const File &output) const {
     output.write_attribute(m_time_name, "calendar", time().calendar());
     output.write_attribute(m_time_name, "units", time().units_string());
   }
+
+  if (m_adaptive_interval) {
+    output.write_attribute(m_time_name, "update_interval", io::PISM_DOUBLE, {m_update_interval});
+  }
 }
 
 void OptTillphiYieldStress::write_model_state_impl(const File &output) const {
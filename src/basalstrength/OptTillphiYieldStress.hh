@@ -19,6 +19,8 @@
 #ifndef _PISMOPTTILLPHIYIELDSTRESS_H_
 #define _PISMOPTTILLPHIYIELDSTRESS_H_
 
+#include <deque>
+
 #include "pism/basalstrength/MohrCoulombYieldStress.hh"
 
 namespace pism {
@@ -34,7 +36,17 @@ private:
 
   void update_tillphi(const array::Scalar &ice_surface_elevation,
                       const array::Scalar &bed_topography,
-                      const array::CellType &mask);
+                      const array::CellType &mask,
+                      double interval);
+
+  double phi0(double bed_elevation) const;
+
+  double secant_adjustment(double dh, double dh_previous, double phi_change,
+                           double dphi_proportional) const;
+
+  void anderson_mixing();
+
+  void adapt_update_interval(double residual);
 
   void init_t_last(const File &input_file);
   void init_usurf_target(const File &input_file);
@@ -53,6 +65,25 @@ private:
   array::Scalar1 m_usurf_difference;
   array::Scalar1 m_usurf_target;
 
+  //! Method used to compute tillphi adjustments
+  enum Method {PROPORTIONAL, SECANT, ANDERSON} m_method;
+
+  //! Till friction angle before the last iteration (used by the secant method)
+  array::Scalar m_tillphi_previous;
+  //! Proposed tillphi adjustment
+  array::Scalar m_dphi;
+
+  // Anderson mixing: iterates and residuals of the previous iteration and the history of
+  // their differences
+  array::Scalar m_anderson_x;
+  array::Scalar m_anderson_f;
+  std::deque<std::shared_ptr<array::Scalar> > m_anderson_dx;
+  std::deque<std::shared_ptr<array::Scalar> > m_anderson_df;
+  unsigned int m_anderson_depth;
+
+  //! True if the information from the previous iteration is available
+  bool m_history_available;
+
   double m_dphi_scale;
 
   // convergence threshold:
@@ -75,6 +106,12 @@ private:
   double m_t_last;
   //! Update interval in seconds
   double m_update_interval;
+  //! Bounds of the update interval (used if the update interval is adaptive)
+  double m_update_interval_min;
+  double m_update_interval_max;
+  bool m_adaptive_interval;
+  //! RMS surface elevation mismatch computed during the last iteration
+  double m_residual;
   //! Temporal resolution to use when checking whether it's time to update
   double m_t_eps;
   //! Name of the variable used to store the last update time.
@@ -16,7 +16,7 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
-#include <cmath>                // pow, sqrt
+#include <cmath>                // pow, sqrt, cbrt
 
 #include "pism/basalstrength/basal_resistance.hh"
 
@@ -68,6 +68,22 @@ void IceBasalResistancePlasticLaw::drag_with_derivative(double tauc, double vx,
   }
 }
 
+/*!
+ * Compute drag coefficients and (if `dbeta` is not NULL) their derivatives at `N` points.
+ *
+ * This is the version used by SSA solvers: it evaluates the drag for a row of grid points
+ * (or all quadrature points of an element) using one virtual method call. Derived classes
+ * that don't override it fall back to the point-wise drag_with_derivative().
+ */
+void IceBasalResistancePlasticLaw::drag_with_derivative(unsigned int N, const double *tauc,
+                                                        const Vector2d *velocity, double *beta,
+                                                        double *dbeta) const {
+  for (unsigned int k = 0; k < N; ++k) {
+    drag_with_derivative(tauc[k], velocity[k].u, velocity[k].v, &beta[k],
+                         dbeta != nullptr ? &dbeta[k] : nullptr);
+  }
+}
+
 /* Pseudo-plastic */
 
 IceBasalResistancePseudoPlasticLaw::IceBasalResistancePseudoPlasticLaw(const Config &config)
@@ -75,6 +91,45 @@ IceBasalResistancePseudoPlasticLaw::IceBasalResistancePseudoPlasticLaw(const Con
   m_pseudo_q = config.get_number("basal_resistance.pseudo_plastic.q");
   m_pseudo_u_threshold = config.get_number("basal_resistance.pseudo_plastic.u_threshold", "m second-1");
   m_sliding_scale_factor_reduces_tauc = config.get_number("basal_resistance.pseudo_plastic.sliding_scale_factor");
+
+  double Aq = 1.0;
+  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
+    Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
+  }
+  m_drag_factor = 1.0 / (Aq * pow(m_pseudo_u_threshold, m_pseudo_q));
+
+  const double eps = 1e-12;
+  if (fabs(m_pseudo_q) < eps) {
+    m_exponent = Q_ZERO;
+  } else if (fabs(m_pseudo_q - 0.25) < eps) {
+    m_exponent = Q_ONE_QUARTER;
+  } else if (fabs(m_pseudo_q - 1.0 / 3.0) < eps) {
+    m_exponent = Q_ONE_THIRD;
+  } else if (fabs(m_pseudo_q - 1.0) < eps) {
+    m_exponent = Q_ONE;
+  } else {
+    m_exponent = Q_GENERAL;
+  }
+}
+
+//! Compute @f$ (|\mathbf{u}|^2)^{(q-1)/2} @f$, avoiding `pow()` for common values of `q`.
+double IceBasalResistancePseudoPlasticLaw::power(double magreg2) const {
+  switch (m_exponent) {
+  case Q_ZERO:
+    return 1.0 / sqrt(magreg2);
+  case Q_ONE_QUARTER: {
+    // (|u|^2)^(-3/8) = 1 / ((|u|^2)^(1/4) * (|u|^2)^(1/8))
+    const double a = sqrt(sqrt(magreg2));
+    return 1.0 / (a * sqrt(a));
+  }
+  case Q_ONE_THIRD:
+    return 1.0 / cbrt(magreg2);
+  case Q_ONE:
+    return 1.0;
+  case Q_GENERAL:
+  default:
+    return pow(magreg2, 0.5 * (m_pseudo_q - 1));
+  }
 }
 
 void IceBasalResistancePseudoPlasticLaw::print_info(const Logger &log,
@@ -151,13 +206,7 @@ void IceBasalResistancePseudoPlasticLaw::print_info(const Logger &log,
 double IceBasalResistancePseudoPlasticLaw::drag(double tauc, double vx, double vy) const {
   const double magreg2 = square(m_plastic_regularize) + square(vx) + square(vy);
 
-  double Aq = 1.0;
-
-  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
-    Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
-  }
-
-  return (tauc / Aq) * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
+  return tauc * m_drag_factor * power(magreg2);
 }
 
 
@@ -174,12 +223,7 @@ void IceBasalResistancePseudoPlasticLaw::drag_with_derivative(double tauc, doubl
 {
   const double magreg2 = square(m_plastic_regularize) + square(vx) + square(vy);
 
-  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
-    double Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
-    *beta = (tauc / Aq) * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
-  } else {
-    *beta =  tauc * pow(magreg2, 0.5*(m_pseudo_q - 1)) * pow(m_pseudo_u_threshold, -m_pseudo_q);
-  }
+  *beta = tauc * m_drag_factor * power(magreg2);
 
   if (dbeta) {
     *dbeta = (m_pseudo_q - 1) * (*beta) / magreg2;
@@ -187,6 +231,71 @@ void IceBasalResistancePseudoPlasticLaw::drag_with_derivative(double tauc, doubl
 
 }
 
+namespace {
+
+/*!
+ * Evaluate the pseudo-plastic drag at `N` points, using `power` to compute
+ * @f$ (|\mathbf{u}|^2)^{(q-1)/2} @f$.
+ *
+ * The loop body contains no branches (except for the one checking `dbeta`, which does not
+ * depend on the loop index), so compilers can vectorize it.
+ */
+template <class Power>
+void pseudo_plastic_drag(unsigned int N, double eps2, double C, double q, const double *tauc,
+                         const Vector2d *velocity, double *beta, double *dbeta, Power power) {
+  if (dbeta != nullptr) {
+    for (unsigned int k = 0; k < N; ++k) {
+      const double magreg2 = eps2 + square(velocity[k].u) + square(velocity[k].v);
+
+      beta[k]  = tauc[k] * C * power(magreg2);
+      dbeta[k] = (q - 1) * beta[k] / magreg2;
+    }
+  } else {
+    for (unsigned int k = 0; k < N; ++k) {
+      const double magreg2 = eps2 + square(velocity[k].u) + square(velocity[k].v);
+
+      beta[k] = tauc[k] * C * power(magreg2);
+    }
+  }
+}
+
+} // end of anonymous namespace
+
+void IceBasalResistancePseudoPlasticLaw::drag_with_derivative(unsigned int N, const double *tauc,
+                                                              const Vector2d *velocity,
+                                                              double *beta, double *dbeta) const {
+  const double eps2 = square(m_plastic_regularize), C = m_drag_factor, q = m_pseudo_q;
+
+  switch (m_exponent) {
+  case Q_ZERO:
+    pseudo_plastic_drag(N, eps2, C, q, tauc, velocity, beta, dbeta,
+                        [](double x) { return 1.0 / sqrt(x); });
+    break;
+  case Q_ONE_QUARTER:
+    pseudo_plastic_drag(N, eps2, C, q, tauc, velocity, beta, dbeta, [](double x) {
+      const double a = sqrt(sqrt(x));
+      return 1.0 / (a * sqrt(a));
+    });
+    break;
+  case Q_ONE_THIRD:
+    pseudo_plastic_drag(N, eps2, C, q, tauc, velocity, beta, dbeta,
+                        [](double x) { return 1.0 / cbrt(x); });
+    break;
+  case Q_ONE:
+    pseudo_plastic_drag(N, eps2, C, q, tauc, velocity, beta, dbeta,
+                        [](double /* x */) { return 1.0; });
+    break;
+  case Q_GENERAL:
+  default:
+    {
+      const double exponent = 0.5 * (q - 1);
+      pseudo_plastic_drag(N, eps2, C, q, tauc, velocity, beta, dbeta,
+                          [exponent](double x) { return pow(x, exponent); });
+    }
+    break;
+  }
+}
+
 /* Regularized Coulomb */
 
 IceBasalResistanceRegularizedLaw::IceBasalResistanceRegularizedLaw(const Config &config)
@@ -194,6 +303,11 @@ IceBasalResistanceRegularizedLaw::IceBasalResistanceRegularizedLaw(const Config
   m_pseudo_q = config.get_number("basal_resistance.pseudo_plastic.q");
   m_pseudo_u_threshold = config.get_number("basal_resistance.pseudo_plastic.u_threshold", "m second-1");
   m_sliding_scale_factor_reduces_tauc = config.get_number("basal_resistance.pseudo_plastic.sliding_scale_factor");
+
+  m_drag_factor = 1.0;
+  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
+    m_drag_factor = 1.0 / pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
+  }
 }
 
 void IceBasalResistanceRegularizedLaw::print_info(const Logger &log,
@@ -210,12 +324,8 @@ void IceBasalResistanceRegularizedLaw::print_info(const Logger &log,
 double IceBasalResistanceRegularizedLaw::drag(double tauc, double vx, double vy) const {
   const double magreg2sqr = sqrt(square(m_plastic_regularize) + square(vx) + square(vy));
 
-  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
-    double Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
-    return (tauc / Aq) * pow(magreg2sqr, (m_pseudo_q - 1)) * pow((magreg2sqr + m_pseudo_u_threshold), -m_pseudo_q);
-  } else {
-    return tauc * pow(magreg2sqr, (m_pseudo_q - 1)) * pow((magreg2sqr + m_pseudo_u_threshold), -m_pseudo_q);
-  }
+  return tauc * m_drag_factor * pow(magreg2sqr, (m_pseudo_q - 1)) *
+         pow((magreg2sqr + m_pseudo_u_threshold), -m_pseudo_q);
 }
 
 //! Compute the drag coefficient and its derivative with respect to @f$ \alpha = \frac 1 2 (u_x^2 + u_y^2) @f$
@@ -233,12 +343,8 @@ void IceBasalResistanceRegularizedLaw::drag_with_derivative(double tauc, double
   const double magreg2    = square(m_plastic_regularize) + square(vx) + square(vy),
                magreg2sqr = sqrt(magreg2);
 
-  if (m_sliding_scale_factor_reduces_tauc > 0.0) {
-    double Aq = pow(m_sliding_scale_factor_reduces_tauc, m_pseudo_q);
-    *beta = (tauc / Aq) * pow(magreg2sqr, (m_pseudo_q - 1)) * pow((magreg2sqr + m_pseudo_u_threshold), -m_pseudo_q);
-  } else {
-    *beta =  tauc * pow(magreg2sqr, (m_pseudo_q - 1)) * pow((magreg2sqr + m_pseudo_u_threshold), -m_pseudo_q);
-  }
+  *beta = tauc * m_drag_factor * pow(magreg2sqr, (m_pseudo_q - 1)) *
+          pow((magreg2sqr + m_pseudo_u_threshold), -m_pseudo_q);
 
   if (dbeta) {
     *dbeta = (((m_pseudo_q - 1) / magreg2) - (m_pseudo_q / (magreg2sqr * (magreg2sqr + m_pseudo_u_threshold)))) * (*beta);
@@ -20,6 +20,7 @@
 #define __basal_resistance_hh
 
 #include "pism/util/Units.hh"
+#include "pism/util/Vector2d.hh"
 
 namespace pism {
 
@@ -39,6 +40,10 @@ public:
   virtual double drag(double tauc, double vx, double vy) const;
   virtual void drag_with_derivative(double tauc, double vx, double vy,
                                     double *drag, double *ddrag) const;
+
+  //! Compute drag coefficients (and their derivatives) at `N` points.
+  virtual void drag_with_derivative(unsigned int N, const double *tauc, const Vector2d *velocity,
+                                    double *drag, double *ddrag) const;
 protected:
   double m_plastic_regularize;
 };
@@ -51,8 +56,19 @@ public:
   virtual double drag(double tauc, double vx, double vy) const;
   virtual void drag_with_derivative(double tauc, double vx, double vy,
                                     double *drag, double *ddrag) const;
+  virtual void drag_with_derivative(unsigned int N, const double *tauc, const Vector2d *velocity,
+                                    double *drag, double *ddrag) const;
 protected:
   double m_pseudo_q, m_pseudo_u_threshold, m_sliding_scale_factor_reduces_tauc;
+
+  //! Values of `q` that allow computing @f$ (|\mathbf{u}|^2)^{(q-1)/2} @f$ without `pow()`
+  enum Exponent { Q_GENERAL, Q_ZERO, Q_ONE_QUARTER, Q_ONE_THIRD, Q_ONE };
+  Exponent m_exponent;
+
+  //! Velocity-independent factor @f$ 1 / (A^q U_{\mathtt{th}}^q) @f$
+  double m_drag_factor;
+
+  double power(double magreg2) const;
 };
 
 class IceBasalResistanceRegularizedLaw : public IceBasalResistancePlasticLaw{
@@ -63,8 +79,12 @@ public:
   virtual double drag(double tauc, double vx, double vy) const;
   virtual void drag_with_derivative(double tauc, double vx, double vy,
                                     double *drag, double *ddrag) const;
+  using IceBasalResistancePlasticLaw::drag_with_derivative;
 protected:
   double m_pseudo_q, m_pseudo_u_threshold, m_sliding_scale_factor_reduces_tauc;
+
+  //! Velocity-independent factor @f$ 1 / A^q @f$
+  double m_drag_factor;
 };
 
 } // end of namespace pism
@@ -0,0 +1,170 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "Compares point-wise and row-batched evaluation of the pseudo-plastic sliding law\n"
+  "(drag and its derivative) used during the assembly of SSA systems.\n"
+  "Exits with a non-zero status if batched and point-wise results differ.\n"
+  "Usage: drag_benchmark [-Mx <row length>] [-repeat <N>]\n\n";
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "pism/basalstrength/basal_resistance.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/Vector2d.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace {
+
+using namespace pism;
+
+//! A row of grid points: sliding speeds from zero to 10 km/year, yield stress from 10 to
+//! 200 kPa.
+struct Row {
+  Row(unsigned int N) {
+    const double year = 365 * 86400.0;
+
+    for (unsigned int k = 0; k < N; ++k) {
+      const double
+        s     = (double)k / (N - 1),
+        speed = 1e4 / year * s * s * s,
+        angle = 2.0 * M_PI * s;
+
+      velocity.push_back({ speed * cos(angle), speed * sin(angle) });
+      tauc.push_back(1e4 + 1.9e5 * s);
+    }
+    // exactly zero velocity exercises the regularization
+    velocity[0] = { 0.0, 0.0 };
+  }
+
+  std::vector<double> tauc;
+  std::vector<Vector2d> velocity;
+};
+
+double max_relative_difference(const std::vector<double> &a, const std::vector<double> &b) {
+  double result = 0.0;
+  for (size_t k = 0; k < a.size(); ++k) {
+    if (b[k] != 0.0) {
+      result = std::max(result, std::fabs(a[k] - b[k]) / std::fabs(b[k]));
+    }
+  }
+  return result;
+}
+
+//! Returns the maximum relative difference between batched and point-wise results.
+double benchmark(std::shared_ptr<Context> ctx, double q, const Row &row, int N_repeat) {
+  auto config = ctx->config();
+  auto log    = ctx->log();
+
+  config->set_number("basal_resistance.pseudo_plastic.q", q);
+  IceBasalResistancePseudoPlasticLaw law(*config);
+
+  const unsigned int N = row.tauc.size();
+  const double *tauc = row.tauc.data();
+  const Vector2d *velocity = row.velocity.data();
+
+  std::vector<double>
+    beta_scalar(N), dbeta_scalar(N),
+    beta_batched(N), dbeta_batched(N),
+    beta_exact(N), dbeta_exact(N);
+
+  double t0 = get_time(ctx->com());
+  for (int r = 0; r < N_repeat; ++r) {
+    for (unsigned int k = 0; k < N; ++k) {
+      law.drag_with_derivative(tauc[k], velocity[k].u, velocity[k].v,
+                               &beta_scalar[k], &dbeta_scalar[k]);
+    }
+  }
+  double t1 = get_time(ctx->com());
+  for (int r = 0; r < N_repeat; ++r) {
+    law.drag_with_derivative(N, tauc, velocity, beta_batched.data(), dbeta_batched.data());
+  }
+  double t2 = get_time(ctx->com());
+
+  // reference values computed using pow()
+  {
+    const double
+      eps         = config->get_number("basal_resistance.plastic.regularization", "m second-1"),
+      u_threshold = config->get_number("basal_resistance.pseudo_plastic.u_threshold", "m second-1"),
+      A           = config->get_number("basal_resistance.pseudo_plastic.sliding_scale_factor"),
+      Aq          = A > 0.0 ? pow(A, q) : 1.0;
+
+    for (unsigned int k = 0; k < N; ++k) {
+      const double magreg2 = eps * eps + velocity[k].magnitude_squared();
+
+      beta_exact[k]  = tauc[k] / (Aq * pow(u_threshold, q)) * pow(magreg2, 0.5 * (q - 1));
+      dbeta_exact[k] = (q - 1) * beta_exact[k] / magreg2;
+    }
+  }
+
+  double error = std::max(max_relative_difference(beta_batched, beta_scalar),
+                          max_relative_difference(dbeta_batched, dbeta_scalar));
+
+  log->message(1, "q = %.4f:\n", q);
+  log->message(1, "  drag:  point-wise %9.3f ms, batched %9.3f ms (speedup %.2f)\n",
+               (t1 - t0) * 1e3, (t2 - t1) * 1e3, (t1 - t0) / (t2 - t1));
+  log->message(1, "         max. relative difference: batched vs point-wise %e, batched vs pow() %e\n",
+               error,
+               std::max(max_relative_difference(beta_batched, beta_exact),
+                        max_relative_difference(dbeta_batched, dbeta_exact)));
+
+  return error;
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  try {
+    auto ctx = context_from_options(com, "drag_benchmark");
+
+    options::Integer Mx("-Mx", "number of points in a row", 1001);
+    options::Integer N_repeat("-repeat", "number of repetitions", 10000);
+
+    Row row(Mx);
+
+    // special values of q (see IceBasalResistancePseudoPlasticLaw) and a general one
+    double error = 0.0;
+    for (double q : {0.0, 0.25, 1.0 / 3.0, 1.0, 0.6}) {
+      error = std::max(error, benchmark(ctx, q, row, N_repeat));
+    }
+
+    if (error > 1e-12) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "batched and point-wise drag differ (max. relative difference %e)",
+                                    error);
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -94,7 +94,7 @@ void BTU_Full::init_impl(const InputOptions &opts) {
   // Initialize the temperature field.
   {
     // store the current "revision number" of the temperature field
-    const int temp_revision = m_temp->state_counter();
+    const uint64_t temp_revision = m_temp->state_counter();
 
     if (opts.type == INIT_RESTART) {
       File input_file(m_grid->com, opts.filename, io::PISM_GUESS, io::PISM_READONLY);
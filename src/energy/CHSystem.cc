@@ -82,7 +82,7 @@ void CHSystem::bootstrap_impl(const File &input_file,
   m_log->message(2, "* Bootstrapping the cryo-hydrologic warming model from %s...\n",
                  input_file.filename().c_str());
 
-  int enthalpy_revision = m_ice_enthalpy.state_counter();
+  uint64_t enthalpy_revision = m_ice_enthalpy.state_counter();
   regrid_enthalpy();
 
   if (enthalpy_revision == m_ice_enthalpy.state_counter()) {
@@ -100,7 +100,7 @@ void CHSystem::initialize_impl(const array::Scalar &basal_melt_rate,
 
   m_log->message(2, "* Bootstrapping the cryo-hydrologic warming model...\n");
 
-  int enthalpy_revision = m_ice_enthalpy.state_counter();
+  uint64_t enthalpy_revision = m_ice_enthalpy.state_counter();
   regrid_enthalpy();
 
   if (enthalpy_revision == m_ice_enthalpy.state_counter()) {
@@ -17,6 +17,9 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>              // std::max
+#include <cmath>                  // std::fabs
+
 #include "pism/energy/EnergyModel.hh"
 #include "pism/energy/utilities.hh"
 #include "pism/stressbalance/StressBalance.hh"
@@ -76,6 +79,7 @@ EnergyModelStats::EnergyModelStats() {
   reduced_accuracy_counter = 0;
   low_temperature_counter  = 0;
   liquified_ice_volume     = 0.0;
+  max_enthalpy_change      = 0.0;
 }
 
 EnergyModelStats& EnergyModelStats::operator+=(const EnergyModelStats &other) {
@@ -83,6 +87,7 @@ EnergyModelStats& EnergyModelStats::operator+=(const EnergyModelStats &other) {
   reduced_accuracy_counter += other.reduced_accuracy_counter;
   low_temperature_counter  += other.low_temperature_counter;
   liquified_ice_volume     += other.liquified_ice_volume;
+  max_enthalpy_change      = std::max(max_enthalpy_change, other.max_enthalpy_change);
   return *this;
 }
 
@@ -100,6 +105,7 @@ void EnergyModelStats::sum(MPI_Comm com) {
   reduced_accuracy_counter = GlobalSum(com, reduced_accuracy_counter);
   low_temperature_counter  = GlobalSum(com, low_temperature_counter);
   liquified_ice_volume     = GlobalSum(com, liquified_ice_volume);
+  max_enthalpy_change      = GlobalMax(com, max_enthalpy_change);
 }
 
 
@@ -199,19 +205,30 @@ void EnergyModel::init_enthalpy(const File &input_file, bool do_regrid, int reco
  */
 void EnergyModel::regrid_enthalpy() {
 
+  // make enthalpy available to models using a different grid (grid sequencing)
+  m_grid->add_state_field(m_ice_enthalpy);
+
   auto regrid_filename = m_config->get_string("input.regrid.file");
   auto regrid_vars     = set_split(m_config->get_string("input.regrid.vars"), ',');
+  auto source_grid     = m_grid->regrid_source();
 
-
-  if (regrid_filename.empty()) {
+  if (regrid_filename.empty() and not source_grid) {
     return;
   }
 
   std::string enthalpy_name = m_ice_enthalpy.metadata().get_name();
 
   if (regrid_vars.empty() or member(enthalpy_name, regrid_vars)) {
-    File regrid_file(m_grid->com, regrid_filename, io::PISM_GUESS, io::PISM_READONLY);
-    init_enthalpy(regrid_file, true, 0);
+    const array::Array *source = source_grid ? source_grid->state_field(enthalpy_name) : nullptr;
+
+    if (source != nullptr) {
+      m_log->message(2, "* Interpolating ice enthalpy from the %d*%d grid ...\n",
+                     (int)source_grid->Mx(), (int)source_grid->My());
+      m_ice_enthalpy.regrid(*source);
+    } else if (not regrid_filename.empty()) {
+      File regrid_file(m_grid->com, regrid_filename, io::PISM_GUESS, io::PISM_READONLY);
+      init_enthalpy(regrid_file, true, 0);
+    }
   }
 }
 
@@ -252,6 +269,8 @@ void EnergyModel::update(double t, double dt, const Inputs &inputs) {
     // this call should fill m_work with new values of enthalpy
     this->update_impl(t, dt, inputs);
 
+    m_stats.max_enthalpy_change = max_enthalpy_change(*inputs.ice_thickness);
+
     m_ice_enthalpy.copy_from(m_work);
   }
   profiling().end("ice_energy");
@@ -278,6 +297,32 @@ void EnergyModel::update(double t, double dt, const Inputs &inputs) {
   }
 }
 
+/*!
+ * Compute the maximum absolute difference between new (in `m_work`) and old enthalpy
+ * values in the ice (not globalized).
+ *
+ * Used to adapt the length of energy time steps (see `time_stepping.skip.adaptive.enabled`).
+ */
+double EnergyModel::max_enthalpy_change(const array::Scalar &ice_thickness) const {
+  array::AccessScope list{&ice_thickness, &m_work, &m_ice_enthalpy};
+
+  double result = 0.0;
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const double
+      *E_new = m_work.get_column(i, j),
+      *E_old = m_ice_enthalpy.get_column(i, j);
+
+    const unsigned int ks = m_grid->kBelowHeight(ice_thickness(i, j));
+    for (unsigned int k = 0; k <= ks; ++k) {
+      result = std::max(result, std::fabs(E_new[k] - E_old[k]));
+    }
+  }
+
+  return result;
+}
+
 MaxTimestep EnergyModel::max_timestep_impl(double t) const {
   // silence a compiler warning
   (void) t;
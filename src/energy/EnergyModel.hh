@@ -70,6 +70,8 @@ public:
   unsigned int reduced_accuracy_counter;
   unsigned int low_temperature_counter;
   double liquified_ice_volume;
+  //! maximum absolute change of ice enthalpy during a time step, J kg-1
+  double max_enthalpy_change;
 };
 
 class EnergyModel : public Component {
@@ -137,6 +139,8 @@ protected:
 
   /*! @brief Regrid enthalpy from the -regrid_file. */
   void regrid_enthalpy();
+
+  double max_enthalpy_change(const array::Scalar &ice_thickness) const;
 protected:
   array::Array3D m_ice_enthalpy;
   array::Array3D m_work;
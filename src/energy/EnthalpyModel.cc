@@ -23,6 +23,8 @@
 #include "pism/energy/utilities.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/EnthalpyConverter.hh"
+#include "pism/util/SigmaCoordinate.hh"
+#include "pism/util/Vars.hh"
 #include "pism/util/array/CellType.hh"
 #include "pism/util/io/File.hh"
 
@@ -32,7 +34,52 @@ namespace energy {
 EnthalpyModel::EnthalpyModel(std::shared_ptr<const Grid> grid,
                              std::shared_ptr<const stressbalance::StressBalance> stress_balance)
   : EnergyModel(grid, stress_balance) {
-  // empty
+
+  if (m_config->get_flag("grid.sigma.enabled")) {
+    m_ice_enthalpy_sigma = allocate_sigma_field(m_grid, "enthalpy_sigma", true);
+    m_ice_enthalpy_sigma->metadata(0)
+        .long_name("ice enthalpy on sigma levels")
+        .units("J kg-1");
+
+    m_work_sigma = allocate_sigma_field(m_grid, "work_vector_sigma", false);
+    m_work_sigma->metadata(0).units("J kg-1");
+
+    m_sigma_ice_thickness = std::make_shared<array::Scalar>(m_grid, "enthalpy_sigma_thickness");
+    m_sigma_ice_thickness->metadata(0)
+        .long_name("ice thickness corresponding to enthalpy_sigma")
+        .units("m");
+  }
+}
+
+/*!
+ * Initialize enthalpy on sigma levels (if the sigma coordinate is used).
+ *
+ * Reads it from `input_file` (if not null and if it contains enthalpy on the same sigma
+ * levels). Otherwise interpolates `m_ice_enthalpy` to sigma levels.
+ */
+void EnthalpyModel::init_sigma_state(const array::Scalar &ice_thickness,
+                                     const File *input_file, unsigned int record) {
+  if (not m_ice_enthalpy_sigma) {
+    return;
+  }
+
+  bool done = false;
+  if (input_file != nullptr and
+      input_file->find_variable(m_sigma_ice_thickness->get_name())) {
+    done = read_sigma_field(*input_file, record, *m_ice_enthalpy_sigma);
+    if (done) {
+      m_sigma_ice_thickness->read(*input_file, record);
+    }
+  }
+
+  if (not done) {
+    z_to_sigma(m_ice_enthalpy, ice_thickness, *m_ice_enthalpy_sigma);
+    m_sigma_ice_thickness->copy_from(ice_thickness);
+  }
+
+  // make sure that these fields are included in copies of the model state
+  m_grid->add_state_field(*m_ice_enthalpy_sigma);
+  m_grid->add_state_field(*m_sigma_ice_thickness);
 }
 
 void EnthalpyModel::restart_impl(const File &input_file, int record) {
@@ -43,8 +90,16 @@ void EnthalpyModel::restart_impl(const File &input_file, int record) {
   m_basal_melt_rate.read(input_file, record);
   init_enthalpy(input_file, false, record);
 
+  const auto enthalpy_state = m_ice_enthalpy.state_counter();
+
   regrid("Energy balance model", m_basal_melt_rate, REGRID_WITHOUT_REGRID_VARS);
   regrid_enthalpy();
+
+  // Enthalpy on sigma levels in input_file is out of date if enthalpy was regridded.
+  const bool regridded = m_ice_enthalpy.state_counter() != enthalpy_state;
+
+  init_sigma_state(*m_grid->variables().get_2d_scalar("land_ice_thickness"),
+                   regridded ? nullptr : &input_file, record);
 }
 
 void EnthalpyModel::bootstrap_impl(const File &input_file,
@@ -61,13 +116,15 @@ void EnthalpyModel::bootstrap_impl(const File &input_file,
 
   regrid("Energy balance model", m_basal_melt_rate, REGRID_WITHOUT_REGRID_VARS);
 
-  int enthalpy_revision = m_ice_enthalpy.state_counter();
+  uint64_t enthalpy_revision = m_ice_enthalpy.state_counter();
   regrid_enthalpy();
 
   if (enthalpy_revision == m_ice_enthalpy.state_counter()) {
     bootstrap_ice_enthalpy(ice_thickness, surface_temperature, climatic_mass_balance,
                            basal_heat_flux, m_ice_enthalpy);
   }
+
+  init_sigma_state(ice_thickness);
 }
 
 void EnthalpyModel::initialize_impl(const array::Scalar &basal_melt_rate,
@@ -82,13 +139,15 @@ void EnthalpyModel::initialize_impl(const array::Scalar &basal_melt_rate,
 
   regrid("Energy balance model", m_basal_melt_rate, REGRID_WITHOUT_REGRID_VARS);
 
-  int enthalpy_revision = m_ice_enthalpy.state_counter();
+  uint64_t enthalpy_revision = m_ice_enthalpy.state_counter();
   regrid_enthalpy();
 
   if (enthalpy_revision == m_ice_enthalpy.state_counter()) {
     bootstrap_ice_enthalpy(ice_thickness, surface_temperature, climatic_mass_balance,
                            basal_heat_flux, m_ice_enthalpy);
   }
+
+  init_sigma_state(ice_thickness);
 }
 
 //! Update ice enthalpy field based on conservation of energy.
@@ -101,6 +160,10 @@ No communication of ghosts is done for any of these fields.
 
 We use an instance of enthSystemCtx.
 
+If `grid.sigma.enabled` is set the model state is stored on sigma levels (see
+SigmaCoordinate.hh) and `m_work` is computed by interpolating the updated state to the
+grid.
+
 Regarding drainage, see [\ref AschwandenBuelerKhroulevBlatter] and references therein.
  */
 
@@ -138,21 +201,32 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
   const array::Scalar1 &ice_thickness = *inputs.ice_thickness;
 
-  energy::enthSystemCtx system(m_grid->z(), "energy.enthalpy", m_grid->dx(), m_grid->dy(), dt,
-                               *m_config, m_ice_enthalpy, u3, v3, w3, strain_heating3, EC);
+  const bool sigma = (m_ice_enthalpy_sigma != nullptr);
 
-  const size_t Mz_fine = system.z().size();
-  const double dz = system.dz();
-  std::vector<double> Enthnew(Mz_fine); // new enthalpy in column
+  // the model state and the storage for the updated state
+  const array::Array3D &enthalpy = sigma ? *m_ice_enthalpy_sigma : m_ice_enthalpy;
+  array::Array3D &work = sigma ? *m_work_sigma : m_work;
+
+  energy::enthSystemCtx system(enthalpy.levels(), "energy.enthalpy", m_grid->dx(), m_grid->dy(), dt,
+                               *m_config, enthalpy, u3, v3, w3, strain_heating3, EC);
 
   array::AccessScope list{&ice_surface_temp, &shelf_base_temp, &surface_liquid_fraction,
       &ice_thickness, &basal_frictional_heating, &basal_heat_flux, &till_water_thickness,
-      &cell_type, &u3, &v3, &w3, &strain_heating3, &m_basal_melt_rate, &m_ice_enthalpy,
-      &m_work};
+      &cell_type, &u3, &v3, &w3, &strain_heating3, &m_basal_melt_rate, &enthalpy,
+      &work};
+
+  if (sigma) {
+    system.use_sigma_coordinate(m_grid->z(), ice_thickness, *m_sigma_ice_thickness,
+                                m_config->get_number("geometry.ice_free_thickness_standard"));
+    list.add(*m_sigma_ice_thickness);
+  }
+
+  const size_t Mz_fine = system.z().size();
+  std::vector<double> Enthnew(Mz_fine); // new enthalpy in column
 
   double margin_threshold = m_config->get_number("energy.margin_ice_thickness_limit");
 
-  unsigned int liquifiedCount = 0;
+  double liquified_thickness = 0.0;
 
   ParallelSection loop(m_grid->com);
   try {
@@ -165,6 +239,9 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
                   marginal(ice_thickness, i, j, margin_threshold),
                   H);
 
+      // the vertical grid spacing depends on H if the sigma coordinate is used
+      const double dz = system.dz();
+
       // enthalpy and pressures at top of ice
       const double
         depth_ks = H - system.ks() * dz,
@@ -177,7 +254,7 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
       // deal completely with columns with no ice; enthalpy and basal_melt_rate need setting
       if (ice_free_column) {
-        m_work.set_column(i, j, Enth_ks);
+        work.set_column(i, j, Enth_ks);
         // The floating basal melt rate will be set later; cover this
         // case and set to zero for now. Also, there is no basal melt
         // rate on ice free land and ice free ocean
@@ -246,7 +323,7 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
               L     = EC->L(T_m);
 
             if (Enthnew[k] >= system.Enth_s(k) + 0.5 * L) {
-              liquifiedCount++; // count these rare events...
+              liquified_thickness += dz; // count these rare events...
               Enthnew[k] = system.Enth_s(k) + 0.5 * L; //  but lose the energy
             }
 
@@ -335,24 +412,42 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
         } // end of the grounded case
       } // end of the basal melt rate computation
 
-      system.fine_to_coarse(Enthnew, i, j, m_work);
+      system.fine_to_coarse(Enthnew, i, j, work);
     }
   } catch (...) {
     loop.failed();
   }
   loop.check();
 
-  m_stats.liquified_ice_volume = ((double) liquifiedCount) * dz * m_grid->cell_area();
+  m_stats.liquified_ice_volume = liquified_thickness * m_grid->cell_area();
+
+  if (sigma) {
+    // EnergyModel::update() copies m_work to m_ice_enthalpy
+    sigma_to_z(*m_work_sigma, ice_thickness, m_work);
+
+    m_ice_enthalpy_sigma->copy_from(*m_work_sigma);
+    m_sigma_ice_thickness->copy_from(ice_thickness);
+  }
 }
 
 void EnthalpyModel::define_model_state_impl(const File &output) const {
   m_ice_enthalpy.define(output, io::PISM_DOUBLE);
   m_basal_melt_rate.define(output, io::PISM_DOUBLE);
+
+  if (m_ice_enthalpy_sigma) {
+    m_ice_enthalpy_sigma->define(output, io::PISM_DOUBLE);
+    m_sigma_ice_thickness->define(output, io::PISM_DOUBLE);
+  }
 }
 
 void EnthalpyModel::write_model_state_impl(const File &output) const {
   m_ice_enthalpy.write(output);
   m_basal_melt_rate.write(output);
+
+  if (m_ice_enthalpy_sigma) {
+    m_ice_enthalpy_sigma->write(output);
+    m_sigma_ice_thickness->write(output);
+  }
 }
 
 } // end of namespace energy
@@ -51,6 +51,16 @@ protected:
 
   virtual void define_model_state_impl(const File &output) const;
   virtual void write_model_state_impl(const File &output) const;
+
+  void init_sigma_state(const array::Scalar &ice_thickness,
+                        const File *input_file = nullptr, unsigned int record = 0);
+
+  //! Ice enthalpy on sigma levels (allocated if `grid.sigma.enabled` is set).
+  std::shared_ptr<array::Array3D> m_ice_enthalpy_sigma;
+  //! Temporary storage for the updated enthalpy on sigma levels.
+  std::shared_ptr<array::Array3D> m_work_sigma;
+  //! Ice thickness corresponding to `m_ice_enthalpy_sigma`.
+  std::shared_ptr<array::Scalar> m_sigma_ice_thickness;
 };
 
 /*! @brief The "dummy" energy balance model. Reads in enthalpy from a file, but does not update it. */
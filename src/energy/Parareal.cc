@@ -0,0 +1,553 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min
+#include <cmath>                // std::ceil
+
+#include "pism/energy/Parareal.hh"
+
+#include "pism/age/AgeModel.hh"
+#include "pism/energy/EnthalpyModel.hh"
+#include "pism/stressbalance/timestepping.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/Vars.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+namespace energy {
+
+MPI_Comm parareal_split(MPI_Comm world, int n_slices, int &slice) {
+  int rank = 0, size = 0;
+  MPI_Comm_rank(world, &rank);
+  MPI_Comm_size(world, &size);
+
+  if (n_slices < 1 or size % n_slices != 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "the number of processes (%d) has to be divisible"
+                                  " by the number of time slices (%d)",
+                                  size, n_slices);
+  }
+
+  slice = rank / (size / n_slices);
+
+  MPI_Comm result = MPI_COMM_NULL;
+  int ierr = MPI_Comm_split(world, slice, rank, &result);
+  if (ierr != MPI_SUCCESS) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "MPI_Comm_split failed");
+  }
+
+  return result;
+}
+
+FrozenInputs::FrozenInputs(std::shared_ptr<const Grid> grid)
+  : ice_thickness(grid, "thk"),
+    cell_type(grid, "mask"),
+    basal_frictional_heating(grid, "bfrict"),
+    basal_heat_flux(grid, "heat_flux_from_bedrock"),
+    surface_liquid_fraction(grid, "ice_surface_liquid_water_fraction"),
+    shelf_base_temp(grid, "shelfbtemp"),
+    surface_temp(grid, "ice_surface_temp"),
+    till_water_thickness(grid, "tillwat"),
+    volumetric_heating_rate(grid, "strainheat", array::WITHOUT_GHOSTS, grid->z()),
+    u3(grid, "uvel", array::WITHOUT_GHOSTS, grid->z()),
+    v3(grid, "vvel", array::WITHOUT_GHOSTS, grid->z()),
+    w3(grid, "wvel_rel", array::WITHOUT_GHOSTS, grid->z()),
+    zero3(grid, "zero_velocity", array::WITHOUT_GHOSTS, grid->z()) {
+
+  ice_thickness.metadata(0)
+      .long_name("land ice thickness")
+      .units("m")
+      .standard_name("land_ice_thickness");
+  cell_type.metadata(0).long_name("ice-type (ice-free/grounded/floating/ocean) integer mask");
+  basal_frictional_heating.metadata(0)
+      .long_name("basal frictional heating")
+      .units("W m-2");
+  basal_heat_flux.metadata(0)
+      .long_name("upward geothermal flux at the top bedrock surface")
+      .units("W m-2");
+  surface_liquid_fraction.metadata(0)
+      .long_name("liquid water fraction of the ice at the top surface")
+      .units("1");
+  shelf_base_temp.metadata(0)
+      .long_name("ice temperature at the bottom of floating ice")
+      .units("K");
+  surface_temp.metadata(0)
+      .long_name("ice temperature at the top ice surface")
+      .units("K");
+  till_water_thickness.metadata(0)
+      .long_name("effective thickness of subglacial water stored in till")
+      .units("m");
+  volumetric_heating_rate.metadata(0)
+      .long_name("rate of strain heating in ice (dissipation heating)")
+      .units("W m-3");
+  u3.metadata(0).long_name("x-component of the ice velocity").units("m s-1");
+  v3.metadata(0).long_name("y-component of the ice velocity").units("m s-1");
+  w3.metadata(0)
+      .long_name("vertical velocity of ice, relative to base of ice directly below")
+      .units("m s-1");
+
+  zero3.set(0.0);
+}
+
+/*!
+ * Read inputs from `input_file`.
+ *
+ * The ice thickness, the cell type mask, the ice velocity and the ice surface temperature
+ * are required, other fields are optional.
+ */
+void FrozenInputs::read(const File &input_file, unsigned int record) {
+  auto config = ice_thickness.grid()->ctx()->config();
+
+  ice_thickness.read(input_file, record);
+  cell_type.read(input_file, record);
+  surface_temp.read(input_file, record);
+  u3.read(input_file, record);
+  v3.read(input_file, record);
+  w3.read(input_file, record);
+
+  // the geothermal flux is the same as the heat flux from bedrock if the bedrock thermal
+  // layer is not used
+  if (input_file.find_variable("heat_flux_from_bedrock")) {
+    basal_heat_flux.read(input_file, record);
+  } else {
+    array::Scalar bheatflx(ice_thickness.grid(), "bheatflx");
+    bheatflx.metadata(0).units("W m-2");
+    bheatflx.read(input_file, record);
+    basal_heat_flux.copy_from(bheatflx);
+  }
+
+  auto read_optional = [&input_file, record](array::Array &field, double default_value) {
+    if (input_file.find_variable(field.get_name())) {
+      field.read(input_file, record);
+    } else {
+      field.set(default_value);
+    }
+  };
+
+  read_optional(basal_frictional_heating, 0.0);
+  read_optional(surface_liquid_fraction, 0.0);
+  read_optional(shelf_base_temp,
+                config->get_number("constants.fresh_water.melting_point_temperature"));
+  read_optional(till_water_thickness, 0.0);
+  read_optional(volumetric_heating_rate, 0.0);
+}
+
+/*!
+ * Inputs of the energy model.
+ *
+ * If `column_only` is set, horizontal advection is turned off.
+ */
+Inputs FrozenInputs::energy_inputs(bool column_only) const {
+  Inputs result;
+
+  result.cell_type                = &cell_type;
+  result.basal_frictional_heating = &basal_frictional_heating;
+  result.basal_heat_flux          = &basal_heat_flux;
+  result.ice_thickness            = &ice_thickness;
+  result.surface_liquid_fraction  = &surface_liquid_fraction;
+  result.shelf_base_temp          = &shelf_base_temp;
+  result.surface_temp             = &surface_temp;
+  result.till_water_thickness     = &till_water_thickness;
+  result.volumetric_heating_rate  = &volumetric_heating_rate;
+  result.u3                       = column_only ? &zero3 : &u3;
+  result.v3                       = column_only ? &zero3 : &v3;
+  result.w3                       = &w3;
+
+  return result;
+}
+
+/*!
+ * Inputs of the age model.
+ *
+ * If `column_only` is set, horizontal advection is turned off.
+ */
+AgeModelInputs FrozenInputs::age_inputs(bool column_only) const {
+  return AgeModelInputs(&ice_thickness,
+                        column_only ? &zero3 : &u3,
+                        column_only ? &zero3 : &v3,
+                        &w3);
+}
+
+//! Enthalpy model with a way to set the model state.
+class EnthalpyPropagator : public EnthalpyModel {
+public:
+  EnthalpyPropagator(std::shared_ptr<const Grid> grid)
+    : EnthalpyModel(grid, nullptr) {
+    // empty
+  }
+
+  void set_enthalpy(const array::Array3D &enthalpy, const array::Scalar &ice_thickness) {
+    m_ice_enthalpy.copy_from(enthalpy);
+    init_sigma_state(ice_thickness);
+  }
+
+  void set_basal_melt_rate(const array::Scalar &basal_melt_rate) {
+    m_basal_melt_rate.copy_from(basal_melt_rate);
+  }
+};
+
+//! Age model with a way to set the model state.
+class AgePropagator : public AgeModel {
+public:
+  AgePropagator(std::shared_ptr<const Grid> grid)
+    : AgeModel(grid, nullptr) {
+    // empty
+  }
+
+  void set_age(const array::Array3D &age, const array::Scalar &ice_thickness) {
+    m_ice_age.copy_from(age);
+    init_sigma_state(ice_thickness);
+  }
+};
+
+Parareal::State::State(std::shared_ptr<const Grid> grid, bool use_age)
+  : enthalpy(grid, "enthalpy", array::WITHOUT_GHOSTS, grid->z()) {
+  enthalpy.metadata(0).units("J kg-1");
+
+  if (use_age) {
+    age = std::make_shared<array::Array3D>(grid, "age", array::WITHOUT_GHOSTS, grid->z());
+    age->metadata(0).units("s");
+  }
+}
+
+void Parareal::State::copy_from(const State &other) {
+  enthalpy.copy_from(other.enthalpy);
+  if (age) {
+    age->copy_from(*other.age);
+  }
+}
+
+Parareal::Parareal(std::shared_ptr<Grid> grid, MPI_Comm world, int slice, int n_slices)
+  : m_grid(grid),
+    m_config(grid->ctx()->config()),
+    m_log(grid->ctx()->log()),
+    m_sys(grid->ctx()->unit_system()),
+    m_world(world),
+    m_slice(slice),
+    m_n_slices(n_slices),
+    m_group_size(1),
+    m_inputs(grid),
+    m_basal_melt_rate(grid, "bmelt"),
+    m_dt_fine(0.0) {
+
+  int world_size = 0;
+  MPI_Comm_size(m_world, &world_size);
+  m_group_size = world_size / m_n_slices;
+
+  // States are sent from one group to the next without re-distributing them, so all
+  // groups have to use the same domain decomposition.
+  {
+    const int local[4] = {m_grid->xs(), m_grid->xm(), m_grid->ys(), m_grid->ym()};
+    std::vector<int> all(4 * world_size);
+
+    MPI_Allgather(local, 4, MPI_INT, all.data(), 4, MPI_INT, m_world);
+
+    for (int r = 0; r < world_size; ++r) {
+      for (int k = 0; k < 4; ++k) {
+        if (all[4 * r + k] != all[4 * (r % m_group_size) + k]) {
+          throw RuntimeError(PISM_ERROR_LOCATION,
+                             "all time slices have to use the same domain decomposition");
+        }
+      }
+    }
+  }
+
+  // EnthalpyModel and AgeModel get the ice thickness from the dictionary of variables
+  // during initialization
+  grid->variables().add(m_inputs.ice_thickness);
+
+  m_energy = std::make_shared<EnthalpyPropagator>(m_grid);
+
+  if (m_config->get_flag("age.enabled")) {
+    m_age = std::make_shared<AgePropagator>(m_grid);
+  }
+
+  m_basal_melt_rate.metadata(0).units("m s-1");
+}
+
+Parareal::~Parareal() {
+  // empty
+}
+
+void Parareal::init(const File &input_file, unsigned int record) {
+  m_inputs.read(input_file, record);
+
+  m_energy->restart(input_file, record);
+  m_basal_melt_rate.copy_from(m_energy->basal_melt_rate());
+
+  if (m_age) {
+    m_age->init(InputOptions(INIT_RESTART, input_file.filename(), record));
+  }
+
+  auto cfl = max_timestep_cfl_3d(m_inputs.ice_thickness, m_inputs.cell_type, m_inputs.u3,
+                                 m_inputs.v3, m_inputs.w3);
+
+  m_dt_fine = m_config->get_number("time_stepping.maximum_time_step", "seconds");
+  if (cfl.dt_max.finite()) {
+    m_dt_fine = std::min(m_dt_fine, cfl.dt_max.value());
+  }
+}
+
+bool Parareal::last_slice() const {
+  return m_slice == m_n_slices - 1;
+}
+
+/*!
+ * Run the fine (if `fine` is true) or the coarse propagator from `t0` to `t1` starting
+ * from `state`. The result is stored in `state`.
+ */
+void Parareal::propagate(bool fine, double t0, double t1, State &state) {
+  const auto &H = m_inputs.ice_thickness;
+
+  m_energy->set_enthalpy(state.enthalpy, H);
+  if (m_age) {
+    m_age->set_age(*state.age, H);
+  }
+
+  auto energy_inputs = m_inputs.energy_inputs(not fine);
+  auto age_inputs    = m_inputs.age_inputs(not fine);
+
+  double dt_max = fine ? m_dt_fine : (t1 - t0) / m_config->get_number("energy.parareal.coarse_steps");
+
+  int N = static_cast<int>(std::ceil((t1 - t0) / dt_max));
+  double dt = (t1 - t0) / N;
+
+  for (int n = 0; n < N; ++n) {
+    double t = t0 + n * dt;
+
+    m_energy->update(t, dt, energy_inputs);
+    if (m_age) {
+      m_age->update(t, dt, age_inputs);
+    }
+  }
+
+  state.enthalpy.copy_from(m_energy->enthalpy());
+  if (m_age) {
+    state.age->copy_from(m_age->age());
+  }
+
+  if (fine) {
+    m_basal_melt_rate.copy_from(m_energy->basal_melt_rate());
+  }
+}
+
+//! Send `state` to the group handling `slice`.
+void Parareal::send(State &state, int slice) {
+  int rank = 0;
+  MPI_Comm_rank(m_world, &rank);
+  const int destination = rank + (slice - m_slice) * m_group_size;
+
+  for (auto *field : {&state.enthalpy, state.age.get()}) {
+    if (field == nullptr) {
+      continue;
+    }
+
+    // read-only access: does not increment the state counter
+    PetscInt size = 0;
+    PetscErrorCode ierr = VecGetLocalSize(field->petsc_vec(), &size);
+    PISM_CHK(ierr, "VecGetLocalSize");
+
+    petsc::VecArray data(field->petsc_vec());
+    MPI_Send(data.get(), size, MPI_DOUBLE, destination, 0, m_world);
+  }
+}
+
+//! Receive `state` from the group handling `slice`.
+void Parareal::receive(int slice, State &state) {
+  int rank = 0;
+  MPI_Comm_rank(m_world, &rank);
+  const int source = rank + (slice - m_slice) * m_group_size;
+
+  for (auto *field : {&state.enthalpy, state.age.get()}) {
+    if (field == nullptr) {
+      continue;
+    }
+
+    PetscInt size = 0;
+    PetscErrorCode ierr = VecGetLocalSize(field->petsc_vec(), &size);
+    PISM_CHK(ierr, "VecGetLocalSize");
+
+    // vec() increments the state counter: received values replace stored ones
+    petsc::VecArray data(field->vec());
+    MPI_Recv(data.get(), size, MPI_DOUBLE, source, 0, m_world, MPI_STATUS_IGNORE);
+  }
+}
+
+/*!
+ * Compute maximum absolute differences between `a` and `b` over all time slices.
+ */
+void Parareal::max_change(const State &a, const State &b, double &enthalpy,
+                          double &age) const {
+  array::Array3D difference(m_grid, "difference", array::WITHOUT_GHOSTS, m_grid->z());
+
+  difference.copy_from(a.enthalpy);
+  difference.add(-1.0, b.enthalpy);
+  enthalpy = difference.norm(NORM_INFINITY)[0];
+
+  age = 0.0;
+  if (a.age) {
+    difference.copy_from(*a.age);
+    difference.add(-1.0, *b.age);
+    age = difference.norm(NORM_INFINITY)[0];
+  }
+
+  enthalpy = GlobalMax(m_world, enthalpy);
+  age      = GlobalMax(m_world, age);
+}
+
+/*!
+ * Solve from `t0` to `t1` using parareal iterations.
+ *
+ * Uses the standard parareal update
+ *
+ * @f[ U_{n+1}^{k+1} = G(U_n^{k+1}) + F(U_n^k) - G(U_n^k), @f]
+ *
+ * where @f$ U_n^k @f$ is the state at the beginning of the slice @f$ n @f$ after
+ * @f$ k @f$ iterations and @f$ F @f$ and @f$ G @f$ are fine and coarse propagators.
+ *
+ * Fine propagators run concurrently in all slices; coarse corrections are pipelined.
+ *
+ * The state at the start of the slice `n` does not change after `n` iterations, so
+ * after `n_slices` iterations the result is identical to the one computed by running the
+ * fine propagator sequentially.
+ */
+Parareal::Stats Parareal::run(double t0, double t1) {
+  const double
+    slice_length = (t1 - t0) / m_n_slices,
+    t_start      = t0 + m_slice * slice_length,
+    t_end        = t_start + slice_length;
+
+  const double
+    enthalpy_tolerance = m_config->get_number("energy.parareal.enthalpy_tolerance"),
+    age_tolerance      = m_config->get_number("energy.parareal.age_tolerance", "seconds");
+
+  int max_iterations = static_cast<int>(m_config->get_number("energy.parareal.max_iterations"));
+  if (max_iterations <= 0 or max_iterations > m_n_slices) {
+    max_iterations = m_n_slices;
+  }
+
+  const bool use_age = (m_age != nullptr);
+
+  // states at the beginning and at the end of this slice
+  State start(m_grid, use_age), end(m_grid, use_age), previous_end(m_grid, use_age);
+  // results of the coarse and fine propagators
+  State coarse(m_grid, use_age), fine(m_grid, use_age);
+
+  start.enthalpy.copy_from(m_energy->enthalpy());
+  if (use_age) {
+    start.age->copy_from(m_age->age());
+  }
+
+  Stats stats{0, 0.0, 0.0, 0};
+
+  // iteration zero: the coarse propagator sweep (not needed if there is only one slice)
+  if (m_n_slices > 1) {
+    if (m_slice > 0) {
+      receive(m_slice - 1, start);
+    }
+
+    coarse.copy_from(start);
+    propagate(false, t_start, t_end, coarse);
+    end.copy_from(coarse);
+
+    if (not last_slice()) {
+      send(end, m_slice + 1);
+    }
+  }
+
+  for (int k = 1; k <= max_iterations; ++k) {
+    previous_end.copy_from(end);
+
+    // The start state of this slice did not change during the previous iteration if
+    // m_slice < k - 1. In this case we already have the fine propagator result.
+    if (m_slice >= k - 1) {
+      fine.copy_from(start);
+      propagate(true, t_start, t_end, fine);
+      stats.fine_runs += 1;
+    }
+
+    if (m_slice < k) {
+      // the start state is exact, so is the fine propagator result
+      end.copy_from(fine);
+    } else {
+      receive(m_slice - 1, start);
+
+      // correction: end = G(start) + F - G_old
+      end.copy_from(fine);
+      end.enthalpy.add(-1.0, coarse.enthalpy);
+      if (use_age) {
+        end.age->add(-1.0, *coarse.age);
+      }
+
+      coarse.copy_from(start);
+      propagate(false, t_start, t_end, coarse);
+
+      end.enthalpy.add(1.0, coarse.enthalpy);
+      if (use_age) {
+        end.age->add(1.0, *coarse.age);
+      }
+    }
+
+    if (not last_slice() and m_slice >= k - 1) {
+      // slices m_slice < k - 1 sent the same state during the previous iteration
+      send(end, m_slice + 1);
+    }
+
+    stats.iterations = k;
+    max_change(end, previous_end, stats.enthalpy_change, stats.age_change);
+
+    m_log->message(2, "  parareal iteration %d: max. change of enthalpy %f J kg-1, age %f years\n",
+                   k, stats.enthalpy_change,
+                   units::convert(m_sys, stats.age_change, "seconds", "years"));
+
+    if (stats.enthalpy_change < enthalpy_tolerance and stats.age_change < age_tolerance) {
+      break;
+    }
+  }
+
+  // store the final state
+  m_energy->set_enthalpy(end.enthalpy, m_inputs.ice_thickness);
+  m_energy->set_basal_melt_rate(m_basal_melt_rate);
+  if (use_age) {
+    m_age->set_age(*end.age, m_inputs.ice_thickness);
+  }
+
+  return stats;
+}
+
+void Parareal::write_model_state(const File &output) const {
+  m_inputs.ice_thickness.write(output);
+
+  m_energy->define_model_state(output);
+  m_energy->write_model_state(output);
+
+  if (m_age) {
+    m_age->define_model_state(output);
+    m_age->write_model_state(output);
+  }
+}
+
+} // end of namespace energy
+} // end of namespace pism
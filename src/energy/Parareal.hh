@@ -0,0 +1,157 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_PARAREAL_H
+#define PISM_PARAREAL_H
+
+#include <memory>
+
+#include <mpi.h>
+
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/Units.hh"
+#include "pism/util/array/Array3D.hh"
+#include "pism/util/array/CellType.hh"
+#include "pism/util/array/Scalar.hh"
+
+namespace pism {
+
+class AgeModelInputs;
+class File;
+class Grid;
+
+namespace energy {
+
+class Inputs;
+
+//! Split `world` into `n_slices` groups of consecutive ranks of the same size.
+MPI_Comm parareal_split(MPI_Comm world, int n_slices, int &slice);
+
+//! Time-independent inputs of the energy and age models (geometry, ice velocity, boundary
+//! conditions).
+class FrozenInputs {
+public:
+  FrozenInputs(std::shared_ptr<const Grid> grid);
+
+  void read(const File &input_file, unsigned int record);
+
+  Inputs energy_inputs(bool column_only) const;
+  AgeModelInputs age_inputs(bool column_only) const;
+
+  array::Scalar1 ice_thickness;
+  array::CellType cell_type;
+  array::Scalar basal_frictional_heating;
+  array::Scalar basal_heat_flux;
+  array::Scalar surface_liquid_fraction;
+  array::Scalar shelf_base_temp;
+  array::Scalar surface_temp;
+  array::Scalar till_water_thickness;
+
+  array::Array3D volumetric_heating_rate;
+  array::Array3D u3;
+  array::Array3D v3;
+  array::Array3D w3;
+
+  //! zero horizontal velocity used by the column-only coarse propagator
+  array::Array3D zero3;
+};
+
+class EnthalpyPropagator;
+class AgePropagator;
+
+//! Parallel-in-time (parareal) solver of the enthalpy and age equations with frozen
+//! geometry and ice velocity.
+/*!
+ * The time interval is split into `n_slices` slices. Slice `n` is handled by its own group
+ * of processes (see parareal_split()) using its own copy of the grid.
+ *
+ * The fine propagator is EnthalpyModel (and AgeModel if `age.enabled` is set) stepping
+ * using the time step restricted by the CFL condition. The coarse propagator is the same
+ * model with horizontal advection turned off ("column-only"), which allows it to take long
+ * time steps (see `energy.parareal.coarse_steps`).
+ *
+ * All groups use the same domain decomposition, so states are sent from one group to the
+ * next without re-distributing them.
+ */
+class Parareal {
+public:
+  Parareal(std::shared_ptr<Grid> grid, MPI_Comm world, int slice, int n_slices);
+  ~Parareal();
+
+  void init(const File &input_file, unsigned int record);
+
+  struct Stats {
+    //! number of parareal iterations
+    int iterations;
+    //! changes of enthalpy (J kg-1) and age (seconds) during the last iteration
+    double enthalpy_change, age_change;
+    //! number of fine propagator runs performed by this slice
+    int fine_runs;
+  };
+
+  Stats run(double t0, double t1);
+
+  //! True if this group handles the last time slice (and has the final state).
+  bool last_slice() const;
+
+  void write_model_state(const File &output) const;
+
+private:
+  struct State {
+    State(std::shared_ptr<const Grid> grid, bool age);
+
+    void copy_from(const State &other);
+
+    array::Array3D enthalpy;
+    std::shared_ptr<array::Array3D> age;
+  };
+
+  void propagate(bool fine, double t0, double t1, State &state);
+
+  void send(State &state, int slice);
+  void receive(int slice, State &state);
+
+  void max_change(const State &a, const State &b, double &enthalpy, double &age) const;
+
+  std::shared_ptr<const Grid> m_grid;
+  Config::ConstPtr m_config;
+  Logger::ConstPtr m_log;
+  units::System::Ptr m_sys;
+
+  MPI_Comm m_world;
+  int m_slice, m_n_slices, m_group_size;
+
+  FrozenInputs m_inputs;
+
+  //! energy and age models used by both fine and coarse propagators
+  std::shared_ptr<EnthalpyPropagator> m_energy;
+  std::shared_ptr<AgePropagator> m_age;
+
+  //! basal melt rate computed by the last run of the fine propagator
+  array::Scalar m_basal_melt_rate;
+
+  //! maximum fine time step (the CFL time step restriction)
+  double m_dt_fine;
+};
+
+} // end of namespace energy
+} // end of namespace pism
+
+#endif /* PISM_PARAREAL_H */
@@ -22,6 +22,7 @@
 #include "pism/energy/utilities.hh"
 #include "pism/util/Vars.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/pism_utilities.hh"
 
@@ -39,6 +40,12 @@ TemperatureModel::TemperatureModel(
       .units("K")
       .standard_name("land_ice_temperature");
   m_ice_temperature.metadata()["valid_min"] = {0.0};
+
+  if (m_config->get_flag("grid.sigma.enabled")) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "the temperature-based energy balance model does not support"
+                       " the sigma coordinate (grid.sigma.enabled)");
+  }
 }
 
 const array::Array3D & TemperatureModel::temperature() const {
@@ -80,7 +87,7 @@ void TemperatureModel::bootstrap_impl(const File &input_file,
                            io::Default(m_config->get_number("bootstrapping.defaults.bmelt")));
   regrid("Temperature-based energy balance model", m_basal_melt_rate, REGRID_WITHOUT_REGRID_VARS);
 
-  int temp_revision = m_ice_temperature.state_counter();
+  uint64_t temp_revision = m_ice_temperature.state_counter();
   regrid("Temperature-based energy balance model", m_ice_temperature, REGRID_WITHOUT_REGRID_VARS);
 
   if (temp_revision == m_ice_temperature.state_counter()) {
@@ -102,7 +109,7 @@ void TemperatureModel::initialize_impl(const array::Scalar &basal_melt_rate,
   m_basal_melt_rate.copy_from(basal_melt_rate);
   regrid("Temperature-based energy balance model", m_basal_melt_rate, REGRID_WITHOUT_REGRID_VARS);
 
-  int temp_revision = m_ice_temperature.state_counter();
+  uint64_t temp_revision = m_ice_temperature.state_counter();
   regrid("Temperature-based energy balance model", m_ice_temperature, REGRID_WITHOUT_REGRID_VARS);
 
   if (temp_revision == m_ice_temperature.state_counter()) {
@@ -77,16 +77,9 @@ enthSystemCtx::enthSystemCtx(const std::vector<double>& storage_grid,
   m_E_s.resize(Mz);
   m_E_w.resize(Mz);
 
-  m_nu = m_dt / m_dz;
-
-  double
-    ratio = config.get_number(prefix + ".temperate_ice_thermal_conductivity_ratio"),
-    K     = m_ice_k / m_ice_c,
-    K0    = (ratio * m_ice_k) / m_ice_c;
+  m_temperate_k_ratio = config.get_number(prefix + ".temperate_ice_thermal_conductivity_ratio");
 
-  m_R_factor = m_dt / (pow(m_dz, 2) * m_ice_density);
-  m_R_cold = K * m_R_factor;
-  m_R_temp = K0 * m_R_factor;
+  init_grid_constants();
 
   if (config.get_flag("energy.temperature_dependent_thermal_conductivity")) {
     m_k_depends_on_T = true;
@@ -95,6 +88,23 @@ enthSystemCtx::enthSystemCtx(const std::vector<double>& storage_grid,
   }
 }
 
+//! Set constants that depend on the vertical grid spacing.
+/*!
+ * In the sigma mode the grid spacing depends on the ice thickness, so these are re-computed
+ * in every column.
+ */
+void enthSystemCtx::init_grid_constants() {
+  const double
+    K  = m_ice_k / m_ice_c,
+    K0 = (m_temperate_k_ratio * m_ice_k) / m_ice_c;
+
+  m_nu = m_dt / m_dz;
+
+  m_R_factor = m_dt / (m_dz * m_dz * m_ice_density);
+  m_R_cold   = K * m_R_factor;
+  m_R_temp   = K0 * m_R_factor;
+}
+
 /*!
   In this implementation \f$k\f$ does not depend on temperature.
  */
@@ -114,22 +124,27 @@ void enthSystemCtx::init(int i, int j, bool marginal, double ice_thickness) {
 
   init_column(i, j, m_ice_thickness);
 
+  if (m_sigma) {
+    init_grid_constants();
+  }
+
   if (m_ks == 0) {
     return;
   }
 
-  coarse_to_fine(m_u3, m_i, m_j, m_u.data());
-  coarse_to_fine(m_v3, m_i, m_j, m_v.data());
+  input_to_fine(m_u3, m_i, m_j, m_u.data());
+  input_to_fine(m_v3, m_i, m_j, m_v.data());
 
   if (m_marginal and m_margin_exclude_vertical_advection) {
     for (unsigned int k = 0; k < m_w.size(); ++k) {
       m_w[k] = 0.0;
     }
   } else {
-    coarse_to_fine(m_w3, m_i, m_j, m_w.data());
+    input_to_fine(m_w3, m_i, m_j, m_w.data());
+    add_sigma_metric_terms();
   }
 
-  coarse_to_fine(m_strain_heating3, m_i, m_j, m_strain_heating.data());
+  input_to_fine(m_strain_heating3, m_i, m_j, m_strain_heating.data());
   coarse_to_fine(m_Enth3, m_i, m_j, m_Enth.data());
 
   coarse_to_fine(m_Enth3, m_i, m_j+1, m_E_n.data());
@@ -96,6 +96,9 @@ protected:
   double m_ice_density, m_ice_c, m_ice_k, m_p_air,
     m_nu, m_R_cold, m_R_temp, m_R_factor;
 
+  //! ratio of thermal conductivities of temperate and cold ice
+  double m_temperate_k_ratio;
+
   double m_ice_thickness,
     m_lambda;              //! implicit FD method parameter
   double m_D0, m_U0, m_B0;   // coefficients of the first (basal) equation
@@ -109,6 +112,7 @@ protected:
   const array::Array3D &m_Enth3, &m_strain_heating3;
   EnthalpyConverter::Ptr m_EC;  // conductivity has known dependence on T, not enthalpy
 
+  void init_grid_constants();
   void compute_enthalpy_CTS();
   double compute_lambda();
 
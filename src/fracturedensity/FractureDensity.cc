@@ -22,7 +22,7 @@
 
 #include "pism/fracturedensity/FractureDensity.hh"
 #include "pism/geometry/Geometry.hh"
-#include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityDerivedFields.hh"
 #include "pism/util/pism_utilities.hh"
 
 namespace pism {
@@ -38,8 +38,6 @@ FractureDensity::FractureDensity(std::shared_ptr<const Grid> grid,
       m_age(grid, "fracture_age"),
       m_age_new(grid, "new_fracture_age"),
       m_toughness(grid, "fracture_toughness"),
-      m_strain_rates(grid, "strain_rates", array::WITHOUT_GHOSTS),
-      m_deviatoric_stresses(grid, "sigma", array::WITHOUT_GHOSTS, 3),
       m_velocity(grid, "ghosted_velocity"),
       m_flow_law(flow_law) {
 
@@ -67,24 +65,6 @@ FractureDensity::FractureDensity(std::shared_ptr<const Grid> grid,
       .long_name("fracture toughness")
       .units("Pa");
 
-  m_strain_rates.metadata(0).set_name("eigen1");
-  m_strain_rates.metadata(0)
-      .long_name("major principal component of horizontal strain-rate")
-      .units("second-1");
-
-  m_strain_rates.metadata(1).set_name("eigen2");
-  m_strain_rates.metadata(1)
-      .long_name("minor principal component of horizontal strain-rate")
-      .units("second-1");
-
-  m_deviatoric_stresses.metadata(0).set_name("sigma_xx");
-  m_deviatoric_stresses.metadata(0).long_name("deviatoric stress in x direction").units("Pa");
-
-  m_deviatoric_stresses.metadata(1).set_name("sigma_yy");
-  m_deviatoric_stresses.metadata(1).long_name("deviatoric stress in y direction").units("Pa");
-
-  m_deviatoric_stresses.metadata(2).set_name("sigma_xy");
-  m_deviatoric_stresses.metadata(2).long_name("deviatoric shear stress").units("Pa");
 }
 
 void FractureDensity::restart(const File &input_file, int record) {
@@ -131,7 +111,8 @@ void FractureDensity::update(double dt,
                              const Geometry &geometry,
                              const array::Vector &velocity,
                              const array::Scalar &hardness,
-                             const array::Scalar &bc_mask) {
+                             const array::Scalar &bc_mask,
+                             const stressbalance::VelocityDerivedFields &velocity_derived_fields) {
   using std::pow;
 
   const double
@@ -150,17 +131,12 @@ void FractureDensity::update(double dt,
 
   m_velocity.copy_from(velocity);
 
-  stressbalance::compute_2D_principal_strain_rates(m_velocity,
-                                                   geometry.cell_type,
-                                                   m_strain_rates);
-
-  stressbalance::compute_2D_stresses(*m_flow_law,
-                                     m_velocity,
-                                     hardness,
-                                     geometry.cell_type,
-                                     m_deviatoric_stresses);
+  // computed by the stress balance model and shared with calving models
+  const auto &strain_rates = velocity_derived_fields.principal_strain_rates(geometry.cell_type);
+  const auto &deviatoric_stresses =
+      velocity_derived_fields.deviatoric_stresses(hardness, geometry.cell_type);
 
-  array::AccessScope list{&m_velocity, &m_strain_rates, &m_deviatoric_stresses,
+  array::AccessScope list{&m_velocity, &strain_rates, &deviatoric_stresses,
                                &D, &D_new, &geometry.cell_type, &bc_mask, &A, &A_new,
                                &m_growth_rate, &m_healing_rate, &m_flow_enhancement,
                                &m_toughness, &hardness, &geometry.ice_thickness};
@@ -265,9 +241,9 @@ void FractureDensity::update(double dt,
     ///von mises criterion
 
     double
-      txx    = m_deviatoric_stresses(i, j).xx,
-      tyy    = m_deviatoric_stresses(i, j).yy,
-      txy    = m_deviatoric_stresses(i, j).xy,
+      txx    = deviatoric_stresses(i, j).xx,
+      tyy    = deviatoric_stresses(i, j).yy,
+      txy    = deviatoric_stresses(i, j).xy,
       T1     = 0.5 * (txx + tyy) + sqrt(0.25 * pow(txx - tyy, 2) + pow(txy, 2)), //Pa
       T2     = 0.5 * (txx + tyy) - sqrt(0.25 * pow(txx - tyy, 2) + pow(txy, 2)), //Pa
       sigmat = sqrt(pow(T1, 2) + pow(T2, 2) - T1 * T2);
@@ -339,8 +315,8 @@ void FractureDensity::update(double dt,
         double kappa = 2.8;
 
         // effective strain rate
-        double e1 = m_strain_rates(i, j).eigen1;
-        double e2 = m_strain_rates(i, j).eigen2;
+        double e1 = strain_rates(i, j).eigen1;
+        double e2 = strain_rates(i, j).eigen2;
         double ee = sqrt(pow(e1, 2.0) + pow(e2, 2.0) - e1 * e2);
 
         // threshold for unfractured ice
@@ -363,14 +339,14 @@ void FractureDensity::update(double dt,
         }
       }
     } else {
-      fdnew = gamma * (m_strain_rates(i, j).eigen1 - 0.0) * (1 - D_new(i, j));
+      fdnew = gamma * (strain_rates(i, j).eigen1 - 0.0) * (1 - D_new(i, j));
       if (sigmat > initThreshold) {
         D_new(i, j) += fdnew * dt;
       }
     }
 
     //healing
-    double fdheal = gammaheal * std::min(0.0, (m_strain_rates(i, j).eigen1 - healThreshold));
+    double fdheal = gammaheal * std::min(0.0, (strain_rates(i, j).eigen1 - healThreshold));
     if (geometry.cell_type.icy(i, j)) {
       if (constant_healing) {
         fdheal = gammaheal * (-healThreshold);
@@ -379,7 +355,7 @@ void FractureDensity::update(double dt,
         } else {
           D_new(i, j) += fdheal * dt;
         }
-      } else if (m_strain_rates(i, j).eigen1 < healThreshold) {
+      } else if (strain_rates(i, j).eigen1 < healThreshold) {
         if (fracture_weighted_healing) {
           D_new(i, j) += fdheal * dt * (1 - D(i, j));
         } else {
@@ -405,7 +381,7 @@ void FractureDensity::update(double dt,
 
       // fracture healing rate
       if (geometry.cell_type.icy(i, j)) {
-        if (constant_healing or (m_strain_rates(i, j).eigen1 < healThreshold)) {
+        if (constant_healing or (strain_rates(i, j).eigen1 < healThreshold)) {
           if (fracture_weighted_healing) {
             m_healing_rate(i, j) = fdheal * (1 - D(i, j));
           } else {
@@ -23,14 +23,16 @@
 #include "pism/rheology/FlowLaw.hh"
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/array/Vector.hh"
-#include "pism/util/array/Array2D.hh"
-#include "pism/stressbalance/StressBalance.hh"
 
 namespace pism {
 
 class Grid;
 class Geometry;
 
+namespace stressbalance {
+class VelocityDerivedFields;
+} // end of namespace stressbalance
+
 class FractureDensity : public Component {
 public:
   FractureDensity(std::shared_ptr<const Grid> grid, std::shared_ptr<const rheology::FlowLaw> flow_law);
@@ -45,7 +47,8 @@ public:
               const Geometry &geometry,
               const array::Vector &velocity,
               const array::Scalar &hardness,
-              const array::Scalar &inflow_boundary_mask);
+              const array::Scalar &inflow_boundary_mask,
+              const stressbalance::VelocityDerivedFields &velocity_derived_fields);
 
   const array::Scalar& density() const;
   const array::Scalar& growth_rate() const;
@@ -70,12 +73,6 @@ private:
   array::Scalar m_age_new;
   array::Scalar m_toughness;
 
-  //! major and minor principal components of horizontal strain-rate tensor (temporary storage)
-  array::Array2D<stressbalance::PrincipalStrainRates> m_strain_rates;
-
-  //! components of horizontal stress tensor along axes and shear stress (temporary storage)
-  array::Array2D<stressbalance::DeviatoricStresses> m_deviatoric_stresses;
-
   //! Ghosted copy of the ice velocity
   array::Vector1 m_velocity;
 
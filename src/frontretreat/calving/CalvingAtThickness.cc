@@ -125,6 +125,9 @@ void CalvingAtThickness::update(double t,
 
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
+
+  cell_type.inc_state_counter();
+  ice_thickness.inc_state_counter();
 }
 
 const array::Scalar& CalvingAtThickness::threshold() const {
@@ -22,7 +22,7 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/array/CellType.hh"
-#include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityDerivedFields.hh"
 
 namespace pism {
 namespace calving {
@@ -49,16 +49,17 @@ void EigenCalving::init() {
                                   m_grid->dx(), m_grid->dy(),
                                   fabs(m_grid->dx() - m_grid->dy()) / std::max(m_grid->dx(), m_grid->dy()));
   }
-
-  m_strain_rates.set(0.0);
 }
 
 //! \brief Uses principal strain rates to apply "eigencalving" with constant K.
 /*!
   See equation (26) in [\ref Winkelmannetal2011].
+
+  Principal strain rates are computed by the stress balance model (see
+  VelocityDerivedFields) and shared with other calving and fracture density models.
 */
-void EigenCalving::update(const array::CellType &cell_type,
-                          const array::Vector1 &ice_velocity) {
+void EigenCalving::update(const array::CellType1 &cell_type,
+                          const stressbalance::VelocityDerivedFields &velocity_derived_fields) {
 
   // make a copy with a wider stencil
   m_cell_type.copy_from(cell_type);
@@ -71,11 +72,9 @@ void EigenCalving::update(const array::CellType &cell_type,
   // regime
   const double eigenCalvOffset = 0.0;
 
-  stressbalance::compute_2D_principal_strain_rates(ice_velocity, m_cell_type,
-                                                   m_strain_rates);
-  m_strain_rates.update_ghosts();
+  const auto &strain_rates = velocity_derived_fields.principal_strain_rates(cell_type);
 
-  array::AccessScope list{&m_cell_type, &m_calving_rate, &m_strain_rates};
+  array::AccessScope list{&m_cell_type, &m_calving_rate, &strain_rates};
 
   // Compute the horizontal calving rate
   for (auto pt = m_grid->points(); pt; pt.next()) {
@@ -95,8 +94,8 @@ void EigenCalving::update(const array::CellType &cell_type,
         for (int p = -1; p < 2; p += 2) {
           const int I = i + p * offset;
           if (m_cell_type.floating_ice(I, j) and not m_cell_type.ice_margin(I, j)) {
-            eigen1 += m_strain_rates(I, j).eigen1;
-            eigen2 += m_strain_rates(I, j).eigen2;
+            eigen1 += strain_rates(I, j).eigen1;
+            eigen2 += strain_rates(I, j).eigen2;
             N += 1;
           }
         }
@@ -104,8 +103,8 @@ void EigenCalving::update(const array::CellType &cell_type,
         for (int q = -1; q < 2; q += 2) {
           const int J = j + q * offset;
           if (m_cell_type.floating_ice(i, J) and not m_cell_type.ice_margin(i, J)) {
-            eigen1 += m_strain_rates(i, J).eigen1;
-            eigen2 += m_strain_rates(i, J).eigen2;
+            eigen1 += strain_rates(i, J).eigen1;
+            eigen2 += strain_rates(i, J).eigen2;
             N += 1;
           }
         }
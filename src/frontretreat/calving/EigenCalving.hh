@@ -32,7 +32,8 @@ public:
 
   void init();
 
-  void update(const array::CellType &cell_type, const array::Vector1 &ice_velocity);
+  void update(const array::CellType1 &cell_type,
+              const stressbalance::VelocityDerivedFields &velocity_derived_fields);
 protected:
   DiagnosticList diagnostics_impl() const;
 
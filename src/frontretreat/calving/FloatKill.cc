@@ -85,6 +85,9 @@ void FloatKill::update(array::Scalar &cell_type, array::Scalar &ice_thickness) {
 
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
+
+  cell_type.inc_state_counter();
+  ice_thickness.inc_state_counter();
 }
 
 } // end of namespace calving
@@ -26,21 +26,10 @@ StressCalving::StressCalving(std::shared_ptr<const Grid> grid,
                              unsigned int stencil_width)
   : Component(grid),
     m_stencil_width(stencil_width),
-    m_strain_rates(m_grid, "strain_rates", array::WITH_GHOSTS, 2),
     m_calving_rate(m_grid, "calving_rate"),
     m_cell_type(m_grid, "cell_type")
 {
 
-  m_strain_rates.metadata(0).set_name("eigen1");
-  m_strain_rates.metadata(0)
-      .long_name("major principal component of horizontal strain-rate")
-      .units("second-1");
-
-  m_strain_rates.metadata(1).set_name("eigen2");
-  m_strain_rates.metadata(1)
-      .long_name("minor principal component of horizontal strain-rate")
-      .units("second-1");
-
   m_calving_rate.metadata(0)
       .long_name("horizontal calving rate")
       .units("m s-1")
@@ -22,12 +22,14 @@
 
 #include "pism/util/Component.hh"
 #include "pism/util/array/Scalar.hh"
-#include "pism/util/array/Array2D.hh"
 #include "pism/util/array/CellType.hh"
-#include "pism/stressbalance/StressBalance.hh" // struct PrincipalStrainRates
 
 namespace pism {
 
+namespace stressbalance {
+class VelocityDerivedFields;
+} // end of namespace stressbalance
+
 namespace calving {
 
 /*! @brief An abstract class containing fields used by all stress-based calving methods. */
@@ -41,8 +43,6 @@ public:
 protected:
   const int m_stencil_width;
 
-  array::Array2D<stressbalance::PrincipalStrainRates> m_strain_rates;
-
   array::Scalar m_calving_rate;
 
   array::CellType1 m_cell_type;
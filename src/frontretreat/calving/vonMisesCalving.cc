@@ -26,7 +26,7 @@
 #include "pism/util/error_handling.hh"
 #include "pism/util/array/CellType.hh"
 #include "pism/util/array/Vector.hh"
-#include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityDerivedFields.hh"
 #include "pism/rheology/FlowLawFactory.hh"
 #include "pism/rheology/FlowLaw.hh"
 #include "pism/geometry/Geometry.hh"
@@ -90,8 +90,6 @@ void vonMisesCalving::init() {
                                   m_grid->dx(), m_grid->dy(),
                                   fabs(m_grid->dx() - m_grid->dy()) / std::max(m_grid->dx(), m_grid->dy()));
   }
-
-  m_strain_rates.set(0.0);
 }
 
 //! \brief Uses principal strain rates to apply the "von Mises" calving method
@@ -101,7 +99,8 @@ void vonMisesCalving::init() {
 void vonMisesCalving::update(const array::CellType1 &cell_type,
                              const array::Scalar &ice_thickness,
                              const array::Vector1 &ice_velocity,
-                             const array::Array3D &ice_enthalpy) {
+                             const array::Array3D &ice_enthalpy,
+                             const stressbalance::VelocityDerivedFields &velocity_derived_fields) {
 
   using std::max;
   using std::sqrt;
@@ -113,12 +112,10 @@ void vonMisesCalving::update(const array::CellType1 &cell_type,
   // make a copy with a wider stencil
   m_cell_type.copy_from(cell_type);
 
-  stressbalance::compute_2D_principal_strain_rates(ice_velocity, m_cell_type,
-                                                   m_strain_rates);
-  m_strain_rates.update_ghosts();
+  const auto &strain_rates = velocity_derived_fields.principal_strain_rates(cell_type);
 
   array::AccessScope list{&ice_enthalpy, &ice_thickness, &m_cell_type, &ice_velocity,
-                               &m_strain_rates, &m_calving_rate, &m_calving_threshold};
+                               &strain_rates, &m_calving_rate, &m_calving_threshold};
 
   const double *z = m_grid->z().data();
 
@@ -149,8 +146,8 @@ void vonMisesCalving::update(const array::CellType1 &cell_type,
               auto k = m_grid->kBelowHeight(H);
               hardness += averaged_hardness(*m_flow_law, H, k, z, ice_enthalpy.get_column(I, j));
             }
-            eigen1 += m_strain_rates(I, j).eigen1;
-            eigen2 += m_strain_rates(I, j).eigen2;
+            eigen1 += strain_rates(I, j).eigen1;
+            eigen2 += strain_rates(I, j).eigen2;
             N += 1;
           }
         }
@@ -164,8 +161,8 @@ void vonMisesCalving::update(const array::CellType1 &cell_type,
               auto k = m_grid->kBelowHeight(H);
               hardness += averaged_hardness(*m_flow_law, H, k, z, ice_enthalpy.get_column(i, J));
             }
-            eigen1 += m_strain_rates(i, J).eigen1;
-            eigen2 += m_strain_rates(i, J).eigen2;
+            eigen1 += strain_rates(i, J).eigen1;
+            eigen2 += strain_rates(i, J).eigen2;
             N += 1;
           }
         }
@@ -42,7 +42,8 @@ public:
   void update(const array::CellType1 &cell_type,
               const array::Scalar &ice_thickness,
               const array::Vector1 &ice_velocity,
-              const array::Array3D &ice_enthalpy);
+              const array::Array3D &ice_enthalpy,
+              const stressbalance::VelocityDerivedFields &velocity_derived_fields);
   const array::Scalar& threshold() const;
 
 protected:
@@ -118,6 +118,9 @@ void IcebergRemover::update_impl(const array::Scalar &bc_mask,
   // elevation can be updated redundantly)
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
+
+  cell_type.inc_state_counter();
+  ice_thickness.inc_state_counter();
 }
 
 } // end of namespace calving
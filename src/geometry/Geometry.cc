@@ -19,6 +19,9 @@
 
 #include "pism/geometry/Geometry.hh"
 
+#include <array>
+#include <limits>
+
 #include "pism/util/array/CellType.hh"
 #include "pism/util/Mask.hh"
 #include "pism/util/pism_utilities.hh"
@@ -42,7 +45,10 @@ Geometry::Geometry(const std::shared_ptr<const Grid> &grid)
     ice_area_specific_volume(grid, "ice_area_specific_volume"),
     cell_type(grid, "mask"),
     cell_grounded_fraction(grid, "cell_grounded_fraction"),
-    ice_surface_elevation(grid, "usurf") {
+    ice_surface_elevation(grid, "usurf"),
+    m_last_threshold(0.0),
+    m_cell_type_state(std::numeric_limits<uint64_t>::max()),
+    m_surface_state(std::numeric_limits<uint64_t>::max()) {
 
   latitude.metadata(0)
       .long_name("latitude")
@@ -109,30 +115,127 @@ Geometry::Geometry(const std::shared_ptr<const Grid> &grid)
   ensure_consistency(0.0);
 }
 
+/*!
+ * Cell type and surface elevation at a grid point depend only on sea level, bed elevation
+ * and ice thickness *at this point*. This makes it possible to re-compute them only where
+ * one of these inputs changed since the last call.
+ *
+ * Changes are detected by comparing inputs to their copies saved during the last call, so
+ * code modifying ice geometry does not need to do anything special. Everything is
+ * re-computed if the ice free thickness threshold changed or if `cell_type` or
+ * `ice_surface_elevation` were modified elsewhere (i.e. their state counters changed).
+ *
+ * Ghosts of a field are updated only if it changed on at least one sub-domain (this
+ * requires one reduction instead of up to four ghost exchanges).
+ */
 void Geometry::ensure_consistency(double ice_free_thickness_threshold) {
   auto grid = ice_thickness.grid();
   Config::ConstPtr config = grid->ctx()->config();
 
-  array::AccessScope list{&sea_level_elevation, &bed_elevation,
-      &ice_thickness, &ice_area_specific_volume,
-      &cell_type, &ice_surface_elevation};
+  const int
+    xs = grid->xs(),
+    xm = grid->xm(),
+    ys = grid->ys(),
+    N  = 4;                     // number of inputs per grid point
+
+  const bool recompute_all = (m_last_inputs.size() != (size_t)(N * xm * grid->ym()) or
+                              ice_free_thickness_threshold != m_last_threshold or
+                              cell_type.state_counter() != m_cell_type_state or
+                              ice_surface_elevation.state_counter() != m_surface_state);
+  if (recompute_all) {
+    m_last_inputs.resize(N * xm * grid->ym());
+  }
+
+  // flags: 0 - ice thickness, 1 - ice area specific volume, 2 - cell type, 3 - surface
+  // elevation, 4 - bed elevation or sea level, 5 - ice area specific volume has to be
+  // added to ice thickness
+  int changed[6] = {0, 0, 0, 0, 0, 0};
+  if (recompute_all) {
+    for (int k = 0; k < 5; ++k) {
+      changed[k] = 1;
+    }
+  }
+
+  GeometryCalculator gc(*config);
+  gc.set_icefree_thickness(ice_free_thickness_threshold);
+
+  // Grid points where the cell type or the ice thickness have to be modified. These
+  // modifications are rare, so they are applied after the main loop. This way fields that
+  // did not change are accessed using const references and their state counters (and so
+  // ghost exchanges, see array::Array::update_ghosts()) are not affected.
+  std::vector<std::array<int, 3> > new_cell_type;
+  std::vector<std::array<int, 2> > add_volume;
 
-  // first ensure that ice_area_specific_volume is 0 if ice_thickness > 0.
+  // Compute cell type and surface elevation where inputs changed. Note that ice area
+  // specific volume is added to ice thickness if ice_thickness > 0.
   {
+    const Geometry &inputs = *this;
+
+    array::AccessScope list{&inputs.sea_level_elevation, &inputs.bed_elevation,
+        &inputs.ice_thickness, &inputs.ice_area_specific_volume,
+        &inputs.cell_type, &ice_surface_elevation};
+
     ParallelSection loop(grid->com);
     try {
       for (auto p = grid->points(); p; p.next()) {
         const int i = p.i(), j = p.j();
 
-        if (ice_thickness(i, j) < 0.0) {
+        double
+          H = inputs.ice_thickness(i, j),
+          V = inputs.ice_area_specific_volume(i, j);
+
+        if (H < 0.0) {
           throw RuntimeError::formatted(PISM_ERROR_LOCATION,
                                         "H = %e (negative) at point i=%d, j=%d",
-                                        ice_thickness(i, j), i, j);
+                                        H, i, j);
         }
 
-        if (ice_thickness(i, j) > 0.0 and ice_area_specific_volume(i, j) > 0.0) {
-          ice_thickness(i, j) += ice_area_specific_volume(i, j);
-          ice_area_specific_volume(i, j) = 0.0;
+        if (H > 0.0 and V > 0.0) {
+          H += V;
+          V = 0.0;
+          add_volume.push_back({i, j});
+          changed[5] = 1;
+        }
+
+        const double
+          sea_level = inputs.sea_level_elevation(i, j),
+          bed       = inputs.bed_elevation(i, j);
+
+        double *last = &m_last_inputs[N * ((i - xs) + xm * (j - ys))];
+
+        // note: these comparisons are false if an input is NaN, so NaNs count as changes
+        const bool
+          H_unchanged = (H == last[2]),
+          V_unchanged = (V == last[3]),
+          unchanged   = (sea_level == last[0] and bed == last[1] and H_unchanged);
+
+        if (not recompute_all and unchanged and V_unchanged) {
+          continue;
+        }
+
+        changed[0] |= H_unchanged ? 0 : 1;
+        changed[1] |= V_unchanged ? 0 : 1;
+        changed[4] |= (sea_level == last[0] and bed == last[1]) ? 0 : 1;
+
+        last[0] = sea_level;
+        last[1] = bed;
+        last[2] = H;
+        last[3] = V;
+
+        if (recompute_all or not unchanged) {
+          int mask = 0;
+          double surface = 0.0;
+          gc.compute(sea_level, bed, H, &mask, &surface);
+
+          if (mask != inputs.cell_type.as_int(i, j)) {
+            new_cell_type.push_back({i, j, mask});
+            changed[2] = 1;
+          }
+
+          if (surface != ice_surface_elevation(i, j)) {
+            ice_surface_elevation(i, j) = surface;
+            changed[3] = 1;
+          }
         }
       }
     } catch (...) {
@@ -141,31 +244,55 @@ void Geometry::ensure_consistency(double ice_free_thickness_threshold) {
     loop.check();
   }
 
-  // compute cell type and surface elevation
-  {
-    GeometryCalculator gc(*config);
-    gc.set_icefree_thickness(ice_free_thickness_threshold);
+  int changed_global[6] = {0, 0, 0, 0, 0, 0};
+  GlobalMax(grid->com, changed, changed_global, 6);
 
-    ParallelSection loop(grid->com);
-    try {
-      for (auto p = grid->points(); p; p.next()) {
-        const int i = p.i(), j = p.j();
+  // Apply modifications. Note that fields are accessed using non-const pointers on *all*
+  // sub-domains so that their state counters stay in sync.
+  if (changed_global[5] != 0) {
+    array::AccessScope list{&ice_thickness, &ice_area_specific_volume};
 
-        int mask = 0;
-        gc.compute(sea_level_elevation(i, j), bed_elevation(i, j), ice_thickness(i, j),
-                   &mask, &ice_surface_elevation(i, j));
-        cell_type(i, j) = mask;
-      }
-    } catch (...) {
-      loop.failed();
+    for (const auto &p : add_volume) {
+      const int i = p[0], j = p[1];
+
+      ice_thickness(i, j) += ice_area_specific_volume(i, j);
+      ice_area_specific_volume(i, j) = 0.0;
     }
-    loop.check();
   }
 
-  ice_thickness.update_ghosts();
-  ice_area_specific_volume.update_ghosts();
-  cell_type.update_ghosts();
-  ice_surface_elevation.update_ghosts();
+  if (changed_global[2] != 0) {
+    // note: fields computed using the cell type mask (e.g. strain rates used by calving
+    // models) are re-computed when its state counter changes
+    array::AccessScope list{&cell_type};
+
+    for (const auto &p : new_cell_type) {
+      cell_type(p[0], p[1]) = p[2];
+    }
+  }
+
+  // Update ghosts of fields that changed on at least one sub-domain (update_ghosts() does
+  // nothing if ghosts are up to date).
+  if (changed_global[0] != 0 or changed_global[5] != 0) {
+    ice_thickness.update_ghosts();
+  }
+  if (changed_global[1] != 0 or changed_global[5] != 0) {
+    ice_area_specific_volume.update_ghosts();
+  }
+  if (changed_global[2] != 0) {
+    cell_type.update_ghosts();
+  }
+  if (changed_global[3] != 0) {
+    ice_surface_elevation.update_ghosts();
+  }
+
+  m_last_threshold = ice_free_thickness_threshold;
+  m_cell_type_state = cell_type.state_counter();
+  m_surface_state   = ice_surface_elevation.state_counter();
+
+  if (changed_global[0] == 0 and changed_global[4] == 0) {
+    // the cell grounded fraction depends on ice thickness, bed elevation and sea level only
+    return;
+  }
 
   const double
     ice_density = config->get_number("constants.ice.density"),
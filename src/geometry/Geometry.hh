@@ -20,6 +20,8 @@
 #ifndef GEOMETRY_H
 #define GEOMETRY_H
 
+#include <vector>
+
 #include "pism/util/array/CellType.hh"
 
 namespace pism {
@@ -33,6 +35,9 @@ public:
   /*!
    * Ensures consistency of ice geometry by re-computing cell type, cell grounded fraction, and ice
    * surface elevation.
+   *
+   * Only cells where bed elevation, sea level or ice thickness changed since the last call
+   * are re-computed and only fields that changed are communicated.
    */
   void ensure_consistency(double ice_free_thickness_threshold);
 
@@ -57,6 +62,16 @@ public:
   array::Scalar2 ice_surface_elevation;
 
   void dump(const char *filename) const;
+
+private:
+  //! Sea level, bed elevation, ice thickness and ice area specific volume (interleaved) at
+  //! points of the local sub-domain, as of the last call to ensure_consistency().
+  std::vector<double> m_last_inputs;
+  //! Ice free thickness threshold used by the last call to ensure_consistency().
+  double m_last_threshold;
+  //! State counters of cell_type and ice_surface_elevation after the last call to
+  //! ensure_consistency().
+  uint64_t m_cell_type_state, m_surface_state;
 };
 
 void ice_bottom_surface(const Geometry &geometry, array::Scalar &result);
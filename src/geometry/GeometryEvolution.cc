@@ -80,9 +80,8 @@ struct GeometryEvolution::Impl {
   array::Staggered1 flux_staggered;
 
   // Work space
+  array::Staggered2 flux_unlimited;    // flux before limiting (width=2 ghosts)
   array::Vector1 input_velocity;       // a ghosted copy; not modified
-  array::Scalar1 bed_elevation;        // a copy; not modified
-  array::Scalar1 sea_level;            // a copy; not modified
   array::Scalar1 ice_thickness;        // updated in place
   array::Scalar1 area_specific_volume; // updated in place
   array::Scalar1 surface_elevation;    // updated to maintain consistency
@@ -100,9 +99,8 @@ GeometryEvolution::Impl::Impl(std::shared_ptr<const Grid> grid)
       thickness_change(grid, "thickness_change"),
       ice_area_specific_volume_change(grid, "ice_area_specific_volume_change"),
       flux_staggered(grid, "flux_staggered"),
+      flux_unlimited(grid, "flux_unlimited"),
       input_velocity(grid, "input_velocity"),
-      bed_elevation(grid, "bed_elevation"),
-      sea_level(grid, "sea_level"),
       ice_thickness(grid, "ice_thickness"),
       area_specific_volume(grid, "area_specific_volume"),
       surface_elevation(grid, "surface_elevation"),
@@ -123,7 +121,9 @@ GeometryEvolution::Impl::Impl(std::shared_ptr<const Grid> grid)
 
   // reported quantities
   {
-    // This is the only reported field that is ghosted (we need ghosts to compute flux divergence).
+    // This is the only reported field that is ghosted (we need ghosts to compute flux
+    // divergence). Note that only ghosts used by Staggered1::star() at points of the
+    // sub-domain are valid (see compute_flux_divergence()).
     flux_staggered.metadata(0)
         .long_name("fluxes through cell interfaces (sides) on the staggered grid (x-offset)")
         .units("m2 s-1")
@@ -160,14 +160,17 @@ GeometryEvolution::Impl::Impl(std::shared_ptr<const Grid> grid)
 
   // internal storage
   {
+    flux_unlimited.metadata(0)
+        .long_name("fluxes through cell interfaces before limiting (x-offset)")
+        .units("m2 s-1");
+    flux_unlimited.metadata(1)
+        .long_name("fluxes through cell interfaces before limiting (y-offset)")
+        .units("m2 s-1");
+
     input_velocity.metadata(0)
         .long_name("ghosted copy of the input velocity")
         .units("meters / second");
 
-    bed_elevation.metadata(0).long_name("ghosted copy of the bed elevation").units("meters");
-
-    sea_level.metadata(0).long_name("ghosted copy of the sea level elevation").units("meters");
-
     ice_thickness.metadata(0)
         .long_name("working (ghosted) copy of the ice thickness")
         .units("meters");
@@ -177,10 +180,10 @@ GeometryEvolution::Impl::Impl(std::shared_ptr<const Grid> grid)
         .units("meters3 / meters2");
 
     surface_elevation.metadata(0)
-        .long_name("working (ghosted) copy of the surface elevation")
+        .long_name("working (ghosted) surface elevation")
         .units("meters");
 
-    cell_type.metadata(0).long_name("working (ghosted) copy of the cell type mask");
+    cell_type.metadata(0).long_name("working (ghosted) cell type mask");
 
     residual.metadata(0).long_name("residual area specific volume").units("meters3 / meters2");
 
@@ -246,6 +249,14 @@ const array::Scalar &GeometryEvolution::conservation_error() const {
  * @param[in] thickness_bc_mask ice thickness Dirichlet B.C. mask
  *
  * Results are stored in internal fields accessible using getters.
+ *
+ * Uses ghosts of `geometry.ice_thickness`, `geometry.bed_elevation` and
+ * `geometry.sea_level_elevation` (width=1); the caller has to make sure that they are up
+ * to date. (Geometry::ensure_consistency() updates ghosts of ice thickness; copy_from()
+ * and set() update ghosts of bed and sea level elevations.)
+ *
+ * Per time step this method performs two ghost exchanges (the advective velocity and
+ * interface fluxes) and does not allocate memory.
  */
 void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
                                   const array::Vector &advective_velocity,
@@ -254,50 +265,44 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
 
   profiling().begin("ge.update_ghosted_copies");
   {
-    // make ghosted copies of input fields
-    m_impl->ice_thickness.copy_from(geometry.ice_thickness);
-    m_impl->area_specific_volume.copy_from(geometry.ice_area_specific_volume);
-    m_impl->sea_level.copy_from(geometry.sea_level_elevation);
-    m_impl->bed_elevation.copy_from(geometry.bed_elevation);
+    // make a ghosted copy of the advective velocity: stress balance models do not
+    // guarantee that its ghosts are up to date
     m_impl->input_velocity.copy_from(advective_velocity);
 
-    // Compute cell_type and surface_elevation. Ghosts of results are updated.
-    m_impl->gc.compute(m_impl->sea_level,          // in (uses ghosts)
-                       m_impl->bed_elevation,      // in (uses ghosts)
-                       m_impl->ice_thickness,      // in (uses ghosts)
-                       m_impl->cell_type,          // out (ghosts are updated)
-                       m_impl->surface_elevation); // out (ghosts are updated)
+    // Compute cell_type (including ghosts) using the ice thickness threshold of this
+    // class. This uses ghosts of inputs and requires no communication.
+    m_impl->gc.compute_mask(geometry.sea_level_elevation, // in (uses ghosts)
+                            geometry.bed_elevation,       // in (uses ghosts)
+                            geometry.ice_thickness,       // in (uses ghosts)
+                            m_impl->cell_type);           // out (including ghosts)
+
+    if (m_impl->use_part_grid) {
+      m_impl->gc.compute_surface(geometry.sea_level_elevation, // in (uses ghosts)
+                                 geometry.bed_elevation,       // in (uses ghosts)
+                                 geometry.ice_thickness,       // in (uses ghosts)
+                                 m_impl->surface_elevation);   // out (including ghosts)
+    }
   }
   profiling().end("ge.update_ghosted_copies");
 
   // Derived classes can include modifications for regional runs.
   profiling().begin("ge.interface_fluxes");
   compute_interface_fluxes(m_impl->cell_type,       // in (uses ghosts)
-                           m_impl->ice_thickness,   // in (uses ghosts)
+                           geometry.ice_thickness,  // in (uses ghosts)
                            m_impl->input_velocity,  // in (uses ghosts)
                            diffusive_flux,          // in
-                           m_impl->flux_staggered); // out
+                           m_impl->flux_unlimited); // out
   profiling().end("ge.interface_fluxes");
 
-  m_impl->flux_staggered.update_ghosts();
-
-  {
-    // allocate temporary storage (FIXME: at some point I should evaluate whether it's OK
-    // to allocate this every time step)
-    array::Staggered flux_limited(m_grid, "limited_ice_flux");
-
-    make_nonnegative_preserving(dt,
-                                m_impl->ice_thickness,  // in (uses ghosts)
-                                m_impl->flux_staggered, // in (uses ghosts)
-                                flux_limited);
-
-    m_impl->flux_staggered.copy_from(flux_limited);
-  }
+  // the only ghost exchange of fluxes
+  m_impl->flux_unlimited.update_ghosts();
 
   profiling().begin("ge.flux_divergence");
   compute_flux_divergence(dt,                         // in
-                          m_impl->flux_staggered,     // in (uses ghosts)
+                          geometry.ice_thickness,     // in (uses ghosts)
+                          m_impl->flux_unlimited,     // in (uses ghosts)
                           thickness_bc_mask,          // in
+                          m_impl->flux_staggered,     // out
                           m_impl->conservation_error, // in/out
                           m_impl->flux_divergence);   // out
   profiling().end("ge.flux_divergence");
@@ -305,11 +310,10 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
   // This is where part_grid is implemented.
   profiling().begin("ge.update_in_place");
   update_in_place(dt,                            // in
-                  m_impl->bed_elevation,         // in
-                  m_impl->sea_level,             // in
+                  geometry,                      // in
                   m_impl->flux_divergence,       // in
-                  m_impl->ice_thickness,         // in/out
-                  m_impl->area_specific_volume); // in/out
+                  m_impl->ice_thickness,         // out
+                  m_impl->area_specific_volume); // out
   profiling().end("ge.update_in_place");
 
   // Compute ice thickness and area specific volume changes.
@@ -582,7 +586,6 @@ void GeometryEvolution::compute_interface_fluxes(const array::CellType1 &cell_ty
 
   ParallelSection loop(m_grid->com);
   try {
-    // compute advective fluxes and put them in output
     for (auto p = m_grid->points(); p; p.next()) {
       const int i = p.i(), j = p.j(), M = cell_type(i, j);
 
@@ -611,30 +614,11 @@ void GeometryEvolution::compute_interface_fluxes(const array::CellType1 &cell_ty
         const double H_n         = ice_thickness(i_n, j_n),
                      Q_advective = v * (v > 0.0 ? H : H_n); // first order upwinding
 
-        output(i, j, n) = Q_advective;
+        // limit the advective flux and add the diffusive flux to it to get the total
+        output(i, j, n) = limit_diffusive_flux(M, M_n, diffusive_flux(i, j, n)) +
+                          limit_advective_flux(M, M_n, Q_advective);
       } // end of the loop over neighbors (n)
     }
-
-    // limit the advective flux and add the diffusive flux to it to get the total
-    for (auto p = m_grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j(), M = cell_type(i, j);
-
-      for (int n = 0; n < 2; ++n) {
-        const int oi = 1 - n,  // offset in the i direction
-            oj       = n,      // offset in the j direction
-            i_n      = i + oi, // i index of a neighbor
-            j_n      = j + oj; // j index of a neighbor
-
-        const int M_n = cell_type(i_n, j_n);
-
-        // diffusive flux
-        const double Q_diffusive = limit_diffusive_flux(M, M_n, diffusive_flux(i, j, n)),
-                     Q_advective = limit_advective_flux(M, M_n, output(i, j, n));
-
-        output(i, j, n) = Q_diffusive + Q_advective;
-      } // end of the loop over n
-    }
-
   } catch (...) {
     loop.failed();
   }
@@ -642,81 +626,120 @@ void GeometryEvolution::compute_interface_fluxes(const array::CellType1 &cell_ty
 }
 
 /*!
- * Compute flux divergence using cell interface fluxes on the staggered grid.
+ * Limit interface fluxes `flux` to preserve non-negativity of ice thickness (see
+ * make_nonnegative_preserving()) and compute the flux divergence using limited fluxes.
+ *
+ * Limited fluxes through interfaces on the western and southern edges of the sub-domain
+ * are computed using ghosts of `flux` (this is why it has to have width=2 ghosts) and
+ * stored in ghosts of `limited_flux`, so no ghost exchange is needed.
  *
  * The flux divergence at *ice thickness* Dirichlet B.C. locations is set to zero.
  */
-void GeometryEvolution::compute_flux_divergence(double dt, const array::Staggered1 &flux,
+void GeometryEvolution::compute_flux_divergence(double dt,
+                                                const array::Scalar1 &ice_thickness,
+                                                const array::Staggered2 &flux,
                                                 const array::Scalar &thickness_bc_mask,
+                                                array::Staggered1 &limited_flux,
                                                 array::Scalar &conservation_error,
                                                 array::Scalar &output) {
   const double dx = m_grid->dx(), dy = m_grid->dy();
 
-  array::AccessScope list{ &flux, &thickness_bc_mask, &conservation_error, &output };
+  const int
+    xs = m_grid->xs(),
+    xm = m_grid->xm(),
+    ys = m_grid->ys(),
+    ym = m_grid->ym();
+
+  array::AccessScope list{ &ice_thickness, &flux, &thickness_bc_mask, &limited_flux,
+                           &conservation_error, &output };
+
+  int limiter_count = 0;
 
   ParallelSection loop(m_grid->com);
   try {
-    for (auto p = m_grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
+    // Note: loops start at the column and the row of ghosts to the west and to the south
+    // of the sub-domain. Limited fluxes through the western and southern interfaces of
+    // the cell (i, j) are computed by earlier iterations.
+    for (int j = ys - 1; j < ys + ym; ++j) {
+      for (int i = xs - 1; i < xs + xm; ++i) {
+
+        // limit fluxes through the eastern and northern interfaces of the cell (i, j)
+        bool limited = nonnegative_preserving_flux(dt, dx, dy, ice_thickness, flux, i, j,
+                                                   limited_flux(i, j, 0),
+                                                   limited_flux(i, j, 1));
+
+        if (i < xs or j < ys) {
+          // the cell (i, j) is not in this sub-domain
+          continue;
+        }
 
-      auto Q = flux.star(i, j);
+        limiter_count += limited ? 1 : 0;
 
-      double divQ = (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
+        auto Q = limited_flux.star(i, j);
 
-      if (thickness_bc_mask(i, j) > 0.5) {
-        // the thickness change would have been equal to -divQ*dt. By keeping ice
-        // thickness fixed we *add* divQ*dt meters of ice.
-        conservation_error(i, j) += divQ * dt; // units: meters
-        output(i, j) = 0.0;
-      } else {
-        output(i, j) = divQ;
+        double divQ = (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
+
+        if (thickness_bc_mask(i, j) > 0.5) {
+          // the thickness change would have been equal to -divQ*dt. By keeping ice
+          // thickness fixed we *add* divQ*dt meters of ice.
+          conservation_error(i, j) += divQ * dt; // units: meters
+          output(i, j) = 0.0;
+        } else {
+          output(i, j) = divQ;
+        }
       }
     }
   } catch (...) {
     loop.failed();
   }
   loop.check();
+
+  limiter_count = GlobalSum(m_grid->com, limiter_count);
+  if (limiter_count > 0) {
+    m_log->message(2, "limited ice flux at %d locations\n", limiter_count);
+  }
 }
 
 /*!
- * Update ice thickness and area_specific_volume *in place*.
+ * Compute ice thickness and area_specific_volume after the flow step.
  *
  * It would be better to compute the change in ice thickness and area_specific_volume and then apply
- * them, but it would require re-writing all the part-grid code from scratch. So, I make copies of
- * ice thickness and area_specific_volume, use this old code, then compute differences to get changes.
- * Compute ice thickness changes due to the flow of the ice.
+ * them, but it would require re-writing all the part-grid code from scratch. So, I update
+ * copies of ice thickness and area_specific_volume, use this old code, then compute
+ * differences to get changes.
+ *
+ * Assumes that the cell type mask (and surface elevation, if the part-grid scheme is
+ * enabled) in the work space correspond to `geometry`.
  *
  * @param[in] dt time step, seconds
- * @param[in] bed_elevation bed elevation, meters
- * @param[in] sea_level sea level elevation
- * @param[in] ice_thickness ice thickness
- * @param[in] area_specific_volume area-specific volume (m3/m2)
+ * @param[in] geometry ice geometry at the beginning of the time step
  * @param[in] flux_divergence flux divergence
- * @param[out] thickness_change ice thickness change due to flow
- * @param[out] area_specific_volume_change area specific volume change due to flow
+ * @param[out] ice_thickness ice thickness
+ * @param[out] area_specific_volume area-specific volume (m3/m2)
  */
-void GeometryEvolution::update_in_place(double dt, const array::Scalar &bed_topography,
-                                        const array::Scalar &sea_level,
+void GeometryEvolution::update_in_place(double dt,
+                                        const Geometry &geometry,
                                         const array::Scalar &flux_divergence,
                                         array::Scalar &ice_thickness,
                                         array::Scalar &area_specific_volume) {
 
-  m_impl->gc.compute(sea_level, bed_topography, ice_thickness, m_impl->cell_type,
-                     m_impl->surface_elevation);
+  const auto &bed_topography = geometry.bed_elevation;
+  const auto &sea_level      = geometry.sea_level_elevation;
+  const auto &H_old          = geometry.ice_thickness;
+  const auto &V_old          = geometry.ice_area_specific_volume;
 
-  array::AccessScope list{ &ice_thickness, &flux_divergence };
+  array::AccessScope list{ &H_old, &V_old, &ice_thickness, &area_specific_volume,
+                           &flux_divergence };
 
   if (m_impl->use_part_grid) {
     m_impl->residual.set(0.0);
 
-    // Store ice thickness. We need this copy to make sure that modifying ice_thickness in the loop
-    // below does not affect the computation of the threshold thickness. (Note that
-    // part_grid_threshold_thickness uses neighboring values of the mask, ice thickness, and surface
-    // elevation.)
-    m_impl->thickness.copy_from(ice_thickness);
-
-    list.add({ &area_specific_volume, &m_impl->residual, &m_impl->thickness,
-               &m_impl->surface_elevation, &bed_topography, &m_impl->cell_type });
+    // Note that we use the old ice thickness to compute the threshold thickness, so
+    // updating ice_thickness in the loop below does not affect it.
+    // (part_grid_threshold_thickness uses neighboring values of the mask, ice thickness,
+    // and surface elevation.)
+    list.add({ &m_impl->residual, &m_impl->surface_elevation, &bed_topography,
+               &m_impl->cell_type });
   }
 
   const double Lz = m_grid->Lz();
@@ -726,28 +749,31 @@ void GeometryEvolution::update_in_place(double dt, const array::Scalar &bed_topo
     for (auto p = m_grid->points(); p; p.next()) {
       const int i = p.i(), j = p.j();
 
-      double divQ = flux_divergence(i, j);
+      double
+        divQ = flux_divergence(i, j),
+        H    = H_old(i, j),
+        V    = V_old(i, j);
 
       if (m_impl->use_part_grid) {
         if (m_impl->cell_type.ice_free_ocean(i, j) and m_impl->cell_type.next_to_ice(i, j)) {
           assert(divQ <= 0.0);
           // Add the flow contribution to this partially filled cell.
-          area_specific_volume(i, j) += -divQ * dt;
+          V += -divQ * dt;
 
           double threshold = part_grid_threshold_thickness(
-              m_impl->cell_type.star_int(i, j), m_impl->thickness.star(i, j),
+              m_impl->cell_type.star_int(i, j), H_old.star(i, j),
               m_impl->surface_elevation.star(i, j), bed_topography(i, j));
 
           // if threshold is zero, turn all the area specific volume into ice thickness, with zero
           // residual
           if (threshold == 0.0) {
-            threshold = area_specific_volume(i, j);
+            threshold = V;
           }
 
-          if (area_specific_volume(i, j) >= threshold) {
-            ice_thickness(i, j) += threshold;
-            m_impl->residual(i, j)     = area_specific_volume(i, j) - threshold;
-            area_specific_volume(i, j) = 0.0;
+          if (V >= threshold) {
+            H += threshold;
+            m_impl->residual(i, j) = V - threshold;
+            V = 0.0;
           }
 
           // In this case the flux goes into the area_specific_volume variable and does not directly
@@ -756,30 +782,32 @@ void GeometryEvolution::update_in_place(double dt, const array::Scalar &bed_topo
         }
       } // end of if (use_part_grid)
 
-      ice_thickness(i, j) += -dt * divQ;
+      H += -dt * divQ;
 
-      if (ice_thickness(i, j) > Lz) {
+      if (H > Lz) {
         throw RuntimeError::formatted(PISM_ERROR_LOCATION,
                                       "ice thickness would exceed Lz at i=%d, j=%d (H=%f, Lz=%f)",
-                                      i, j, ice_thickness(i, j), Lz);
+                                      i, j, H, Lz);
       }
+
+      ice_thickness(i, j)        = H;
+      area_specific_volume(i, j) = V;
     }
   } catch (...) {
     loop.failed();
   }
   loop.check();
 
-  ice_thickness.update_ghosts();
-
-  // Compute the mask corresponding to the new thickness.
-  m_impl->gc.compute_mask(sea_level, bed_topography, ice_thickness, m_impl->cell_type);
-
   /*
     Redistribute residual ice mass from subgrid-scale parameterization.
 
     See [@ref Albrechtetal2011].
   */
   if (m_impl->use_part_grid) {
+    // residual_redistribution_iteration() uses ghosts of ice thickness to compute the
+    // mask corresponding to the new thickness
+    ice_thickness.update_ghosts();
+
     const int max_n_iterations = m_config->get_number("geometry.part_grid.max_iterations");
 
     bool done = false;
@@ -27,8 +27,8 @@
 namespace pism {
 
 /*!
- * NB! Write this in a way that does not use ghosts of input fields (copy to temp. storage and
- * communicate).
+ * NB! This class uses ghosts of Geometry fields instead of making ghosted copies (see
+ * flow_step()). Work space is allocated once, in the constructor.
  *
  * The promise:
  *
@@ -78,8 +78,7 @@ protected:
   virtual void init_impl(const InputOptions &opts);
 
   void update_in_place(double dt,
-                       const array::Scalar& bed_elevation,
-                       const array::Scalar& sea_level,
+                       const Geometry &geometry,
                        const array::Scalar& flux_divergence,
                        array::Scalar& ice_thickness,
                        array::Scalar& area_specific_volume);
@@ -100,10 +99,12 @@ protected:
                                         array::Staggered           &output);
 
   virtual void compute_flux_divergence(double dt,
-                                       const array::Staggered1 &flux_staggered,
+                                       const array::Scalar1 &ice_thickness,
+                                       const array::Staggered2 &flux_staggered,
                                        const array::Scalar &thickness_bc_mask,
+                                       array::Staggered1 &limited_flux,
                                        array::Scalar &conservation_error,
-                                       array::Scalar &flux_fivergence);
+                                       array::Scalar &flux_divergence);
 
   virtual void ensure_nonnegativity(const array::Scalar &ice_thickness,
                                     const array::Scalar &area_specific_volume,
@@ -77,106 +77,118 @@ void make_nonnegative_preserving(double dt,
                                  const array::Staggered1 &flux,
                                  array::Staggered &result) {
 
-  using details::pp;
-  using details::np;
-  using details::flux_out;
-
   auto grid = result.grid();
 
   double
-    eps = std::numeric_limits<double>::epsilon(),
     dx = grid->dx(),
     dy = grid->dy();
 
   array::AccessScope list{&flux, &x, &result};
 
-  // flux divergence
-  auto div = [dx, dy](const stencils::Star<double> &Q) {
-    return (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
-  };
-
   int limiter_count = 0;
 
   for (auto p = grid->points(); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    auto Q   = flux.star(i, j);
-    auto Q_n = flux.star(i, j + 1);
-    auto Q_e = flux.star(i + 1, j);
-
-    const double
-      div_Q   = div(Q),
-      div_Q_e = div(Q_e),
-      div_Q_n = div(Q_n);
-
-    if ((div_Q   <= 0.0 or x(i, j)     - dt * div_Q   >= eps) and
-        (div_Q_e <= 0.0 or x(i + 1, j) - dt * div_Q_e >= eps) and
-        (div_Q_n <= 0.0 or x(i, j + 1) - dt * div_Q_n >= eps)) {
-      // No need to limit fluxes: total fluxes out of cells (i, j), (i + 1, j), (i, j + 1)
-      // may be able to create a negative thickness, but fluxes *into* these cells make up for it
-      //
-      // Without this check the limiter is a little over-eager and may affect results in
-      // areas where mass conservation is not an issue.
-      result(i, j, 0) = Q.e;
-      result(i, j, 1) = Q.n;
-      continue;
+    if (nonnegative_preserving_flux(dt, dx, dy, x, flux, i, j,
+                                    result(i, j, 0), result(i, j, 1))) {
+      limiter_count += 1;
     }
+  }
 
-    limiter_count += 1;
+  limiter_count = GlobalSum(grid->com, limiter_count);
+  if (limiter_count > 0) {
+    auto log = grid->ctx()->log();
+    log->message(2, "limited ice flux at %d locations\n", limiter_count);
+  }
+}
 
-    // compute total amounts moved *out* of the current cell and its north and east
-    // neighbors over the course of the time step dt
-    //
-    // see equation (A4) in [Smolarkiewicz1989]
-    //
-    // note that we can compute all these using the width=1 stencil because of the way
-    // PISM's staggered grid is set up
-    double F_out   = flux_out(Q, dx, dy, dt);
-    double F_out_n = flux_out(Q_n, dx, dy, dt);
-    double F_out_e = flux_out(Q_e, dx, dy, dt);
-
-    // amounts moved through the eastern and northern cell faces
-    double F_e = Q.e * dt / dx;
-    double F_n = Q.n * dt / dy;
-
-    // Maximum amounts the current cell and its neighbors can lose while maintaining
-    // non-negativity
-    //
-    // Note: we limit total amounts so that
-    //
-    // - if a cell value X is below eps, the flux is zero
-    //
-    // - otherwise the total flux out of a cell can remove at most (X - eps) over the
-    //   course of a time step
-    //
-    // This is needed to avoid small negative values resulting from rounding errors.
-    double X_ij = pp(x(i, j) - eps);
-    double X_e  = pp(x(i + 1, j) - eps);
-    double X_n  = pp(x(i, j + 1) - eps);
+bool nonnegative_preserving_flux(double dt, double dx, double dy,
+                                 const array::Scalar1 &x,
+                                 const array::Staggered1 &flux,
+                                 int i, int j,
+                                 double &result_e, double &result_n) {
+  using details::pp;
+  using details::np;
+  using details::flux_out;
 
-    // limit total amounts (see equation (10) in [Smolarkiewicz1989])
-    double F_e_limited = std::max(std::min(F_e, (pp(F_e) / F_out) * X_ij),
-                                  (-np(F_e) / F_out_e) * X_e);
+  const double eps = std::numeric_limits<double>::epsilon();
 
-    assert(x(i, j) - F_e_limited >= 0);
-    assert(x(i + 1, j) + F_e_limited >= 0);
+  // flux divergence
+  auto div = [dx, dy](const stencils::Star<double> &Q) {
+    return (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
+  };
 
-    double F_n_limited = std::max(std::min(F_n, (pp(F_n) / F_out) * X_ij),
-                                  (-np(F_n) / F_out_n) * X_n);
+  auto Q   = flux.star(i, j);
+  auto Q_n = flux.star(i, j + 1);
+  auto Q_e = flux.star(i + 1, j);
 
-    assert(x(i, j) - F_n_limited >= 0);
-    assert(x(i, j + 1) + F_n_limited >= 0);
+  const double
+    div_Q   = div(Q),
+    div_Q_e = div(Q_e),
+    div_Q_n = div(Q_n);
 
-    // convert back to fluxes:
-    result(i, j, 0) = F_e_limited * dx / dt;
-    result(i, j, 1) = F_n_limited * dy / dt;
+  if ((div_Q   <= 0.0 or x(i, j)     - dt * div_Q   >= eps) and
+      (div_Q_e <= 0.0 or x(i + 1, j) - dt * div_Q_e >= eps) and
+      (div_Q_n <= 0.0 or x(i, j + 1) - dt * div_Q_n >= eps)) {
+    // No need to limit fluxes: total fluxes out of cells (i, j), (i + 1, j), (i, j + 1)
+    // may be able to create a negative thickness, but fluxes *into* these cells make up for it
+    //
+    // Without this check the limiter is a little over-eager and may affect results in
+    // areas where mass conservation is not an issue.
+    result_e = Q.e;
+    result_n = Q.n;
+    return false;
   }
 
-  limiter_count = GlobalSum(grid->com, limiter_count);
-  if (limiter_count > 0) {
-    auto log = grid->ctx()->log();
-    log->message(2, "limited ice flux at %d locations\n", limiter_count);
-  }
+  // compute total amounts moved *out* of the current cell and its north and east
+  // neighbors over the course of the time step dt
+  //
+  // see equation (A4) in [Smolarkiewicz1989]
+  //
+  // note that we can compute all these using the width=1 stencil because of the way
+  // PISM's staggered grid is set up
+  double F_out   = flux_out(Q, dx, dy, dt);
+  double F_out_n = flux_out(Q_n, dx, dy, dt);
+  double F_out_e = flux_out(Q_e, dx, dy, dt);
+
+  // amounts moved through the eastern and northern cell faces
+  double F_e = Q.e * dt / dx;
+  double F_n = Q.n * dt / dy;
+
+  // Maximum amounts the current cell and its neighbors can lose while maintaining
+  // non-negativity
+  //
+  // Note: we limit total amounts so that
+  //
+  // - if a cell value X is below eps, the flux is zero
+  //
+  // - otherwise the total flux out of a cell can remove at most (X - eps) over the
+  //   course of a time step
+  //
+  // This is needed to avoid small negative values resulting from rounding errors.
+  double X_ij = pp(x(i, j) - eps);
+  double X_e  = pp(x(i + 1, j) - eps);
+  double X_n  = pp(x(i, j + 1) - eps);
+
+  // limit total amounts (see equation (10) in [Smolarkiewicz1989])
+  double F_e_limited = std::max(std::min(F_e, (pp(F_e) / F_out) * X_ij),
+                                (-np(F_e) / F_out_e) * X_e);
+
+  assert(x(i, j) - F_e_limited >= 0);
+  assert(x(i + 1, j) + F_e_limited >= 0);
+
+  double F_n_limited = std::max(std::min(F_n, (pp(F_n) / F_out) * X_ij),
+                                (-np(F_n) / F_out_n) * X_n);
+
+  assert(x(i, j) - F_n_limited >= 0);
+  assert(x(i, j + 1) + F_n_limited >= 0);
+
+  // convert back to fluxes:
+  result_e = F_e_limited * dx / dt;
+  result_n = F_n_limited * dy / dt;
+
+  return true;
 }
 
 } // end of namespace pism
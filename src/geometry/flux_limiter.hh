@@ -33,4 +33,16 @@ void make_nonnegative_preserving(double dt,
                                  const array::Staggered1 &flux,
                                  array::Staggered &result);
 
+/*! Compute limited fluxes through the eastern and northern interfaces of the cell (i, j).
+ *
+ * Requires ghosts of `x` and `flux` at (i + 1, j) and (i, j + 1).
+ *
+ * Returns true if fluxes were limited.
+ */
+bool nonnegative_preserving_flux(double dt, double dx, double dy,
+                                 const array::Scalar1 &x,
+                                 const array::Staggered1 &flux,
+                                 int i, int j,
+                                 double &result_e, double &result_n);
+
 } // end of namespace pism
@@ -0,0 +1,345 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "pism/icemodel/DomainCropping.hh"
+
+#include "pism/geometry/Geometry.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/io/io_helpers.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+
+namespace {
+
+//! A rectangular part of the full grid (ranges of grid indices, inclusive).
+struct Box {
+  int i0, j0, i1, j1;
+
+  bool empty() const {
+    return i0 > i1 or j0 > j1;
+  }
+
+  int Mx() const {
+    return i1 - i0 + 1;
+  }
+
+  int My() const {
+    return j1 - j0 + 1;
+  }
+
+  double area() const {
+    return (double)Mx() * (double)My();
+  }
+
+  bool operator==(const Box &other) const {
+    return i0 == other.i0 and j0 == other.j0 and i1 == other.i1 and j1 == other.j1;
+  }
+};
+
+//! Bounding box of icy cells in the full grid. `domain` is the part of the full grid used
+//! by the model.
+Box ice_bounding_box(const Geometry &geometry, const Box &domain) {
+  const auto &cell_type = geometry.cell_type;
+  const auto &grid      = *cell_type.grid();
+
+  // -i, -j, i, j of icy cells (use a maximum to compute all four in one reduction)
+  const int lowest = std::numeric_limits<int>::lowest();
+  int local[4]     = { lowest, lowest, lowest, lowest };
+  int result[4]    = { lowest, lowest, lowest, lowest };
+
+  array::AccessScope list{ &cell_type };
+
+  for (auto p = grid.points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (cell_type.icy(i, j)) {
+      local[0] = std::max(local[0], -(i + domain.i0));
+      local[1] = std::max(local[1], -(j + domain.j0));
+      local[2] = std::max(local[2], i + domain.i0);
+      local[3] = std::max(local[3], j + domain.j0);
+    }
+  }
+
+  GlobalMax(grid.com, local, result, 4);
+
+  if (result[2] == lowest) {
+    // no ice
+    return { 0, 0, -1, -1 };
+  }
+
+  return { -result[0], -result[1], result[2], result[3] };
+}
+
+/*!
+ * Distance from the ice margin needed by models of the physics.
+ *
+ * - Orographic precipitation depends on the upwind topography within the distance
+ *   moisture travels before falling out.
+ * - The Lingle-Clark bed deformation model deforms the bed up to the peripheral bulge,
+ *   about `pi` flexural lengths from the load.
+ */
+double physics_margin(const Config &config) {
+  double result = 0.0;
+
+  auto atmosphere = set_split(config.get_string("atmosphere.models"), ',');
+  if (member("orographic_precipitation", atmosphere)) {
+    double
+      wind_speed      = config.get_number("atmosphere.orographic_precipitation.wind_speed", "m s-1"),
+      conversion_time = config.get_number("atmosphere.orographic_precipitation.conversion_time"),
+      fallout_time    = config.get_number("atmosphere.orographic_precipitation.fallout_time");
+
+    result = std::max(result, 3.0 * wind_speed * (conversion_time + fallout_time));
+  }
+
+  if (config.get_string("bed_deformation.model") == "lc") {
+    double
+      D               = config.get_number("bed_deformation.lithosphere_flexural_rigidity"),
+      rho             = config.get_number("bed_deformation.mantle_density"),
+      g               = config.get_number("constants.standard_gravity"),
+      flexural_length = std::pow(D / (rho * g), 0.25);
+
+    result = std::max(result, M_PI * flexural_length);
+  }
+
+  return result;
+}
+
+//! Parameters of the grid covering `box`. Only the full grid may be periodic.
+grid::Parameters box_parameters(const Config &config, const Grid &full, const Box &box) {
+  grid::Parameters P(config);
+
+  const bool
+    cell_centered = full.registration() == grid::CELL_CENTER,
+    whole_domain  = box == Box{ 0, 0, (int)full.Mx() - 1, (int)full.My() - 1 };
+
+  P.Mx           = box.Mx();
+  P.My           = box.My();
+  P.x0           = 0.5 * (full.x(box.i0) + full.x(box.i1));
+  P.y0           = 0.5 * (full.y(box.j0) + full.y(box.j1));
+  P.Lx           = 0.5 * (cell_centered ? P.Mx : P.Mx - 1) * full.dx();
+  P.Ly           = 0.5 * (cell_centered ? P.My : P.My - 1) * full.dy();
+  P.registration = full.registration();
+  P.periodicity  = whole_domain ? full.periodicity() : grid::NOT_PERIODIC;
+  P.z            = full.z();
+
+  return P;
+}
+
+//! Grow `box` until the grid covering it can be distributed across all processes.
+Box distributable(const Context &ctx, const Grid &full, Box box) {
+  while (true) {
+    auto P = box_parameters(*ctx.config(), full, box);
+    try {
+      P.ownership_ranges_from_options(ctx.size());
+      return box;
+    } catch (RuntimeError &) {
+      if (box == Box{ 0, 0, (int)full.Mx() - 1, (int)full.My() - 1 }) {
+        throw;
+      }
+      box = { std::max(box.i0 - 1, 0), std::max(box.j0 - 1, 0),
+              std::min(box.i1 + 1, (int)full.Mx() - 1), std::min(box.j1 + 1, (int)full.My() - 1) };
+    }
+  }
+}
+
+} // end of anonymous namespace
+
+bool domain_cropping_requested(const Config &config) {
+  return config.get_flag("grid.cropping.enabled");
+}
+
+IceModelTerminationReason run_with_domain_cropping(std::shared_ptr<Context> ctx,
+                                                   std::unique_ptr<IceModel> &model) {
+  auto config = ctx->config();
+  auto log    = ctx->log();
+  auto time   = ctx->time();
+
+  const double
+    interval      = config->get_number("grid.cropping.interval", "seconds"),
+    threshold     = config->get_number("grid.cropping.threshold"),
+    edge_distance = config->get_number("grid.cropping.edge_distance", "m"),
+    margin        = std::max(config->get_number("grid.cropping.margin", "m"),
+                             physics_margin(*config));
+
+  if (not (interval > 0.0)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "grid.cropping.interval has to be positive; got %f seconds",
+                                  interval);
+  }
+
+  if (not (threshold > 0.0 and threshold <= 1.0)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "grid.cropping.threshold has to be in (0, 1]; got %f",
+                                  threshold);
+  }
+
+  if (edge_distance >= margin) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "grid.cropping.edge_distance (%f km) has to be smaller than"
+                                  " the margin (%f km)",
+                                  edge_distance / 1000.0, margin / 1000.0);
+  }
+
+  if (not config->get_flag("input.bootstrap")) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "domain cropping requires bootstrapping (-bootstrap)");
+  }
+
+  // the full domain
+  auto full = Grid::FromOptions(ctx);
+
+  const int
+    margin_x = (int)std::ceil(margin / full->dx()),
+    margin_y = (int)std::ceil(margin / full->dy()),
+    edge_x   = (int)std::ceil(edge_distance / full->dx()),
+    edge_y   = (int)std::ceil(edge_distance / full->dy());
+
+  const Box full_box{ 0, 0, (int)full->Mx() - 1, (int)full->My() - 1 };
+
+  log->message(2, "* Domain cropping: using a margin of %.1f km around the ice...\n",
+               margin / 1000.0);
+
+  const double run_end = time->end();
+  const bool
+    append_timeseries = config->get_flag("output.timeseries.append"),
+    append_extra      = config->get_flag("output.extra.append"),
+    append_snapshots  = config->get_flag("output.snapshot.append");
+
+  Box box = full_box;
+  std::shared_ptr<Grid> grid;
+  IceModelTerminationReason result = PISM_DONE;
+
+  // Replaces `model` with a new model using the part of the full grid covered by `domain`.
+  auto switch_to = [&](const Box &domain) {
+    auto P = box_parameters(*config, *full, domain);
+    P.ownership_ranges_from_options(ctx->size());
+
+    auto new_grid = std::make_shared<Grid>(ctx, P);
+    new_grid->set_output_domain(*full);
+
+    // copy model state from the previous model in memory
+    new_grid->set_regrid_source(grid);
+
+    time->set_end(run_end);
+
+    std::unique_ptr<IceModel> new_model(new IceModel(new_grid, ctx));
+    new_model->init();
+
+    // De-allocate the previous model.
+    new_grid->set_regrid_source(nullptr);
+    model = std::move(new_model);
+    grid  = new_grid;
+  };
+
+  // Makes the next model append to output files written so far.
+  auto append_to_outputs = [&]() {
+    config->set_flag("output.timeseries.append", true);
+
+    auto extra_file = config->get_string("output.extra.file");
+    if (not extra_file.empty() and not config->get_flag("output.extra.split") and
+        io::file_exists(grid->com, extra_file)) {
+      config->set_flag("output.extra.append", true);
+    }
+
+    auto snapshot_file = config->get_string("output.snapshot.file");
+    if (not snapshot_file.empty() and not config->get_flag("output.snapshot.split") and
+        io::file_exists(grid->com, snapshot_file)) {
+      config->set_flag("output.snapshot.append", true);
+    }
+  };
+
+  bool done = false;
+  while (not done) {
+    switch_to(box);
+
+    // run until the end of the run or until the domain has to change
+    while (true) {
+      if (time->current() >= run_end) {
+        done = true;
+        break;
+      }
+
+      Box ice = ice_bounding_box(model->geometry(), box);
+
+      if (not ice.empty()) {
+        Box next = { std::max(ice.i0 - margin_x, 0), std::max(ice.j0 - margin_y, 0),
+                     std::min(ice.i1 + margin_x, full_box.i1),
+                     std::min(ice.j1 + margin_y, full_box.j1) };
+        next = distributable(*ctx, *full, next);
+
+        // ice is too close to an edge of the current domain (edges of the full domain
+        // don't count)
+        bool near_edge = ((box.i0 > 0 and ice.i0 - box.i0 < edge_x) or
+                          (box.j0 > 0 and ice.j0 - box.j0 < edge_y) or
+                          (box.i1 < full_box.i1 and box.i1 - ice.i1 < edge_x) or
+                          (box.j1 < full_box.j1 and box.j1 - ice.j1 < edge_y));
+
+        bool smaller = next.area() < threshold * box.area();
+
+        if ((near_edge or smaller) and not (next == box)) {
+          log->message(2,
+                       "* Domain cropping: switching to the %d*%d part of the %d*%d grid"
+                       " (x in [%.1f, %.1f] km, y in [%.1f, %.1f] km)...\n",
+                       next.Mx(), next.My(), (int)full->Mx(), (int)full->My(),
+                       full->x(next.i0) / 1000.0, full->x(next.i1) / 1000.0,
+                       full->y(next.j0) / 1000.0, full->y(next.j1) / 1000.0);
+          box = next;
+          break;
+        }
+      }
+
+      result = model->run_to(std::min(time->current() + interval, run_end));
+
+      if (result != PISM_DONE) {
+        done = true;
+        break;
+      }
+    }
+
+    if (not done) {
+      append_to_outputs();
+    }
+  }
+
+  if (result == PISM_DONE and not (box == full_box)) {
+    // Values outside of the cropped domain are known: there is no ice and everything else
+    // comes from input.file. Use the full grid to save the output file so that it can be
+    // used to re-start.
+    log->message(2, "* Domain cropping: switching to the full %d*%d grid to save results...\n",
+                 (int)full->Mx(), (int)full->My());
+    append_to_outputs();
+    switch_to(full_box);
+  }
+
+  time->set_end(run_end);
+  config->set_flag("output.timeseries.append", append_timeseries);
+  config->set_flag("output.extra.append", append_extra);
+  config->set_flag("output.snapshot.append", append_snapshots);
+
+  return result;
+}
+
+} // end of namespace pism
@@ -0,0 +1,60 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_DOMAINCROPPING_H
+#define PISM_DOMAINCROPPING_H
+
+#include <memory>
+
+#include "pism/icemodel/IceModel.hh"
+
+namespace pism {
+
+//! Returns true if `grid.cropping.enabled` is set.
+bool domain_cropping_requested(const Config &config);
+
+//! Run a model using a computational domain cropped to the ice-covered region.
+/*!
+ * Every `grid.cropping.interval` years this computes the bounding box of ice, extended by
+ * `grid.cropping.margin` (or by the distance needed by the orographic precipitation and
+ * the Lingle-Clark bed deformation models, whichever is larger), in the grid set using
+ * command-line options (the "full" grid).
+ *
+ * The model is moved to a new grid covering this box if its area is less than
+ * `grid.cropping.threshold` times the area of the current domain or if ice is closer than
+ * `grid.cropping.edge_distance` to an edge of the current domain. Grid points of all
+ * these grids coincide with points of the full grid.
+ *
+ * The new model is bootstrapped from `input.file` (this re-creates forcing on the new
+ * grid); then model state variables are copied from the previous model in memory (see
+ * Grid::set_regrid_source()). Areas outside of the previous domain are ice-free.
+ *
+ * Spatial output uses coordinates of the full grid (see Grid::set_output_domain()).
+ *
+ * If the run is finished, the model is moved to the full grid before returning, so that
+ * the output file contains values everywhere in the full domain.
+ *
+ * On return `model` contains the model used last.
+ */
+IceModelTerminationReason run_with_domain_cropping(std::shared_ptr<Context> ctx,
+                                                   std::unique_ptr<IceModel> &model);
+
+} // end of namespace pism
+
+#endif /* PISM_DOMAINCROPPING_H */
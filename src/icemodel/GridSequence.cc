@@ -0,0 +1,176 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "pism/icemodel/GridSequence.hh"
+
+#include "pism/util/Grid.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/Units.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+
+namespace {
+
+//! Parse a comma-separated list of numbers, converting from `units` to `internal_units`.
+std::vector<double> parse_list(units::System::Ptr sys, const Config &config,
+                               const std::string &parameter, const std::string &units,
+                               const std::string &internal_units) {
+  std::vector<double> result;
+  for (const auto &token : split(config.get_string(parameter), ',')) {
+    try {
+      result.push_back(units::convert(sys, parse_number(token), units, internal_units));
+    } catch (RuntimeError &e) {
+      e.add_context("parsing %s", parameter.c_str());
+      throw;
+    }
+  }
+  return result;
+}
+
+//! Number of grid points needed to cover [-L, L] (relative to the center) with spacing `dx`.
+unsigned int n_points(double L, double dx, grid::Registration registration) {
+  auto N = static_cast<unsigned int>(std::round(2.0 * L / dx));
+
+  return registration == grid::CELL_CENTER ? N : N + 1;
+}
+
+//! Allocate the grid of a stage using the domain and the vertical grid of `base`.
+std::shared_ptr<Grid> stage_grid(std::shared_ptr<const Context> ctx, const Grid &base,
+                                 double dx) {
+  grid::Parameters P(*ctx->config());
+
+  P.x0           = base.x0();
+  P.y0           = base.y0();
+  P.Lx           = base.Lx();
+  P.Ly           = base.Ly();
+  P.registration = base.registration();
+  P.periodicity  = base.periodicity();
+  P.z            = base.z();
+  P.Mx           = n_points(base.Lx(), dx, P.registration);
+  P.My           = n_points(base.Ly(), dx, P.registration);
+
+  P.ownership_ranges_from_options(ctx->size());
+
+  return std::make_shared<Grid>(ctx, P);
+}
+
+} // end of anonymous namespace
+
+bool grid_sequence_requested(const Config &config) {
+  return not config.get_string("grid.sequence.dx").empty();
+}
+
+IceModelTerminationReason run_grid_sequence(std::shared_ptr<Context> ctx,
+                                            std::unique_ptr<IceModel> &model) {
+  auto config = ctx->config();
+  auto log    = ctx->log();
+  auto time   = ctx->time();
+  auto sys    = ctx->unit_system();
+
+  auto dx        = parse_list(sys, *config, "grid.sequence.dx", "km", "m");
+  auto durations = parse_list(sys, *config, "grid.sequence.durations", "years", "seconds");
+
+  const size_t N_stages = dx.size();
+
+  if (durations.size() + 1 != N_stages) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "grid.sequence.durations has to have %d entries"
+                                  " (one for each stage except the last one); got %d",
+                                  (int)N_stages - 1, (int)durations.size());
+  }
+
+  for (auto d : dx) {
+    if (not (d > 0.0)) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "grid.sequence.dx has to be positive; got %f m", d);
+    }
+  }
+
+  if (not config->get_flag("input.bootstrap")) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "grid sequencing requires bootstrapping (-bootstrap)");
+  }
+
+  // stage end times
+  const double run_end = time->end();
+  std::vector<double> stage_end(N_stages, run_end);
+  {
+    double t = time->start();
+    for (size_t k = 0; k < durations.size(); ++k) {
+      t += durations[k];
+
+      if (t >= run_end) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "stage %d of the grid sequence ends after the end of the run",
+                                      (int)k + 1);
+      }
+      stage_end[k] = t;
+    }
+  }
+
+  // the domain and the vertical grid
+  auto base = Grid::FromOptions(ctx);
+
+  const bool append_timeseries = config->get_flag("output.timeseries.append");
+
+  std::shared_ptr<Grid> grid;
+  IceModelTerminationReason result = PISM_DONE;
+
+  for (size_t k = 0; k < N_stages; ++k) {
+    log->message(2,
+                 "* Grid sequence: stage %d of %d (dx = %.3f km) ...\n",
+                 (int)k + 1, (int)N_stages, dx[k] / 1000.0);
+
+    auto new_grid = stage_grid(ctx, *base, dx[k]);
+
+    // interpolate model state from the previous stage in memory
+    new_grid->set_regrid_source(grid);
+
+    time->set_end(stage_end[k]);
+
+    std::unique_ptr<IceModel> new_model(new IceModel(new_grid, ctx));
+    new_model->init();
+
+    // De-allocate the previous stage. Fields stored on its grid are not needed anymore.
+    new_grid->set_regrid_source(nullptr);
+    model = std::move(new_model);
+    grid  = new_grid;
+
+    result = model->run();
+
+    if (result != PISM_DONE) {
+      break;
+    }
+
+    // append to scalar time series written during earlier stages
+    config->set_flag("output.timeseries.append", true);
+  }
+
+  time->set_end(run_end);
+  config->set_flag("output.timeseries.append", append_timeseries);
+
+  return result;
+}
+
+} // end of namespace pism
@@ -0,0 +1,49 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_GRIDSEQUENCE_H
+#define PISM_GRIDSEQUENCE_H
+
+#include <memory>
+
+#include "pism/icemodel/IceModel.hh"
+
+namespace pism {
+
+//! Returns true if `grid.sequence.dx` requests a grid sequence.
+bool grid_sequence_requested(const Config &config);
+
+//! Run a sequence of models using progressively finer grids in one process.
+/*!
+ * Stage `k` uses the horizontal grid spacing `grid.sequence.dx[k]` and the domain and
+ * vertical grid of the grid set using command-line options. It runs for
+ * `grid.sequence.durations[k]` years (the last stage runs until the end of the run).
+ *
+ * At every stage transition the new model is bootstrapped from `input.file`; then all
+ * model state variables are interpolated from the previous model *in memory* (see
+ * Grid::set_regrid_source()).
+ *
+ * On return `model` contains the model used during the last stage that was run.
+ */
+IceModelTerminationReason run_grid_sequence(std::shared_ptr<Context> ctx,
+                                            std::unique_ptr<IceModel> &model);
+
+} // end of namespace pism
+
+#endif /* PISM_GRIDSEQUENCE_H */
@@ -50,6 +50,7 @@
 #include "pism/fracturedensity/FractureDensity.hh"
 #include "pism/coupler/util/options.hh" // ForcingOptions
 #include "pism/coupler/ocean/PyOceanModel.hh"
+#include "pism/util/Analysis.hh"
 
 namespace pism {
 
@@ -70,7 +71,13 @@ IceModel::IceModel(std::shared_ptr<Grid> grid, const std::shared_ptr<Context> &c
       m_velocity_bc_mask(m_grid, "vel_bc_mask"),
       m_velocity_bc_values(m_grid, "_bc"), // u_bc and v_bc
       m_ice_thickness_bc_mask(grid, "thk_bc_mask"),
+      m_dt_energy_age(0.0),
+      m_enthalpy_change_rate(0.0),
+      m_energy_age_ice_thickness(m_grid, "energy_age_ice_thickness"),
       m_step_counter(0),
+      m_velocity_is_current(false),
+      m_rollback_dt_max(0.0),
+      m_step_retries(0),
       m_thickness_change(grid),
       m_ts_times(new std::vector<double>()),
       m_extra_bounds("time_bounds", m_sys),
@@ -103,6 +110,8 @@ IceModel::IceModel(std::shared_ptr<Grid> grid, const std::shared_ptr<Context> &c
   m_save_snapshots = false;
   // Do not save time-series by default:
   m_save_extra     = false;
+  // Do not perform in-situ analyses by default:
+  m_next_analysis  = 0;
 
   m_fracture = nullptr;
 
@@ -141,6 +150,14 @@ double IceModel::dt() const {
   return m_dt;
 }
 
+unsigned int IceModel::step_retries() const {
+  return m_step_retries;
+}
+
+double IceModel::dt_energy_age() const {
+  return m_dt_energy_age;
+}
+
 void IceModel::reset_counters() {
   dt_TempAge       = 0.0;
   m_dt             = 0.0;
@@ -420,29 +437,22 @@ std::string IceModel::save_state_on_error(const std::string &suffix,
 /*!
 During the time-step we perform the following actions:
  */
-void IceModel::step(bool do_mass_continuity,
-                    bool do_skip) {
-
-  m_step_counter++;
-
+//! Update the velocity field using the current model state.
+/*!
+ * In some cases the whole three-dimensional field is updated and in some cases just the
+ * vertically-averaged horizontal velocity is updated.
+ */
+void IceModel::update_velocity(bool update_at_depth) {
   const Profiling &profiling = m_ctx->profiling();
 
-  double current_time = m_time->current();
-
   //! \li call pre_step_hook() to let derived classes do more
   pre_step_hook();
 
-  //! \li update the velocity field; in some cases the whole three-dimensional
-  //! field is updated and in some cases just the vertically-averaged
-  //! horizontal velocity is updated
-
   // always "update" ice velocity (possibly trivially); only update
   // SSA and only update velocities at depth if suggested by temp and age
   // stability criterion; note *lots* of communication is avoided by skipping
   // SSA (and temp/age)
 
-  const bool updateAtDepth  = (m_skip_countdown == 0);
-
   // Combine basal melt rate in grounded (computed during the energy
   // step) and floating (provided by an ocean model) areas.
   //
@@ -455,18 +465,36 @@ void IceModel::step(bool do_mass_continuity,
                             m_basal_melt_rate);
   }
 
-  try {
-    profiling.begin("stress_balance");
-    m_stress_balance->update(stress_balance_inputs(), updateAtDepth);
-    profiling.end("stress_balance");
-  } catch (RuntimeError &e) {
-    std::string output_file = save_state_on_error("_stressbalance_failed", {});
+  profiling.begin("stress_balance");
+  m_stress_balance->update(stress_balance_inputs(), update_at_depth);
+  profiling.end("stress_balance");
+}
 
-    e.add_context("performing a time step. (Note: Model state was saved to '%s'.)",
-                  output_file.c_str());
-    throw;
-  }
+void IceModel::step(bool do_mass_continuity,
+                    bool do_skip) {
 
+  m_step_counter++;
+
+  const Profiling &profiling = m_ctx->profiling();
+
+  double current_time = m_time->current();
+
+  const bool updateAtDepth  = (m_skip_countdown == 0);
+
+  //! \li update the velocity field (unless it was computed at the end of the previous
+  //! step; see step_with_rollback())
+  if (not m_velocity_is_current) {
+    try {
+      update_velocity(updateAtDepth);
+    } catch (RuntimeError &e) {
+      std::string output_file = save_state_on_error("_stressbalance_failed", {});
+
+      e.add_context("performing a time step. (Note: Model state was saved to '%s'.)",
+                    output_file.c_str());
+      throw;
+    }
+  }
+  m_velocity_is_current = false;
 
   m_stdout_flags += m_stress_balance->stdout_report();
 
@@ -648,7 +676,7 @@ void IceModel::step(bool do_mass_continuity,
   //! \li compute the bed deformation, which depends on current thickness, bed elevation,
   //! and sea level
   if (m_beddef) {
-    int topg_state_counter = m_beddef->bed_elevation().state_counter();
+    uint64_t topg_state_counter = m_beddef->bed_elevation().state_counter();
 
     profiling.begin("bed_deformation");
     m_beddef->update(m_geometry.ice_thickness,
@@ -679,10 +707,15 @@ void IceModel::step(bool do_mass_continuity,
   m_time->step(m_dt);
 
   if (updateAtDepth) {
+    m_dt_energy_age = dt_TempAge;
     t_TempAge  = m_time->current();
     dt_TempAge = 0.0;
   }
 
+  if (do_skip and m_config->get_flag("time_stepping.skip.adaptive.enabled")) {
+    adapt_skip_countdown(updateAtDepth);
+  }
+
   // Check if the ice thickness exceeded the height of the computational box and stop if it did.
   if (max(m_geometry.ice_thickness) > m_grid->Lz()) {
     auto o_file = save_state_on_error("_max_thickness", {});
@@ -770,6 +803,7 @@ IceModelTerminationReason IceModel::run() {
   bool do_mass_conserve = m_config->get_flag("geometry.update.enabled");
   bool do_energy = m_config->get_flag("energy.enabled");
   bool do_skip = m_config->get_flag("time_stepping.skip.enabled");
+  bool rollback = m_config->get_flag("time_stepping.rollback.enabled");
 
   // de-allocate diagnostics that are not needed
   prune_diagnostics();
@@ -781,6 +815,7 @@ IceModelTerminationReason IceModel::run() {
 
   // Update spatially-variable diagnostics at the beginning of the run.
   write_extras();
+  run_analyses();
 
   // Update scalar time series to remember the state at the beginning of the run.
   // This is needed to compute rates of change of the ice mass, volume, etc.
@@ -800,6 +835,9 @@ IceModelTerminationReason IceModel::run() {
   t_TempAge = m_time->current();
   dt_TempAge = 0.0;
 
+  // the model state may have been modified since the last call
+  m_velocity_is_current = false;
+
   IceModelTerminationReason termination_reason = PISM_DONE;
   // main loop for time evolution
   // IceModel::step calls Time::step(dt), ensuring that this while loop
@@ -809,7 +847,11 @@ IceModelTerminationReason IceModel::run() {
 
     m_stdout_flags.erase();  // clear it out
 
-    step(do_mass_conserve, do_skip);
+    if (rollback) {
+      step_with_rollback(do_mass_conserve, do_skip);
+    } else {
+      step(do_mass_conserve, do_skip);
+    }
 
     update_diagnostics(m_dt);
 
@@ -828,6 +870,7 @@ IceModelTerminationReason IceModel::run() {
     profiling.begin("io");
     write_snapshot();
     write_extras();
+    run_analyses();
     bool stop_after_chekpoint = write_checkpoint();
     profiling.end("io");
 
@@ -1007,6 +1050,7 @@ void IceModel::prune_diagnostics() {
   requested = combine(requested, m_snapshot_vars);
   requested = combine(requested, m_extra_vars);
   requested = combine(requested, m_checkpoint_vars);
+  requested = combine(requested, analysis_inputs());
 
   // de-allocate diagnostics that were not requested
   for (const auto &v : available) {
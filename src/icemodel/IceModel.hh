@@ -104,6 +104,7 @@ class CellType;
 }
 
 class Grid;
+class Analysis;
 class AgeModel;
 class Isochrones;
 class Component;
@@ -158,11 +159,23 @@ public:
    */
   void set_python_ocean_model(std::shared_ptr<ocean::PyOceanModel> model);
 
+  void add_analysis(std::shared_ptr<Analysis> analysis);
+
   const Geometry& geometry() const;
   const GeometryEvolution& geometry_evolution() const;
 
   double dt() const;
 
+  //! Total number of time steps repeated after stress balance failures.
+  unsigned int step_retries() const;
+
+  // Used by step_with_rollback(); public to make testing easier.
+  void save_step_state();
+  void restore_step_state();
+
+  //! Length of the last energy and age time step.
+  double dt_energy_age() const;
+
 protected:
   virtual void allocate_submodels();
   virtual void allocate_stressbalance();
@@ -323,12 +336,47 @@ protected:
 
   unsigned int m_skip_countdown;
 
+  //! length of the last energy and age time step
+  double m_dt_energy_age;
+  //! maximum rate of change of ice enthalpy during the last energy time step, J kg-1 s-1
+  double m_enthalpy_change_rate;
+  //! ice thickness at the time of the last energy and age update (see
+  //! adapt_skip_countdown())
+  array::Scalar m_energy_age_ice_thickness;
+
   std::string m_adaptive_timestep_reason;
 
   std::string m_stdout_flags;
 
   unsigned int m_step_counter;
 
+  // see rollback.cc
+
+  //! In-memory copy of the model state at the beginning of a time step.
+  struct StepSnapshot {
+    //! Model state fields and their copies
+    std::map<array::Array *, std::shared_ptr<petsc::Vec> > fields;
+
+    double time;
+    double t_TempAge;
+    double dt_TempAge;
+    double hit_multiples_last_time;
+    unsigned int skip_countdown;
+    unsigned int step_counter;
+    bool new_bed_elevation;
+    std::string stdout_flags;
+  };
+  std::unique_ptr<StepSnapshot> m_step_snapshot;
+  //! True if the velocity field was computed using the current model state (see
+  //! step_with_rollback()).
+  bool m_velocity_is_current;
+  //! Maximum length of a time step repeated after a stress balance failure (0 if inactive)
+  double m_rollback_dt_max;
+  unsigned int m_step_retries;
+
+  virtual void step_with_rollback(bool do_mass_continuity, bool do_skip);
+  virtual void update_velocity(bool update_at_depth);
+
   // see iceModel.cc
   virtual void allocate_storage();
 
@@ -341,6 +389,7 @@ protected:
 
   virtual MaxTimestep max_timestep_diffusivity();
   virtual unsigned int skip_counter(double input_dt, double input_dt_diffusivity);
+  virtual void adapt_skip_countdown(bool energy_age_step);
 
   // see energy.cc
   virtual void bedrock_thermal_model_step();
@@ -455,6 +504,16 @@ protected:
   void write_extras();
   MaxTimestep extras_max_timestep(double my_t);
 
+  // in-situ analyses
+  std::vector<std::shared_ptr<Analysis> > m_analyses;
+  std::string m_analysis_filename;
+  std::vector<double> m_analysis_times;
+  unsigned int m_next_analysis;
+  void init_analyses();
+  void run_analyses();
+  std::set<std::string> analysis_inputs() const;
+  MaxTimestep analysis_max_timestep(double my_t);
+
   // automatic checkpoints
   std::string m_checkpoint_filename;
   double m_last_checkpoint_time;
@@ -1972,6 +1972,38 @@ public:
   }
 };
 
+//! \brief Reports the length of the last energy and age time step.
+class EnergyAgeTimeStepLength : public TSDiag<TSSnapshotDiagnostic, IceModel> {
+public:
+  EnergyAgeTimeStepLength(const IceModel *m)
+      : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "dt_energy_age") {
+
+    set_units("second", "year");
+    m_variable["long_name"] = "length of the last energy and age time step";
+    m_variable["valid_min"] = { 0.0 };
+  }
+
+  double compute() {
+    return model->dt_energy_age();
+  }
+};
+
+//! \brief Reports the number of time steps repeated after stress balance failures.
+class StepRetries : public TSDiag<TSSnapshotDiagnostic, IceModel> {
+public:
+  StepRetries(const IceModel *m) : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "step_retries") {
+
+    set_units("1", "1");
+    m_variable["long_name"] = "number of time steps repeated after stress balance failures"
+        " since the beginning of the run";
+    m_variable["valid_min"] = { 0.0 };
+  }
+
+  double compute() {
+    return model->step_retries();
+  }
+};
+
 //! \brief Reports the mass continuity time step.
 class TimeStepRatio : public TSDiag<TSSnapshotDiagnostic, IceModel> {
 public:
@@ -3243,6 +3275,8 @@ void IceModel::init_diagnostics() {
     {"max_horizontal_vel", s(new scalar::MaxHorizontalVelocity(this))},
     {"dt",              s(new scalar::TimeStepLength(this))},
     {"dt_ratio",        s(new scalar::TimeStepRatio(this))},
+    {"dt_energy_age",   s(new scalar::EnergyAgeTimeStepLength(this))},
+    {"step_retries",    s(new scalar::StepRetries(this))},
     // balancing the books
     {"tendency_of_ice_mass",                           s(new scalar::IceMassRateOfChange(this))},
     {"tendency_of_ice_mass_due_to_flow",               s(new scalar::IceMassRateOfChangeDueToFlow(this))},
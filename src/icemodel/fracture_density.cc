@@ -74,7 +74,8 @@ void IceModel::update_fracture_density() {
   // check if this time step is short enough.
   m_fracture->update(m_dt, m_geometry,
                      m_stress_balance->shallow()->velocity(),
-                     hardness, bc_mask);
+                     hardness, bc_mask,
+                     m_stress_balance->velocity_derived_fields());
 }
 
 } // end of namespace pism
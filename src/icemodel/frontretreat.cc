@@ -103,7 +103,7 @@ void IceModel::front_retreat_step() {
   {
     if (m_eigen_calving) {
       m_eigen_calving->update(m_geometry.cell_type,
-                              m_stress_balance->shallow()->velocity());
+                              m_stress_balance->velocity_derived_fields());
     }
 
     if (m_hayhurst_calving) {
@@ -119,7 +119,8 @@ void IceModel::front_retreat_step() {
       m_vonmises_calving->update(m_geometry.cell_type,
                                  m_geometry.ice_thickness,
                                  m_stress_balance->shallow()->velocity(),
-                                 m_energy_model->enthalpy());
+                                 m_energy_model->enthalpy(),
+                                 m_stress_balance->velocity_derived_fields());
     }
 
     if (m_frontal_melt) {
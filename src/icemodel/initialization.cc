@@ -451,11 +451,66 @@ void IceModel::initialize_2d() {
 }
 
 //! Manage regridding based on user options.
+/*!
+ * If the grid has a regridding source (grid sequencing), interpolate model state variables
+ * in memory instead of reading them from `input.regrid.file`. In this case ice thickness
+ * and the ice area specific volume are interpolated if `input.regrid.vars` is empty.
+ *
+ * Areas outside of the domain of the regridding source (domain cropping) are ice-free.
+ */
 void IceModel::regrid() {
 
   auto filename    = m_config->get_string("input.regrid.file");
   auto regrid_vars = set_split(m_config->get_string("input.regrid.vars"), ',');
 
+  for (auto *v : m_model_state) {
+    m_grid->add_state_field(*v);
+  }
+
+  auto source_grid = m_grid->regrid_source();
+  if (source_grid) {
+    if (regrid_vars.empty()) {
+      regrid_vars = { m_geometry.ice_thickness.get_name(),
+                      m_geometry.ice_area_specific_volume.get_name() };
+    }
+
+    m_log->message(2, "interpolating from the %d*%d grid ...\n",
+                   (int)source_grid->Mx(), (int)source_grid->My());
+
+    for (auto *v : m_model_state) {
+      const auto *source = source_grid->state_field(v->get_name());
+      if (source != nullptr and member(v->get_name(), regrid_vars)) {
+        v->regrid(*source);
+      }
+    }
+
+    // The source model (using a cropped domain) has no ice outside of its domain.
+    {
+      const auto &x = source_grid->x();
+      const auto &y = source_grid->y();
+
+      const double
+        x_min = x.front() - 0.5 * m_grid->dx(),
+        x_max = x.back() + 0.5 * m_grid->dx(),
+        y_min = y.front() - 0.5 * m_grid->dy(),
+        y_max = y.back() + 0.5 * m_grid->dy();
+
+      array::AccessScope list{&m_geometry.ice_thickness, &m_geometry.ice_area_specific_volume};
+
+      for (auto p = m_grid->points(); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        double x_ij = m_grid->x(i), y_ij = m_grid->y(j);
+
+        if (x_ij < x_min or x_ij > x_max or y_ij < y_min or y_ij > y_max) {
+          m_geometry.ice_thickness(i, j)            = 0.0;
+          m_geometry.ice_area_specific_volume(i, j) = 0.0;
+        }
+      }
+    }
+    return;
+  }
+
   // Return if no regridding is requested:
   if (filename.empty()) {
      return;
@@ -822,6 +877,7 @@ void IceModel::misc_setup() {
   init_checkpoints();
   init_timeseries();
   init_extras();
+  init_analyses();
 
   // a report on whether PISM-PIK modifications of IceModel are in use
   {
@@ -130,6 +130,7 @@ void IceModel::save_results() {
               string_to_backend(m_config->get_string("output.format")),
               io::PISM_READWRITE_MOVE,
               m_ctx->pio_iosys_id());
+    file.set_sparse_3d(m_config->get_flag("output.sparse_3d"));
 
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
 
@@ -0,0 +1,202 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cmath>
+
+#include "pism/icemodel/IceModel.hh"
+
+#include "pism/util/Analysis.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/util/Vars.hh"
+
+namespace pism {
+
+/*!
+ * Register an in-situ analysis.
+ *
+ * Analyses are performed at times set using `output.analysis.times`; results are
+ * saved to `output.analysis.file`.
+ */
+void IceModel::add_analysis(std::shared_ptr<Analysis> analysis) {
+  m_analyses.push_back(analysis);
+}
+
+//! Initialize the code performing in-situ analyses.
+void IceModel::init_analyses() {
+
+  m_next_analysis = 0;
+
+  m_analysis_filename = m_config->get_string("output.analysis.file");
+  auto times          = m_config->get_string("output.analysis.times");
+
+  bool file_set = not m_analysis_filename.empty();
+  bool times_set = not times.empty();
+
+  if (file_set xor times_set) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "you need to set both output.analysis.file and output.analysis.times"
+                       " to perform in-situ analyses.");
+  }
+
+  if (not file_set) {
+    m_analysis_times.clear();
+    return;
+  }
+
+  try {
+    m_analysis_times = m_time->parse_times(times);
+  } catch (RuntimeError &e) {
+    e.add_context("parsing the output.analysis.times argument %s", times.c_str());
+    throw;
+  }
+
+  if (m_analysis_times.empty()) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "output.analysis.times cannot be empty");
+  }
+
+  m_log->message(2, "  saving results of in-situ analyses to '%s'\n",
+                 m_analysis_filename.c_str());
+  m_log->message(2, "  times requested: %s\n", times.c_str());
+
+  // prepare the output file
+  {
+    File file(m_grid->com, m_analysis_filename, io::PISM_NETCDF3, io::PISM_READWRITE_MOVE);
+
+    write_metadata(file, SKIP_MAPPING, PREPEND_HISTORY);
+    io::define_time(file, *m_ctx);
+  }
+}
+
+//! Computes the maximum time-step we can take and still hit all `-analysis_times`.
+MaxTimestep IceModel::analysis_max_timestep(double my_t) {
+
+  if (m_analyses.empty() or m_analysis_times.empty()) {
+    return MaxTimestep("in-situ analysis (-analysis_times)");
+  }
+
+  double eps = m_config->get_number("time_stepping.resolution");
+
+  return reporting_max_timestep(m_analysis_times, my_t, eps,
+                                "in-situ analysis (-analysis_times)");
+}
+
+/*!
+ * Names of fields needed by registered in-situ analyses.
+ */
+std::set<std::string> IceModel::analysis_inputs() const {
+  std::set<std::string> result;
+  for (const auto &a : m_analyses) {
+    for (const auto &name : a->inputs()) {
+      result.insert(name);
+    }
+  }
+  return result;
+}
+
+/*!
+ * Perform in-situ analyses if the current time matches one of the requested times.
+ *
+ * Model state variables are passed to analyses as is (no copies); other fields are
+ * computed using corresponding spatially-variable diagnostics.
+ */
+void IceModel::run_analyses() {
+
+  if (m_analyses.empty() or m_analysis_times.empty()) {
+    return;
+  }
+
+  const double time_resolution = m_config->get_number("time_stepping.resolution");
+  const double current_time    = m_time->current();
+
+  // skip requested times before the beginning of the run
+  while (m_next_analysis < m_analysis_times.size() and
+         m_analysis_times[m_next_analysis] < m_time->start() - time_resolution) {
+    m_next_analysis++;
+  }
+
+  // do we need to perform analyses *now*?
+  if (m_next_analysis < m_analysis_times.size() and
+      (current_time >= m_analysis_times[m_next_analysis] or
+       std::fabs(current_time - m_analysis_times[m_next_analysis]) < time_resolution)) {
+
+    while (m_next_analysis < m_analysis_times.size() and
+           (m_analysis_times[m_next_analysis] <= current_time or
+            std::fabs(current_time - m_analysis_times[m_next_analysis]) < time_resolution)) {
+      m_next_analysis++;
+    }
+  } else {
+    return;
+  }
+
+  AnalysisInputs inputs(m_grid->com, current_time);
+  {
+    const auto &variables = m_grid->variables();
+
+    for (const auto &name : analysis_inputs()) {
+      if (variables.is_available(name)) {
+        inputs.add(name, *variables.get(name));
+        continue;
+      }
+
+      auto d = m_diagnostics.find(name);
+      if (d != m_diagnostics.end()) {
+        inputs.add(name, std::shared_ptr<const array::Array>(d->second->compute()));
+        continue;
+      }
+
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "field '%s' requested by an in-situ analysis is not available",
+                                    name.c_str());
+    }
+  }
+
+  File file(m_grid->com, m_analysis_filename, io::PISM_NETCDF3, io::PISM_READWRITE);
+
+  auto time_name = m_config->get_string("time.dimension_name");
+
+  unsigned int record = file.dimension_length(time_name);
+  io::append_time(file, time_name, current_time);
+
+  for (const auto &a : m_analyses) {
+    auto names  = a->outputs();
+    auto values = a->compute(inputs);
+
+    if (names.size() != values.size()) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "an in-situ analysis computing %s returned %d values (expected %d)",
+                                    join(names, ",").c_str(), (int)values.size(),
+                                    (int)names.size());
+    }
+
+    for (unsigned int k = 0; k < names.size(); ++k) {
+      VariableMetadata variable(names[k], m_sys);
+      variable["units"]        = a->units(names[k]);
+      variable["output_units"] = a->units(names[k]);
+      variable["long_name"]    = a->long_name(names[k]);
+
+      io::define_timeseries(variable, time_name, file, io::PISM_DOUBLE);
+      io::write_timeseries(file, variable, record, { values[k] });
+    }
+  }
+}
+
+} // end of namespace pism
@@ -324,6 +324,9 @@ void IceModel::write_extras() {
                                   string_to_backend(m_config->get_string("output.format")),
                                   mode,
                                   m_ctx->pio_iosys_id()));
+
+      // the sparse encoding supports one record per file
+      m_extra_file->set_sparse_3d(m_split_extra and m_config->get_flag("output.sparse_3d"));
     }
 
     std::string time_name = m_config->get_string("time.dimension_name");
@@ -21,6 +21,8 @@
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
 
 namespace pism {
 
@@ -49,6 +51,7 @@ void IceModel::init_snapshots() {
   bool times_set = not save_times.empty();
 
   bool split = m_config->get_flag("output.snapshot.split");
+  bool append = m_config->get_flag("output.snapshot.append");
 
   m_snapshot_vars = output_variables(m_config->get_string("output.snapshot.size"));
 
@@ -85,10 +88,39 @@ void IceModel::init_snapshots() {
                        " are outside of the modeled time interval");
   }
 
+  if (append and split) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "both output.snapshot.split and output.snapshot.append are set.");
+  }
+
   m_save_snapshots = true;
   m_snapshots_file_is_ready = false;
   m_split_snapshots = false;
 
+  if (append and io::file_exists(m_grid->com, m_snapshots_filename)) {
+    File file(m_grid->com, m_snapshots_filename, io::PISM_NETCDF3, io::PISM_READONLY);
+
+    std::string time_name = m_config->get_string("time.dimension_name");
+    if (file.find_variable(time_name)) {
+      double time_max = vector_max(file.read_dimension(time_name));
+
+      // skip times saved already
+      while (m_current_snapshot < m_snapshot_times.size() and
+             m_snapshot_times[m_current_snapshot] <= time_max) {
+        m_current_snapshot++;
+      }
+
+      if (m_current_snapshot > 0) {
+        m_log->message(2,
+                       "skipping times before the last record in %s (at %s)\n",
+                       m_snapshots_filename.c_str(), m_time->date(time_max).c_str());
+      }
+    }
+
+    // append to this file instead of moving it aside
+    m_snapshots_file_is_ready = true;
+  }
+
   if (split) {
     m_split_snapshots = true;
   } else if (not ends_with(m_snapshots_filename, ".nc")) {
@@ -122,8 +154,8 @@ void IceModel::write_snapshot() {
   }
 
   // do we need to save *now*?
-  if ((m_time->current() >= m_snapshot_times[m_current_snapshot]) and
-      (m_current_snapshot < m_snapshot_times.size())) {
+  if ((m_current_snapshot < m_snapshot_times.size()) and
+      (m_time->current() >= m_snapshot_times[m_current_snapshot])) {
     saving_after = m_snapshot_times[m_current_snapshot];
 
     while ((m_current_snapshot < m_snapshot_times.size()) and
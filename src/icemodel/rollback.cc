@@ -0,0 +1,186 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "pism/icemodel/IceModel.hh"
+
+#include "pism/util/Grid.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+
+namespace pism {
+
+/*!
+ * Save a copy of the model state.
+ *
+ * The model state includes all fields that sub-models made available using
+ * Component::regrid() (see Grid::state_fields()), ice geometry, and the basal yield
+ * stress. Note that the internal state of sub-models that is not stored in fields is
+ * *not* saved.
+ *
+ * Storage for copies is allocated during the first call.
+ */
+void IceModel::save_step_state() {
+  if (not m_step_snapshot) {
+    m_step_snapshot.reset(new StepSnapshot());
+  }
+  auto &S = *m_step_snapshot;
+
+  std::set<array::Array *> fields(m_model_state.begin(), m_model_state.end());
+  for (auto *f : m_grid->state_fields()) {
+    fields.insert(f);
+  }
+  std::vector<array::Array *> other_fields{ &m_geometry.bed_elevation,
+                                            &m_geometry.sea_level_elevation,
+                                            &m_geometry.ice_thickness,
+                                            &m_geometry.ice_area_specific_volume,
+                                            &m_geometry.cell_type,
+                                            &m_geometry.cell_grounded_fraction,
+                                            &m_geometry.ice_surface_elevation,
+                                            &m_basal_yield_stress };
+  fields.insert(other_fields.begin(), other_fields.end());
+
+  PetscErrorCode ierr = 0;
+  for (auto *f : fields) {
+    auto &copy = S.fields[f];
+
+    if (not copy) {
+      copy = std::make_shared<petsc::Vec>();
+      ierr = VecDuplicate(f->petsc_vec(), copy->rawptr());
+      PISM_CHK(ierr, "VecDuplicate");
+    }
+
+    ierr = VecCopy(f->petsc_vec(), *copy);
+    PISM_CHK(ierr, "VecCopy");
+  }
+
+  S.time                    = m_time->current();
+  S.t_TempAge               = t_TempAge;
+  S.dt_TempAge              = dt_TempAge;
+  S.hit_multiples_last_time = m_timestep_hit_multiples_last_time;
+  S.skip_countdown          = m_skip_countdown;
+  S.step_counter            = m_step_counter;
+  S.new_bed_elevation       = m_new_bed_elevation;
+  S.stdout_flags            = m_stdout_flags;
+}
+
+//! Restore the model state saved by save_step_state().
+void IceModel::restore_step_state() {
+  if (not m_step_snapshot) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "no saved model state to restore");
+  }
+  const auto &S = *m_step_snapshot;
+
+  PetscErrorCode ierr = 0;
+  for (const auto &f : S.fields) {
+    ierr = VecCopy(*f.second, f.first->vec());
+    PISM_CHK(ierr, "VecCopy");
+
+    // make sure that sub-models using state counters notice the change
+    f.first->inc_state_counter();
+  }
+
+  m_time->set(S.time);
+  t_TempAge                          = S.t_TempAge;
+  dt_TempAge                         = S.dt_TempAge;
+  m_timestep_hit_multiples_last_time = S.hit_multiples_last_time;
+  m_skip_countdown                   = S.skip_countdown;
+  m_step_counter                     = S.step_counter;
+  m_new_bed_elevation                = S.new_bed_elevation;
+  m_stdout_flags                     = S.stdout_flags;
+}
+
+/*!
+ * Perform a time step and repeat it using a shorter time step length if the stress
+ * balance solver fails at the end of this step.
+ *
+ * The stress balance is solved at the *beginning* of a time step, so a solver failure is
+ * caused by the model state produced by the *previous* step. To be able to repeat that
+ * step we
+ *
+ * - save a copy of the model state (see save_step_state()),
+ * - perform a time step,
+ * - compute the velocity field used by the next step.
+ *
+ * If the stress balance solver fails, we restore the saved model state and repeat the
+ * step using the time step length reduced by the factor `time_stepping.rollback.dt_factor`
+ * (see the "rollback" restriction in max_timestep()).
+ *
+ * The next call of step() re-uses the velocity field computed here. This implies that
+ * velocity diagnostics saved after a time step correspond to the model state at the *end*
+ * of this step.
+ */
+void IceModel::step_with_rollback(bool do_mass_continuity, bool do_skip) {
+  const unsigned int max_retries =
+      static_cast<unsigned int>(m_config->get_number("time_stepping.rollback.max_retries"));
+  const double dt_factor = m_config->get_number("time_stepping.rollback.dt_factor");
+
+  save_step_state();
+
+  bool velocity_is_current = m_velocity_is_current;
+  unsigned int retries     = 0;
+  while (true) {
+    m_velocity_is_current = velocity_is_current;
+    step(do_mass_continuity, do_skip);
+
+    if (not (m_time->current() < m_time->end())) {
+      // this was the last step of the run
+      break;
+    }
+
+    try {
+      update_velocity(m_skip_countdown == 0);
+      m_velocity_is_current = true;
+      break;
+    } catch (RuntimeError &e) {
+      if (retries >= max_retries) {
+        std::string output_file = save_state_on_error("_stressbalance_failed", {});
+
+        e.add_context("performing a time step (repeated %d times)."
+                      " (Note: Model state was saved to '%s'.)",
+                      (int)retries, output_file.c_str());
+        throw;
+      }
+
+      const double dt_failed = m_dt;
+
+      restore_step_state();
+      m_rollback_dt_max = dt_factor * dt_failed;
+
+      m_log->message(2,
+                     "PISM WARNING: stress balance failed:\n%s\n"
+                     "  Repeating the time step from %s using dt <= %f seconds (retry %d of %d) ...\n",
+                     e.what(), m_time->date(m_time->current()).c_str(), m_rollback_dt_max,
+                     (int)retries + 1, (int)max_retries);
+
+      // the velocity field has to be re-computed using the restored model state
+      velocity_is_current = false;
+      retries += 1;
+      m_step_retries += 1;
+    }
+  }
+
+  m_rollback_dt_max = 0.0;
+}
+
+} // end of namespace pism
@@ -17,7 +17,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <algorithm>            // std::sort
-#include <cmath>                // std::floor
+#include <cmath>                // std::floor, std::fabs
 #include <cassert>
 
 #include "pism/icemodel/IceModel.hh"
@@ -26,7 +26,10 @@
 #include "pism/util/Time.hh"
 #include "pism/util/MaxTimestep.hh"
 #include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/timestepping.hh"
+#include "pism/energy/EnergyModel.hh"
 #include "pism/util/Component.hh" // ...->max_timestep()
+#include "pism/util/pism_utilities.hh"
 
 #include "pism/frontretreat/calving/EigenCalving.hh"
 #include "pism/frontretreat/calving/HayhurstCalving.hh"
@@ -37,6 +40,9 @@
 
 namespace pism {
 
+//! Fraction of the 3D CFL time step length used by the time step "skipping" mechanism.
+static const double skip_conservative_factor = 0.95;
+
 //! Compute the maximum time step allowed by the diffusive SIA.
 /*!
 If maximum diffusivity is positive (i.e. if there is diffusion going on) then
@@ -80,15 +86,88 @@ unsigned int IceModel::skip_counter(double dt, double dt_diffusivity) {
 
   const int skip_max = static_cast<int>(m_config->get_number("time_stepping.skip.max"));
 
+  if (m_config->get_flag("time_stepping.skip.adaptive.enabled")) {
+    // adapt_skip_countdown() decides when to stop skipping
+    return skip_max;
+  }
+
   if (dt_diffusivity > 0.0) {
-    const double conservative_factor = 0.95;
-    const double counter             = floor(conservative_factor * (dt / dt_diffusivity));
+    const double counter = floor(skip_conservative_factor * (dt / dt_diffusivity));
     return std::min(static_cast<int>(counter), skip_max);
   }
 
   return skip_max;
 }
 
+/*!
+ * Adaptive "skipping": decide if the next step should update the energy and age models.
+ *
+ * Energy and age models are updated at the next step if
+ *
+ * - the 3D CFL condition (using the velocity field from the last energy and age update)
+ *   would not allow one more skipped step,
+ * - the enthalpy change during the current energy time step would exceed
+ *   `time_stepping.skip.adaptive.max_enthalpy_change` assuming that enthalpy changes at
+ *   the same rate as during the last energy time step,
+ * - the ice thickness changed by more than `time_stepping.skip.adaptive.max_thickness_change`
+ *   since the last energy and age update (this limits changes in the velocity field
+ *   used by energy and age models, too).
+ *
+ * The number of skipped steps never exceeds `time_stepping.skip.max`. See
+ * energy_age_update_due().
+ *
+ * Age is not monitored: it grows at the same rate everywhere and its advection is limited
+ * by the 3D CFL condition alone.
+ *
+ * @param[in] energy_age_step true if energy and age models were updated during the current
+ *                            step
+ */
+void IceModel::adapt_skip_countdown(bool energy_age_step) {
+
+  if (energy_age_step) {
+    // record the state at the beginning of the next energy and age time step
+    m_energy_age_ice_thickness.copy_from(m_geometry.ice_thickness);
+
+    m_enthalpy_change_rate = 0.0;
+    if (m_dt_energy_age > 0.0) {
+      m_enthalpy_change_rate = m_energy_model->stats().max_enthalpy_change / m_dt_energy_age;
+    }
+    return;
+  }
+
+  if (m_skip_countdown == 0) {
+    // the next step updates energy and age models anyway
+    return;
+  }
+
+  double dH = 0.0;
+  {
+    array::AccessScope list{ &m_geometry.ice_thickness, &m_energy_age_ice_thickness };
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      dH = std::max(dH, std::fabs(m_geometry.ice_thickness(i, j) - m_energy_age_ice_thickness(i, j)));
+    }
+    dH = GlobalMax(m_grid->com, dH);
+  }
+
+  MaxTimestep dt_cfl;
+  {
+    auto cfl = m_stress_balance->max_timestep_cfl_3d().dt_max;
+    if (cfl.finite()) {
+      dt_cfl = MaxTimestep(skip_conservative_factor * cfl.value());
+    }
+  }
+
+  if (energy_age_update_due(dt_TempAge, m_dt, dt_cfl, m_enthalpy_change_rate,
+                            m_config->get_number("time_stepping.skip.adaptive.max_enthalpy_change"),
+                            dH,
+                            m_config->get_number("time_stepping.skip.adaptive.max_thickness_change"))) {
+    m_skip_countdown = 0;
+  }
+}
+
 //! Use various stability criteria to determine the time step for an evolution run.
 /*!
 The main loop in run() approximates many physical processes.  Several of these approximations,
@@ -150,6 +229,25 @@ IceModel::TimesteppingInfo IceModel::max_timestep(unsigned int counter) {
     restrictions.push_back(MaxTimestep(max_timestep, max));
   }
 
+  // Repeat a time step using a shorter step length after a stress balance failure (see
+  // step_with_rollback()).
+  if (m_rollback_dt_max > 0.0) {
+    restrictions.push_back(MaxTimestep(m_rollback_dt_max, "rollback"));
+  }
+
+  // Make sure that the 3D CFL condition is satisfied by the energy and age time step
+  // accumulated during "skipped" steps (see adapt_skip_countdown()).
+  if (m_config->get_flag("time_stepping.skip.enabled") and
+      m_config->get_flag("time_stepping.skip.adaptive.enabled") and dt_TempAge > 0.0) {
+    auto cfl = m_stress_balance->max_timestep_cfl_3d().dt_max;
+    if (cfl.finite()) {
+      double dt_left = skip_conservative_factor * cfl.value() - dt_TempAge;
+      if (dt_left > 0.0) {
+        restrictions.push_back(MaxTimestep(dt_left, "energy/age interval"));
+      }
+    }
+  }
+
   // Never go past the end of a run.
   const double time_to_end = m_time->end() - current_time;
   if (time_to_end > 0.0) {
@@ -161,6 +259,7 @@ IceModel::TimesteppingInfo IceModel::max_timestep(unsigned int counter) {
     restrictions.push_back(ts_max_timestep(current_time));
     restrictions.push_back(extras_max_timestep(current_time));
     restrictions.push_back(save_max_timestep(current_time));
+    restrictions.push_back(analysis_max_timestep(current_time));
   }
 
   // mass continuity stability criteria
@@ -108,6 +108,11 @@ VariableMetadata IceModel::run_stats() const {
   result["model_years_per_processor_hour"] = { model_years / proc_hours };
   result["number_of_time_steps"]           = { (double)m_step_counter };
 
+  // ghost exchanges performed and skipped by this process
+  auto ghosts = array::ghost_exchange_counts();
+  result["ghost_exchanges"]         = { (double)ghosts.performed };
+  result["ghost_exchanges_skipped"] = { (double)ghosts.skipped };
+
   return result;
 }
 
@@ -0,0 +1,124 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "Thermal spin-up with frozen geometry and ice velocity using parareal iterations.\n";
+
+#include <petscsys.h>           // PETSC_COMM_WORLD
+
+#include "pism/energy/Parareal.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/pism_options.hh"
+
+using namespace pism;
+
+int main(int argc, char *argv[]) {
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  int exit_code = 0;
+  try {
+    // Each time slice is handled by its own group of processes.
+    auto n_slices = options::Integer("-parareal_slices",
+                                     "number of parareal time slices", 1);
+
+    int slice = 0;
+    com = energy::parareal_split(PETSC_COMM_WORLD, n_slices, slice);
+
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_parareal", false);
+
+    Logger::Ptr log = ctx->log();
+    Config::Ptr config = ctx->config();
+
+    std::string usage =
+      "  pism_parareal -i IN.nc -y Y -o OUT.nc [-parareal_slices K] [OTHER PISM & PETSc OPTIONS]\n"
+      "where:\n"
+      "  -i                   IN.nc is a PISM output file containing the ice geometry, the ice\n"
+      "                       velocity (uvel, vvel, wvel_rel) and the initial enthalpy\n"
+      "  -parareal_slices K   split the run into K time slices handled by K groups of processes\n"
+      "notes:\n"
+      "  * the number of processes has to be divisible by K\n"
+      "  * all groups have to use the same domain decomposition\n";
+    {
+      bool done = show_usage_check_req_opts(*log, "PISM_PARAREAL (parareal thermal spin-up)",
+                                            {"-i"}, usage);
+      if (done) {
+        return 0;
+      }
+    }
+
+    std::shared_ptr<Grid> grid = Grid::FromOptions(ctx);
+
+    energy::Parareal model(grid, PETSC_COMM_WORLD, slice, n_slices);
+
+    // only the group handling the last slice reports progress and writes the output
+    if (not model.last_slice()) {
+      log->disable();
+    }
+
+    {
+      File input_file(com, config->get_string("input.file"), io::PISM_GUESS, io::PISM_READONLY);
+      model.init(input_file, input_file.nrecords() - 1);
+    }
+
+    auto time = ctx->time();
+
+    log->message(2, "* Running from %s to %s using %d time slice(s)...\n",
+                 time->date(time->start()).c_str(),
+                 time->date(time->end()).c_str(),
+                 (int)n_slices);
+
+    auto stats = model.run(time->start(), time->end());
+
+    log->message(2,
+                 "* Done after %d parareal iteration(s), %d fine propagator run(s) in the last slice.\n",
+                 stats.iterations, stats.fine_runs);
+
+    if (model.last_slice()) {
+      auto filename = config->get_string("output.file");
+
+      File file(grid->com, filename,
+                string_to_backend(config->get_string("output.format")),
+                io::PISM_READWRITE_MOVE,
+                ctx->pio_iosys_id());
+
+      io::define_time(file, *ctx);
+      io::append_time(file, *config, time->end());
+
+      model.write_model_state(file);
+    }
+  }
+  catch (...) {
+    handle_fatal_errors(com);
+    exit_code = 1;
+  }
+
+  return exit_code;
+}
@@ -0,0 +1,142 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "Converts 3D fields stored using the sparse encoding (-o_sparse_3d) to the dense layout.\n";
+
+#include <algorithm>
+#include <petscsys.h>           // PETSC_COMM_WORLD
+
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/VariableMetadata.hh"
+#include "pism/util/array/Array3D.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/IO_Flags.hh"
+#include "pism/util/io/io_helpers.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/pism_options.hh"
+
+using namespace pism;
+
+int main(int argc, char *argv[]) {
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  int exit_code = 0;
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_sparse_expand", false);
+
+    Logger::Ptr log = ctx->log();
+    Config::Ptr config = ctx->config();
+
+    std::string usage =
+      "  pism_sparse_expand -i IN.nc -o OUT.nc\n"
+      "where:\n"
+      "  -i          IN.nc is a PISM output file written using -o_sparse_3d\n"
+      "  -o          OUT.nc will contain dense versions of 3D fields in IN.nc\n"
+      "notes:\n"
+      "  * OUT.nc contains coordinate variables and 3D fields only; use\n"
+      "    'ncks -A -x -v ice_column,ice_column_count,<3D fields> IN.nc OUT.nc'\n"
+      "    to add the rest\n";
+    {
+      bool done = show_usage_check_req_opts(*log, "PISM_SPARSE_EXPAND (expand sparse 3D fields)",
+                                            {"-i", "-o"}, usage);
+      if (done) {
+        return 0;
+      }
+    }
+
+    auto input_filename  = config->get_string("input.file");
+    auto output_filename = config->get_string("output.file");
+
+    File input(com, input_filename, io::PISM_GUESS, io::PISM_READONLY);
+
+    std::vector<std::string> variables;
+    for (unsigned int k = 0; k < input.nvariables(); ++k) {
+      auto name = input.variable_name(k);
+      if (io::sparse_3d_variable(input, name)) {
+        variables.push_back(name);
+      }
+    }
+
+    if (variables.empty()) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "'%s' does not contain fields using the sparse encoding",
+                                    input_filename.c_str());
+    }
+
+    auto grid = Grid::FromFile(ctx, input_filename, variables,
+                               grid::string_to_registration(config->get_string("grid.registration")));
+
+    File output(com, output_filename,
+                string_to_backend(config->get_string("output.format")),
+                io::PISM_READWRITE_MOVE,
+                ctx->pio_iosys_id());
+
+    const unsigned int last_record = std::max(input.nrecords(), 1U) - 1;
+
+    // copy the last time record
+    auto time_name = config->get_string("time.dimension_name");
+    if (input.find_variable(time_name)) {
+      io::define_time(output, time_name,
+                      input.read_text_attribute(time_name, "calendar"),
+                      input.read_text_attribute(time_name, "units"),
+                      ctx->unit_system());
+      io::append_time(output, time_name, input.read_dimension(time_name).back());
+    }
+
+    for (const auto &name : variables) {
+      log->message(2, "* Expanding %s...\n", name.c_str());
+
+      std::vector<double> z;
+      for (const auto &d : io::uncompressed_dimensions(input, name)) {
+        if (input.dimension_type(d, ctx->unit_system()) == Z_AXIS) {
+          z = input.read_dimension(d);
+        }
+      }
+
+      array::Array3D field(grid, name, array::WITHOUT_GHOSTS, z);
+
+      auto &metadata = field.metadata();
+      io::read_attributes(input, name, metadata);
+      // empty text attributes are not written
+      metadata["dense_dimensions"] = "";
+      metadata.output_units(metadata.get_string("units"));
+      if (input.dimensions(name).size() == 1) {
+        metadata.set_time_independent(true);
+      }
+
+      field.read(input, last_record);
+      field.write(output);
+    }
+  }
+  catch (...) {
+    handle_fatal_errors(com);
+    exit_code = 1;
+  }
+
+  return exit_code;
+}
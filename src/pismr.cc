@@ -25,6 +25,8 @@ static char help[] =
 
 #include "pism/icemodel/IceModel.hh"
 #include "pism/icemodel/IceEISModel.hh"
+#include "pism/icemodel/GridSequence.hh"
+#include "pism/icemodel/DomainCropping.hh"
 #include "pism/util/Config.hh"
 #include "pism/util/Grid.hh"
 
@@ -35,7 +37,9 @@ static char help[] =
 #include "pism/util/pism_options.hh"
 
 #include "pism/regional/Grid_Regional.hh"
+#include "pism/regional/IceParentModel.hh"
 #include "pism/regional/IceRegionalModel.hh"
+#include "pism/regional/NestingCoupler.hh"
 
 using namespace pism;
 
@@ -84,6 +88,37 @@ int main(int argc, char *argv[]) {
 
   int exit_code = 0;
   try {
+    // Nested runs: the parent model and the regional model run concurrently on disjoint
+    // groups of processes.
+    bool nested = false, is_parent = false;
+    {
+      auto parent_size = options::Integer("-nesting_parent_size",
+                                          "number of processes running the parent model"
+                                          " in a nested run",
+                                          0);
+      if (parent_size.is_set()) {
+        nested = true;
+        com = nesting_split(PETSC_COMM_WORLD, parent_size, is_parent);
+
+        if (is_parent) {
+          auto parent_options = options::String("-nesting_parent_options",
+                                                "name of the file containing command-line"
+                                                " options of the parent model");
+          if (not parent_options.is_set()) {
+            throw RuntimeError(PISM_ERROR_LOCATION,
+                               "-nesting_parent_options is required in nested runs");
+          }
+
+          // Options in this file override command-line options used by the regional
+          // model. The parent model is *not* a regional model.
+          PetscErrorCode ierr = PetscOptionsClearValue(NULL, "-regional");
+          PISM_CHK(ierr, "PetscOptionsClearValue");
+          ierr = PetscOptionsInsertFile(com, NULL, parent_options->c_str(), PETSC_TRUE);
+          PISM_CHK(ierr, "PetscOptionsInsertFile");
+        }
+      }
+    }
+
     // Note: EISMINT II experiments G and H are not supported.
     auto eisII = options::Keyword("-eisII",
                                   "EISMINT II experiment name",
@@ -121,6 +156,8 @@ int main(int argc, char *argv[]) {
       "  -i                   IN.nc is input file in NetCDF format: contains PISM-written model state\n"
       "  -bootstrap           enable heuristics to produce an initial state from an incomplete input\n"
       "  -regional            enable \"regional mode\"\n"
+      "  -nesting_parent_size N  run a regional model nested in a parent model using N processes\n"
+      "                       for the parent model (requires -regional and -nesting_parent_options)\n"
       "  -eisII [experiment]  enable EISMINT II mode\n"
       "notes:\n"
       "  * option -i is required\n"
@@ -143,7 +180,45 @@ int main(int argc, char *argv[]) {
     std::shared_ptr<Grid> grid;
     std::unique_ptr<IceModel> model;
 
-    if (options::Bool("-regional", "enable regional (outlet glacier) mode")) {
+    bool sequence = grid_sequence_requested(*config);
+    bool cropping = domain_cropping_requested(*config);
+    if ((sequence or cropping) and
+        (nested or eisII.is_set() or
+         options::Bool("-regional", "enable regional (outlet glacier) mode"))) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "grid sequencing and domain cropping are not supported in regional,"
+                         " nested, and EISMINT II runs");
+    }
+
+    if (sequence and cropping) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "grid sequencing and domain cropping cannot be used together");
+    }
+
+    // models are allocated by run_grid_sequence() or run_with_domain_cropping() below
+    bool multiple_models = sequence or cropping;
+
+    if (multiple_models) {
+      // allocated below
+    } else if (nested) {
+      if (is_parent) {
+        grid = Grid::FromOptions(ctx);
+        auto nesting = std::make_shared<NestingCoupler>(grid, PETSC_COMM_WORLD,
+                                                        NestingCoupler::PARENT);
+        model.reset(new IceParentModel(grid, ctx, nesting));
+      } else {
+        if (not options::Bool("-regional", "enable regional (outlet glacier) mode")) {
+          throw RuntimeError(PISM_ERROR_LOCATION,
+                             "nested runs require -regional");
+        }
+        grid = regional_grid_from_options(ctx);
+        auto nesting = std::make_shared<NestingCoupler>(grid, PETSC_COMM_WORLD,
+                                                        NestingCoupler::CHILD);
+        auto regional_model = new IceRegionalModel(grid, ctx);
+        regional_model->set_nesting(nesting);
+        model.reset(regional_model);
+      }
+    } else if (options::Bool("-regional", "enable regional (outlet glacier) mode")) {
       grid = regional_grid_from_options(ctx);
       model.reset(new IceRegionalModel(grid, ctx));
     } else {
@@ -157,17 +232,26 @@ int main(int argc, char *argv[]) {
       }
     }
 
-    model->init();
+    if (not multiple_models) {
+      model->init();
+    }
 
     auto list_type = options::Keyword("-list_diagnostics",
                                       "List available diagnostic quantities and stop.",
                                       "all,spatial,scalar,json",
                                       "all");
 
-    if (list_type.is_set()) {
+    if (list_type.is_set() and not multiple_models) {
       model->list_diagnostics(list_type);
     } else {
-      auto termination_reason = model->run();
+      IceModelTerminationReason termination_reason = PISM_DONE;
+      if (sequence) {
+        termination_reason = run_grid_sequence(ctx, model);
+      } else if (cropping) {
+        termination_reason = run_with_domain_cropping(ctx, model);
+      } else {
+        termination_reason = model->run();
+      }
 
       switch (termination_reason) {
       case PISM_CHEKPOINT:
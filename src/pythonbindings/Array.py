@@ -1,7 +1,11 @@
 # code extending the Array class
 
 def regrid(self, filename, critical=False, default_value=0.0):
-    if critical == True:
+    """Regrid from a file or (if `filename` is an Array) from a field using a different
+    grid (in memory)."""
+    if isinstance(filename, Array):
+        self._regrid(filename)
+    elif critical == True:
         self._regrid(filename, Default.Nil())
     else:
         self._regrid(filename, Default(default_value))
@@ -35,3 +39,28 @@ def local_part(self):
         shape = (ym, xm, shape[2])
 
     return self.vec().get().array.reshape(shape)
+
+def local_view(self):
+    """Read-only NumPy array containing the local (sub-domain) part, without ghosts.
+
+    This is not a copy: it is a view of the PETSc storage used by this field. Use it to
+    compute reductions in in-situ analyses (see PISM.Analysis).
+    """
+
+    width = self.stencil_width()
+    shape = self.shape()
+
+    xm = self.grid().xm() + 2 * width
+    ym = self.grid().ym() + 2 * width
+
+    if len(shape) == 2:
+        shape = (ym, xm)
+    else:
+        shape = (ym, xm, shape[2])
+
+    data = self.petsc_vec().get().getArray(readonly=True).reshape(shape)
+
+    if width > 0:
+        return data[width:-width, width:-width, ...]
+
+    return data
@@ -46,6 +46,7 @@
 #include "basalstrength/MohrCoulombYieldStress.hh"
 #include "util/error_handling.hh"
 #include "util/Diagnostic.hh"
+#include "util/Analysis.hh"
 #include "util/Config.hh"
 
 #if (Pism_USE_JANSSON==1)
@@ -85,6 +86,8 @@
 %include std_vector.i
 %include std_set.i
 %include std_map.i
+// Fixed-width integer types (e.g. array::Array::state_counter())
+%include stdint.i
 
 %include <std_shared_ptr.i>
 
@@ -253,6 +256,11 @@ pism_class(pism::Time, "pism/util/Time.hh")
 
 %shared_ptr(pism::Diagnostic)
 %include "util/Diagnostic.hh"
+
+%ignore pism::AnalysisInputs::add(const std::string &, std::shared_ptr<const array::Array>);
+%feature("director") pism::Analysis;
+%shared_ptr(pism::Analysis)
+%include "util/Analysis.hh"
 %include "stressbalance/timestepping.hh"
 
 %shared_ptr(pism::Component)
@@ -282,6 +290,7 @@ pism_class(pism::MohrCoulombPointwise, "pism/basalstrength/MohrCoulombPointwise.
 pism_class(pism::YieldStress, "pism/basalstrength/YieldStress.hh")
 pism_class(pism::ConstantYieldStress, "pism/basalstrength/ConstantYieldStress.hh")
 pism_class(pism::MohrCoulombYieldStress, "pism/basalstrength/MohrCoulombYieldStress.hh")
+pism_class(pism::OptTillphiYieldStress, "pism/basalstrength/OptTillphiYieldStress.hh")
 pism_class(pism::RegionalYieldStress, "pism/regional/RegionalYieldStress.hh")
 
 %rename(StressBalanceInputs) pism::stressbalance::Inputs;
@@ -291,6 +300,7 @@ pism_class(pism::RegionalYieldStress, "pism/regional/RegionalYieldStress.hh")
 %include pism_SIA.i
 
 %include pism_blatter.i
+%include pism_diva.i
 
 %include pism_BedDef.i
 
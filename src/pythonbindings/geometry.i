@@ -1,6 +1,7 @@
 %{
 #include "geometry/Geometry.hh"
 #include "geometry/GeometryEvolution.hh"
+#include "geometry/flux_limiter.hh"
 %}
 
 
@@ -15,6 +16,9 @@
 %shared_ptr(pism::RegionalGeometryEvolution)
 %include "geometry/GeometryEvolution.hh"
 
+%ignore pism::nonnegative_preserving_flux;
+%include "geometry/flux_limiter.hh"
+
 #if (Pism_DEBUG==1)
 pism_class(pism::MPDATA2, "pism/geometry/MPDATA2.hh")
 pism_class(pism::UNO, "pism/geometry/UNO.hh")
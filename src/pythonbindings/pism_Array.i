@@ -20,9 +20,12 @@ using namespace pism;
 %shared_ptr(pism::array::Vector2)
 %shared_ptr(pism::array::Staggered)
 %shared_ptr(pism::array::Staggered1)
+%shared_ptr(pism::array::Staggered2)
 %shared_ptr(pism::array::Array3D)
 
-%ignore pism::array::AccessScope::AccessScope(std::initializer_list<const PetscAccessible *>);
+%ignore pism::array::AccessScope::AccessScope(std::initializer_list<Item>);
+%ignore pism::array::AccessScope::add(std::initializer_list<Item>);
+%ignore pism::array::AccessScope::Item;
 
 %ignore pism::array::Scalar::array;
 %ignore pism::array::Vector::array;
@@ -85,6 +88,30 @@ using namespace pism;
     %pythoncode "ArrayVector.py"
 };
 
+%extend pism::array::Staggered
+{
+    double getitem(int i, int j, int k)
+    {
+        return (*($self))(i,j,k);
+    }
+
+    void setitem(int i, int j, int k, double val)
+    {
+        (*($self))(i,j,k) = val;
+    }
+
+    %pythoncode {
+    def __getitem__(self, *args):
+        return self.getitem(args[0][0], args[0][1], args[0][2])
+
+    def __setitem__(self, *args):
+        if(len(args) == 2):
+            self.setitem(args[0][0], args[0][1], args[0][2], args[1])
+        else:
+            raise ValueError("__setitem__ requires 2 arguments; received %d" % len(args))
+    }
+};
+
 %ignore pism::array::Array3D::get_column(int, int);
 %ignore pism::array::Array3D::set_column(int, int, const double*);
 %extend pism::array::Array3D
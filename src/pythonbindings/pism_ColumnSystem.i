@@ -9,3 +9,9 @@
 %}
 
 %include "util/ColumnInterpolation.hh"
+
+%{
+#include "util/SigmaCoordinate.hh"
+%}
+
+%include "util/SigmaCoordinate.hh"
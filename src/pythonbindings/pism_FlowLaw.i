@@ -1,4 +1,5 @@
 %{
+#include "rheology/ArrheniusTable.hh"
 #include "rheology/FlowLaw.hh"
 #include "rheology/GPBLD.hh"
 #include "rheology/FlowLawFactory.hh"
@@ -14,7 +15,32 @@
 %shared_ptr(pism::rheology::PatersonBuddCold)
 %shared_ptr(pism::rheology::PatersonBuddWarm)
 
+%ignore pism::rheology::FlowLaw::hardness_n(const double *, const double *, unsigned int, double *) const;
+%ignore pism::rheology::FlowLaw::flow_n(const double *, const double *, const double *, const double *, unsigned int, double *) const;
+
+%include "rheology/ArrheniusTable.hh"
 %include "rheology/FlowLaw.hh"
+
+%extend pism::rheology::FlowLaw
+{
+  std::vector<double> hardness_n(const std::vector<double> &enthalpy,
+                                 const std::vector<double> &pressure) const {
+    std::vector<double> hardness(enthalpy.size());
+    $self->hardness_n(enthalpy.data(), pressure.data(), enthalpy.size(), hardness.data());
+    return hardness;
+  }
+
+  std::vector<double> flow_n(const std::vector<double> &stress,
+                             const std::vector<double> &enthalpy,
+                             const std::vector<double> &pressure,
+                             const std::vector<double> &grainsize) const {
+    std::vector<double> flow(stress.size());
+    $self->flow_n(stress.data(), enthalpy.data(), pressure.data(), grainsize.data(),
+                  stress.size(), flow.data());
+    return flow;
+  }
+};
+
 %include "rheology/GPBLD.hh"
 %include "rheology/PatersonBudd.hh"
 %include "rheology/PatersonBuddCold.hh"
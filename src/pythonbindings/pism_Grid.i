@@ -1,5 +1,6 @@
 %{
 #include "util/Grid.hh"
+#include "util/ProcessGrid.hh"
 %}
 
 %extend pism::Grid
@@ -24,3 +25,4 @@
 %rename("GridParameters") "pism::grid::Parameters";
 %shared_ptr(pism::Grid);
 %include "util/Grid.hh"
+%include "util/ProcessGrid.hh"
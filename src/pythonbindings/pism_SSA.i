@@ -4,6 +4,7 @@
 #include "stressbalance/ssa/SSA_diagnostics.hh"
 #include "stressbalance/ssa/SSAFD_diagnostics.hh"
 #include "stressbalance/StressBalance.hh"
+#include "stressbalance/VelocityDerivedFields.hh"
 %}
 
 %shared_ptr(pism::stressbalance::ShallowStressBalance)
@@ -26,6 +27,8 @@
 %shared_ptr(pism::stressbalance::PrescribedSliding)
 %include "stressbalance/ShallowStressBalance.hh"
 
+%include "stressbalance/VelocityDerivedFields.hh"
+
 %shared_ptr(pism::stressbalance::SSA)
 %include "stressbalance/ssa/SSA.hh"
 %shared_ptr(pism::stressbalance::SSAFD)
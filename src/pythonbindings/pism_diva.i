@@ -0,0 +1,10 @@
+
+pism_class(pism::stressbalance::DIVA,
+           "pism/stressbalance/diva/DIVA.hh")
+
+pism_class(pism::stressbalance::DIVAISMIPHOM,
+           "pism/stressbalance/diva/DIVAISMIPHOM.hh")
+
+/* DIVAMod has to be wrapped after DIVA */
+pism_class(pism::stressbalance::DIVAMod,
+           "pism/stressbalance/diva/DIVAMod.hh")
@@ -18,6 +18,7 @@
  */
 
 #include "pism/regional/EnthalpyModel_Regional.hh"
+#include "pism/util/error_handling.hh"
 
 namespace pism {
 namespace energy {
@@ -31,6 +32,12 @@ EnthalpyModel_Regional::EnthalpyModel_Regional(
   m_basal_melt_rate_stored.metadata(0)
       .long_name("time-independent basal melt rate in the no-model-strip")
       .units("m s-1");
+
+  if (m_config->get_flag("grid.sigma.enabled")) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "the regional energy balance model does not support"
+                       " the sigma coordinate (grid.sigma.enabled)");
+  }
 }
 
 void EnthalpyModel_Regional::restart_impl(const File &input_file, int record) {
@@ -99,5 +106,31 @@ void EnthalpyModel_Regional::update_impl(double t, double dt,
   }
 }
 
+/*!
+ * Set ice enthalpy in the `no_model_mask` strip (used to impose boundary values received
+ * from a parent model).
+ */
+void EnthalpyModel_Regional::set_no_model_strip_enthalpy(const array::Scalar &no_model_mask,
+                                                         const array::Array3D &enthalpy) {
+  unsigned int Mz = m_grid->Mz();
+
+  array::AccessScope list{&no_model_mask, &enthalpy, &m_ice_enthalpy};
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (no_model_mask(i, j) > 0.5) {
+      const double *E = enthalpy.get_column(i, j);
+      double *E_ice = m_ice_enthalpy.get_column(i, j);
+
+      for (unsigned int k = 0; k < Mz; ++k) {
+        E_ice[k] = E[k];
+      }
+    }
+  }
+
+  m_ice_enthalpy.update_ghosts();
+}
+
 } // end of namespace energy
 } // end of namespace pism
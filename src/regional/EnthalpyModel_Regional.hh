@@ -31,6 +31,9 @@ public:
   EnthalpyModel_Regional(std::shared_ptr<const Grid> grid,
                          std::shared_ptr<const stressbalance::StressBalance> stress_balance);
 
+  void set_no_model_strip_enthalpy(const array::Scalar &no_model_mask,
+                                   const array::Array3D &enthalpy);
+
 protected:
   virtual void restart_impl(const File &input_file, int record);
 
@@ -0,0 +1,70 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/regional/IceParentModel.hh"
+
+#include "pism/energy/EnergyModel.hh"
+#include "pism/regional/NestingCoupler.hh"
+#include "pism/stressbalance/ShallowStressBalance.hh"
+#include "pism/stressbalance/StressBalance.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+IceParentModel::IceParentModel(std::shared_ptr<Grid> grid, std::shared_ptr<Context> context,
+                               std::shared_ptr<NestingCoupler> nesting)
+  : IceModel(grid, context),
+    m_nesting(nesting) {
+  // empty
+}
+
+void IceParentModel::misc_setup() {
+  IceModel::misc_setup();
+
+  if (m_config->get_flag("time_stepping.rollback.enabled")) {
+    // boundary values sent to the regional model cannot be taken back
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "time_stepping.rollback.enabled is not supported by nested runs");
+  }
+
+  m_nesting->init();
+
+  // make sure that time steps stop at all coupling times
+  m_submodels["nesting"] = m_nesting.get();
+}
+
+/*!
+ * Send boundary values to the regional model if the current step ends at a coupling
+ * time.
+ *
+ * Note that this is called *before* the model time is updated: the ice geometry
+ * corresponds to the end of the step, the velocity to its beginning.
+ */
+void IceParentModel::post_step_hook() {
+  double t = m_time->current() + m_dt;
+
+  if (m_nesting->exchange_now(t)) {
+    m_nesting->send(t, m_geometry,
+                    m_stress_balance->shallow()->velocity(),
+                    m_energy_model->enthalpy());
+  }
+}
+
+} // end of namespace pism
@@ -0,0 +1,46 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ICEPARENTMODEL_H
+#define PISM_ICEPARENTMODEL_H
+
+#include "pism/icemodel/IceModel.hh"
+
+namespace pism {
+
+class NestingCoupler;
+
+//! A version of IceModel that provides boundary values to a regional model running
+//! concurrently (see NestingCoupler).
+class IceParentModel : public IceModel {
+public:
+  IceParentModel(std::shared_ptr<Grid> grid, std::shared_ptr<Context> context,
+                 std::shared_ptr<NestingCoupler> nesting);
+
+protected:
+  void misc_setup();
+  void post_step_hook();
+
+private:
+  std::shared_ptr<NestingCoupler> m_nesting;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_ICEPARENTMODEL_H */
@@ -24,10 +24,12 @@
 #include "pism/energy/utilities.hh"
 #include "pism/hydrology/Hydrology.hh"
 #include "pism/regional/EnthalpyModel_Regional.hh"
+#include "pism/regional/NestingCoupler.hh"
 #include "pism/regional/RegionalYieldStress.hh"
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/util/array/Forcing.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/Time.hh"
 
 namespace pism {
 
@@ -130,6 +132,91 @@ void IceRegionalModel::model_state_setup() {
   }
 }
 
+/*!
+ * Use boundary values provided by a parent model running concurrently.
+ *
+ * Has to be called before init().
+ */
+void IceRegionalModel::set_nesting(std::shared_ptr<NestingCoupler> nesting) {
+  m_nesting = nesting;
+}
+
+void IceRegionalModel::misc_setup() {
+  IceModel::misc_setup();
+
+  if (m_nesting) {
+    if (m_config->get_flag("time_stepping.rollback.enabled")) {
+      // boundary values received from the parent model cannot be received again
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "time_stepping.rollback.enabled is not supported by nested runs");
+    }
+
+    m_nesting->init(m_no_model_mask);
+
+    // make sure that time steps stop at all coupling times
+    m_submodels["nesting"] = m_nesting.get();
+  }
+}
+
+void IceRegionalModel::pre_step_hook() {
+  const double t = m_time->current();
+
+  if (m_nesting and m_nesting->exchange_now(t)) {
+    m_nesting->receive(t);
+    set_boundary_values(*m_nesting);
+  }
+}
+
+/*!
+ * Replace the ice thickness, surface elevation, sliding velocity (if
+ * `stress_balance.ssa.dirichlet_bc` is set) and enthalpy in the `no_model_mask` strip by
+ * values received from the parent model.
+ */
+void IceRegionalModel::set_boundary_values(const NestingCoupler &nesting) {
+  const bool zero_gradient = m_config->get_flag("regional.zero_gradient");
+  const bool dirichlet_bc  = m_config->get_flag("stress_balance.ssa.dirichlet_bc");
+
+  {
+    const auto &H = nesting.ice_thickness();
+    const auto &h = nesting.ice_surface_elevation();
+    const auto &v = nesting.velocity();
+
+    array::AccessScope list{ &m_no_model_mask, &H, &h, &v, &m_geometry.ice_thickness,
+                             &m_thk_stored, &m_usurf_stored, &m_velocity_bc_values };
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      if (m_no_model_mask(i, j) < 0.5) {
+        continue;
+      }
+
+      m_geometry.ice_thickness(i, j) = H(i, j);
+
+      if (not zero_gradient) {
+        m_thk_stored(i, j)   = H(i, j);
+        m_usurf_stored(i, j) = h(i, j);
+      }
+
+      if (dirichlet_bc) {
+        m_velocity_bc_values(i, j) = v(i, j);
+      }
+    }
+  }
+
+  m_geometry.ice_thickness.update_ghosts();
+  m_thk_stored.update_ghosts();
+  m_usurf_stored.update_ghosts();
+  m_velocity_bc_values.update_ghosts();
+
+  enforce_consistency_of_geometry(DONT_REMOVE_ICEBERGS);
+
+  auto *energy_model = dynamic_cast<energy::EnthalpyModel_Regional*>(m_energy_model.get());
+  if (energy_model != nullptr) {
+    energy_model->set_no_model_strip_enthalpy(m_no_model_mask, nesting.enthalpy());
+  }
+}
+
 void IceRegionalModel::allocate_geometry_evolution() {
   if (m_geometry_evolution) {
     return;
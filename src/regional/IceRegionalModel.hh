@@ -30,6 +30,8 @@ namespace energy {
 class CHSystem;
 } // end of namespace energy
 
+class NestingCoupler;
+
 //! \brief A version of the PISM core class (IceModel) which knows about the
 //! `no_model_mask` and its semantics.
 class IceRegionalModel : public IceModel {
@@ -38,6 +40,8 @@ public:
 
   const energy::CHSystem* cryo_hydrologic_system() const;
 
+  void set_nesting(std::shared_ptr<NestingCoupler> nesting);
+
 protected:
   virtual void bootstrap_2d(const File &input_file);
 
@@ -47,6 +51,9 @@ protected:
   void allocate_basal_yield_stress();
   void allocate_energy_model();
   void model_state_setup();
+  void misc_setup();
+
+  void pre_step_hook();
 
   void energy_step();
   void hydrology_step();
@@ -64,6 +71,11 @@ private:
 
   std::shared_ptr<energy::CHSystem> m_ch_system;
   std::shared_ptr<array::Array3D> m_ch_warming_flux;
+
+  void set_boundary_values(const NestingCoupler &nesting);
+
+  //! Source of boundary values in the `no_model_mask` strip (nested runs only)
+  std::shared_ptr<NestingCoupler> m_nesting;
 };
 
 } // end of namespace pism
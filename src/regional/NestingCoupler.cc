@@ -0,0 +1,502 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+#include "pism/regional/NestingCoupler.hh"
+
+#include "pism/geometry/Geometry.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/MaxTimestep.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+MPI_Comm nesting_split(MPI_Comm world, int parent_size, bool &is_parent) {
+  int rank = 0, size = 0;
+  MPI_Comm_rank(world, &rank);
+  MPI_Comm_size(world, &size);
+
+  if (parent_size < 1 or parent_size >= size) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "the number of processes running the parent model (%d)"
+                                  " has to be between 1 and %d",
+                                  parent_size, size - 1);
+  }
+
+  is_parent = rank < parent_size;
+
+  MPI_Comm result = MPI_COMM_NULL;
+  int ierr = MPI_Comm_split(world, is_parent ? 0 : 1, rank, &result);
+  if (ierr != MPI_SUCCESS) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "MPI_Comm_split failed");
+  }
+
+  return result;
+}
+
+namespace {
+
+/*!
+ * Find `k` such that `x[k] <= X < x[k + 1]` and the corresponding linear interpolation
+ * weight. Values outside of `[x[0], x[N-1]]` are clipped.
+ */
+void interval(const std::vector<double> &x, double X, int &k, double &weight) {
+  const int N = x.size();
+
+  if (N == 1 or X <= x[0]) {
+    k      = 0;
+    weight = 0.0;
+    return;
+  }
+
+  if (X >= x[N - 1]) {
+    k      = N - 2;
+    weight = 1.0;
+    return;
+  }
+
+  k      = std::upper_bound(x.begin(), x.end(), X) - x.begin() - 1;
+  weight = (X - x[k]) / (x[k + 1] - x[k]);
+}
+
+std::vector<int> displacements(const std::vector<int> &counts) {
+  std::vector<int> result(counts.size(), 0);
+  for (unsigned int k = 1; k < counts.size(); ++k) {
+    result[k] = result[k - 1] + counts[k - 1];
+  }
+  return result;
+}
+
+} // end of anonymous namespace
+
+NestingCoupler::NestingCoupler(std::shared_ptr<const Grid> grid, MPI_Comm world, Role role)
+    : Component(grid),
+      m_world(world),
+      m_role(role),
+      m_t_next(0.0),
+      m_dt(0.0),
+      m_initialized(false),
+      m_parent_Mz(0),
+      m_ice_thickness(grid, "nesting_thk"),
+      m_ice_surface_elevation(grid, "nesting_usurf"),
+      m_velocity(grid, "nesting_velocity"),
+      m_enthalpy(grid, "nesting_enthalpy", array::WITHOUT_GHOSTS, grid->z()) {
+
+  m_dt = m_config->get_number("regional.nesting.dt", "seconds");
+
+  if (m_dt <= 0.0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "regional.nesting.dt has to be positive (got %f seconds)",
+                                  m_dt);
+  }
+
+  m_ice_thickness.metadata(0).long_name("ice thickness received from the parent model").units("m");
+  m_ice_surface_elevation.metadata(0)
+      .long_name("ice surface elevation received from the parent model")
+      .units("m");
+  m_velocity.metadata(0).long_name("x-component of the sliding velocity received from the parent model").units("m s-1");
+  m_velocity.metadata(1).long_name("y-component of the sliding velocity received from the parent model").units("m s-1");
+  m_enthalpy.metadata(0).long_name("ice enthalpy received from the parent model").units("J kg-1");
+}
+
+NestingCoupler::Role NestingCoupler::role() const {
+  return m_role;
+}
+
+void NestingCoupler::init() {
+  if (m_role != PARENT) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "the child model has to provide no_model_mask");
+  }
+  init_impl(nullptr);
+}
+
+void NestingCoupler::init(const array::Scalar &no_model_mask) {
+  if (m_role != CHILD) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "the parent model does not use no_model_mask");
+  }
+  init_impl(&no_model_mask);
+}
+
+/*!
+ * Set up the communication pattern and compute interpolation weights.
+ */
+void NestingCoupler::init_impl(const array::Scalar *no_model_mask) {
+
+  m_log->message(2, "* Initializing %s side of the nested model coupling...\n",
+                 m_role == PARENT ? "the parent" : "the regional");
+
+  int world_size = 0;
+  MPI_Comm_size(m_world, &world_size);
+
+  // Processor ownership ranges
+  const int n_info = 5;
+  std::vector<int> ownership(n_info * world_size);
+  {
+    int local[n_info] = { m_role, m_grid->xs(), m_grid->xm(), m_grid->ys(), m_grid->ym() };
+    MPI_Allgather(local, n_info, MPI_INT, ownership.data(), n_info, MPI_INT, m_world);
+  }
+
+  int parent_root = -1;
+  for (int r = 0; r < world_size; ++r) {
+    if (ownership[n_info * r + 0] == PARENT) {
+      parent_root = r;
+      break;
+    }
+  }
+
+  if (parent_root < 0) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "no processes are running the parent model");
+  }
+
+  // Parent grid
+  std::vector<double> parent_x, parent_y, parent_z;
+  {
+    int size[3] = {0, 0, 0};
+    if (m_role == PARENT) {
+      size[0] = m_grid->Mx();
+      size[1] = m_grid->My();
+      size[2] = m_grid->Mz();
+    }
+    MPI_Bcast(size, 3, MPI_INT, parent_root, m_world);
+
+    parent_x.resize(size[0]);
+    parent_y.resize(size[1]);
+    parent_z.resize(size[2]);
+
+    if (m_role == PARENT) {
+      parent_x = m_grid->x();
+      parent_y = m_grid->y();
+      parent_z = m_grid->z();
+    }
+
+    MPI_Bcast(parent_x.data(), size[0], MPI_DOUBLE, parent_root, m_world);
+    MPI_Bcast(parent_y.data(), size[1], MPI_DOUBLE, parent_root, m_world);
+    MPI_Bcast(parent_z.data(), size[2], MPI_DOUBLE, parent_root, m_world);
+
+    m_parent_Mz = size[2];
+  }
+
+  // Check that both models cover the same time interval
+  {
+    double times[2] = {time().start(), time().end()};
+    MPI_Bcast(times, 2, MPI_DOUBLE, parent_root, m_world);
+
+    double eps = m_config->get_number("time_stepping.resolution");
+
+    int local_ok = (std::abs(times[0] - time().start()) < eps and
+                    std::abs(times[1] - time().end()) < eps) ? 1 : 0;
+    int ok = 0;
+    MPI_Allreduce(&local_ok, &ok, 1, MPI_INT, MPI_MIN, m_world);
+
+    if (ok == 0) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "parent and regional models have to use the same start and end times");
+    }
+  }
+
+  m_send_counts.assign(world_size, 0);
+  m_recv_counts.assign(world_size, 0);
+  m_recv_indices.clear();
+  m_stencils.clear();
+
+  if (m_role == CHILD) {
+    const int Mx = parent_x.size();
+
+    // owner of a point of the parent grid
+    auto owner = [&](int i, int j) {
+      for (int r = 0; r < world_size; ++r) {
+        const int *o = &ownership[n_info * r];
+        if (o[0] == PARENT and
+            i >= o[1] and i < o[1] + o[2] and
+            j >= o[3] and j < o[3] + o[4]) {
+          return r;
+        }
+      }
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "point (%d, %d) of the parent grid is not owned by any process",
+                                    i, j);
+    };
+
+    // linear indices of parent grid points needed by this process
+    std::vector<Stencil> stencils;
+    std::vector<std::set<int> > requests(world_size);
+    {
+      array::AccessScope list{ no_model_mask };
+
+      for (auto p = m_grid->points(); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        if ((*no_model_mask)(i, j) < 0.5) {
+          continue;
+        }
+
+        int I = 0, J = 0;
+        double alpha = 0.0, beta = 0.0;
+        interval(parent_x, m_grid->x(i), I, alpha);
+        interval(parent_y, m_grid->y(j), J, beta);
+
+        const int I1 = std::min(I + 1, (int)parent_x.size() - 1);
+        const int J1 = std::min(J + 1, (int)parent_y.size() - 1);
+
+        Stencil s;
+        s.i         = i;
+        s.j         = j;
+        s.index[0]  = J * Mx + I;
+        s.index[1]  = J * Mx + I1;
+        s.index[2]  = J1 * Mx + I1;
+        s.index[3]  = J1 * Mx + I;
+        s.weight[0] = (1.0 - alpha) * (1.0 - beta);
+        s.weight[1] = alpha * (1.0 - beta);
+        s.weight[2] = alpha * beta;
+        s.weight[3] = (1.0 - alpha) * beta;
+
+        for (int n = 0; n < 4; ++n) {
+          int idx = s.index[n];
+          requests[owner(idx % Mx, idx / Mx)].insert(idx);
+        }
+
+        stencils.push_back(s);
+      }
+    }
+
+    // Data received from the parent are sorted by the rank of the sender, then by the
+    // linear index.
+    std::map<int, int> position;
+    for (int r = 0; r < world_size; ++r) {
+      m_recv_counts[r] = requests[r].size();
+      for (int idx : requests[r]) {
+        position[idx] = m_recv_indices.size();
+        m_recv_indices.push_back(idx);
+      }
+    }
+
+    for (auto &s : stencils) {
+      for (int n = 0; n < 4; ++n) {
+        s.index[n] = position[s.index[n]];
+      }
+    }
+    m_stencils = stencils;
+
+    // vertical interpolation
+    {
+      const auto &z = m_grid->z();
+      m_k_below.resize(z.size());
+      m_k_weight.resize(z.size());
+      for (unsigned int k = 0; k < z.size(); ++k) {
+        interval(parent_z, z[k], m_k_below[k], m_k_weight[k]);
+      }
+    }
+  }
+
+  // Tell the parent which points to send
+  {
+    MPI_Alltoall(m_recv_counts.data(), 1, MPI_INT, m_send_counts.data(), 1, MPI_INT, m_world);
+
+    int n_send = 0;
+    for (int c : m_send_counts) {
+      n_send += c;
+    }
+    m_send_indices.resize(n_send);
+
+    auto send_displ = displacements(m_send_counts);
+    auto recv_displ = displacements(m_recv_counts);
+
+    // note: the child *sends* requests and the parent *receives* them
+    MPI_Alltoallv(m_recv_indices.data(), m_recv_counts.data(), recv_displ.data(), MPI_INT,
+                  m_send_indices.data(), m_send_counts.data(), send_displ.data(), MPI_INT,
+                  m_world);
+  }
+
+  // the first exchange happens one coupling interval after the start of the run
+  m_t_next      = time().current() + m_dt;
+  m_initialized = true;
+}
+
+bool NestingCoupler::exchange_now(double t) const {
+  if (not m_initialized) {
+    return false;
+  }
+
+  double eps = m_config->get_number("time_stepping.resolution");
+
+  // Both models stop at the end of the run, so there is no exchange at that time.
+  return t >= m_t_next - eps and t < time().end() - eps;
+}
+
+void NestingCoupler::advance(double t) {
+  double eps = m_config->get_number("time_stepping.resolution");
+
+  while (m_t_next <= t + eps) {
+    m_t_next += m_dt;
+  }
+}
+
+unsigned int NestingCoupler::values_per_point() const {
+  // ice thickness, surface elevation, two components of the velocity and an enthalpy
+  // column
+  return 4 + m_parent_Mz;
+}
+
+void NestingCoupler::transfer(const std::vector<double> &send_buffer,
+                              std::vector<double> &recv_buffer) {
+  const int world_size = m_send_counts.size();
+  const int N          = values_per_point();
+
+  std::vector<int> send_counts(world_size), recv_counts(world_size);
+  for (int r = 0; r < world_size; ++r) {
+    send_counts[r] = N * m_send_counts[r];
+    recv_counts[r] = N * m_recv_counts[r];
+  }
+
+  auto send_displ = displacements(send_counts);
+  auto recv_displ = displacements(recv_counts);
+
+  recv_buffer.resize(N * m_recv_indices.size());
+
+  MPI_Alltoallv(const_cast<double *>(send_buffer.data()), send_counts.data(), send_displ.data(), MPI_DOUBLE,
+                recv_buffer.data(), recv_counts.data(), recv_displ.data(), MPI_DOUBLE,
+                m_world);
+}
+
+void NestingCoupler::send(double t, const Geometry &geometry, const array::Vector &velocity,
+                          const array::Array3D &enthalpy) {
+  if (m_role != PARENT) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "only the parent model can send boundary values");
+  }
+
+  const int Mx = m_grid->Mx();
+  const int N  = values_per_point();
+
+  std::vector<double> buffer(N * m_send_indices.size()), unused;
+  {
+    array::AccessScope list{ &geometry.ice_thickness, &geometry.ice_surface_elevation,
+                             &velocity, &enthalpy };
+
+    for (unsigned int n = 0; n < m_send_indices.size(); ++n) {
+      const int i = m_send_indices[n] % Mx, j = m_send_indices[n] / Mx;
+
+      double *values = &buffer[N * n];
+
+      values[0] = geometry.ice_thickness(i, j);
+      values[1] = geometry.ice_surface_elevation(i, j);
+      values[2] = velocity(i, j).u;
+      values[3] = velocity(i, j).v;
+
+      const double *E = enthalpy.get_column(i, j);
+      for (unsigned int k = 0; k < m_parent_Mz; ++k) {
+        values[4 + k] = E[k];
+      }
+    }
+  }
+
+  transfer(buffer, unused);
+
+  advance(t);
+}
+
+void NestingCoupler::receive(double t) {
+  if (m_role != CHILD) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "only the regional model can receive boundary values");
+  }
+
+  const int N = values_per_point();
+
+  std::vector<double> buffer, empty;
+  transfer(empty, buffer);
+
+  const unsigned int Mz = m_grid->Mz();
+  std::vector<double> column(m_parent_Mz);
+
+  array::AccessScope list{ &m_ice_thickness, &m_ice_surface_elevation, &m_velocity, &m_enthalpy };
+
+  for (const auto &s : m_stencils) {
+    const int i = s.i, j = s.j;
+
+    double H = 0.0, h = 0.0, u = 0.0, v = 0.0;
+    std::fill(column.begin(), column.end(), 0.0);
+
+    for (int n = 0; n < 4; ++n) {
+      const double *values = &buffer[N * s.index[n]];
+      const double w = s.weight[n];
+
+      H += w * values[0];
+      h += w * values[1];
+      u += w * values[2];
+      v += w * values[3];
+
+      for (unsigned int k = 0; k < m_parent_Mz; ++k) {
+        column[k] += w * values[4 + k];
+      }
+    }
+
+    m_ice_thickness(i, j)         = H;
+    m_ice_surface_elevation(i, j) = h;
+    m_velocity(i, j)              = Vector2d(u, v);
+
+    double *E = m_enthalpy.get_column(i, j);
+    for (unsigned int k = 0; k < Mz; ++k) {
+      const int k0 = m_k_below[k];
+      const int k1 = std::min(k0 + 1, (int)m_parent_Mz - 1);
+      const double w = m_k_weight[k];
+
+      E[k] = (1.0 - w) * column[k0] + w * column[k1];
+    }
+  }
+
+  advance(t);
+}
+
+MaxTimestep NestingCoupler::max_timestep_impl(double t) const {
+  if (not m_initialized) {
+    return MaxTimestep("nesting");
+  }
+
+  double eps = m_config->get_number("time_stepping.resolution");
+
+  double dt = m_t_next - t;
+  if (dt < eps) {
+    dt = m_dt;
+  }
+
+  return MaxTimestep(dt, "nesting");
+}
+
+const array::Scalar& NestingCoupler::ice_thickness() const {
+  return m_ice_thickness;
+}
+
+const array::Scalar& NestingCoupler::ice_surface_elevation() const {
+  return m_ice_surface_elevation;
+}
+
+const array::Vector& NestingCoupler::velocity() const {
+  return m_velocity;
+}
+
+const array::Array3D& NestingCoupler::enthalpy() const {
+  return m_enthalpy;
+}
+
+} // end of namespace pism
@@ -0,0 +1,143 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_NESTINGCOUPLER_H
+#define PISM_NESTINGCOUPLER_H
+
+#include <vector>
+
+#include "pism/util/Component.hh"
+#include "pism/util/array/Array3D.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/array/Vector.hh"
+
+namespace pism {
+
+class Geometry;
+
+/*!
+ * Split `world` into the group running the parent (usually global) model and the group
+ * running the regional model.
+ *
+ * Processes with ranks below `parent_size` run the parent model.
+ */
+MPI_Comm nesting_split(MPI_Comm world, int parent_size, bool &is_parent);
+
+//! Concurrent one-way nesting of a regional model inside a running parent model.
+/*!
+ * The parent and the regional ("child") model run concurrently on disjoint groups of
+ * processes of the communicator `world` (see nesting_split()). At coupling times
+ * (multiples of `regional.nesting.dt` since the start of the run, excluding the start and
+ * the end of the run) the parent model sends ice thickness, surface elevation, sliding
+ * velocity and enthalpy to processes of the child model that own points in the
+ * `no_model_mask` strip. The child model uses boundary values from its input file until
+ * the first exchange. Values are interpolated
+ * (bilinearly in the horizontal and linearly in the vertical) using weights that are
+ * computed once during initialization.
+ *
+ * Both models register a NestingCoupler as a sub-model so that their time steps stop at
+ * all coupling times (see max_timestep()). All methods except for max_timestep() are
+ * collective on `world`.
+ */
+class NestingCoupler : public Component {
+public:
+  enum Role { PARENT, CHILD };
+
+  NestingCoupler(std::shared_ptr<const Grid> grid, MPI_Comm world, Role role);
+  virtual ~NestingCoupler() = default;
+
+  Role role() const;
+
+  //! Initialize the parent side.
+  void init();
+  //! Initialize the child side. Boundary values are transferred at points where
+  //! `no_model_mask` is set.
+  void init(const array::Scalar &no_model_mask);
+
+  //! True if the model has to exchange boundary values at time `t`.
+  bool exchange_now(double t) const;
+
+  //! Send boundary values corresponding to time `t` (parent side).
+  void send(double t, const Geometry &geometry, const array::Vector &velocity,
+            const array::Array3D &enthalpy);
+
+  //! Receive boundary values corresponding to time `t` (child side).
+  void receive(double t);
+
+  //! Boundary values received during the last exchange (valid in the `no_model_mask`
+  //! strip).
+  const array::Scalar& ice_thickness() const;
+  const array::Scalar& ice_surface_elevation() const;
+  const array::Vector& velocity() const;
+  const array::Array3D& enthalpy() const;
+
+private:
+  MaxTimestep max_timestep_impl(double t) const;
+
+  void init_impl(const array::Scalar *no_model_mask);
+
+  //! Number of values transferred per grid point.
+  unsigned int values_per_point() const;
+
+  void transfer(const std::vector<double> &send_buffer, std::vector<double> &recv_buffer);
+
+  void advance(double t);
+
+  MPI_Comm m_world;
+  Role m_role;
+
+  //! Time of the next exchange
+  double m_t_next;
+  //! Time between exchanges
+  double m_dt;
+  bool m_initialized;
+
+  //! Number of vertical levels in the parent grid
+  unsigned int m_parent_Mz;
+
+  // Communication pattern (sizes are equal to the size of `world`)
+  std::vector<int> m_send_counts;
+  std::vector<int> m_recv_counts;
+  //! Parent side: linear (j * Mx + i) indices of points requested by each process
+  std::vector<int> m_send_indices;
+  //! Child side: linear indices of points received from the parent, in order
+  std::vector<int> m_recv_indices;
+
+  //! Child side: interpolation stencil of a point in the `no_model_mask` strip
+  struct Stencil {
+    int i, j;
+    //! Positions of parent grid neighbors in the receive buffer
+    int index[4];
+    double weight[4];
+  };
+  std::vector<Stencil> m_stencils;
+
+  //! Child side: linear interpolation in the vertical direction
+  std::vector<int> m_k_below;
+  std::vector<double> m_k_weight;
+
+  array::Scalar m_ice_thickness;
+  array::Scalar m_ice_surface_elevation;
+  array::Vector m_velocity;
+  array::Array3D m_enthalpy;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_NESTINGCOUPLER_H */
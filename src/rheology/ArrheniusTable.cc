@@ -0,0 +1,88 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/rheology/ArrheniusTable.hh"
+
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace rheology {
+
+ArrheniusTable::ArrheniusTable(double Q, double R)
+  : m_a(Q / R), m_x_min(0.0), m_dx(1.0), m_dx_inv(1.0), m_s_max(-1.0) {
+  // empty
+}
+
+ArrheniusTable::ArrheniusTable(double Q, double R, double T_min, double T_max,
+                               double relative_error)
+  : ArrheniusTable(Q, R) {
+
+  if (not (relative_error > 0.0) or Q == 0.0) {
+    // all values are computed using exp()
+    return;
+  }
+
+  if (not (T_min > 0.0 and T_max > T_min)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid Arrhenius table range: [%f, %f] Kelvin", T_min, T_max);
+  }
+
+  // Find the largest z = |a| dx / 2 (the largest |d| in from_inverse_temperature()) such
+  // that the relative error of the Taylor polynomial z^5 / 120 * exp(2 z) does not exceed
+  // `relative_error`. A few fixed point iterations are enough.
+  double z = std::pow(120.0 * relative_error, 0.2);
+  for (int k = 0; k < 5; ++k) {
+    z = std::pow(120.0 * relative_error * std::exp(-2.0 * z), 0.2);
+  }
+
+  const double
+    x_min = 1.0 / T_max,
+    x_max = 1.0 / T_min,
+    dx    = 2.0 * z / std::fabs(m_a);
+
+  const double N = std::ceil((x_max - x_min) / dx) + 1.0;
+
+  // don't allow tables that are too big to be useful
+  const double N_max = 1e6;
+  if (N > N_max) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "Arrhenius table with the relative error of %e would need %e"
+                                  " points (Q = %f J/mol)",
+                                  relative_error, N, Q);
+  }
+
+  const auto n_points = static_cast<unsigned int>(N);
+
+  m_x_min  = x_min;
+  m_dx     = (x_max - x_min) / (n_points - 1);
+  m_dx_inv = 1.0 / m_dx;
+  m_s_max  = n_points - 1;
+
+  m_values.resize(n_points);
+  for (unsigned int k = 0; k < n_points; ++k) {
+    m_values[k] = std::exp(-m_a * (m_x_min + k * m_dx));
+  }
+}
+
+unsigned int ArrheniusTable::size() const {
+  return m_values.size();
+}
+
+} // end of namespace rheology
+} // end of namespace pism
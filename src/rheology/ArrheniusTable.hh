@@ -0,0 +1,88 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ARRHENIUSTABLE_H
+#define PISM_ARRHENIUSTABLE_H
+
+#include <cmath>
+#include <vector>
+
+namespace pism {
+namespace rheology {
+
+//! Tabulated Arrhenius factor @f$ \exp(-Q / (R T)) @f$.
+/*!
+ * Values are stored at equally spaced points in @f$ x = 1/T @f$ covering
+ * @f$ [T_{\text{min}}, T_{\text{max}}] @f$. Between table points we use
+ *
+ * @f[ \exp(-a x) = \exp(-a x_k) \exp(-a (x - x_k)), \quad a = Q / R, @f]
+ *
+ * where @f$ x_k @f$ is the nearest table point and the second factor is approximated by
+ * the 4th degree Taylor polynomial. The spacing of table points is chosen so that the
+ * relative error does not exceed `relative_error` (up to rounding errors).
+ *
+ * Values outside of the table range (and all values if `relative_error` is zero) are
+ * computed using `exp()`.
+ */
+class ArrheniusTable {
+public:
+  //! Create an "empty" table (all values are computed using `exp()`).
+  ArrheniusTable(double Q = 0.0, double R = 1.0);
+  ArrheniusTable(double Q, double R, double T_min, double T_max, double relative_error);
+
+  //! Returns @f$ \exp(-Q / (R T)) @f$.
+  double operator()(double T) const {
+    return from_inverse_temperature(1.0 / T);
+  }
+
+  //! Returns @f$ \exp(-Q x / R) @f$, where @f$ x = 1 / T @f$.
+  double from_inverse_temperature(double x) const {
+    const double s = (x - m_x_min) * m_dx_inv;
+
+    // note: this is false if s is NaN and if the table is empty (m_s_max < 0)
+    if (not (s >= 0.0 and s <= m_s_max)) {
+      return std::exp(-m_a * x);
+    }
+
+    const auto k  = static_cast<unsigned int>(s + 0.5);
+    const double d = -m_a * (x - (m_x_min + k * m_dx));
+
+    return m_values[k] * (1.0 + d * (1.0 + d * (0.5 + d * (1.0 / 6.0 + d * (1.0 / 24.0)))));
+  }
+
+  //! Number of table points (zero if the table is empty).
+  unsigned int size() const;
+
+private:
+  //! Q / R
+  double m_a;
+  //! 1 / T_max
+  double m_x_min;
+  //! spacing of table points in 1 / T
+  double m_dx;
+  double m_dx_inv;
+  //! index of the last point (as a floating point number); negative if the table is empty
+  double m_s_max;
+  std::vector<double> m_values;
+};
+
+} // end of namespace rheology
+} // end of namespace pism
+
+#endif /* PISM_ARRHENIUSTABLE_H */
@@ -56,6 +56,15 @@ FlowLaw::FlowLaw(const std::string &prefix, const Config &config,
   m_Q_warm = config.get_number("flow_law.Paterson_Budd.Q_warm");
   m_crit_temp = config.get_number("flow_law.Paterson_Budd.T_critical");
 
+  m_arrhenius_table_error = config.get_number("flow_law.Arrhenius_table.relative_error");
+
+  m_softness_cold = arrhenius_table(m_Q_cold);
+  m_softness_warm = arrhenius_table(m_Q_warm);
+  m_hardness_cold = arrhenius_table(-m_Q_cold / m_n);
+  m_hardness_warm = arrhenius_table(-m_Q_warm / m_n);
+  m_B_cold        = pow(m_A_cold, m_hardness_power);
+  m_B_warm        = pow(m_A_warm, m_hardness_power);
+
   double
     schoofLen = config.get_number("flow_law.Schoof_regularizing_length", "m"),
     schoofVel = config.get_number("flow_law.Schoof_regularizing_velocity", "m second-1");
@@ -75,13 +84,36 @@ double FlowLaw::exponent() const {
   return m_n;
 }
 
+/*!
+ * Create a table of Arrhenius factors @f$ \exp(-Q/(RT)) @f$ covering temperatures of ice
+ * in a typical ice sheet (values outside of this range are computed using `exp()`).
+ */
+ArrheniusTable FlowLaw::arrhenius_table(double Q) const {
+  const double
+    T_min = 200.0,              // Kelvin
+    T_max = 300.0;              // Kelvin
+
+  return ArrheniusTable(Q, m_ideal_gas_constant, T_min, T_max, m_arrhenius_table_error);
+}
+
 //! Return the softness parameter A(T) for a given temperature T.
 /*! This is not a natural part of all FlowLaw instances.   */
 double FlowLaw::softness_paterson_budd(double T_pa) const {
-  const double A = T_pa < m_crit_temp ? m_A_cold : m_A_warm;
-  const double Q = T_pa < m_crit_temp ? m_Q_cold : m_Q_warm;
+  if (T_pa < m_crit_temp) {
+    return m_A_cold * m_softness_cold(T_pa);
+  }
+  return m_A_warm * m_softness_warm(T_pa);
+}
 
-  return A * exp(-Q / (m_ideal_gas_constant * T_pa));
+//! Return the hardness parameter @f$ A(T)^{-1/n} @f$ corresponding to softness_paterson_budd().
+/*!
+ * Uses @f$ A(T)^{-1/n} = A_0^{-1/n} \exp(Q / (n R T)) @f$ to avoid calling `pow()`.
+ */
+double FlowLaw::hardness_paterson_budd(double T_pa) const {
+  if (T_pa < m_crit_temp) {
+    return m_B_cold * m_hardness_cold(T_pa);
+  }
+  return m_B_warm * m_hardness_warm(T_pa);
 }
 
 //! The flow law itself.
@@ -204,6 +236,7 @@ void averaged_hardness_vec(const FlowLaw &ice,
   loop.check();
 
   result.update_ghosts();
+  result.inc_state_counter();
 }
 
 //! Computes vertical average of `B(E, p)` ice hardness, namely @f$\bar B(E, p)@f$.
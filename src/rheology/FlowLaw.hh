@@ -23,6 +23,7 @@
 
 #include "pism/util/EnthalpyConverter.hh"
 #include "pism/util/Vector2d.hh"
+#include "pism/rheology/ArrheniusTable.hh"
 
 namespace pism {
 
@@ -126,6 +127,9 @@ protected:
   EnthalpyConverter::Ptr m_EC;
 
   double softness_paterson_budd(double T_pa) const;
+  double hardness_paterson_budd(double T_pa) const;
+
+  ArrheniusTable arrhenius_table(double Q) const;
 
   //! regularization parameter for @f$ \gamma @f$
   double m_schoofReg;
@@ -146,6 +150,15 @@ protected:
   //! critical temperature (cold -- warm transition)
   double m_crit_temp;
 
+  //! maximum relative error of tabulated Arrhenius factors
+  double m_arrhenius_table_error;
+  //! @f$ \exp(-Q/(RT)) @f$ for cold and warm ice (Paterson-Budd softness)
+  ArrheniusTable m_softness_cold, m_softness_warm;
+  //! @f$ \exp(Q/(nRT)) @f$ for cold and warm ice (Paterson-Budd hardness)
+  ArrheniusTable m_hardness_cold, m_hardness_warm;
+  //! @f$ A_{\text{cold}}^{-1/n} @f$ and @f$ A_{\text{warm}}^{-1/n} @f$
+  double m_B_cold, m_B_warm;
+
   //! acceleration due to gravity
   double m_standard_gravity;
   //! ideal gas constant
@@ -20,6 +20,9 @@
 #include "pism/rheology/GPBLD.hh"
 #include "pism/util/ConfigInterface.hh"
 
+#include <algorithm>              // std::min
+#include <cmath>                  // pow
+
 namespace pism {
 namespace rheology {
 
@@ -36,6 +39,9 @@ GPBLD::GPBLD(const std::string &prefix,
   m_water_frac_coeff = config.get_number("flow_law.gpbld.water_frac_coeff");
 
   m_water_frac_observed_limit = config.get_number("flow_law.gpbld.water_frac_observed_limit");
+
+  m_softness_T_0 = softness_paterson_budd(m_T_0);
+  m_hardness_T_0 = hardness_paterson_budd(m_T_0);
 }
 
 //! The softness factor in the Glen-Paterson-Budd-Lliboutry-Duval flow law.  For constitutive law form.
@@ -56,7 +62,29 @@ double GPBLD::softness_impl(double enthalpy, double pressure) const {
     // as stated in \ref AschwandenBuelerBlatter, cap omega at max of observations:
     omega = std::min(omega, m_water_frac_observed_limit);
     // next line implements eqn (23) in \ref AschwandenBlatter2009
-    return softness_paterson_budd(m_T_0) * (1.0 + m_water_frac_coeff * omega);
+    return m_softness_T_0 * (1.0 + m_water_frac_coeff * omega);
+  }
+}
+
+/*!
+ * Computes @f$ A^{-1/n} @f$ using hardness_paterson_budd() (no `pow()` calls in cold ice).
+ */
+double GPBLD::hardness_impl(double enthalpy, double pressure) const {
+  const double E_s = m_EC->enthalpy_cts(pressure);
+  if (enthalpy < E_s) {       // cold ice
+    double T_pa = m_EC->pressure_adjusted_temperature(enthalpy, pressure);
+    return hardness_paterson_budd(T_pa);
+  } else { // temperate ice
+    double omega = m_EC->water_fraction(enthalpy, pressure);
+    omega = std::min(omega, m_water_frac_observed_limit);
+    return m_hardness_T_0 * pow(1.0 + m_water_frac_coeff * omega, m_hardness_power);
+  }
+}
+
+void GPBLD::hardness_n_impl(const double *enthalpy, const double *pressure,
+                            unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = GPBLD::hardness_impl(enthalpy[k], pressure[k]);
   }
 }
 
@@ -66,7 +94,7 @@ void GPBLD::flow_n_impl(const double *stress, const double *enthalpy,
   // optimize the common case of Glen n=3
   if (m_n == 3.0) {
     for (unsigned int k = 0; k < n; ++k) {
-      result[k] = this->softness(enthalpy[k], pressure[k]) * (stress[k] * stress[k]);
+      result[k] = GPBLD::softness_impl(enthalpy[k], pressure[k]) * (stress[k] * stress[k]);
     }
 
     return;
@@ -35,10 +35,16 @@ public:
   GPBLD(const std::string &prefix, const Config &config, EnthalpyConverter::Ptr EC);
 protected:
   double softness_impl(double enthalpy, double pressure) const;
+  double hardness_impl(double enthalpy, double pressure) const;
+  void hardness_n_impl(const double *enthalpy, const double *pressure,
+                       unsigned int n, double *result) const;
   void flow_n_impl(const double *stress, const double *enthalpy,
                    const double *pressure, const double *grainsize,
                    unsigned int n, double *result) const;
   double m_T_0, m_water_frac_coeff, m_water_frac_observed_limit;
+
+  //! softness and hardness of temperate ice with zero water fraction
+  double m_softness_T_0, m_hardness_T_0;
 };
 
 } // end of namespace rheology
@@ -66,6 +66,14 @@ GoldsbyKohlstedt::GoldsbyKohlstedt(const std::string &prefix,
   m_diff_D_0b      = 5.8e-4;    // preexponential grain boundary coeff.
   m_diff_Q_b       = 49.e3;     // activation energy, g.b. (J/mol)
   m_diff_delta     = 9.04e-10;  // grain boundary width (m)
+
+  m_diff_v_factor    = arrhenius_table(m_diff_Q_v);
+  m_diff_b_factor    = arrhenius_table(m_diff_Q_b);
+  m_disl_cold_factor = arrhenius_table(m_disl_Q_cold);
+  m_disl_warm_factor = arrhenius_table(m_disl_Q_warm);
+  m_basal_factor     = arrhenius_table(m_basal_Q);
+  m_gbs_cold_factor  = arrhenius_table(m_gbs_Q_cold);
+  m_gbs_warm_factor  = arrhenius_table(m_gbs_Q_warm);
 }
 
 double GoldsbyKohlstedt::flow_impl(double stress, double E,
@@ -79,11 +87,18 @@ double GoldsbyKohlstedt::hardness_impl(double enthalpy, double pressure) const {
   // We use the Paterson-Budd relation for the hardness parameter. It would be nice if we didn't
   // have to, but we currently need ice hardness to compute the strain heating. See
   // SIAFD::compute_volumetric_strain_heating().
-  double
-    T_pa = m_EC->pressure_adjusted_temperature(enthalpy, pressure),
-    A = softness_paterson_budd(T_pa);
+  double T_pa = m_EC->pressure_adjusted_temperature(enthalpy, pressure);
+
+  return hardness_paterson_budd(T_pa);
+}
 
-  return pow(A, m_hardness_power);
+void GoldsbyKohlstedt::hardness_n_impl(const double *enthalpy, const double *pressure,
+                                       unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    double T_pa = m_EC->pressure_adjusted_temperature(enthalpy[k], pressure[k]);
+
+    result[k] = hardness_paterson_budd(T_pa);
+  }
 }
 
 double GoldsbyKohlstedt::softness_impl(double , double) const {
@@ -137,6 +152,74 @@ double GoldsbyKohlstedt::flow_from_temp(double stress, double temp,
   return eps_diff + eps_disl + (eps_basal * eps_gbs) / (eps_basal + eps_gbs);
 }
 
+/*!
+ * Column-batched version of flow_impl().
+ *
+ * Uses tabulated Arrhenius factors (see ArrheniusTable) and evaluates the activation
+ * volume factor @f$ \exp(-pV/(RT)) @f$ shared by all creep mechanisms once per level. Grain
+ * size factors are re-computed only if the grain size changes from one level to the next
+ * and stress powers use one `log()` per level.
+ */
+void GoldsbyKohlstedt::flow_n_impl(const double *stress, const double *enthalpy,
+                                   const double *pressure, const double *grainsize,
+                                   unsigned int n, double *result) const {
+  const double beta = m_beta_CC_grad / (m_rho * m_standard_gravity);
+
+  // grain size and the corresponding diffusional flow and grain boundary sliding factors
+  double gs = -1.0, diff_gs_factor = 0.0, gbs_gs_factor = 0.0;
+
+  for (unsigned int k = 0; k < n; ++k) {
+    const double s = stress[k];
+
+    if (fabs(s) < 1e-10) {
+      result[k] = 0.0;
+      continue;
+    }
+
+    if (grainsize[k] != gs) {
+      gs             = grainsize[k];
+      diff_gs_factor = 42 * m_diff_V_m / (gs * gs);
+      gbs_gs_factor  = 1.0 / pow(gs, m_p_grain_sz_exp);
+    }
+
+    const double
+      p         = pressure[k],
+      T         = m_EC->temperature(enthalpy[k], p) + beta * p,
+      x         = 1.0 / T,
+      RT        = m_ideal_gas_constant * T,
+      pV_factor = exp(-p * m_V_act_vol / RT),
+      log_s     = log(s);
+
+    // Diffusional Flow
+    const double diff_D_v = m_diff_D_0v * m_diff_v_factor.from_inverse_temperature(x);
+    double diff_D_b = m_diff_D_0b * m_diff_b_factor.from_inverse_temperature(x);
+    if (T > m_diff_crit_temp) {
+      diff_D_b *= 1000; // Coble creep scaling
+    }
+    const double eps_diff = diff_gs_factor * (diff_D_v + M_PI * m_diff_delta * diff_D_b / gs) / RT;
+
+    // Dislocation Creep
+    const double
+      disl_stress = m_disl_n == 4.0 ? s * s * s : exp((m_disl_n - 1) * log_s),
+      eps_disl    = disl_stress * pV_factor *
+      (T > m_disl_crit_temp ?
+       m_disl_A_warm * m_disl_warm_factor.from_inverse_temperature(x) :
+       m_disl_A_cold * m_disl_cold_factor.from_inverse_temperature(x));
+
+    // Basal Slip
+    const double eps_basal = m_basal_A * exp((m_basal_n - 1) * log_s) * pV_factor *
+                             m_basal_factor.from_inverse_temperature(x);
+
+    // Grain Boundary Sliding
+    const double eps_gbs = exp((m_gbs_n - 1) * log_s) * gbs_gs_factor * pV_factor *
+      (T > m_gbs_crit_temp ?
+       m_gbs_A_warm * m_gbs_warm_factor.from_inverse_temperature(x) :
+       m_gbs_A_cold * m_gbs_cold_factor.from_inverse_temperature(x));
+
+    result[k] = eps_diff + eps_disl + (eps_basal * eps_gbs) / (eps_basal + eps_gbs);
+  }
+}
+
 
 /*****************
 THE NEXT PROCEDURE REPEATS CODE; INTENDED ONLY FOR DEBUGGING
@@ -232,6 +315,13 @@ double GoldsbyKohlstedtStripped::flow_from_temp(double stress, double temp, doub
   return eps_disl + (eps_basal * eps_gbs) / (eps_basal + eps_gbs);
 }
 
+void GoldsbyKohlstedtStripped::flow_n_impl(const double *stress, const double *enthalpy,
+                                           const double *pressure, const double *grainsize,
+                                           unsigned int n, double *result) const {
+  // the batched version in GoldsbyKohlstedt does not use flow_from_temp()
+  FlowLaw::flow_n_impl(stress, enthalpy, pressure, grainsize, n, result);
+}
+
 
 } // end of namespace rheology
 } // end of namespace pism
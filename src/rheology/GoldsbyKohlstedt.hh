@@ -50,10 +50,15 @@ public:
 protected:
   virtual double flow_impl(double stress, double E,
                            double pressure, double grainsize) const;
+  virtual void flow_n_impl(const double *stress, const double *E,
+                           const double *pressure, const double *grainsize,
+                           unsigned int n, double *result) const;
 
   // NB! not virtual
   double softness_impl(double E, double p) const __attribute__((noreturn));
   double hardness_impl(double E, double p) const;
+  void hardness_n_impl(const double *enthalpy, const double *pressure,
+                       unsigned int n, double *result) const;
   virtual double flow_from_temp(double stress, double temp,
                                 double pressure, double gs) const;
   GKparts flowParts(double stress, double temp, double pressure) const;
@@ -68,6 +73,10 @@ protected:
   //--- grain boundary sliding ---
     m_gbs_crit_temp, m_gbs_A_cold, m_gbs_A_warm, m_gbs_n, m_gbs_Q_cold,
     m_p_grain_sz_exp, m_gbs_Q_warm;
+
+  //! tabulated Arrhenius factors used by flow_n_impl()
+  ArrheniusTable m_diff_v_factor, m_diff_b_factor, m_disl_cold_factor, m_disl_warm_factor,
+    m_basal_factor, m_gbs_cold_factor, m_gbs_warm_factor;
 };
 
 //! Derived class of GoldsbyKohlstedt for testing purposes only.
@@ -83,6 +92,9 @@ public:
 protected:
   virtual double flow_from_temp(double stress, double temp,
                                 double pressure, double gs) const;
+  virtual void flow_n_impl(const double *stress, const double *E,
+                           const double *pressure, const double *grainsize,
+                           unsigned int n, double *result) const;
 
   double m_d_grain_size_stripped;
 };
@@ -0,0 +1,171 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "Compares scalar and column-batched evaluation of flow laws (flow and hardness).\n"
+  "Usage: flowlaw_benchmark [-Mz <levels>] [-repeat <N>]\n\n";
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "pism/rheology/FlowLawFactory.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/EnthalpyConverter.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace {
+
+using namespace pism;
+
+//! A column of ice: from the surface to the base of a 3 km thick ice sheet.
+struct Column {
+  Column(const EnthalpyConverter &EC, unsigned int N) {
+    const double H = 3000.0;
+
+    for (unsigned int k = 0; k < N; ++k) {
+      const double
+        depth = H * k / (N - 1),
+        p     = EC.pressure(depth),
+        T     = std::min(230.0 + 45.0 * depth / H, EC.melting_temperature(p));
+
+      pressure.push_back(p);
+      enthalpy.push_back(EC.enthalpy(T, 0.0, p));
+      stress.push_back(1e3 + 1e5 * depth / H);
+      grain_size.push_back(1e-3);
+    }
+  }
+
+  std::vector<double> stress, enthalpy, pressure, grain_size;
+};
+
+double max_relative_difference(const std::vector<double> &a, const std::vector<double> &b) {
+  double result = 0.0;
+  for (size_t k = 0; k < a.size(); ++k) {
+    if (b[k] != 0.0) {
+      result = std::max(result, std::fabs(a[k] - b[k]) / std::fabs(b[k]));
+    }
+  }
+  return result;
+}
+
+void benchmark(std::shared_ptr<Context> ctx, const std::string &flow_law_name,
+               const Column &column, int N_repeat) {
+  auto config = ctx->config();
+  auto EC     = ctx->enthalpy_converter();
+  auto log    = ctx->log();
+
+  const std::string prefix = "stress_balance.sia.";
+
+  rheology::FlowLawFactory factory(prefix, config, EC);
+  factory.set_default(flow_law_name);
+  auto law = factory.create();
+
+  // reference flow law evaluating exp() directly
+  std::shared_ptr<rheology::FlowLaw> reference;
+  {
+    const double relative_error = config->get_number("flow_law.Arrhenius_table.relative_error");
+    config->set_number("flow_law.Arrhenius_table.relative_error", 0.0);
+    rheology::FlowLawFactory reference_factory(prefix, config, EC);
+    reference_factory.set_default(flow_law_name);
+    reference = reference_factory.create();
+    config->set_number("flow_law.Arrhenius_table.relative_error", relative_error);
+  }
+
+  const unsigned int N = column.stress.size();
+  const double *S = column.stress.data(), *E = column.enthalpy.data(),
+               *P = column.pressure.data(), *GS = column.grain_size.data();
+
+  std::vector<double> scalar(N), batched(N), exact(N);
+
+  // flow
+  double t0 = get_time(ctx->com());
+  for (int r = 0; r < N_repeat; ++r) {
+    for (unsigned int k = 0; k < N; ++k) {
+      scalar[k] = law->flow(S[k], E[k], P[k], GS[k]);
+    }
+  }
+  double t1 = get_time(ctx->com());
+  for (int r = 0; r < N_repeat; ++r) {
+    law->flow_n(S, E, P, GS, N, batched.data());
+  }
+  double t2 = get_time(ctx->com());
+  for (unsigned int k = 0; k < N; ++k) {
+    exact[k] = reference->flow(S[k], E[k], P[k], GS[k]);
+  }
+
+  log->message(1, "%s:\n", law->name().c_str());
+  log->message(1, "  flow:     scalar %9.3f ms, batched %9.3f ms (speedup %.2f)\n",
+               (t1 - t0) * 1e3, (t2 - t1) * 1e3, (t1 - t0) / (t2 - t1));
+  log->message(1, "            max. relative difference: batched vs scalar %e, batched vs exact %e\n",
+               max_relative_difference(batched, scalar), max_relative_difference(batched, exact));
+
+  // hardness
+  t0 = get_time(ctx->com());
+  for (int r = 0; r < N_repeat; ++r) {
+    for (unsigned int k = 0; k < N; ++k) {
+      scalar[k] = law->hardness(E[k], P[k]);
+    }
+  }
+  t1 = get_time(ctx->com());
+  for (int r = 0; r < N_repeat; ++r) {
+    law->hardness_n(E, P, N, batched.data());
+  }
+  t2 = get_time(ctx->com());
+  for (unsigned int k = 0; k < N; ++k) {
+    exact[k] = reference->hardness(E[k], P[k]);
+  }
+
+  log->message(1, "  hardness: scalar %9.3f ms, batched %9.3f ms (speedup %.2f)\n",
+               (t1 - t0) * 1e3, (t2 - t1) * 1e3, (t1 - t0) / (t2 - t1));
+  log->message(1, "            max. relative difference: batched vs scalar %e, batched vs exact %e\n",
+               max_relative_difference(batched, scalar), max_relative_difference(batched, exact));
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  try {
+    auto ctx = context_from_options(com, "flowlaw_benchmark");
+
+    options::Integer Mz("-Mz", "number of levels in a column", 401);
+    options::Integer N_repeat("-repeat", "number of repetitions", 1000);
+
+    Column column(*ctx->enthalpy_converter(), Mz);
+
+    for (const auto &name : {"gk", "gpbld", "pb"}) {
+      benchmark(ctx, name, column, N_repeat);
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -24,6 +24,7 @@
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/util/array/Vector.hh"
 #include "pism/util/Context.hh"
+#include "pism/util/pism_utilities.hh" // GlobalMax
 
 namespace pism {
 namespace stressbalance {
@@ -81,6 +82,39 @@ std::shared_ptr<const rheology::FlowLaw> SSB_Modifier::flow_law() const {
   return m_flow_law;
 }
 
+/*!
+ * Estimate max SIA-type diffusivity assuming that `Q = -D \nabla h`.
+ */
+void SSB_Modifier::compute_max_diffusivity(const array::Vector &velocity,
+                                           const array::Scalar &ice_thickness,
+                                           const array::Scalar1 &surface) {
+  const double eps = 1e-3;
+  double
+    dx = m_grid->dx(),
+    dy = m_grid->dy();
+
+  array::AccessScope list{&velocity, &ice_thickness, &surface};
+
+  m_D_max = 0.0;
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    auto h = surface.star(i, j);
+    auto H = ice_thickness(i, j);
+
+    if (H > 0.0) {
+      Vector2d grad_h = {(h.e - h.w) / (2.0 * dx),
+                        (h.n - h.s) / (2.0 * dy)};
+
+      double D = H * velocity(i, j).magnitude() / (grad_h.magnitude() + eps);
+
+      m_D_max = std::max(D, m_D_max);
+    }
+  }
+
+  m_D_max = GlobalMax(m_grid->com, m_D_max);
+}
+
 void ConstantInColumn::init() {
   SSB_Modifier::init();
 }
@@ -62,6 +62,10 @@ public:
   std::shared_ptr<const rheology::FlowLaw> flow_law() const;
 
 protected:
+  void compute_max_diffusivity(const array::Vector &velocity,
+                               const array::Scalar &ice_thickness,
+                               const array::Scalar1 &surface);
+
   std::shared_ptr<rheology::FlowLaw> m_flow_law;
   EnthalpyConverter::Ptr m_EC;
   double m_D_max;
@@ -19,6 +19,7 @@
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/stressbalance/ShallowStressBalance.hh"
 #include "pism/stressbalance/SSB_Modifier.hh"
+#include "pism/stressbalance/VelocityDerivedFields.hh"
 #include "pism/util/EnthalpyConverter.hh"
 #include "pism/rheology/FlowLaw.hh"
 #include "pism/util/Grid.hh"
@@ -141,7 +142,8 @@ StressBalance::StressBalance(std::shared_ptr<const Grid> g,
     m_w(m_grid, "wvel_rel", array::WITHOUT_GHOSTS, m_grid->z()),
     m_strain_heating(m_grid, "strain_heating", array::WITHOUT_GHOSTS, m_grid->z()),
     m_shallow_stress_balance(sb),
-    m_modifier(ssb_mod) {
+    m_modifier(ssb_mod),
+    m_velocity_derived_fields(new VelocityDerivedFields(m_grid, sb)) {
 
   m_w.metadata(0)
       .long_name("vertical velocity of ice, relative to base of ice directly below")
@@ -167,6 +169,9 @@ void StressBalance::init() {
 void StressBalance::update(const Inputs &inputs, bool full_update) {
 
   try {
+    // strain rates and stresses computed using the old velocity are out of date
+    m_velocity_derived_fields->invalidate();
+
     profiling().begin("stress_balance.shallow");
     m_shallow_stress_balance->update(inputs, full_update);
     profiling().end("stress_balance.shallow");
@@ -212,6 +217,10 @@ CFLData StressBalance::max_timestep_cfl_3d() const {
   return m_cfl_3d;
 }
 
+const VelocityDerivedFields& StressBalance::velocity_derived_fields() const {
+  return *m_velocity_derived_fields;
+}
+
 const array::Vector& StressBalance::advective_velocity() const {
   return m_shallow_stress_balance->velocity();
 }
@@ -36,6 +36,7 @@ namespace stressbalance {
 
 class ShallowStressBalance;
 class SSB_Modifier;
+class VelocityDerivedFields;
 
 class Inputs {
 public:
@@ -121,6 +122,10 @@ public:
 
   //! \brief Returns a pointer to a stress balance modifier implementation.
   const SSB_Modifier* modifier() const;
+
+  //! \brief Strain rates and stresses derived from the advective velocity (computed on
+  //! demand, shared by calving and fracture density models).
+  const VelocityDerivedFields& velocity_derived_fields() const;
 protected:
   virtual DiagnosticList diagnostics_impl() const;
   virtual TSDiagnosticList ts_diagnostics_impl() const;
@@ -141,6 +146,8 @@ protected:
 
   std::shared_ptr<ShallowStressBalance> m_shallow_stress_balance;
   std::shared_ptr<SSB_Modifier> m_modifier;
+
+  std::unique_ptr<VelocityDerivedFields> m_velocity_derived_fields;
 };
 
 std::shared_ptr<StressBalance> create(const std::string &model_name,
@@ -0,0 +1,158 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/stressbalance/VelocityDerivedFields.hh"
+
+#include <limits>
+
+#include "pism/stressbalance/ShallowStressBalance.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Profiling.hh"
+#include "pism/util/array/CellType.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace stressbalance {
+
+VelocityDerivedFields::Key::Key()
+  : generation(-1),
+    velocity_state(std::numeric_limits<uint64_t>::max()),
+    cell_type(nullptr),
+    cell_type_state(std::numeric_limits<uint64_t>::max()),
+    hardness(nullptr),
+    hardness_state(std::numeric_limits<uint64_t>::max()) {
+  // empty
+}
+
+bool VelocityDerivedFields::Key::operator==(const Key &other) const {
+  return (generation == other.generation and velocity_state == other.velocity_state and
+          cell_type == other.cell_type and cell_type_state == other.cell_type_state and
+          hardness == other.hardness and hardness_state == other.hardness_state);
+}
+
+VelocityDerivedFields::VelocityDerivedFields(std::shared_ptr<const Grid> grid,
+                                             std::shared_ptr<const ShallowStressBalance> stress_balance)
+  : m_stress_balance(stress_balance),
+    m_generation(0),
+    m_strain_rates(grid, "strain_rates", array::WITH_GHOSTS, 2),
+    m_strain_rates_valid(false),
+    m_deviatoric_stresses(grid, "sigma", array::WITHOUT_GHOSTS),
+    m_deviatoric_stresses_valid(false) {
+
+  m_strain_rates.metadata(0).set_name("eigen1");
+  m_strain_rates.metadata(0)
+      .long_name("major principal component of horizontal strain-rate")
+      .units("second-1");
+
+  m_strain_rates.metadata(1).set_name("eigen2");
+  m_strain_rates.metadata(1)
+      .long_name("minor principal component of horizontal strain-rate")
+      .units("second-1");
+
+  m_deviatoric_stresses.metadata(0).set_name("sigma_xx");
+  m_deviatoric_stresses.metadata(0).long_name("deviatoric stress in x direction").units("Pa");
+
+  m_deviatoric_stresses.metadata(1).set_name("sigma_yy");
+  m_deviatoric_stresses.metadata(1).long_name("deviatoric stress in y direction").units("Pa");
+
+  m_deviatoric_stresses.metadata(2).set_name("sigma_xy");
+  m_deviatoric_stresses.metadata(2).long_name("deviatoric shear stress").units("Pa");
+}
+
+void VelocityDerivedFields::invalidate() {
+  m_generation += 1;
+  m_strain_rates_valid        = false;
+  m_deviatoric_stresses_valid = false;
+}
+
+VelocityDerivedFields::Key VelocityDerivedFields::key(const array::CellType1 &cell_type,
+                                                      const array::Scalar *hardness) const {
+  Key result;
+
+  result.generation      = m_generation;
+  result.velocity_state  = m_stress_balance->velocity().state_counter();
+  result.cell_type       = &cell_type;
+  result.cell_type_state = cell_type.state_counter();
+
+  if (hardness != nullptr) {
+    result.hardness       = hardness;
+    result.hardness_state = hardness->state_counter();
+  }
+
+  return result;
+}
+
+/*!
+ * Returns principal strain rates of the advective velocity computed using `cell_type`.
+ *
+ * Ghosts are up to date (stencil width 2).
+ */
+const array::Array2D<PrincipalStrainRates> &
+VelocityDerivedFields::principal_strain_rates(const array::CellType1 &cell_type) const {
+  auto K = key(cell_type, nullptr);
+
+  if (not (m_strain_rates_valid and K == m_strain_rates_key)) {
+    const auto &profiling = m_strain_rates.grid()->ctx()->profiling();
+    profiling.begin("stress_balance.strain_rates");
+    {
+      compute_2D_principal_strain_rates(m_stress_balance->velocity(), cell_type,
+                                        m_strain_rates);
+      m_strain_rates.update_ghosts();
+    }
+    profiling.end("stress_balance.strain_rates");
+
+    m_strain_rates_key   = K;
+    m_strain_rates_valid = true;
+  }
+
+  return m_strain_rates;
+}
+
+/*!
+ * Returns deviatoric stresses corresponding to the advective velocity, computed using the
+ * vertically-averaged ice hardness `hardness` and `cell_type`.
+ *
+ * Ghosts are *not* updated.
+ */
+const array::Array2D<DeviatoricStresses> &
+VelocityDerivedFields::deviatoric_stresses(const array::Scalar &hardness,
+                                           const array::CellType1 &cell_type) const {
+  auto K = key(cell_type, &hardness);
+
+  if (not (m_deviatoric_stresses_valid and K == m_deviatoric_stresses_key)) {
+    auto flow_law = m_stress_balance->flow_law();
+    if (not flow_law) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "deviatoric stresses require a stress balance model with a flow law");
+    }
+
+    compute_2D_stresses(*flow_law, m_stress_balance->velocity(), hardness, cell_type,
+                        m_deviatoric_stresses);
+
+    m_deviatoric_stresses_key   = K;
+    m_deviatoric_stresses_valid = true;
+  }
+
+  return m_deviatoric_stresses;
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
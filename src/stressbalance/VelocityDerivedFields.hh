@@ -0,0 +1,98 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_VELOCITYDERIVEDFIELDS_H
+#define PISM_VELOCITYDERIVEDFIELDS_H
+
+#include "pism/stressbalance/StressBalance.hh" // PrincipalStrainRates, DeviatoricStresses
+#include "pism/util/array/Array2D.hh"
+
+namespace pism {
+
+namespace array {
+class CellType1;
+class Scalar;
+} // end of namespace array
+
+namespace stressbalance {
+
+class ShallowStressBalance;
+
+//! Fields derived from the advective (2D) ice velocity, shared by calving and fracture models.
+/*!
+ * Principal strain rates and deviatoric stresses are computed on demand and re-used until
+ * inputs change. Strain rates have ghosts (stencil width 2) filled using one exchange;
+ * deviatoric stresses are used point-wise and don't have ghosts.
+ *
+ * Cached values are invalidated by StressBalance::update() (see invalidate()) and
+ * whenever the state counter of the velocity field changes.
+ *
+ * Both quantities use one-sided differences at ice margins, so they depend on the cell type
+ * mask as well. The mask (its identity and its state counter) is a part of the cache key:
+ * consumers that use the same mask share results.
+ */
+class VelocityDerivedFields {
+public:
+  VelocityDerivedFields(std::shared_ptr<const Grid> grid,
+                        std::shared_ptr<const ShallowStressBalance> stress_balance);
+
+  //! Mark all cached fields as out of date.
+  void invalidate();
+
+  const array::Array2D<PrincipalStrainRates> &
+  principal_strain_rates(const array::CellType1 &cell_type) const;
+
+  const array::Array2D<DeviatoricStresses> &
+  deviatoric_stresses(const array::Scalar &hardness, const array::CellType1 &cell_type) const;
+
+private:
+  //! Identifies inputs used to compute a cached field.
+  struct Key {
+    Key();
+
+    bool operator==(const Key &other) const;
+
+    int generation;
+    uint64_t velocity_state;
+    const void *cell_type;
+    uint64_t cell_type_state;
+    const void *hardness;
+    uint64_t hardness_state;
+  };
+
+  Key key(const array::CellType1 &cell_type, const array::Scalar *hardness) const;
+
+  std::shared_ptr<const ShallowStressBalance> m_stress_balance;
+
+  //! incremented by invalidate()
+  int m_generation;
+
+  mutable array::Array2D<PrincipalStrainRates> m_strain_rates;
+  mutable Key m_strain_rates_key;
+  mutable bool m_strain_rates_valid;
+
+  mutable array::Array2D<DeviatoricStresses> m_deviatoric_stresses;
+  mutable Key m_deviatoric_stresses_key;
+  mutable bool m_deviatoric_stresses_valid;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_VELOCITYDERIVEDFIELDS_H */
@@ -258,8 +258,13 @@ bool Blatter::marine_boundary(int face,
 Blatter::Blatter(std::shared_ptr<const Grid> grid, int Mz, int coarsening_factor)
   : ShallowStressBalance(grid),
     m_parameters(grid, "bp_input_parameters", array::WITH_GHOSTS),
+    m_ice_only(false),
+    m_snes_iterations(0),
+    m_ksp_iterations(0),
+    m_active_columns_changed(true),
     m_face4(grid->dx(), grid->dy(), fem::Q1Quadrature4()),    // 4-point Gaussian quadrature
-    m_face100(grid->dx(), grid->dy(), fem::Q1QuadratureN(10)) // 100-point quadrature for grounding lines
+    m_face100(grid->dx(), grid->dy(), fem::Q1QuadratureN(10)), // 100-point quadrature for grounding lines
+    m_tuner(grid, "Blatter", "bp_")
 {
 
   assert(m_face4.n_pts() <= m_Nq);
@@ -273,6 +278,36 @@ Blatter::Blatter(std::shared_ptr<const Grid> grid, int Mz, int coarsening_factor
                        "Failed to allocate a Blatter solver instance");
   }
 
+  m_ice_only = m_config->get_flag("stress_balance.blatter.ice_only");
+  if (m_ice_only) {
+    ice_only_init();
+
+    if (m_config->get_flag("solver_tuning.enabled") or
+        not m_config->get_string("solver_tuning.input_file").empty()) {
+      m_log->message(2, "Blatter solver: solver tuning is disabled in the ice-only mode\n");
+    }
+  } else {
+    // Candidate linear solver configurations (see solver_tuning.enabled). The number of
+    // multigrid levels is fixed by the grid hierarchy created in setup(), so only
+    // smoothers are compared when multigrid is used.
+    int mg_levels = options::Integer("-bp_pc_mg_levels", "", 1);
+    if (mg_levels > 1) {
+      m_tuner.add_candidate("mg_richardson_sor",
+                            "-mg_levels_ksp_type richardson -mg_levels_pc_type sor");
+      m_tuner.add_candidate("mg_chebyshev_sor",
+                            "-mg_levels_ksp_type chebyshev -mg_levels_pc_type sor");
+      m_tuner.add_candidate("mg_chebyshev_jacobi",
+                            "-mg_levels_ksp_type chebyshev -mg_levels_pc_type jacobi");
+      m_tuner.add_candidate("mg_gmres_bjacobi",
+                            "-mg_levels_ksp_type gmres -mg_levels_pc_type bjacobi");
+    } else {
+      m_tuner.add_candidate("bjacobi_ilu0", "-ksp_type gmres -pc_type bjacobi -sub_pc_type ilu");
+      m_tuner.add_candidate("asm1_ilu0", "-ksp_type gmres -pc_type asm -pc_asm_overlap 1"
+                            " -sub_pc_type ilu");
+      m_tuner.add_candidate("gamg", "-ksp_type gmres -pc_type gamg");
+    }
+  }
+
   {
     std::vector<double> sigma(Mz);
     double dz = 1.0 / (Mz - 1.0);
@@ -385,6 +420,8 @@ PetscErrorCode Blatter::setup(DM pism_da, grid::Periodicity periodicity, int Mz,
   MPI_Comm comm;
   PetscErrorCode ierr = PetscObjectGetComm((PetscObject)pism_da, &comm); CHKERRQ(ierr);
 
+  m_prefix = prefix;
+
   // FIXME: add the ability to add a prefix to the option prefix. We need this to be able
   // to run more than one instance of PISM in parallel.
   auto option = pism::printf("-%spc_mg_levels", prefix.c_str());
@@ -743,6 +780,15 @@ void Blatter::report_mesh_info() {
     }
   }
 
+  // number of icy and boundary columns
+  double n_columns = 0.0;
+  for (int j = info.ys; j < info.ys + info.ym; j++) {
+    for (int i = info.xs; i < info.xs + info.xm; i++) {
+      n_columns += static_cast<double>((int)m_parameters(i, j).node_type != NODE_EXTERIOR);
+    }
+  }
+
+  n_columns = GlobalSum(m_grid->com, n_columns);
   n_cells = GlobalSum(m_grid->com, n_cells);
   R_avg = GlobalSum(m_grid->com, R_avg);
   R_avg /= std::max(n_cells, 1.0);
@@ -754,6 +800,18 @@ void Blatter::report_mesh_info() {
                  "Blatter solver: %d * (%d - 1) = %d active elements\n",
                  (int)n_cells, (int)info.mz, (int)(n_cells * (info.mz - 1)));
 
+  {
+    // two degrees of freedom (u and v) per node
+    double
+      N_total  = 2.0 * info.mx * info.my * info.mz,
+      N_active = 2.0 * n_columns * info.mz;
+
+    m_log->message(2,
+                   "  Unknowns: %d total, %d in icy and boundary columns (%3.1f%%)%s\n",
+                   (int)N_total, (int)N_active, 100.0 * N_active / N_total,
+                   m_ice_only ? ", preconditioning icy and boundary columns only" : "");
+  }
+
   if (n_cells > 0) {
     m_log->message(2,
                    "  Vertical spacing (m): min = %3.3f, max = %3.3f, avg = %3.3f\n",
@@ -772,7 +830,11 @@ Blatter::SolutionInfo Blatter::solve() {
   SolutionInfo result;
 
   // Solve the system:
-  ierr = SNESSolve(m_snes, NULL, m_x); PISM_CHK(ierr, "SNESSolve");
+  if (m_ice_only) {
+    ierr = SNESSolve(m_snes, NULL, m_x); PISM_CHK(ierr, "SNESSolve");
+  } else {
+    m_tuner.solve(m_snes, m_x);
+  }
 
   ierr = SNESGetConvergedReason(m_snes, &result.snes_reason);
   PISM_CHK(ierr, "SNESGetConvergedReason");
@@ -790,15 +852,21 @@ Blatter::SolutionInfo Blatter::solve() {
   ierr = KSPGetConvergedReason(ksp, &result.ksp_reason);
   PISM_CHK(ierr, "KSPGetConvergedReason");
 
-  PC pc;
-  ierr = KSPGetPC(ksp, &pc);
-  PISM_CHK(ierr, "KSPGetPC");
+  // In the "ice only" mode multigrid is used to precondition the restricted system. Note
+  // that m_ksp_active is not allocated if SNES stopped before the first PCSetUp().
+  KSP mg_ksp = m_ice_only ? m_ksp_active.get() : ksp;
+
+  PCType pc_type = nullptr;
+  PC pc = nullptr;
+  if (mg_ksp != nullptr) {
+    ierr = KSPGetPC(mg_ksp, &pc);
+    PISM_CHK(ierr, "KSPGetPC");
 
-  PCType pc_type;
-  ierr = PCGetType(pc, &pc_type);
-  PISM_CHK(ierr, "PCGetType");
+    ierr = PCGetType(pc, &pc_type);
+    PISM_CHK(ierr, "PCGetType");
+  }
 
-  if (std::string(pc_type) == PCMG) {
+  if (pc_type != nullptr and std::string(pc_type) == PCMG) {
     KSP coarse_ksp;
     ierr = PCMGGetCoarseSolve(pc, &coarse_ksp);
     PISM_CHK(ierr, "PCMGGetCoarseSolve");
@@ -995,6 +1063,14 @@ void Blatter::update(const Inputs &inputs, bool full_update) {
   init_2d_parameters(inputs);
   init_ice_hardness(inputs, m_da);
 
+  if (m_ice_only) {
+    update_active_columns();
+  }
+
+  if (m_tuner.enabled()) {
+    m_tuner.set_problem_size(icy_cell_count(inputs.geometry->cell_type));
+  }
+
   report_mesh_info();
 
   // Store the "old" initial guess: it may be needed to re-try.
@@ -1081,6 +1157,8 @@ void Blatter::update(const Inputs &inputs, bool full_update) {
                  "  SNES: %d, KSP: %d\n",
                  SNESConvergedReasons[info.snes_reason],
                  snes_total_it, ksp_total_it);
+  m_snes_iterations = snes_total_it;
+  m_ksp_iterations  = ksp_total_it;
   if (info.mg_coarse_ksp_it > 0) {
     m_log->message(2,
                    "  Level 0 KSP (last iteration): %d\n",
@@ -1206,5 +1284,13 @@ std::shared_ptr<array::Array3D> Blatter::velocity_v_sigma() const {
   return m_v_sigma;
 }
 
+int Blatter::snes_iterations() const {
+  return m_snes_iterations;
+}
+
+int Blatter::ksp_iterations() const {
+  return m_ksp_iterations;
+}
+
 } // end of namespace stressbalance
 } // end of namespace pism
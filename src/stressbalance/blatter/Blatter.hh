@@ -23,7 +23,11 @@
 #include "pism/util/petscwrappers/SNES.hh"
 #include "pism/util/petscwrappers/DM.hh"
 #include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/petscwrappers/IS.hh"
+#include "pism/util/petscwrappers/KSP.hh"
+#include "pism/util/petscwrappers/Mat.hh"
 #include "pism/util/fem/FEM.hh"
+#include "pism/util/SolverTuner.hh"
 
 namespace pism {
 
@@ -44,6 +48,10 @@ public:
   std::shared_ptr<array::Array3D> velocity_u_sigma() const;
   std::shared_ptr<array::Array3D> velocity_v_sigma() const;
 
+  //! Total numbers of SNES and KSP iterations during the last update() call.
+  int snes_iterations() const;
+  int ksp_iterations() const;
+
   /*!
    * 2D input parameters
    */
@@ -102,6 +110,31 @@ protected:
   // True if the Eisenstat-Walker method of adjusting linear solver tolerances is enabled.
   bool m_ksp_use_ew;
 
+  // "Ice only" mode: apply the preconditioner to the system restricted to icy and
+  // boundary columns (see ice_only.cc)
+  bool m_ice_only;
+  // total numbers of SNES and KSP iterations during the last update() call
+  int m_snes_iterations, m_ksp_iterations;
+  // options prefix of the solver
+  std::string m_prefix;
+  // true if the set of active columns changed since the last preconditioner setup
+  bool m_active_columns_changed;
+  // active (icy and boundary) owned columns, stored in the [j][i] order
+  std::vector<bool> m_active_columns;
+  // coarse multigrid levels (coarsest first) used in the "ice only" mode
+  std::vector<std::shared_ptr<petsc::DM> > m_coarse_dms;
+  // interpolation from level l - 1 to level l is stored in m_interpolation[l - 1]
+  std::vector<std::shared_ptr<petsc::Mat> > m_interpolation;
+  // indexes of active degrees of freedom on each multigrid level (coarsest first)
+  std::vector<std::shared_ptr<petsc::IS> > m_active_dofs;
+  // the Jacobian restricted to active degrees of freedom
+  petsc::Mat m_J_active;
+  // the diagonal of the Jacobian (used in exterior columns)
+  petsc::Vec m_J_diagonal;
+  // solver for the restricted system (KSPPREONLY with the preconditioner chosen by the
+  // user)
+  petsc::KSP m_ksp_active;
+
   static const int m_Nq = 100;
   static const int m_n_work = 9;
 
@@ -112,6 +145,10 @@ protected:
   fem::Q1Element3Face m_face4;
   fem::Q1Element3Face m_face100;
 
+  // selects the configuration of the linear solver if solver_tuning.enabled is set (not
+  // used in the "ice only" mode)
+  SolverTuner m_tuner;
+
   void init_impl();
 
   void define_model_state_impl(const File &output) const;
@@ -230,6 +267,18 @@ protected:
 
   SolutionInfo solve();
   SolutionInfo parameter_continuation();
+
+  void ice_only_init();
+
+  void update_active_columns();
+
+  void ice_only_pc_setup(Mat J);
+
+  void ice_only_pc_apply(Vec b, Vec x);
+
+  static PetscErrorCode ice_only_pc_setup_callback(PC pc);
+
+  static PetscErrorCode ice_only_pc_apply_callback(PC pc, Vec b, Vec x);
 };
 
 } // end of namespace stressbalance
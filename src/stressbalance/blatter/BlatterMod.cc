@@ -25,7 +25,6 @@
 
 #include "pism/geometry/Geometry.hh"
 #include "pism/stressbalance/StressBalance.hh" // Inputs
-#include "pism/util/pism_utilities.hh" // GlobalMax
 
 namespace pism {
 namespace stressbalance {
@@ -107,38 +106,5 @@ void BlatterMod::transfer(const array::Scalar &ice_thickness) {
   m_v.update_ghosts();
 }
 
-/*!
- * Estimate max SIA-type diffusivity assuming that `Q = -D \nabla h`.
- */
-void BlatterMod::compute_max_diffusivity(const array::Vector &velocity,
-                                         const array::Scalar &ice_thickness,
-                                         const array::Scalar1 &surface) {
-  const double eps = 1e-3;
-  double
-    dx = m_grid->dx(),
-    dy = m_grid->dy();
-
-  array::AccessScope list{&velocity, &ice_thickness, &surface};
-
-  m_D_max = 0.0;
-  for (auto p = m_grid->points(); p; p.next()) {
-    const int i = p.i(), j = p.j();
-
-    auto h = surface.star(i, j);
-    auto H = ice_thickness(i, j);
-
-    if (H > 0.0) {
-      Vector2d grad_h = {(h.e - h.w) / (2.0 * dx),
-                        (h.n - h.s) / (2.0 * dy)};
-
-      double D = H * velocity(i, j).magnitude() / (grad_h.magnitude() + eps);
-
-      m_D_max = std::max(D, m_D_max);
-    }
-  }
-
-  m_D_max = GlobalMax(m_grid->com, m_D_max);
-}
-
 } // end of namespace stressbalance
 } // end of namespace pism
@@ -45,10 +45,6 @@ private:
   std::shared_ptr<Blatter> m_solver;
 
   void transfer(const array::Scalar &ice_thickness);
-
-  void compute_max_diffusivity(const array::Vector &velocity,
-                               const array::Scalar &ice_thickness,
-                               const array::Scalar1 &surface);
 };
 
 } // end of namespace stressbalance
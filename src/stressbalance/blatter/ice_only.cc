@@ -0,0 +1,290 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/stressbalance/blatter/Blatter.hh"
+
+#include "pism/util/error_handling.hh"
+#include "pism/util/node_types.hh"
+#include "pism/util/pism_utilities.hh" // GlobalMax()
+
+#include "pism/stressbalance/blatter/util/grid_hierarchy.hh"
+
+/*
+ * The "ice only" mode of the Blatter solver.
+ *
+ * Equations corresponding to nodes in ice-free (exterior) columns are trivial (see
+ * residual_dirichlet() and jacobian_dirichlet()) and exterior elements do not contribute
+ * to the Jacobian, so the Jacobian is block-diagonal with respect to the splitting of
+ * unknowns into "active" (icy and boundary columns) and "exterior" ones.
+ *
+ * In this mode the SNES and the Krylov method use the same Jacobian and residual as
+ * before, but the preconditioner (PCSHELL)
+ *
+ * - inverts the diagonal in exterior columns and
+ *
+ * - applies the preconditioner chosen by the user (e.g. `-bp_pc_type mg`) to the system
+ *   restricted to active columns.
+ *
+ * This preconditioner is as good as the original one, but all the preconditioner work
+ * (smoothing, coarse grid solves, Galerkin products) is done in active columns only.
+ *
+ * Multigrid uses Galerkin coarse grid operators and interpolation operators restricted to
+ * active degrees of freedom. The grid hierarchy uses semi-coarsening in the vertical
+ * direction, so the set of active columns is the same on all levels.
+ */
+
+namespace pism {
+namespace stressbalance {
+
+/*!
+ * Replace the preconditioner used by the SNES with the "ice only" one.
+ *
+ * Note that the preconditioner for the restricted system is created later (see
+ * ice_only_pc_setup()) using the same options prefix.
+ */
+void Blatter::ice_only_init() {
+  PetscErrorCode ierr;
+
+  KSP ksp;
+  ierr = SNESGetKSP(m_snes, &ksp); PISM_CHK(ierr, "SNESGetKSP");
+
+  PC pc;
+  ierr = KSPGetPC(ksp, &pc); PISM_CHK(ierr, "KSPGetPC");
+
+  ierr = PCSetType(pc, PCSHELL); PISM_CHK(ierr, "PCSetType");
+
+  ierr = PCShellSetContext(pc, this); PISM_CHK(ierr, "PCShellSetContext");
+
+  ierr = PCShellSetName(pc, "ice_only"); PISM_CHK(ierr, "PCShellSetName");
+
+  ierr = PCShellSetSetUp(pc, ice_only_pc_setup_callback); PISM_CHK(ierr, "PCShellSetSetUp");
+
+  ierr = PCShellSetApply(pc, ice_only_pc_apply_callback); PISM_CHK(ierr, "PCShellSetApply");
+}
+
+/*!
+ * Find active (icy and boundary) columns using node types in m_parameters.
+ *
+ * Sets m_active_columns_changed if the set of active columns changed on at least one
+ * process.
+ */
+void Blatter::update_active_columns() {
+  DMDALocalInfo info;
+  int ierr = DMDAGetLocalInfo(m_da, &info); PISM_CHK(ierr, "DMDAGetLocalInfo");
+  info = grid_transpose(info);
+
+  std::vector<bool> active(info.xm * info.ym);
+
+  {
+    array::AccessScope list{&m_parameters};
+
+    for (int j = 0; j < info.ym; j++) {
+      for (int i = 0; i < info.xm; i++) {
+        auto node_type = static_cast<int>(m_parameters(info.xs + i, info.ys + j).node_type);
+
+        active[j * info.xm + i] = (node_type != NODE_EXTERIOR);
+      }
+    }
+  }
+
+  int changed = static_cast<int>(active != m_active_columns);
+  GlobalMax(m_grid->com, &changed, &changed, 1);
+
+  if (changed != 0) {
+    m_active_columns = active;
+    m_active_columns_changed = true;
+  }
+}
+
+/*!
+ * Set up the preconditioner for the restricted system.
+ *
+ * Re-creates the restricted solver if the set of active columns changed, otherwise
+ * re-uses the restricted Jacobian and the Galerkin coarse grid operators.
+ */
+void Blatter::ice_only_pc_setup(Mat J) {
+  PetscErrorCode ierr;
+
+  if (m_J_diagonal.get() == nullptr) {
+    ierr = MatCreateVecs(J, m_J_diagonal.rawptr(), NULL); PISM_CHK(ierr, "MatCreateVecs");
+  }
+  ierr = MatGetDiagonal(J, m_J_diagonal); PISM_CHK(ierr, "MatGetDiagonal");
+
+  if (m_active_columns_changed or m_ksp_active.get() == nullptr) {
+    // Create the solver for the restricted system. We can't re-use the old one because
+    // sizes of all the operators changed.
+    if (m_ksp_active.get() != nullptr) {
+      ierr = KSPDestroy(m_ksp_active.rawptr()); PISM_CHK(ierr, "KSPDestroy");
+    }
+    if (m_J_active.get() != nullptr) {
+      ierr = MatDestroy(m_J_active.rawptr()); PISM_CHK(ierr, "MatDestroy");
+    }
+
+    ierr = KSPCreate(m_grid->com, m_ksp_active.rawptr()); PISM_CHK(ierr, "KSPCreate");
+
+    ierr = KSPSetOptionsPrefix(m_ksp_active, m_prefix.c_str());
+    PISM_CHK(ierr, "KSPSetOptionsPrefix");
+
+    ierr = KSPSetFromOptions(m_ksp_active); PISM_CHK(ierr, "KSPSetFromOptions");
+
+    // the outer Krylov method is chosen using -bp_ksp_type, so here we just apply the
+    // preconditioner
+    ierr = KSPSetType(m_ksp_active, KSPPREONLY); PISM_CHK(ierr, "KSPSetType");
+
+    PC pc;
+    ierr = KSPGetPC(m_ksp_active, &pc); PISM_CHK(ierr, "KSPGetPC");
+
+    PCType pc_type;
+    ierr = PCGetType(pc, &pc_type); PISM_CHK(ierr, "PCGetType");
+
+    PetscInt n_levels = 1;
+    if (std::string(pc_type) == PCMG) {
+      ierr = PCMGGetLevels(pc, &n_levels); PISM_CHK(ierr, "PCMGGetLevels");
+    }
+
+    // Create coarse grids and interpolation operators. These do not depend on the
+    // geometry, so we create them once.
+    if (m_coarse_dms.size() != (size_t)(n_levels - 1)) {
+      m_coarse_dms.clear();
+      m_interpolation.clear();
+
+      ::DM fine = m_da;
+      for (int l = n_levels - 2; l >= 0; --l) {
+        ::DM coarse;
+        ierr = DMCoarsen(fine, m_grid->com, &coarse); PISM_CHK(ierr, "DMCoarsen");
+
+        ::Mat P;
+        ierr = DMCreateInterpolation(coarse, fine, &P, NULL);
+        PISM_CHK(ierr, "DMCreateInterpolation");
+
+        // DMDA interpolation operators with dof > 1 use MATMAIJ, which does not support
+        // MatCreateSubMatrix()
+        ierr = MatConvert(P, MATAIJ, MAT_INPLACE_MATRIX, &P); PISM_CHK(ierr, "MatConvert");
+
+        m_coarse_dms.insert(m_coarse_dms.begin(), std::make_shared<petsc::DM>(coarse));
+        m_interpolation.insert(m_interpolation.begin(), std::make_shared<petsc::Mat>(P));
+
+        fine = coarse;
+      }
+    }
+
+    // index sets of active degrees of freedom on all levels
+    m_active_dofs.clear();
+    for (int l = 0; l < n_levels; ++l) {
+      ::DM da = (l == n_levels - 1) ? m_da.get() : m_coarse_dms[l]->get();
+
+      auto dofs = std::make_shared<petsc::IS>();
+      ierr = column_dofs(da, m_active_columns, dofs->rawptr()); PISM_CHK(ierr, "column_dofs");
+
+      m_active_dofs.push_back(dofs);
+    }
+
+    if (n_levels > 1) {
+      // There are no DMs describing restricted systems, so coarse grid operators cannot
+      // be re-discretized.
+#if PETSC_VERSION_LT(3,8,0)
+      ierr = PCMGSetGalerkin(pc, PETSC_TRUE); PISM_CHK(ierr, "PCMGSetGalerkin");
+#else
+      ierr = PCMGSetGalerkin(pc, PC_MG_GALERKIN_BOTH); PISM_CHK(ierr, "PCMGSetGalerkin");
+#endif
+
+      for (int l = 1; l < n_levels; ++l) {
+        petsc::Mat P;
+        ierr = MatCreateSubMatrix(*m_interpolation[l - 1],
+                                  *m_active_dofs[l], *m_active_dofs[l - 1],
+                                  MAT_INITIAL_MATRIX, P.rawptr());
+        PISM_CHK(ierr, "MatCreateSubMatrix");
+
+        ierr = PCMGSetInterpolation(pc, l, P); PISM_CHK(ierr, "PCMGSetInterpolation");
+      }
+    }
+
+    ierr = MatCreateSubMatrix(J, *m_active_dofs.back(), *m_active_dofs.back(),
+                              MAT_INITIAL_MATRIX, m_J_active.rawptr());
+    PISM_CHK(ierr, "MatCreateSubMatrix");
+
+    m_active_columns_changed = false;
+  } else {
+    ierr = MatCreateSubMatrix(J, *m_active_dofs.back(), *m_active_dofs.back(),
+                              MAT_REUSE_MATRIX, m_J_active.rawptr());
+    PISM_CHK(ierr, "MatCreateSubMatrix");
+  }
+
+  ierr = KSPSetOperators(m_ksp_active, m_J_active, m_J_active);
+  PISM_CHK(ierr, "KSPSetOperators");
+}
+
+/*!
+ * Apply the "ice only" preconditioner.
+ */
+void Blatter::ice_only_pc_apply(Vec b, Vec x) {
+  PetscErrorCode ierr;
+
+  // Exterior columns: the Jacobian is diagonal. Note that values in active columns are
+  // overwritten below.
+  ierr = VecPointwiseDivide(x, b, m_J_diagonal); PISM_CHK(ierr, "VecPointwiseDivide");
+
+  // Active columns
+  {
+    ::IS dofs = *m_active_dofs.back();
+
+    Vec b_active, x_active;
+    ierr = VecGetSubVector(b, dofs, &b_active); PISM_CHK(ierr, "VecGetSubVector");
+    ierr = VecGetSubVector(x, dofs, &x_active); PISM_CHK(ierr, "VecGetSubVector");
+
+    ierr = KSPSolve(m_ksp_active, b_active, x_active); PISM_CHK(ierr, "KSPSolve");
+
+    ierr = VecRestoreSubVector(x, dofs, &x_active); PISM_CHK(ierr, "VecRestoreSubVector");
+    ierr = VecRestoreSubVector(b, dofs, &b_active); PISM_CHK(ierr, "VecRestoreSubVector");
+  }
+}
+
+PetscErrorCode Blatter::ice_only_pc_setup_callback(PC pc) {
+  Blatter *solver = nullptr;
+  PetscErrorCode ierr = PCShellGetContext(pc, (void**)&solver); CHKERRQ(ierr);
+
+  try {
+    Mat J;
+    ierr = PCGetOperators(pc, NULL, &J); PISM_CHK(ierr, "PCGetOperators");
+
+    solver->ice_only_pc_setup(J);
+  } catch (...) {
+    MPI_Comm com = solver->grid()->com;
+    handle_fatal_errors(com);
+    SETERRQ(com, 1, "A PISM callback failed");
+  }
+  return 0;
+}
+
+PetscErrorCode Blatter::ice_only_pc_apply_callback(PC pc, Vec b, Vec x) {
+  Blatter *solver = nullptr;
+  PetscErrorCode ierr = PCShellGetContext(pc, (void**)&solver); CHKERRQ(ierr);
+
+  try {
+    solver->ice_only_pc_apply(b, x);
+  } catch (...) {
+    MPI_Comm com = solver->grid()->com;
+    handle_fatal_errors(com);
+    SETERRQ(com, 1, "A PISM callback failed");
+  }
+  return 0;
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
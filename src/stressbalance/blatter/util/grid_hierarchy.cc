@@ -253,4 +253,60 @@ PetscErrorCode restrict_data(DM fine, DM coarse, const char *dm_name) {
   return 0;
 }
 
+/*! @brief Create the index set containing all degrees of freedom of a 3D DMDA `da` in
+ * selected map-plane columns.
+ *
+ * `columns` contains one flag per *owned* column, stored in the [j][i] order (`i` changing
+ * fastest). All nodes in a column are owned by the same process and semi-coarsening does
+ * not change the map-plane domain distribution, so the same `columns` can be used on all
+ * multigrid levels.
+ *
+ * @param[in] da 3D DMDA
+ * @param[in] columns flags marking selected columns
+ * @param[out] result index set using PETSc's global ordering
+ */
+PetscErrorCode column_dofs(DM da, const std::vector<bool> &columns, IS *result) {
+  PetscErrorCode ierr;
+
+  MPI_Comm comm;
+  ierr = PetscObjectGetComm((PetscObject)da, &comm); CHKERRQ(ierr);
+
+  DMDALocalInfo info;
+  ierr = DMDAGetLocalInfo(da, &info); CHKERRQ(ierr);
+  info = grid_transpose(info);
+
+  if (columns.size() != (size_t)(info.xm * info.ym)) {
+    SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "column flags do not match the DMDA"); // LCOV_EXCL_LINE
+  }
+
+  // global index of the first degree of freedom owned by this process
+  PetscInt start = 0;
+  {
+    Vec v;
+    ierr = DMGetGlobalVector(da, &v); CHKERRQ(ierr);
+    ierr = VecGetOwnershipRange(v, &start, NULL); CHKERRQ(ierr);
+    ierr = DMRestoreGlobalVector(da, &v); CHKERRQ(ierr);
+  }
+
+  // degrees of freedom in a column are stored contiguously (see grid_transpose())
+  PetscInt column_size = info.mz * info.dof;
+
+  std::vector<PetscInt> indices;
+  for (int j = 0; j < info.ym; ++j) {
+    for (int i = 0; i < info.xm; ++i) {
+      PetscInt n = j * info.xm + i;
+      if (columns[n]) {
+        for (PetscInt k = 0; k < column_size; ++k) {
+          indices.push_back(start + n * column_size + k);
+        }
+      }
+    }
+  }
+
+  ierr = ISCreateGeneral(comm, (PetscInt)indices.size(), indices.data(),
+                         PETSC_COPY_VALUES, result); CHKERRQ(ierr);
+
+  return 0;
+}
+
 } // end of namespace pism
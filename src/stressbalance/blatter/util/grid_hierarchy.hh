@@ -1,4 +1,4 @@
-/* Copyright (C) 2020, 2021 PISM Authors
+/* Copyright (C) 2020, 2021, 2023 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -20,6 +20,8 @@
 #ifndef PISM_GRID_HIERARCHY_H
 #define PISM_GRID_HIERARCHY_H
 
+#include <vector>
+
 #include <petscdmda.h>
 
 namespace pism {
@@ -34,6 +36,8 @@ PetscErrorCode create_restriction(DM fine, DM coarse, const char *dm_name);
 
 PetscErrorCode restrict_data(DM fine, DM coarse, const char *dm_name);
 
+PetscErrorCode column_dofs(DM da, const std::vector<bool> &columns, IS *result);
+
 } // end of namespace pism
 
 #endif /* PISM_GRID_HIERARCHY_H */
@@ -0,0 +1,418 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min
+#include <cmath>
+
+#include "pism/stressbalance/diva/DIVA.hh"
+
+#include "pism/basalstrength/basal_resistance.hh"
+#include "pism/geometry/Geometry.hh"
+#include "pism/rheology/FlowLaw.hh"
+#include "pism/stressbalance/StressBalance.hh" // Inputs
+#include "pism/util/pism_utilities.hh" // pism::printf
+
+namespace pism {
+namespace stressbalance {
+
+DIVA::DIVA(std::shared_ptr<const Grid> grid)
+  : SSAFD(grid),
+    m_basal_yield_stress(nullptr),
+    m_ice_hardness(grid, "ice_hardness", array::WITH_GHOSTS, grid->z()),
+    m_viscosity(grid, "effective_viscosity", array::WITHOUT_GHOSTS, grid->z()),
+    m_beta(grid, "diva_basal_drag"),
+    m_F2(grid, "diva_F2"),
+    m_basal_stress(grid, "diva_basal_stress"),
+    m_basal_velocity(grid, "diva_basal_velocity") {
+
+  m_ice_hardness.metadata(0)
+      .long_name("ice hardness")
+      .set_units_without_validation(pism::printf("Pa s^(1/%f)", m_flow_law->exponent()));
+
+  m_viscosity.metadata(0).long_name("effective viscosity of ice").units("Pa s");
+
+  m_beta.metadata(0)
+      .long_name("basal drag coefficient corresponding to the basal velocity")
+      .units("Pa s m-1");
+
+  m_F2.metadata(0)
+      .long_name("integral of the reciprocal of the effective viscosity weighted by the"
+                 " squared relative depth")
+      .units("m Pa-1 s-1");
+
+  m_basal_stress.metadata(0).long_name("basal shear stress (x component)").units("Pa");
+  m_basal_stress.metadata(1).long_name("basal shear stress (y component)").units("Pa");
+
+  m_basal_velocity.metadata(0).long_name("basal ice velocity (x component)").units("m s-1");
+  m_basal_velocity.metadata(1).long_name("basal ice velocity (y component)").units("m s-1");
+
+  m_viscosity_tolerance = m_config->get_number("stress_balance.diva.viscosity.relative_tolerance");
+  m_viscosity_max_iterations =
+      static_cast<int>(m_config->get_number("stress_balance.diva.viscosity.max_iterations"));
+
+  // the first Picard iteration uses the SSA approximation
+  m_beta.set(0.0);
+  m_F2.set(0.0);
+  m_basal_stress.set(0.0);
+  m_basal_velocity.set(0.0);
+  m_viscosity.set(0.0);
+
+  m_z.resize(grid->Mz() + 1);
+  m_B.resize(grid->Mz() + 1);
+}
+
+void DIVA::update(const Inputs &inputs, bool full_update) {
+  SSAFD::update(inputs, full_update);
+
+  if (full_update) {
+    // basal frictional heating corresponds to the basal velocity (not the
+    // vertically-averaged velocity)
+    compute_basal_frictional_heating(m_basal_velocity, *inputs.basal_yield_stress, m_mask,
+                                     m_basal_frictional_heating);
+  }
+}
+
+const array::Vector &DIVA::basal_velocity() const {
+  return m_basal_velocity;
+}
+
+const array::Vector &DIVA::basal_stress() const {
+  return m_basal_stress;
+}
+
+const array::Array3D &DIVA::effective_viscosity() const {
+  return m_viscosity;
+}
+
+void DIVA::solve(const Inputs &inputs) {
+  m_basal_yield_stress = inputs.basal_yield_stress;
+  try {
+    SSAFD::solve(inputs);
+  } catch (...) {
+    m_basal_yield_stress = nullptr;
+    throw;
+  }
+  m_basal_yield_stress = nullptr;
+}
+
+/*!
+ * Computes ice hardness at cell centers (used to compute the effective viscosity in
+ * columns) in addition to the vertically-averaged hardness on the staggered grid.
+ */
+void DIVA::compute_hardav_staggered(const Inputs &inputs) {
+  const auto &ice_thickness = inputs.geometry->ice_thickness;
+  const auto &enthalpy      = *inputs.enthalpy;
+
+  const auto &z = m_grid->z();
+  const unsigned int Mz = m_grid->Mz();
+
+  std::vector<double> pressure(Mz);
+
+  array::AccessScope list{ &ice_thickness, &enthalpy, &m_ice_hardness };
+
+  ParallelSection loop(m_grid->com);
+  try {
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double H = ice_thickness(i, j);
+
+      for (unsigned int k = 0; k < Mz; ++k) {
+        pressure[k] = m_EC->pressure(std::max(H - z[k], 0.0));
+      }
+
+      m_flow_law->hardness_n(enthalpy.get_column(i, j), pressure.data(), Mz,
+                             m_ice_hardness.get_column(i, j));
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  m_ice_hardness.update_ghosts();
+
+  SSAFD::compute_hardav_staggered(inputs);
+}
+
+/*!
+ * Returns the effective viscosity corresponding to the ice hardness `hardness`, the second
+ * invariant `gamma` of the horizontal strain rate and the magnitude `tau` of the vertical
+ * shear stress.
+ *
+ * Solves
+ *
+ * @f[ \eta = \nu\left(B, \gamma + \frac14 \left( \frac{\tau}{\eta} \right)^2\right) @f]
+ *
+ * using Newton's method in @f$ x = \ln \eta @f$, starting from the smaller of the
+ * viscosities corresponding to the horizontal strain rate and the vertical shear alone
+ * (both are upper bounds).
+ */
+double DIVA::viscosity(double hardness, double gamma, double tau) const {
+  double nu = 0.0, dnu = 0.0;
+  m_flow_law->effective_viscosity(hardness, gamma, &nu, nullptr);
+
+  if (tau == 0.0) {
+    return nu;
+  }
+
+  // viscosity corresponding to the vertical shear alone
+  const double n = m_flow_law->exponent();
+  const double eta_shear = std::pow(0.5 * hardness, n) * std::pow(0.5 * tau, 1.0 - n);
+
+  double x = std::log(std::min(nu, eta_shear));
+
+  for (int k = 0; k < m_viscosity_max_iterations; ++k) {
+    const double
+      eta    = std::exp(x),
+      shear2 = 0.25 * tau * tau / (eta * eta);
+
+    m_flow_law->effective_viscosity(hardness, gamma + shear2, &nu, &dnu);
+
+    // G(x) = ln nu(gamma + tau^2 exp(-2 x) / 4), 0 <= G'(x) < 1
+    const double
+      G     = std::log(nu),
+      dG    = -2.0 * shear2 * dnu / nu,
+      delta = (x - G) / (1.0 - dG);
+
+    x -= delta;
+
+    if (std::fabs(delta) < m_viscosity_tolerance) {
+      break;
+    }
+  }
+
+  return std::exp(x);
+}
+
+/*!
+ * Sets levels `m_z` in a column of ice of thickness `H` (grid levels below the surface and
+ * the surface itself) and the ice hardness `m_B` at these levels (the average of `B_0`
+ * and `B_1`).
+ *
+ * Returns the number of levels.
+ */
+unsigned int DIVA::column(double H, const double *B_0, const double *B_1) const {
+  const auto &z = m_grid->z();
+
+  const unsigned int ks = m_grid->kBelowHeight(H);
+
+  for (unsigned int k = 0; k <= ks; ++k) {
+    m_z[k] = z[k];
+    m_B[k] = 0.5 * (B_0[k] + B_1[k]);
+  }
+
+  if (z[ks] < H) {
+    // use hardness at the grid level just below the surface
+    m_z[ks + 1] = H;
+    m_B[ks + 1] = m_B[ks];
+    return ks + 2;
+  }
+
+  return ks + 1;
+}
+
+/*!
+ * Updates the basal velocity, the basal drag coefficient, the basal shear stress, the
+ * effective viscosity and the integral @f$ F_2 @f$ at cell centers using the
+ * vertically-averaged velocity `velocity`.
+ *
+ * The basal velocity uses @f$ \beta @f$ and @f$ F_2 @f$ from the previous Picard
+ * iteration.
+ */
+void DIVA::update_columns(const array::Scalar &ice_thickness, const array::Vector1 &velocity) {
+  if (m_basal_yield_stress == nullptr) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "basal yield stress is not set");
+  }
+
+  const auto &tauc = *m_basal_yield_stress;
+
+  const double
+    dx    = m_grid->dx(),
+    dy    = m_grid->dy(),
+    H_min = strength_extension->get_min_thickness();
+
+  const unsigned int Mz = m_grid->Mz();
+
+  array::AccessScope list{ &ice_thickness, &velocity, &tauc, &m_mask,
+                           &m_ice_hardness, &m_viscosity, &m_beta, &m_F2,
+                           &m_basal_stress, &m_basal_velocity };
+
+  ParallelSection loop(m_grid->com);
+  try {
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double H = ice_thickness(i, j);
+      const Vector2d U = velocity(i, j);
+
+      if (not m_mask.icy(i, j) or H < H_min) {
+        m_beta(i, j)           = 0.0;
+        m_F2(i, j)             = 0.0;
+        m_basal_stress(i, j)   = 0.0;
+        m_basal_velocity(i, j) = U;
+        m_viscosity.set_column(i, j, 0.0);
+        continue;
+      }
+
+      const Vector2d u_b = U / (1.0 + m_beta(i, j) * m_F2(i, j));
+
+      const double beta = m_basal_sliding_law->drag(tauc(i, j), u_b.u, u_b.v);
+
+      // floating ice does not have vertical shear
+      const Vector2d tau_b = m_mask.grounded(i, j) ? beta * u_b : Vector2d(0.0, 0.0);
+
+      // horizontal strain rates
+      const double gamma = secondInvariant_2D(
+          { (velocity(i + 1, j).u - velocity(i - 1, j).u) / (2.0 * dx),
+            (velocity(i + 1, j).v - velocity(i - 1, j).v) / (2.0 * dx) },
+          { (velocity(i, j + 1).u - velocity(i, j - 1).u) / (2.0 * dy),
+            (velocity(i, j + 1).v - velocity(i, j - 1).v) / (2.0 * dy) });
+
+      const double *B = m_ice_hardness.get_column(i, j);
+      const unsigned int N = column(H, B, B);
+
+      const double tau = tau_b.magnitude();
+
+      double *eta = m_viscosity.get_column(i, j);
+
+      double F2 = 0.0, f_previous = 0.0;
+      for (unsigned int k = 0; k < N; ++k) {
+        const double
+          s   = (H - m_z[k]) / H,
+          e   = viscosity(m_B[k], gamma, tau * s),
+          f_k = s * s / e;
+
+        if (k > 0) {
+          F2 += 0.5 * (f_previous + f_k) * (m_z[k] - m_z[k - 1]);
+        }
+        f_previous = f_k;
+
+        if (k < Mz) {
+          eta[k] = e;
+        }
+      }
+      // extend the viscosity above the ice surface
+      for (unsigned int k = N; k < Mz; ++k) {
+        eta[k] = eta[N - 1];
+      }
+
+      m_beta(i, j)           = beta;
+      m_F2(i, j)             = F2;
+      m_basal_stress(i, j)   = tau_b;
+      m_basal_velocity(i, j) = u_b;
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  m_basal_stress.update_ghosts();
+}
+
+void DIVA::compute_nuH_staggered(const array::Scalar1 &ice_thickness,
+                                 const array::Vector1 &velocity,
+                                 const array::Staggered &hardness,
+                                 double nuH_regularization,
+                                 array::Staggered &result) {
+  update_columns(ice_thickness, velocity);
+
+  array::AccessScope list{ &m_basal_stress, &m_ice_hardness };
+
+  SSAFD::compute_nuH_staggered(ice_thickness, velocity, hardness, nuH_regularization, result);
+}
+
+void DIVA::compute_nuH_staggered_cfbc(const array::Scalar1 &ice_thickness,
+                                      const array::CellType2 &mask,
+                                      const array::Vector1 &velocity,
+                                      const array::Staggered &hardness,
+                                      double nuH_regularization,
+                                      array::Staggered &result) {
+  update_columns(ice_thickness, velocity);
+
+  array::AccessScope list{ &m_basal_stress, &m_ice_hardness };
+
+  SSAFD::compute_nuH_staggered_cfbc(ice_thickness, mask, velocity, hardness, nuH_regularization,
+                                    result);
+}
+
+/*!
+ * Computes the vertical integral of the effective viscosity at the staggered grid location
+ * `(i, j, o)`.
+ *
+ * The shear stress is the average of basal shear stresses at the two neighboring cell
+ * centers, decreasing linearly to zero at the surface.
+ *
+ * The hardness in the column is scaled to match the vertically-averaged hardness
+ * `hardness` (this accounts for the fracture-induced softening, if enabled).
+ *
+ * This calls viscosity() at each of the `N` levels in the column. Its Newton iteration
+ * takes 1 to 4 (typically 2 or 3) steps, each evaluating one `pow()`, `exp()` and `log()`,
+ * for strain rates from 0 to 0.1 1/year and basal shear stresses from 1 to 200 kPa, so
+ * this costs roughly `3 N` times as much as the SSAFD version.
+ */
+double DIVA::column_nuH(int i, int j, int o, double H, double hardness, double gamma) const {
+  const int oi = 1 - o, oj = o;
+
+  const double tau =
+      0.5 * (m_basal_stress(i, j).magnitude() + m_basal_stress(i + oi, j + oj).magnitude());
+
+  const unsigned int N =
+      column(H, m_ice_hardness.get_column(i, j), m_ice_hardness.get_column(i + oi, j + oj));
+
+  double B_integral = 0.0;
+  for (unsigned int k = 1; k < N; ++k) {
+    B_integral += 0.5 * (m_B[k - 1] + m_B[k]) * (m_z[k] - m_z[k - 1]);
+  }
+
+  const double scale = (hardness > 0.0 and B_integral > 0.0) ? hardness * H / B_integral : 1.0;
+
+  double result = 0.0, eta_previous = 0.0;
+  for (unsigned int k = 0; k < N; ++k) {
+    const double eta = viscosity(scale * m_B[k], gamma, tau * (H - m_z[k]) / H);
+
+    if (k > 0) {
+      result += 0.5 * (eta_previous + eta) * (m_z[k] - m_z[k - 1]);
+    }
+    eta_previous = eta;
+  }
+
+  return result;
+}
+
+/*!
+ * Computes the effective basal drag coefficient @f$ \beta / (1 + \beta F_2) @f$.
+ *
+ * Uses @f$ \beta @f$ and @f$ F_2 @f$ computed by update_columns() (arguments are not used).
+ */
+void DIVA::compute_basal_drag(const array::Scalar &tauc, const array::Vector &velocity,
+                              array::Scalar &result) const {
+  (void)tauc;
+  (void)velocity;
+
+  array::AccessScope list{ &m_beta, &m_F2, &result };
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result(i, j) = m_beta(i, j) / (1.0 + m_beta(i, j) * m_F2(i, j));
+  }
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
@@ -0,0 +1,134 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_DIVA_H
+#define PISM_DIVA_H
+
+#include <vector>
+
+#include "pism/stressbalance/ssa/SSAFD.hh"
+#include "pism/util/array/Array3D.hh"
+
+namespace pism {
+namespace stressbalance {
+
+//! Depth-integrated viscosity approximation (DIVA) of the first order stress balance.
+/*!
+ * Follows Goldberg (2011) and Lipscomb et al. (2019).
+ *
+ * Solves an SSA-like system for the vertically-averaged velocity @f$ \bar{\mathbf{u}} @f$
+ *
+ * @f[ - \nabla \cdot \left( 2 \bar\eta H \dot{\epsilon} \right) + \beta_{\text{eff}} \bar{\mathbf{u}}
+ * = - \rho g H \nabla s, @f]
+ *
+ * where the effective viscosity @f$ \eta(z) @f$ depends on the horizontal strain rates
+ * (computed using @f$ \bar{\mathbf{u}} @f$) *and* the vertical shear
+ * @f$ \mathbf{u}_z = \boldsymbol{\tau}(z) / \eta(z) @f$ with the shear stress
+ * @f$ \boldsymbol{\tau}(z) = \boldsymbol{\tau}_b (s - z) / H @f$.
+ *
+ * The basal velocity and the effective basal drag coefficient are
+ *
+ * @f[ \mathbf{u}_b = \frac{\bar{\mathbf{u}}}{1 + \beta F_2},
+ * \quad \beta_{\text{eff}} = \frac{\beta}{1 + \beta F_2},
+ * \quad F_2 = \int_b^s \frac{1}{\eta} \left( \frac{s - z}{H} \right)^2 dz, @f]
+ *
+ * where @f$ \beta @f$ is the drag coefficient of the basal sliding law evaluated at
+ * @f$ \mathbf{u}_b @f$.
+ *
+ * Uses the SSAFD discretization and the Picard iteration: column quantities (@f$ \beta @f$,
+ * @f$ F_2 @f$, @f$ \eta(z) @f$) are updated every time the integrated viscosity is
+ * re-computed.
+ *
+ * The 3D velocity is reconstructed by DIVAMod.
+ */
+class DIVA : public SSAFD {
+public:
+  DIVA(std::shared_ptr<const Grid> grid);
+  virtual ~DIVA() = default;
+
+  void update(const Inputs &inputs, bool full_update);
+
+  //! Basal (sliding) velocity.
+  const array::Vector &basal_velocity() const;
+
+  //! Basal shear stress.
+  const array::Vector &basal_stress() const;
+
+  //! Effective viscosity at cell centers, on the vertical grid used by the model.
+  const array::Array3D &effective_viscosity() const;
+
+protected:
+  void solve(const Inputs &inputs);
+
+  void compute_hardav_staggered(const Inputs &inputs);
+
+  void compute_nuH_staggered(const array::Scalar1 &ice_thickness,
+                             const array::Vector1 &velocity,
+                             const array::Staggered &hardness,
+                             double nuH_regularization,
+                             array::Staggered &result);
+
+  void compute_nuH_staggered_cfbc(const array::Scalar1 &ice_thickness,
+                                  const array::CellType2 &mask,
+                                  const array::Vector1 &velocity,
+                                  const array::Staggered &hardness,
+                                  double nuH_regularization,
+                                  array::Staggered &result);
+
+  double column_nuH(int i, int j, int o, double H, double hardness, double gamma) const;
+
+  void compute_basal_drag(const array::Scalar &tauc, const array::Vector &velocity,
+                          array::Scalar &result) const;
+
+  void update_columns(const array::Scalar &ice_thickness, const array::Vector1 &velocity);
+
+  double viscosity(double hardness, double gamma, double tau) const;
+
+  unsigned int column(double H, const double *B_0, const double *B_1) const;
+
+  //! basal yield stress (set by solve())
+  const array::Scalar *m_basal_yield_stress;
+
+  //! ice hardness at cell centers
+  array::Array3D m_ice_hardness;
+  //! effective viscosity at cell centers
+  array::Array3D m_viscosity;
+
+  //! basal drag coefficient corresponding to the basal velocity
+  array::Scalar m_beta;
+  //! the integral @f$ F_2 @f$ (see above)
+  array::Scalar m_F2;
+  //! basal shear stress
+  array::Vector1 m_basal_stress;
+  //! basal velocity
+  array::Vector m_basal_velocity;
+
+  //! relative tolerance of the effective viscosity computation in a column
+  double m_viscosity_tolerance;
+  //! maximum number of iterations of the effective viscosity computation in a column
+  int m_viscosity_max_iterations;
+
+  // temporary storage
+  mutable std::vector<double> m_z, m_B;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_DIVA_H */
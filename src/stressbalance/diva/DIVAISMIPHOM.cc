@@ -0,0 +1,66 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cmath>
+
+#include "pism/stressbalance/diva/DIVAISMIPHOM.hh"
+
+namespace pism {
+namespace stressbalance {
+
+DIVAISMIPHOM::DIVAISMIPHOM(std::shared_ptr<const Grid> grid, ISMIPHOMTest test)
+  : DIVA(grid) {
+
+  const double degree = M_PI / 180.0;
+
+  // surface slopes used in experiments A and B (0.5 degrees) and C and D (0.1 degrees)
+  if (test == HOM_A or test == HOM_B) {
+    m_slope = std::tan(0.5 * degree);
+  } else {
+    m_slope = std::tan(0.1 * degree);
+  }
+}
+
+/*!
+ * Computes the driving stress @f$ - \rho g H \nabla s @f$, where @f$ s = -x \tan\alpha @f$.
+ */
+void DIVAISMIPHOM::compute_driving_stress(const array::Scalar &ice_thickness,
+                                          const array::Scalar1 &surface_elevation,
+                                          const array::CellType1 &cell_type,
+                                          const array::Scalar1 *no_model_mask,
+                                          array::Vector &result) const {
+  (void)surface_elevation;
+  (void)cell_type;
+  (void)no_model_mask;
+
+  const double
+    rho = m_config->get_number("constants.ice.density"),
+    g   = m_config->get_number("constants.standard_gravity");
+
+  array::AccessScope list{ &ice_thickness, &result };
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result(i, j) = { rho * g * ice_thickness(i, j) * m_slope, 0.0 };
+  }
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
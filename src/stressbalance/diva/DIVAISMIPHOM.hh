@@ -0,0 +1,53 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_DIVAISMIPHOM_H
+#define PISM_DIVAISMIPHOM_H
+
+#include "pism/stressbalance/diva/DIVA.hh"
+#include "pism/stressbalance/blatter/ismip-hom/BlatterISMIPHOM.hh" // ISMIPHOMTest
+
+namespace pism {
+namespace stressbalance {
+
+/*!
+ * DIVA set up for ISMIP-HOM experiments A-D (periodic geometry).
+ *
+ * The surface elevation is not periodic, so the driving stress is computed using the
+ * prescribed surface slope.
+ */
+class DIVAISMIPHOM : public DIVA {
+public:
+  DIVAISMIPHOM(std::shared_ptr<const Grid> grid, ISMIPHOMTest test);
+
+protected:
+  void compute_driving_stress(const array::Scalar &ice_thickness,
+                              const array::Scalar1 &surface_elevation,
+                              const array::CellType1 &cell_type,
+                              const array::Scalar1 *no_model_mask,
+                              array::Vector &result) const;
+
+  //! tangent of the surface slope angle
+  double m_slope;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_DIVAISMIPHOM_H */
@@ -0,0 +1,120 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/stressbalance/diva/DIVAMod.hh"
+
+#include "pism/rheology/FlowLawFactory.hh"
+
+#include "pism/geometry/Geometry.hh"
+#include "pism/stressbalance/StressBalance.hh" // Inputs
+
+namespace pism {
+namespace stressbalance {
+
+DIVAMod::DIVAMod(std::shared_ptr<DIVA> solver)
+  : SSB_Modifier(solver->grid()),
+    m_solver(solver) {
+
+  // use the same flow law as the solver
+  rheology::FlowLawFactory ice_factory("stress_balance.ssa.", m_config, m_EC);
+  m_flow_law = ice_factory.create();
+}
+
+void DIVAMod::init() {
+  // empty
+}
+
+/*!
+ * Post-process ice velocity computed by the DIVA solver.
+ *
+ * - reconstructs the 3D velocity by integrating the vertical shear
+ *   @f$ \mathbf{u}_z = \boldsymbol{\tau}_b (s - z) / (H \eta(z)) @f$ upwards from the base
+ *
+ * - estimates the maximum diffusivity used to compute the time step restriction
+ *
+ * Uses constant extrapolation above the ice surface.
+ */
+void DIVAMod::update(const array::Vector &sliding_velocity,
+                     const Inputs &inputs,
+                     bool full_update) {
+  (void) sliding_velocity;
+  (void) full_update;
+
+  const auto &ice_thickness = inputs.geometry->ice_thickness;
+  const auto &u_b           = m_solver->basal_velocity();
+  const auto &tau_b         = m_solver->basal_stress();
+  const auto &viscosity     = m_solver->effective_viscosity();
+
+  const auto &z = m_grid->z();
+  const unsigned int Mz = m_grid->Mz();
+
+  array::AccessScope list{&m_u, &m_v, &ice_thickness, &u_b, &tau_b, &viscosity};
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    auto *u = m_u.get_column(i, j);
+    auto *v = m_v.get_column(i, j);
+
+    const double H = ice_thickness(i, j);
+    const Vector2d U = u_b(i, j), T = tau_b(i, j);
+
+    const double *eta = viscosity.get_column(i, j);
+
+    if (H == 0.0 or eta[0] <= 0.0) {
+      m_u.set_column(i, j, U.u);
+      m_v.set_column(i, j, U.v);
+      continue;
+    }
+
+    const unsigned int ks = m_grid->kBelowHeight(H);
+
+    // integral of (s - z) / (H eta(z)) from the base to z[k]
+    double I = 0.0, f_previous = 1.0 / eta[0];
+
+    u[0] = U.u;
+    v[0] = U.v;
+    for (unsigned int k = 1; k < Mz; ++k) {
+      if (k <= ks) {
+        const double f_k = (H - z[k]) / (H * eta[k]);
+        I += 0.5 * (f_previous + f_k) * (z[k] - z[k - 1]);
+        f_previous = f_k;
+      } else if (k == ks + 1) {
+        // the integrand is zero at the surface
+        I += 0.5 * f_previous * (H - z[ks]);
+      }
+
+      u[k] = U.u + T.u * I;
+      v[k] = U.v + T.v * I;
+    }
+  }
+
+  m_u.update_ghosts();
+  m_v.update_ghosts();
+
+  // estimate max diffusivity to use in adaptive time stepping
+  compute_max_diffusivity(m_solver->velocity(),
+                          ice_thickness,
+                          inputs.geometry->ice_surface_elevation);
+
+  m_diffusive_flux.set(0.0);
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
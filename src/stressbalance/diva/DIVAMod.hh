@@ -0,0 +1,52 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_DIVA_MOD_H
+#define PISM_DIVA_MOD_H
+
+#include <memory>               // std::shared_ptr
+
+#include "pism/stressbalance/diva/DIVA.hh"
+#include "pism/stressbalance/SSB_Modifier.hh"
+
+namespace pism {
+namespace stressbalance {
+
+/*!
+ * The "modifier" reconstructing the 3D velocity field corresponding to the
+ * vertically-averaged velocity computed using `DIVA`.
+ */
+class DIVAMod : public SSB_Modifier {
+public:
+  DIVAMod(std::shared_ptr<DIVA> solver);
+  virtual ~DIVAMod() = default;
+
+  void init();
+
+  void update(const array::Vector &sliding_velocity,
+              const Inputs &inputs,
+              bool full_update);
+private:
+  std::shared_ptr<DIVA> m_solver;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_DIVA_MOD_H */
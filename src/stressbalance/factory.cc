@@ -27,6 +27,8 @@
 #include "pism/regional/SIAFD_Regional.hh"
 #include "pism/stressbalance/blatter/Blatter.hh"
 #include "pism/stressbalance/blatter/BlatterMod.hh"
+#include "pism/stressbalance/diva/DIVA.hh"
+#include "pism/stressbalance/diva/DIVAMod.hh"
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Context.hh"
@@ -51,6 +53,13 @@ std::shared_ptr<StressBalance> create(const std::string &model,
     return std::shared_ptr<StressBalance>(new StressBalance(grid, blatter, mod));
   }
 
+  if (model == "diva") {
+    std::shared_ptr<DIVA> diva(new DIVA(grid));
+    std::shared_ptr<DIVAMod> mod(new DIVAMod(diva));
+
+    return std::shared_ptr<StressBalance>(new StressBalance(grid, diva, mod));
+  }
+
   SSAFactory SSA;
   if (config->get_string("stress_balance.ssa.method") == "fd") {
     SSA = regional ? SSAFD_RegionalFactory : SSAFDFactory;
@@ -65,9 +65,11 @@ SSAFD::SSAFD(std::shared_ptr<const Grid> grid)
     m_nuH_old(grid, "nuH_old"),
     m_work(grid, "work_vector", array::WITH_GHOSTS,
            2 /* stencil width */),
+    m_basal_drag(grid, "basal_drag"),
     m_b(grid, "right_hand_side"),
     m_velocity_old(grid, "velocity_old"),
-    m_scaling(1e9)  // comparable to typical beta for an ice stream;
+    m_scaling(1e9),  // comparable to typical beta for an ice stream;
+    m_tuner(grid, "SSAFD", "ssafd_")
 {
 
   m_velocity_old.metadata(0)
@@ -88,6 +90,10 @@ SSAFD::SSAFD(std::shared_ptr<const Grid> grid)
 
   m_work.metadata(0).long_name("temporary storage used to compute nuH");
 
+  m_basal_drag.metadata(0)
+      .long_name("basal drag coefficient used to assemble the SSA matrix")
+      .units("Pa s m-1");
+
   // The nuH viewer:
   m_view_nuh        = false;
   m_nuh_viewer_size = 300;
@@ -116,6 +122,20 @@ SSAFD::SSAFD(std::shared_ptr<const Grid> grid)
     ierr = KSPConvergedDefaultSetUIRNorm(m_KSP);
     PISM_CHK(ierr, "KSPConvergedDefaultSetUIRNorm");
   }
+
+  // candidate KSP configurations (see solver_tuning.enabled)
+  {
+    m_tuner.add_candidate("bjacobi_ilu0", "-ksp_type gmres -pc_type bjacobi -sub_pc_type ilu"
+                          " -sub_pc_factor_levels 0");
+    m_tuner.add_candidate("bjacobi_ilu1", "-ksp_type gmres -pc_type bjacobi -sub_pc_type ilu"
+                          " -sub_pc_factor_levels 1");
+    m_tuner.add_candidate("asm1_ilu0", "-ksp_type gmres -pc_type asm -pc_asm_overlap 1"
+                          " -sub_pc_type ilu -sub_pc_factor_levels 0");
+    m_tuner.add_candidate("asm2_ilu1", "-ksp_type gmres -pc_type asm -pc_asm_overlap 2"
+                          " -sub_pc_type ilu -sub_pc_factor_levels 1");
+    m_tuner.add_candidate("asm1_lu", "-ksp_type gmres -pc_type asm -pc_asm_overlap 1"
+                          " -sub_pc_type lu");
+  }
 }
 
 //! @note Uses `PetscErrorCode` *intentionally*.
@@ -412,6 +432,31 @@ static void set_diagonal_matrix_entry(Mat A, int i, int j, int component, double
 }
 
 
+//! Compute the basal drag coefficient corresponding to `velocity`.
+/*!
+ * Evaluates the sliding law one grid row at a time to avoid a virtual method call per grid
+ * point and to let the sliding law use vectorized loops (see
+ * IceBasalResistancePlasticLaw::drag_with_derivative()).
+ *
+ * Values are computed at all grid points, including ones where the basal drag is not
+ * used.
+ */
+void SSAFD::compute_basal_drag(const array::Scalar &tauc, const array::Vector &velocity,
+                               array::Scalar &result) const {
+  array::AccessScope list{ &tauc, &velocity, &result };
+
+  const int xs = m_grid->xs(), xm = m_grid->xm(), ys = m_grid->ys(), ym = m_grid->ym();
+
+  auto *tauc_array   = tauc.array();
+  auto *vel_array    = velocity.array();
+  auto *result_array = result.array();
+
+  for (int j = ys; j < ys + ym; ++j) {
+    m_basal_sliding_law->drag_with_derivative(xm, &tauc_array[j][xs], &vel_array[j][xs],
+                                              &result_array[j][xs], nullptr);
+  }
+}
+
 //! \brief Assemble the left-hand side matrix for the KSP-based, Picard iteration,
 //! and finite difference implementation of the SSA equations.
 /*!
@@ -525,7 +570,11 @@ void SSAFD::assemble_matrix(const Inputs &inputs, bool include_basal_shear, Mat
   ierr = MatZeroEntries(A);
   PISM_CHK(ierr, "MatZeroEntries");
 
-  array::AccessScope list{ &m_nuH, &tauc, &vel, &m_mask, &bed, &surface };
+  if (include_basal_shear) {
+    compute_basal_drag(tauc, vel, m_basal_drag);
+  }
+
+  array::AccessScope list{ &m_nuH, &m_basal_drag, &vel, &m_mask, &bed, &surface };
 
   if (inputs.bc_values != nullptr && inputs.bc_mask != nullptr) {
     list.add(*inputs.bc_mask);
@@ -776,12 +825,12 @@ void SSAFD::assemble_matrix(const Inputs &inputs, bool include_basal_shear, Mat
         }
         case MASK_FLOATING: {
           double scaling = sub_gl ? grounded_fraction(i, j) : 0.0;
-          beta = scaling * m_basal_sliding_law->drag(tauc(i, j), vel(i, j).u, vel(i, j).v);
+          beta = scaling * m_basal_drag(i, j);
           break;
         }
         case MASK_GROUNDED: {
           double scaling = sub_gl ? grounded_fraction(i, j) : 1.0;
-          beta = scaling * m_basal_sliding_law->drag(tauc(i, j), vel(i, j).u, vel(i, j).v);
+          beta = scaling * m_basal_drag(i, j);
           break;
         }
         case MASK_ICE_FREE_OCEAN:
@@ -950,6 +999,10 @@ void SSAFD::solve(const Inputs &inputs) {
     compute_hardav_staggered(inputs);
   }
 
+  if (m_tuner.enabled()) {
+    m_tuner.set_problem_size(icy_cell_count(inputs.geometry->cell_type));
+  }
+
   for (unsigned int k = 0; k < 3; ++k) {
     try {
       if (k == 0) {
@@ -1083,8 +1136,7 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
     ierr = KSPSetOperators(m_KSP, m_A, m_A);
     PISM_CHK(ierr, "KSPSetOperator");
 
-    ierr = KSPSolve(m_KSP, m_b.vec(), m_velocity_global.vec());
-    PISM_CHK(ierr, "KSPSolve");
+    m_tuner.solve(m_KSP, m_b.vec(), m_velocity_global.vec());
 
     // Check if diverged; report to standard out about iteration
     ierr = KSPGetConvergedReason(m_KSP, &reason);
@@ -1477,11 +1529,8 @@ void SSAFD::compute_nuH_staggered(const array::Scalar1 &ice_thickness,
         v_y = (uv(i, j + 1).v - uv(i, j).v) / dy;
       }
 
-      double nu = 0.0;
-      m_flow_law->effective_viscosity(hardness(i, j, o),
-                                      secondInvariant_2D({ u_x, v_x }, { u_y, v_y }), &nu, NULL);
-
-      result(i, j, o) = nu * H;
+      result(i, j, o) =
+          column_nuH(i, j, o, H, hardness(i, j, o), secondInvariant_2D({ u_x, v_x }, { u_y, v_y }));
 
       // include the SSA enhancement factor; in most cases m_e_factor is 1
       result(i, j, o) *= nu_enhancement_scaling;
@@ -1561,7 +1610,7 @@ void SSAFD::compute_nuH_staggered_cfbc(const array::Scalar1 &ice_thickness,
   for (auto p = m_grid->points(); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    double u_x, u_y, v_x, v_y, H, nu, W;
+    double u_x, u_y, v_x, v_y, H, W;
     // i-offset
     {
       if (mask.icy(i, j) && mask.icy(i + 1, j)) {
@@ -1590,9 +1639,8 @@ void SSAFD::compute_nuH_staggered_cfbc(const array::Scalar1 &ice_thickness,
           v_y = 0.0;
         }
 
-        m_flow_law->effective_viscosity(hardness(i, j, 0),
-                                        secondInvariant_2D({ u_x, v_x }, { u_y, v_y }), &nu, NULL);
-        result(i, j, 0) = nu * H;
+        result(i, j, 0) = column_nuH(i, j, 0, H, hardness(i, j, 0),
+                                      secondInvariant_2D({ u_x, v_x }, { u_y, v_y }));
       } else {
         result(i, j, 0) = strength_extension->get_notional_strength();
       }
@@ -1626,9 +1674,8 @@ void SSAFD::compute_nuH_staggered_cfbc(const array::Scalar1 &ice_thickness,
           v_x = 0.0;
         }
 
-        m_flow_law->effective_viscosity(hardness(i, j, 1),
-                                        secondInvariant_2D({ u_x, v_x }, { u_y, v_y }), &nu, NULL);
-        result(i, j, 1) = nu * H;
+        result(i, j, 1) = column_nuH(i, j, 1, H, hardness(i, j, 1),
+                                      secondInvariant_2D({ u_x, v_x }, { u_y, v_y }));
       } else {
         result(i, j, 1) = strength_extension->get_notional_strength();
       }
@@ -1648,6 +1695,29 @@ void SSAFD::compute_nuH_staggered_cfbc(const array::Scalar1 &ice_thickness,
   result.update_ghosts();
 }
 
+/*!
+ * Compute the product of the effective viscosity and ice thickness at the staggered grid
+ * location `(i, j, o)`, given the ice thickness `H`, the vertically-averaged ice hardness
+ * and the second invariant `gamma` of the horizontal strain rate.
+ *
+ * Does not include the SSA enhancement factor and the regularization.
+ *
+ * This is a virtual method called once per staggered grid point. This is intentional: the
+ * cost of the indirect call is small compared to the pow() in
+ * FlowLaw::effective_viscosity() (SSAFD) and the integral over the column (DIVA), and
+ * hoisting it out of the loop would require storing strain rates on the staggered grid.
+ */
+double SSAFD::column_nuH(int i, int j, int o, double H, double hardness, double gamma) const {
+  (void)i;
+  (void)j;
+  (void)o;
+
+  double nu = 0.0;
+  m_flow_law->effective_viscosity(hardness, gamma, &nu, NULL);
+
+  return nu * H;
+}
+
 //! Update the nuH viewer, which shows log10(nu H).
 void SSAFD::update_nuH_viewers() {
 
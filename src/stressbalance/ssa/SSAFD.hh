@@ -26,6 +26,7 @@
 #include "pism/util/petscwrappers/KSP.hh"
 #include "pism/util/petscwrappers/Mat.hh"
 #include "pism/util/array/Staggered.hh"
+#include "pism/util/SolverTuner.hh"
 
 namespace pism {
 namespace stressbalance {
@@ -74,12 +75,17 @@ protected:
                                           double nuH_regularization,
                                           array::Staggered &result);
 
+  virtual double column_nuH(int i, int j, int o, double H, double hardness, double gamma) const;
+
   virtual void compute_nuH_norm(double &norm,
                                 double &norm_change);
 
   virtual void assemble_matrix(const Inputs &inputs,
                                bool include_basal_shear, Mat A);
 
+  virtual void compute_basal_drag(const array::Scalar &tauc, const array::Vector &velocity,
+                                  array::Scalar &result) const;
+
   virtual void assemble_rhs(const Inputs &inputs);
 
   virtual void write_system_petsc(const std::string &namepart);
@@ -110,6 +116,9 @@ protected:
   };
   array::Array2D<Work> m_work;
 
+  //! basal drag coefficient corresponding to the current velocity guess
+  array::Scalar m_basal_drag;
+
   petsc::KSP m_KSP;
   petsc::Mat m_A;
   array::Vector m_b;            // right hand side
@@ -117,6 +126,9 @@ protected:
   array::Vector1 m_velocity_old;
   const double m_scaling;
 
+  //! selects the KSP configuration if `solver_tuning.enabled` is set
+  SolverTuner m_tuner;
+
   unsigned int m_default_pc_failure_count,
     m_default_pc_failure_max_count;
   
@@ -52,7 +52,8 @@ SSAFEM::SSAFEM(std::shared_ptr<const Grid> grid)
       m_node_type(m_grid, "node_type"),
       m_boundary_integral(m_grid, "boundary_integral"),
       m_element_index(*grid),
-      m_q1_element(*grid, fem::Q1Quadrature4()) {
+      m_q1_element(*grid, fem::Q1Quadrature4()),
+      m_tuner(grid, "SSAFEM", "ssafem_") {
   m_bc_mask.set_interpolation_type(NEAREST);
   m_node_type.set_interpolation_type(NEAREST);
 
@@ -71,6 +72,9 @@ SSAFEM::SSAFEM(std::shared_ptr<const Grid> grid)
   ierr = SNESCreate(m_grid->com, m_snes.rawptr());
   PISM_CHK(ierr, "SNESCreate");
 
+  ierr = SNESSetOptionsPrefix(m_snes, "ssafem_");
+  PISM_CHK(ierr, "SNESSetOptionsPrefix");
+
   // Set the SNES callbacks to call into our compute_local_function and compute_local_jacobian.
   m_callback_data.da  = *m_da;
   m_callback_data.ssa = this;
@@ -111,6 +115,16 @@ SSAFEM::SSAFEM(std::shared_ptr<const Grid> grid)
   ierr = SNESSetFromOptions(m_snes);
   PISM_CHK(ierr, "SNESSetFromOptions");
 
+  // candidate configurations of the linear solver (see solver_tuning.enabled)
+  {
+    m_tuner.add_candidate("bjacobi_ilu0", "-ksp_type gmres -pc_type bjacobi -sub_pc_type ilu");
+    m_tuner.add_candidate("asm1_ilu0", "-ksp_type gmres -pc_type asm -pc_asm_overlap 1"
+                          " -sub_pc_type ilu");
+    m_tuner.add_candidate("asm1_lu", "-ksp_type gmres -pc_type asm -pc_asm_overlap 1"
+                          " -sub_pc_type lu");
+    m_tuner.add_candidate("gamg", "-ksp_type gmres -pc_type gamg");
+  }
+
   m_node_type.metadata(0).long_name(
       "node types: interior, boundary, exterior"); // no units or standard name
 
@@ -187,6 +201,10 @@ std::shared_ptr<TerminationReason> SSAFEM::solve_with_reason(const Inputs &input
   // Set up the system to solve.
   cache_inputs(inputs);
 
+  if (m_tuner.enabled()) {
+    m_tuner.set_problem_size(icy_cell_count(inputs.geometry->cell_type));
+  }
+
   return solve_nocache();
 }
 
@@ -222,8 +240,7 @@ std::shared_ptr<TerminationReason> SSAFEM::solve_nocache() {
   }
 
   // Solve:
-  ierr = SNESSolve(m_snes, NULL, m_velocity_global.vec());
-  PISM_CHK(ierr, "SNESSolve");
+  m_tuner.solve(m_snes, m_velocity_global.vec());
 
   // See if it worked.
   SNESConvergedReason snes_reason;
@@ -483,34 +500,23 @@ void SSAFEM::driving_stress(const fem::Element &E,
 }
 
 
-/** @brief Compute the "(regularized effective viscosity) x (ice thickness)" and effective viscous
- *  bed strength from the current solution, at a single quadrature point.
+/** @brief Compute the "(regularized effective viscosity) x (ice thickness)" from the
+ *  current solution, at a single quadrature point.
  *
  * @param[in] thickness ice thickness
  * @param[in] hardness ice hardness
- * @param[in] mask cell type mask
- * @param[in] tauc basal yield stress
- * @param[in] U the value of the solution
  * @param[in] U_x x-derivatives of velocity components
  * @param[in] U_y y-derivatives of velocity components
  * @param[out] nuH product of the ice viscosity and thickness @f$ \nu H @f$
  * @param[out] dnuH derivative of @f$ \nu H @f$ with respect to the
  *                  second invariant @f$ \gamma @f$. Set to NULL if
  *                  not desired.
- * @param[out] beta basal drag coefficient @f$ \beta @f$
- * @param[out] dbeta derivative of @f$ \beta @f$ with respect to the
- *                   second invariant @f$ \gamma @f$. Set to NULL if
- *                   not desired.
  */
-void SSAFEM::PointwiseNuHAndBeta(double thickness,
-                                 double hardness,
-                                 int mask,
-                                 double tauc,
-                                 const Vector2d &U,
-                                 const Vector2d &U_x,
-                                 const Vector2d &U_y,
-                                 double *nuH, double *dnuH,
-                                 double *beta, double *dbeta) {
+void SSAFEM::PointwiseNuH(double thickness,
+                          double hardness,
+                          const Vector2d &U_x,
+                          const Vector2d &U_y,
+                          double *nuH, double *dnuH) {
 
   if (thickness < strength_extension->get_min_thickness()) {
     *nuH = strength_extension->get_notional_strength();
@@ -527,18 +533,43 @@ void SSAFEM::PointwiseNuHAndBeta(double thickness,
       *dnuH *= thickness;
     }
   }
+}
 
-  if (mask::grounded_ice(mask)) {
-    m_basal_sliding_law->drag_with_derivative(tauc, U.u, U.v, beta, dbeta);
-  } else {
-    *beta = 0;
+/** @brief Compute the effective viscous bed strength from the current solution at all
+ *  quadrature points of an element.
+ *
+ * The sliding law is evaluated at all `Nq` points using one call (see
+ * IceBasalResistancePlasticLaw::drag_with_derivative()); values at points that are not
+ * grounded are replaced afterwards.
+ *
+ * @param[in] Nq number of quadrature points
+ * @param[in] mask cell type mask
+ * @param[in] tauc basal yield stress
+ * @param[in] U the value of the solution
+ * @param[out] beta basal drag coefficient @f$ \beta @f$
+ * @param[out] dbeta derivative of @f$ \beta @f$ with respect to the
+ *                   second invariant @f$ \gamma @f$. Set to NULL if
+ *                   not desired.
+ */
+void SSAFEM::basal_drag(unsigned int Nq,
+                        const int *mask,
+                        const double *tauc,
+                        const Vector2d *U,
+                        double *beta, double *dbeta) {
 
-    if (mask::ice_free_land(mask)) {
-      *beta = m_beta_ice_free_bedrock;
-    }
+  m_basal_sliding_law->drag_with_derivative(Nq, tauc, U, beta, dbeta);
+
+  for (unsigned int q = 0; q < Nq; q++) {
+    if (not mask::grounded_ice(mask[q])) {
+      beta[q] = 0;
+
+      if (mask::ice_free_land(mask[q])) {
+        beta[q] = m_beta_ice_free_bedrock;
+      }
 
-    if (dbeta) {
-      *dbeta = 0;
+      if (dbeta) {
+        dbeta[q] = 0;
+      }
     }
   }
 }
@@ -858,18 +889,20 @@ void SSAFEM::compute_local_function(Vector2d const *const *const velocity_global
           residual[k] = 0;
         }
 
+        double beta[Nq_max];
+        basal_drag(Nq, mask, tauc, U, beta, NULL);
+
         // loop over quadrature points:
         for (unsigned int q = 0; q < Nq; q++) {
 
           auto W = E->weight(q);
 
-          double eta = 0.0, beta = 0.0;
-          PointwiseNuHAndBeta(thickness[q], hardness[q], mask[q], tauc[q],
-                              U[q], U_x[q], U_y[q], // inputs
-                              &eta, NULL, &beta, NULL);              // outputs
+          double eta = 0.0;
+          PointwiseNuH(thickness[q], hardness[q], U_x[q], U_y[q], // inputs
+                       &eta, NULL);                               // outputs
 
           // The next few lines compute the actual residual for the element.
-          const Vector2d tau_b = U[q] * (- beta); // basal shear stress
+          const Vector2d tau_b = U[q] * (- beta[q]); // basal shear stress
 
           const double
             u_x          = U_x[q].u,
@@ -1063,6 +1096,9 @@ void SSAFEM::compute_local_jacobian(Vector2d const *const *const velocity_global
         ierr = PetscMemzero(K, sizeof(K));
         PISM_CHK(ierr, "PetscMemzero");
 
+        double beta_q[Nq_max], dbeta_q[Nq_max];
+        basal_drag(Nq, mask, tauc, U, beta_q, dbeta_q);
+
         for (unsigned int q = 0; q < Nq; q++) {
 
           const double
@@ -1071,12 +1107,13 @@ void SSAFEM::compute_local_jacobian(Vector2d const *const *const velocity_global
             v            = U[q].v,
             u_x          = U_x[q].u,
             v_y          = U_y[q].v,
-            u_y_plus_v_x = U_y[q].u + U_x[q].v;
+            u_y_plus_v_x = U_y[q].u + U_x[q].v,
+            beta         = beta_q[q],
+            dbeta        = dbeta_q[q];
 
-          double eta = 0.0, deta = 0.0, beta = 0.0, dbeta = 0.0;
-          PointwiseNuHAndBeta(thickness[q], hardness[q], mask[q], tauc[q],
-                              U[q], U_x[q], U_y[q],
-                              &eta, &deta, &beta, &dbeta);
+          double eta = 0.0, deta = 0.0;
+          PointwiseNuH(thickness[q], hardness[q], U_x[q], U_y[q],
+                       &eta, &deta);
 
           for (unsigned int l = 0; l < n_chi; l++) { // Trial functions
 
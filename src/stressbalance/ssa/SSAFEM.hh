@@ -24,6 +24,7 @@
 #include "pism/util/petscwrappers/SNES.hh"
 #include "pism/util/TerminationReason.hh"
 #include "pism/util/Mask.hh"
+#include "pism/util/SolverTuner.hh"
 
 namespace pism {
 
@@ -90,15 +91,17 @@ protected:
                       const Coefficients *x,
                       Vector2d *driving_stress) const;
 
-  void PointwiseNuHAndBeta(double thickness,
-                           double hardness,
-                           int mask,
-                           double tauc,
-                           const Vector2d &U,
-                           const Vector2d &U_x,
-                           const Vector2d &U_y,
-                           double *nuH, double *dnuH,
-                           double *beta, double *dbeta);
+  void PointwiseNuH(double thickness,
+                    double hardness,
+                    const Vector2d &U_x,
+                    const Vector2d &U_y,
+                    double *nuH, double *dnuH);
+
+  void basal_drag(unsigned int Nq,
+                  const int *mask,
+                  const double *tauc,
+                  const Vector2d *U,
+                  double *beta, double *dbeta);
 
   void compute_local_function(Vector2d const *const *const velocity,
                               Vector2d **residual);
@@ -140,6 +143,9 @@ protected:
   fem::Q1Element2 m_q1_element;
   // fem::P1Element m_p1_element;
 
+  //! selects the KSP configuration if `solver_tuning.enabled` is set
+  SolverTuner m_tuner;
+
   // Support for direct specification of driving stress to the FEM SSA solver. This helps
   // with certain test cases where the grid is periodic but the driving stress cannot be the
   // gradient of a periodic function. (See commit ffb4be16.)
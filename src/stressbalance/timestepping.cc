@@ -168,4 +168,22 @@ MaxTimestep max_timestep_diffusivity(double D_max, double dx, double dy,
   return {};
 }
 
+bool energy_age_update_due(double dt_energy_age, double dt, const MaxTimestep &dt_cfl,
+                           double enthalpy_change_rate, double max_enthalpy_change,
+                           double thickness_change, double max_thickness_change) {
+  // length of the energy and age time step if the next step is skipped
+  const double interval = dt_energy_age + dt;
+
+  // we need room for one more skipped step *and* the step updating energy and age
+  if (dt_cfl.finite() and interval + dt > dt_cfl.value()) {
+    return true;
+  }
+
+  if (enthalpy_change_rate * interval > max_enthalpy_change) {
+    return true;
+  }
+
+  return thickness_change > max_thickness_change;
+}
+
 } // end of namespace pism
@@ -68,6 +68,24 @@ CFLData max_timestep_cfl_2d(const array::Scalar &ice_thickness,
  */
 MaxTimestep max_timestep_diffusivity(double D_max, double dx, double dy,
                                      double adaptive_timestepping_ratio);
+
+/*!
+ * Returns true if energy and age models should be updated at the next time step
+ * (adaptive "skipping").
+ *
+ * @param[in] dt_energy_age length of the current energy and age time step (accumulated
+ *                          during skipped steps, including the current step)
+ * @param[in] dt length of the current time step (the next one is assumed to be as long)
+ * @param[in] dt_cfl maximum energy and age time step allowed by the 3D CFL condition
+ * @param[in] enthalpy_change_rate maximum rate of change of ice enthalpy during the last
+ *                                 energy time step
+ * @param[in] max_enthalpy_change maximum enthalpy change during one energy time step
+ * @param[in] thickness_change maximum ice thickness change since the last update
+ * @param[in] max_thickness_change maximum ice thickness change during one energy time step
+ */
+bool energy_age_update_due(double dt_energy_age, double dt, const MaxTimestep &dt_cfl,
+                           double enthalpy_change_rate, double max_enthalpy_change,
+                           double thickness_change, double max_thickness_change);
 } // end of namespace pism
 
 
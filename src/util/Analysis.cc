@@ -0,0 +1,81 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/Analysis.hh"
+
+#include "pism/util/array/Array.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+
+AnalysisInputs::AnalysisInputs(MPI_Comm com, double time)
+  : m_com(com), m_time(time) {
+  // empty
+}
+
+MPI_Comm AnalysisInputs::com() const {
+  return m_com;
+}
+
+double AnalysisInputs::time() const {
+  return m_time;
+}
+
+bool AnalysisInputs::is_available(const std::string &name) const {
+  return m_fields.find(name) != m_fields.end();
+}
+
+const array::Array& AnalysisInputs::get(const std::string &name) const {
+  auto it = m_fields.find(name);
+  if (it == m_fields.end()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "field '%s' is not available to in-situ analyses",
+                                  name.c_str());
+  }
+  return *it->second;
+}
+
+std::vector<std::string> AnalysisInputs::keys() const {
+  std::vector<std::string> result;
+  for (const auto &f : m_fields) {
+    result.push_back(f.first);
+  }
+  return result;
+}
+
+void AnalysisInputs::add(const std::string &name, const array::Array &field) {
+  m_fields[name] = &field;
+}
+
+void AnalysisInputs::add(const std::string &name, std::shared_ptr<const array::Array> field) {
+  m_fields[name] = field.get();
+  m_storage.emplace_back(field);
+}
+
+std::string Analysis::units(const std::string &output) const {
+  (void) output;
+  return "1";
+}
+
+std::string Analysis::long_name(const std::string &output) const {
+  (void) output;
+  return "";
+}
+
+} // end of namespace pism
@@ -0,0 +1,107 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ANALYSIS_H
+#define PISM_ANALYSIS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+namespace pism {
+
+namespace array {
+class Array;
+} // end of namespace array
+
+//! Read-only access to model fields used by an in-situ analysis.
+/*!
+ * Fields are *not* copied: an analysis sees the storage used by the model (or by a
+ * spatially-variable diagnostic computed just before the analysis is called).
+ */
+class AnalysisInputs {
+public:
+  AnalysisInputs(MPI_Comm com, double time);
+
+  //! MPI communicator used by the model.
+  MPI_Comm com() const;
+
+  //! Current model time, in seconds.
+  double time() const;
+
+  bool is_available(const std::string &name) const;
+
+  //! Get a field. Throws RuntimeError if `name` is not available.
+  const array::Array& get(const std::string &name) const;
+
+  std::vector<std::string> keys() const;
+
+  void add(const std::string &name, const array::Array &field);
+  void add(const std::string &name, std::shared_ptr<const array::Array> field);
+private:
+  MPI_Comm m_com;
+  double m_time;
+  std::map<std::string, const array::Array*> m_fields;
+  //! Storage for fields computed by diagnostics.
+  std::vector<std::shared_ptr<const array::Array> > m_storage;
+};
+
+//! The base class of in-situ analyses.
+/*!
+ * An in-situ analysis computes a few scalars (reductions, values at selected locations,
+ * etc) from model fields at requested times (see `output.analysis.times`).
+ * Results are appended to time series in `output.analysis.file`, avoiding the
+ * need to save full fields using `-extra_file` and post-process them.
+ *
+ * Note that compute() is collective: every rank gets the local part of the requested
+ * fields and every rank has to return the same results.
+ *
+ * Implementations in Python derive from `PISM.Analysis`, use `Array.local_view()` to get
+ * read-only NumPy views of local parts of fields and should be registered using
+ * `IceModel.add_analysis()`.
+ */
+class Analysis {
+public:
+  typedef std::shared_ptr<Analysis> Ptr;
+
+  virtual ~Analysis() = default;
+
+  //! Names of fields (model state variables or spatially-variable diagnostics) used by
+  //! this analysis.
+  virtual std::vector<std::string> inputs() const = 0;
+
+  //! Names of scalar quantities computed by this analysis.
+  virtual std::vector<std::string> outputs() const = 0;
+
+  //! Units of a quantity computed by this analysis ("1" by default).
+  virtual std::string units(const std::string &output) const;
+
+  //! Long name of a quantity computed by this analysis (empty by default).
+  virtual std::string long_name(const std::string &output) const;
+
+  //! Compute outputs (in the order matching outputs()).
+  virtual std::vector<double> compute(const AnalysisInputs &inputs) = 0;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_ANALYSIS_H */
@@ -24,6 +24,7 @@
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/array/Array3D.hh"
+#include "pism/util/array/Scalar.hh"
 #include "pism/util/ColumnSystem.hh"
 
 #include "pism/util/error_handling.hh"
@@ -251,7 +252,11 @@ columnSystemCtx::columnSystemCtx(const std::vector<double>& storage_grid,
                                  const array::Array3D &u3,
                                  const array::Array3D &v3,
                                  const array::Array3D &w3)
-  : m_dx(dx), m_dy(dy), m_dt(dt), m_u3(u3), m_v3(v3), m_w3(w3) {
+  : m_dx(dx), m_dy(dy), m_dt(dt), m_u3(u3), m_v3(v3), m_w3(w3),
+    m_sigma(false),
+    m_ice_thickness(nullptr),
+    m_previous_ice_thickness(nullptr),
+    m_min_thickness(0.0) {
   assert(dx > 0.0);
   assert(dy > 0.0);
   assert(dt > 0.0);
@@ -315,10 +320,114 @@ void columnSystemCtx::init_fine_grid(const std::vector<double>& storage_grid) {
   // Note that it *is* allowed to go over Lz.
 }
 
+/*!
+ * Use the terrain-following vertical coordinate @f$ \sigma = z / H @f$.
+ *
+ * In this mode the storage grid passed to the constructor contains sigma levels. The
+ * fine grid in a column with the thickness @f$ H @f$ consists of levels @f$ H \sigma_k
+ * @f$ (equally spaced with @f$ \Delta z = H \Delta \sigma @f$), so all its levels are in
+ * the ice and the top one is at the ice surface.
+ *
+ * Velocity components and other inputs are stored on the grid `z` and are interpolated to
+ * the fine grid in each column.
+ *
+ * Derived classes have to call add_sigma_metric_terms() after setting velocity components
+ * in a column. `previous_ice_thickness` is the ice thickness corresponding to the state
+ * at the beginning of the time step.
+ */
+void columnSystemCtx::use_sigma_coordinate(const std::vector<double> &z,
+                                           const array::Scalar1 &ice_thickness,
+                                           const array::Scalar &previous_ice_thickness,
+                                           double min_thickness) {
+  m_sigma                  = true;
+  m_sigma_fine             = m_z;
+  m_z_input                = z;
+  m_ice_thickness          = &ice_thickness;
+  m_previous_ice_thickness = &previous_ice_thickness;
+  m_min_thickness          = min_thickness;
+}
+
+//! Interpolate an input (velocity component, etc) to the fine grid in the current column.
+void columnSystemCtx::input_to_fine(const array::Array3D &input, int i, int j,
+                                    double *output) const {
+  if (not m_sigma) {
+    coarse_to_fine(input, i, j, output);
+    return;
+  }
+
+  const double *column = input.get_column(i, j);
+  const size_t N = m_z_input.size();
+
+  unsigned int m = 0;
+  for (unsigned int k = 0; k < m_z.size(); ++k) {
+    const double z = m_z[k];
+
+    if (z >= m_z_input[N - 1]) {
+      output[k] = column[N - 1];
+      continue;
+    }
+
+    while (m + 2 < N and m_z_input[m + 1] <= z) {
+      ++m;
+    }
+
+    const double lambda = (z - m_z_input[m]) / (m_z_input[m + 1] - m_z_input[m]);
+    output[k] = column[m] + lambda * (column[m + 1] - column[m]);
+  }
+}
+
+/*!
+ * Replace the vertical velocity in the current column with the "sigma velocity"
+ *
+ * @f[ \tilde w = w - \sigma \left( \diff{H}{t} + u \diff{H}{x} + v \diff{H}{y} \right). @f]
+ *
+ * With this replacement the equations in the @f$ (x, y, z) @f$ form (using horizontal
+ * derivatives at constant @f$ \sigma @f$ and the fine grid @f$ z_k = H \sigma_k @f$)
+ * approximate the equations transformed to the @f$ (x, y, \sigma) @f$ coordinates.
+ */
+void columnSystemCtx::add_sigma_metric_terms() {
+  if (not m_sigma or m_ks == 0) {
+    return;
+  }
+
+  const array::Scalar1 &H = *m_ice_thickness;
+
+  auto h = H.star(m_i, m_j);
+
+  const double
+    H_x = (h.e - h.w) / (2.0 * m_dx),
+    H_y = (h.n - h.s) / (2.0 * m_dy),
+    H_t = (h.c - (*m_previous_ice_thickness)(m_i, m_j)) / m_dt;
+
+  for (unsigned int k = 0; k <= m_ks; ++k) {
+    m_w[k] -= m_sigma_fine[k] * (H_t + m_u[k] * H_x + m_v[k] * H_y);
+  }
+}
+
 void columnSystemCtx::init_column(int i, int j,
                                   double ice_thickness) {
   m_i  = i;
   m_j  = j;
+
+  if (m_sigma) {
+    const double dsigma = m_sigma_fine[1] - m_sigma_fine[0];
+
+    if (ice_thickness > m_min_thickness) {
+      m_ks = m_sigma_fine.size() - 1;
+      m_dz = ice_thickness * dsigma;
+    } else {
+      m_ks = 0;
+      m_dz = m_min_thickness * dsigma;
+    }
+
+    for (unsigned int k = 0; k < m_z.size(); ++k) {
+      m_z[k] = ice_thickness * m_sigma_fine[k];
+    }
+
+    m_solver->reset();
+    return;
+  }
+
   m_ks = static_cast<unsigned int>(floor(ice_thickness / m_dz));
 
   // Force m_ks to be in the allowed range.
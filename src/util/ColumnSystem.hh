@@ -27,6 +27,8 @@ namespace pism {
 
 namespace array {
 class Array3D;
+class Scalar;
+class Scalar1;
 } // end of namespace array
 
 //! Virtual base class.  Abstracts a tridiagonal system to solve in a column of ice and/or bedrock.
@@ -156,6 +158,11 @@ public:
   const std::vector<double>& z() const;
   void fine_to_coarse(const std::vector<double> &fine, int i, int j,
                       array::Array3D& coarse) const;
+
+  void use_sigma_coordinate(const std::vector<double> &z,
+                            const array::Scalar1 &ice_thickness,
+                            const array::Scalar &previous_ice_thickness,
+                            double min_thickness);
 protected:
   TridiagonalSystem *m_solver;
 
@@ -180,8 +187,24 @@ protected:
   //! pointers to 3D velocity components
   const array::Array3D &m_u3, &m_v3, &m_w3;
 
+  //! true if the storage grid uses the terrain-following (sigma) coordinate
+  bool m_sigma;
+  //! levels of the fine grid in the sigma coordinate
+  std::vector<double> m_sigma_fine;
+  //! vertical grid of inputs (velocity components, etc) in the sigma mode
+  std::vector<double> m_z_input;
+  //! current and previous ice thickness (used to compute metric terms in the sigma mode)
+  const array::Scalar1 *m_ice_thickness;
+  const array::Scalar *m_previous_ice_thickness;
+  //! columns thinner than this are treated as ice-free in the sigma mode
+  double m_min_thickness;
+
   void init_column(int i, int j, double ice_thickness);
 
+  void input_to_fine(const array::Array3D &input, int i, int j, double *fine) const;
+
+  void add_sigma_metric_terms();
+
   void reportColumnZeroPivotErrorMFile(unsigned int M);
 
   void init_fine_grid(const std::vector<double>& storage_grid);
@@ -22,6 +22,7 @@
 #include "pism/util/Profiling.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/Grid.hh"
+#include "pism/util/array/Array.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/VariableMetadata.hh"
 #include "pism/util/ConfigInterface.hh"
@@ -159,10 +160,14 @@ void Component::write_model_state_impl(const File &output) const {
 void Component::regrid(const std::string &module_name, array::Array &variable,
                        RegriddingFlag flag) {
 
+  // make this field available to models using a different grid (grid sequencing)
+  m_grid->add_state_field(variable);
+
   auto regrid_file = m_config->get_string("input.regrid.file");
   auto regrid_vars = set_split(m_config->get_string("input.regrid.vars"), ',');
+  auto source_grid = m_grid->regrid_source();
 
-  if (regrid_file.empty()) {
+  if (regrid_file.empty() and not source_grid) {
     return;
   }
 
@@ -171,12 +176,24 @@ void Component::regrid(const std::string &module_name, array::Array &variable,
   if (((not regrid_vars.empty()) and member(m["short_name"], regrid_vars)) or
       (regrid_vars.empty() and flag == REGRID_WITHOUT_REGRID_VARS)) {
 
-    m_log->message(2,
-               "  %s: regridding '%s' from file '%s' ...\n",
-               module_name.c_str(),
-               m.get_string("short_name").c_str(), regrid_file.c_str());
+    const array::Array *source = source_grid ? source_grid->state_field(variable.get_name()) : nullptr;
+
+    if (source != nullptr) {
+      m_log->message(2,
+                     "  %s: interpolating '%s' from the %d*%d grid ...\n",
+                     module_name.c_str(),
+                     m.get_string("short_name").c_str(),
+                     (int)source_grid->Mx(), (int)source_grid->My());
 
-    variable.regrid(regrid_file, io::Default::Nil());
+      variable.regrid(*source);
+    } else if (not regrid_file.empty()) {
+      m_log->message(2,
+                     "  %s: regridding '%s' from file '%s' ...\n",
+                     module_name.c_str(),
+                     m.get_string("short_name").c_str(), regrid_file.c_str());
+
+      variable.regrid(regrid_file, io::Default::Nil());
+    }
   }
 }
 
@@ -47,6 +47,7 @@ class Scalar1;
 class Scalar2;
 class Scalar;
 class Staggered1;
+class Staggered2;
 class Staggered;
 class Vector1;
 class Vector2;
@@ -761,6 +761,14 @@ void set_config_from_options(units::System::Ptr unit_system, Config &config) {
     // let the user decide if they want to use "-no_mass" or not
   }
 
+  // Till friction angle optimization with frozen thermodynamics: only stress balance and
+  // mass transport are active.
+  if (config.get_string("basal_yield_stress.model") == "tillphi_opt" and
+      config.get_flag("basal_yield_stress.mohr_coulomb.tillphi_opt.freeze_thermodynamics")) {
+    config.set_flag("energy.enabled", false, CONFIG_USER);
+    config.set_flag("age.enabled", false, CONFIG_USER);
+  }
+
   // If frontal melt code includes floating ice, routing hydrology should include it also.
   if (config.get_string("hydrology.model") == "routing") {
     if (config.get_flag("frontal_melt.include_floating_ice")) {
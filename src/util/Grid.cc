@@ -18,7 +18,9 @@
 
 #include <cassert>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <gsl/gsl_interp.h>
 #include <map>
 #include <numeric>
@@ -30,8 +32,11 @@
 #include "pism/pism_config.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/Logger.hh"
+#include "pism/util/ProcessGrid.hh"
 #include "pism/util/Vars.hh"
+#include "pism/util/array/Array.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
 #include "pism/util/petscwrappers/DM.hh"
 #include "pism/util/projection.hh"
 #include "pism/util/pism_options.hh"
@@ -58,6 +63,11 @@ struct Grid::Impl {
 
   std::shared_ptr<const Context> ctx;
 
+  //! MPI communicator used by this grid (see grid::ProcessGrid)
+  MPI_Comm com;
+  //! true if `com` was created by this grid and has to be freed
+  bool com_is_owned;
+
   MappingInfo mapping_info;
 
   // int to match types used by MPI
@@ -116,6 +126,19 @@ struct Grid::Impl {
   //! surface and ocean models).
   Vars variables;
 
+  //! Model state fields that can be interpolated onto a different grid (see
+  //! Component::regrid()).
+  std::map<std::string, array::Array*> state_fields;
+
+  //! Grid used by the model providing initial values of model state variables (grid
+  //! sequencing).
+  std::shared_ptr<const Grid> regrid_source;
+
+  //! Coordinates of the domain used in output files and offsets of this grid in it (see
+  //! Grid::set_output_domain()). Empty coordinate vectors mean "same as this grid".
+  std::vector<double> output_x, output_y;
+  int output_i_offset, output_j_offset;
+
   //! GSL binary search accelerator used to speed up kBelowHeight().
   gsl_interp_accel *bsearch_accel;
 
@@ -124,7 +147,12 @@ struct Grid::Impl {
 };
 
 Grid::Impl::Impl(std::shared_ptr<const Context> context)
-    : ctx(context), mapping_info("mapping", ctx->unit_system()) {
+    : ctx(context),
+      com(context->com()),
+      com_is_owned(false),
+      mapping_info("mapping", ctx->unit_system()),
+      output_i_offset(0),
+      output_j_offset(0) {
   // empty
 }
 
@@ -158,9 +186,90 @@ std::shared_ptr<Grid> Grid::Shallow(std::shared_ptr<const Context> ctx, double L
   }
 }
 
+//! Select the process grid to use with grid parameters `p`.
+/*!
+ * Uses ownership ranges in `p` unless `grid.process_grid.node_aware` is set. Ownership
+ * ranges set using `-Nx`, `-Ny`, `-procs_x`, `-procs_y` take precedence.
+ */
+static grid::ProcessGrid process_grid(const Context &ctx, const grid::Parameters &p) {
+  grid::ProcessGrid result;
+  result.procs_x = p.procs_x;
+  result.procs_y = p.procs_y;
+
+  auto config = ctx.config();
+
+  if (not config->get_flag("grid.process_grid.node_aware")) {
+    return result;
+  }
+
+  options::Integer Nx("-Nx", "Number of processors in the x direction", 0);
+  options::Integer Ny("-Ny", "Number of processors in the y direction", 0);
+  options::IntegerList procs_x("-procs_x", "Processor ownership ranges (x direction)", {});
+  options::IntegerList procs_y("-procs_y", "Processor ownership ranges (y direction)", {});
+
+  if (Nx.is_set() or Ny.is_set() or procs_x.is_set() or procs_y.is_set()) {
+    ctx.log()->message(2, "* Ownership ranges are set using command-line options:"
+                          " ignoring grid.process_grid.node_aware\n");
+    return result;
+  }
+
+  auto stencil_width = static_cast<unsigned int>(config->get_number("grid.max_stencil_width"));
+
+  return grid::node_aware_process_grid(ctx.com(), p.Mx, p.My, stencil_width,
+                                       config->get_number("grid.process_grid.inter_node_cost"));
+}
+
+//! Report predicted and actual halo sizes corresponding to a node-aware process grid.
+static void report_halo_size(const Grid &grid, const grid::ProcessGrid &process_grid) {
+  auto ctx = grid.ctx();
+  auto log = ctx->log();
+
+  auto stencil_width = static_cast<unsigned int>(ctx->config()->get_number("grid.max_stencil_width"));
+
+  auto dm = grid.get_dm(1, stencil_width);
+
+  auto actual = grid::halo_size(*dm, process_grid.node, grid.com);
+  const auto &predicted = process_grid.halo;
+
+  int N_nodes = 1 + *std::max_element(process_grid.node.begin(), process_grid.node.end());
+
+  log->message(2, "* Process grid: %d x %d sub-domains on %d node(s)",
+               (int)process_grid.procs_x.size(), (int)process_grid.procs_y.size(), N_nodes);
+  if (process_grid.block_x > 0) {
+    log->message(2, ", %d x %d sub-domains per node\n", process_grid.block_x,
+                 process_grid.block_y);
+  } else {
+    log->message(2, ", contiguous rows of sub-domains per node\n");
+  }
+
+  // 8 bytes per value; 3D fields have Mz values per grid point
+  const double KiB = 8.0 / 1024.0, Mz = grid.Mz();
+
+  log->message(2,
+               "  Ghost exchange (stencil width %d), KiB total (between nodes):\n"
+               "    2D field:            %12.1f (%12.1f), predicted %12.1f (%12.1f)\n"
+               "    3D field (Mz = %4d): %12.1f (%12.1f), predicted %12.1f (%12.1f)\n",
+               stencil_width,
+               actual.total * KiB, actual.inter_node * KiB,
+               predicted.total * KiB, predicted.inter_node * KiB,
+               (int)Mz,
+               actual.total * KiB * Mz, actual.inter_node * KiB * Mz,
+               predicted.total * KiB * Mz, predicted.inter_node * KiB * Mz);
+}
+
 //! @brief Create a PISM distributed computational grid.
 Grid::Grid(std::shared_ptr<const Context> context, const grid::Parameters &p)
-    : com(context->com()), m_impl(new Impl(context)) {
+    : Grid(context, p, process_grid(*context, p)) {
+  // empty
+}
+
+Grid::Grid(std::shared_ptr<const Context> context, const grid::Parameters &p,
+           const grid::ProcessGrid &process_grid)
+    : com(process_grid.com != MPI_COMM_NULL ? process_grid.com : context->com()),
+      m_impl(new Impl(context)) {
+
+  m_impl->com          = com;
+  m_impl->com_is_owned = (process_grid.com != MPI_COMM_NULL);
 
   try {
     m_impl->bsearch_accel = gsl_interp_accel_alloc();
@@ -182,7 +291,7 @@ Grid::Grid(std::shared_ptr<const Context> context, const grid::Parameters &p)
     m_impl->registration = p.registration;
     m_impl->periodicity  = p.periodicity;
     m_impl->z            = p.z;
-    m_impl->set_ownership_ranges(p.procs_x, p.procs_y);
+    m_impl->set_ownership_ranges(process_grid.procs_x, process_grid.procs_y);
 
     m_impl->compute_horizontal_coordinates();
 
@@ -213,6 +322,10 @@ Grid::Grid(std::shared_ptr<const Context> context, const grid::Parameters &p)
     int patch_size = m_impl->xm * m_impl->ym;
     GlobalMax(com, &patch_size, &m_impl->max_patch_size, 1);
 
+    if (m_impl->com_is_owned) {
+      report_halo_size(*this, process_grid);
+    }
+
   } catch (RuntimeError &e) {
     e.add_context("allocating Grid");
     throw;
@@ -283,7 +396,14 @@ Grid::~Grid() {
   }
 #endif
 
+  bool com_is_owned = m_impl->com_is_owned;
+
   delete m_impl;
+
+  if (com_is_owned) {
+    MPI_Comm tmp = com;
+    MPI_Comm_free(&tmp);
+  }
 }
 
 
@@ -352,18 +472,6 @@ static void compute_nprocs(unsigned int Mx, unsigned int My, unsigned int size,
 }
 
 
-//! \brief Computes processor ownership ranges corresponding to equal area
-//! distribution among processors.
-static std::vector<unsigned int> ownership_ranges(unsigned int Mx, unsigned int Nx) {
-
-  std::vector<unsigned int> result(Nx);
-
-  for (unsigned int i = 0; i < Nx; i++) {
-    result[i] = Mx / Nx + static_cast<unsigned int>((Mx % Nx) > i);
-  }
-  return result;
-}
-
 //! Set processor ownership ranges. Takes care of type conversion (`unsigned int` -> `PetscInt`).
 void Grid::Impl::set_ownership_ranges(const std::vector<unsigned int> &input_procs_x,
                                       const std::vector<unsigned int> &input_procs_y) {
@@ -432,7 +540,7 @@ static OwnershipRanges compute_ownership_ranges(unsigned int Mx, unsigned int My
     }
 
   } else {
-    result.x = ownership_ranges(Mx, Nx);
+    result.x = grid::ownership_ranges(Mx, Nx);
   }
 
   if (procs_y.is_set()) {
@@ -445,7 +553,7 @@ static OwnershipRanges compute_ownership_ranges(unsigned int Mx, unsigned int My
       result.y[k] = procs_y[k];
     }
   } else {
-    result.y = ownership_ranges(My, Ny);
+    result.y = grid::ownership_ranges(My, Ny);
   }
 
   if (result.x.size() * result.y.size() != size) {
@@ -693,7 +801,7 @@ std::shared_ptr<petsc::DM> Grid::Impl::create_dm(int da_dof, int stencil_width)
 
   DM result;
   PetscErrorCode ierr =
-      DMDACreate2d(ctx->com(), DM_BOUNDARY_PERIODIC, DM_BOUNDARY_PERIODIC, DMDA_STENCIL_BOX, Mx, My,
+      DMDACreate2d(com, DM_BOUNDARY_PERIODIC, DM_BOUNDARY_PERIODIC, DMDA_STENCIL_BOX, Mx, My,
                    (PetscInt)procs_x.size(), (PetscInt)procs_y.size(), da_dof, stencil_width,
                    procs_x.data(), procs_y.data(), // lx, ly
                    &result);
@@ -727,6 +835,111 @@ const Vars &Grid::variables() const {
   return m_impl->variables;
 }
 
+/*!
+ * Record a model state field stored on this grid.
+ *
+ * These fields are used to initialize a model using a different grid in the same process
+ * (see set_regrid_source()) and to roll back a time step (see IceModel::step()). The
+ * field has to outlive all models using this grid.
+ */
+void Grid::add_state_field(array::Array &field) const {
+  m_impl->state_fields[field.get_name()] = &field;
+}
+
+//! Get a model state field added using add_state_field(). Returns NULL if not found.
+const array::Array* Grid::state_field(const std::string &name) const {
+  auto it = m_impl->state_fields.find(name);
+  if (it != m_impl->state_fields.end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+//! Get all model state fields added using add_state_field().
+std::vector<array::Array*> Grid::state_fields() const {
+  std::vector<array::Array*> result;
+  for (const auto &f : m_impl->state_fields) {
+    result.push_back(f.second);
+  }
+  return result;
+}
+
+/*!
+ * Set the grid of a model providing initial values of model state variables.
+ *
+ * If set, model components interpolate their state from fields stored on the `source`
+ * grid instead of reading them from `input.regrid.file`. This is used to run a sequence of
+ * models using progressively finer grids in one process.
+ *
+ * Use `nullptr` to stop using a regridding source.
+ */
+void Grid::set_regrid_source(std::shared_ptr<const Grid> source) {
+  m_impl->regrid_source = source;
+}
+
+std::shared_ptr<const Grid> Grid::regrid_source() const {
+  return m_impl->regrid_source;
+}
+
+//! Find the index of `value` in `coordinates` or return -1 if not found.
+static int find_coordinate(const std::vector<double> &coordinates, double value, double spacing) {
+  for (size_t k = 0; k < coordinates.size(); ++k) {
+    if (std::abs(coordinates[k] - value) < 1e-6 * spacing) {
+      return (int)k;
+    }
+  }
+  return -1;
+}
+
+/*!
+ * Write spatial fields using coordinates of a larger `domain` containing this grid.
+ *
+ * Grid points of this grid have to coincide with grid points of `domain`. Fields are
+ * written to the hyperslab corresponding to this grid; the rest of an output variable
+ * is not modified (i.e. contains fill values in a new file).
+ *
+ * This is used to keep output of a model running on a cropped domain in the coordinates
+ * of the full domain (see `grid.cropping.enabled`).
+ */
+void Grid::set_output_domain(const Grid &domain) {
+  int i0 = find_coordinate(domain.x(), x().front(), dx());
+  int j0 = find_coordinate(domain.y(), y().front(), dy());
+
+  if (i0 < 0 or j0 < 0 or
+      std::abs(domain.dx() - dx()) > 1e-6 * dx() or
+      std::abs(domain.dy() - dy()) > 1e-6 * dy() or
+      i0 + Mx() > domain.Mx() or
+      j0 + My() > domain.My()) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "the output domain has to contain this grid and use the same grid points");
+  }
+
+  m_impl->output_x        = domain.x();
+  m_impl->output_y        = domain.y();
+  m_impl->output_i_offset = i0;
+  m_impl->output_j_offset = j0;
+}
+
+//! X coordinates used in output files.
+const std::vector<double>& Grid::output_x() const {
+  return m_impl->output_x.empty() ? x() : m_impl->output_x;
+}
+
+//! Y coordinates used in output files.
+const std::vector<double>& Grid::output_y() const {
+  return m_impl->output_y.empty() ? y() : m_impl->output_y;
+}
+
+//! Starting index of this processor's subset in the X direction in output files.
+int Grid::output_xs() const {
+  return xs() + m_impl->output_i_offset;
+}
+
+//! Starting index of this processor's subset in the Y direction in output files.
+int Grid::output_ys() const {
+  return ys() + m_impl->output_j_offset;
+}
+
 //! Global starting index of this processor's subset.
 int Grid::xs() const {
   return m_impl->xs;
@@ -1055,7 +1268,7 @@ InputGridInfo::InputGridInfo(const File &file, const std::string &variable,
                                     variable.c_str());
     }
 
-    auto dimensions = file.dimensions(var.name);
+    auto dimensions = io::uncompressed_dimensions(file, var.name);
 
     bool time_dimension_processed = false;
     for (const auto &dimension_name : dimensions) {
@@ -1118,6 +1331,31 @@ InputGridInfo::InputGridInfo(const File &file, const std::string &variable,
   }
 }
 
+InputGridInfo::InputGridInfo(const Grid &grid, const std::vector<double> &z) {
+  reset();
+
+  filename      = "";
+  variable_name = "";
+
+  // a field in memory has exactly one "record"
+  t_len = 1;
+
+  x  = grid.x();
+  x0 = grid.x0();
+  Lx = grid.Lx();
+
+  y  = grid.y();
+  y0 = grid.y0();
+  Ly = grid.Ly();
+
+  // 2D fields use one level at z = 0; the input grid does not have a Z axis in this case
+  if (z.size() > 1) {
+    this->z     = z;
+    this->z_min = vector_min(z);
+    this->z_max = vector_max(z);
+  }
+}
+
 Parameters::Parameters(const Config &config) {
   Lx = config.get_number("grid.Lx");
   Ly = config.get_number("grid.Ly");
@@ -1371,8 +1609,8 @@ int Grid::pio_io_decomposition(int dof, int output_datatype) const {
       int ndims = dof < 2 ? 2 : 3;
 
       // the last element is not used if ndims == 2
-      std::vector<int> gdimlen{(int)My(), (int)Mx(), dof};
-      std::vector<long int> start{ys(), xs(), 0}, count{ym(), xm(), dof};
+      std::vector<int> gdimlen{(int)output_y().size(), (int)output_x().size(), dof};
+      std::vector<long int> start{output_ys(), output_xs(), 0}, count{ym(), xm(), dof};
 
       int stat = PIOc_InitDecomp_bc(m_impl->ctx->pio_iosys_id(),
                                     output_datatype, ndims, gdimlen.data(),
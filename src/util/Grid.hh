@@ -33,10 +33,15 @@ namespace pism {
 class Config;
 class Context;
 class File;
+class Grid;
 class Logger;
 class MappingInfo;
 class Vars;
 
+namespace array {
+class Array;
+} // end of namespace array
+
 namespace petsc {
 class DM;
 } // end of namespace petsc
@@ -66,6 +71,8 @@ class InputGridInfo {
 public:
   InputGridInfo(const File &file, const std::string &variable,
                 std::shared_ptr<units::System> unit_system, Registration registration);
+  //! Describe a field stored on `grid` using vertical levels `z` (in-memory regridding).
+  InputGridInfo(const Grid &grid, const std::vector<double> &z);
   void report(const Logger &log, int threshold, std::shared_ptr<units::System> s) const;
   // dimension lengths
   unsigned int t_len;
@@ -102,6 +109,8 @@ private:
   void reset();
 };
 
+struct ProcessGrid;
+
 //! Grid parameters; used to collect defaults before an Grid is allocated.
 /* Make sure that all of
    - `horizontal_size_from_options()`
@@ -352,11 +361,26 @@ public:
   unsigned int size() const;
   int rank() const;
 
+  //! MPI communicator. Has the same processes as `ctx()->com()`, possibly in a different
+  //! order (see `grid.process_grid.node_aware`).
   const MPI_Comm com;
 
   Vars& variables();
   const Vars& variables() const;
 
+  void add_state_field(array::Array &field) const;
+  const array::Array* state_field(const std::string &name) const;
+  std::vector<array::Array*> state_fields() const;
+
+  void set_regrid_source(std::shared_ptr<const Grid> source);
+  std::shared_ptr<const Grid> regrid_source() const;
+
+  void set_output_domain(const Grid &domain);
+  const std::vector<double>& output_x() const;
+  const std::vector<double>& output_y() const;
+  int output_xs() const;
+  int output_ys() const;
+
   int pio_io_decomposition(int dof, int output_datatype) const;
 
   PointsWithGhosts points(unsigned int stencil_width = 0) const {
@@ -364,6 +388,9 @@ public:
   }
 
 private:
+  Grid(std::shared_ptr<const Context> context, const grid::Parameters &p,
+       const grid::ProcessGrid &process_grid);
+
   struct Impl;
   Impl *m_impl;
 
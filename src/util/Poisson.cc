@@ -31,7 +31,8 @@ Poisson::Poisson(std::shared_ptr<const Grid> grid)
     m_log(grid->ctx()->log()),
     m_b(grid, "poisson_rhs"),
     m_x(grid, "poisson_x"),
-    m_mask(grid, "poisson_mask") {
+    m_mask(grid, "poisson_mask"),
+    m_tuner(grid, "Poisson", "poisson_") {
 
   m_da = m_x.dm();
   m_mask.set_interpolation_type(NEAREST);
@@ -55,6 +56,11 @@ Poisson::Poisson(std::shared_ptr<const Grid> grid)
     ierr = KSPSetFromOptions(m_KSP);
     PISM_CHK(ierr, "KSPSetFromOptions");
   }
+
+  m_tuner.add_candidate("bjacobi_ilu0", "-ksp_type gmres -pc_type bjacobi -sub_pc_type ilu");
+  m_tuner.add_candidate("asm1_ilu0", "-ksp_type gmres -pc_type asm -pc_asm_overlap 1"
+                        " -sub_pc_type ilu");
+  m_tuner.add_candidate("gamg", "-ksp_type gmres -pc_type gamg");
 }
 
 /*!
@@ -91,8 +97,7 @@ int Poisson::solve(const array::Scalar& mask, const array::Scalar& bc, double rh
   ierr = KSPSetOperators(m_KSP, m_A, m_A);
   PISM_CHK(ierr, "KSPSetOperator");
 
-  ierr = KSPSolve(m_KSP, m_b.vec(), m_x.vec());
-  PISM_CHK(ierr, "KSPSolve");
+  m_tuner.solve(m_KSP, m_b.vec(), m_x.vec());
 
   // Check if diverged
   KSPConvergedReason  reason;
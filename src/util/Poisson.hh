@@ -21,6 +21,7 @@
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/petscwrappers/KSP.hh"
 #include "pism/util/petscwrappers/Mat.hh"
+#include "pism/util/SolverTuner.hh"
 
 namespace pism {
 
@@ -49,6 +50,7 @@ private:
   array::Scalar m_b;
   array::Scalar m_x;
   array::Scalar1 m_mask;
+  SolverTuner m_tuner;
 };
 
 } // end of namespace pism
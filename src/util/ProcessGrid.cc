@@ -0,0 +1,326 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/ProcessGrid.hh"
+
+#include <algorithm>
+#include <map>
+
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/DM.hh"
+
+namespace pism {
+namespace grid {
+
+std::vector<unsigned int> ownership_ranges(unsigned int M, unsigned int N) {
+
+  std::vector<unsigned int> result(N);
+
+  for (unsigned int i = 0; i < N; i++) {
+    result[i] = M / N + static_cast<unsigned int>((M % N) > i);
+  }
+  return result;
+}
+
+HaloSize::HaloSize() : total(0.0), inter_node(0.0) {
+  // empty
+}
+
+ProcessGrid::ProcessGrid() : block_x(0), block_y(0), com(MPI_COMM_NULL) {
+  // empty
+}
+
+/*!
+ * Finds shared memory nodes using `MPI_Comm_split_type()`.
+ *
+ * Nodes are numbered in the order of their lowest ranks, so rank 0 is always the rank 0 on
+ * node 0.
+ */
+Nodes find_nodes(MPI_Comm com) {
+  int rank = 0, size = 0;
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &size);
+
+  MPI_Comm node_comm = MPI_COMM_NULL;
+  int ierr = MPI_Comm_split_type(com, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+  if (ierr != MPI_SUCCESS) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "MPI_Comm_split_type failed");
+  }
+
+  int local_rank = 0;
+  MPI_Comm_rank(node_comm, &local_rank);
+
+  // the lowest rank on a node identifies this node
+  int leader = rank;
+  MPI_Bcast(&leader, 1, MPI_INT, 0, node_comm);
+  MPI_Comm_free(&node_comm);
+
+  Nodes result;
+  std::vector<int> leaders(size);
+  result.local_rank.resize(size);
+
+  MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT, com);
+  MPI_Allgather(&local_rank, 1, MPI_INT, result.local_rank.data(), 1, MPI_INT, com);
+
+  // leaders are in the increasing order because each rank is its own leader or has a
+  // leader with a lower rank
+  std::map<int, int> node_index;
+  for (int r = 0; r < size; ++r) {
+    if (node_index.find(leaders[r]) == node_index.end()) {
+      int n = static_cast<int>(node_index.size());
+      node_index[leaders[r]] = n;
+    }
+  }
+
+  result.node.resize(size);
+  result.size.resize(node_index.size(), 0);
+  for (int r = 0; r < size; ++r) {
+    result.node[r] = node_index[leaders[r]];
+    result.size[result.node[r]] += 1;
+  }
+
+  return result;
+}
+
+/*!
+ * Predicts the halo size of a 2D field distributed using ownership ranges `procs_x` and
+ * `procs_y`, given the node index of each sub-domain (in the row-major order).
+ *
+ * Uses the box stencil and periodic boundaries, matching DMs created by Grid.
+ */
+HaloSize halo_size(const std::vector<unsigned int> &procs_x,
+                   const std::vector<unsigned int> &procs_y,
+                   const std::vector<int> &node,
+                   unsigned int stencil_width) {
+  const int
+    Nx = static_cast<int>(procs_x.size()),
+    Ny = static_cast<int>(procs_y.size());
+  const double w = stencil_width;
+
+  HaloSize result;
+  for (int j = 0; j < Ny; ++j) {
+    for (int i = 0; i < Nx; ++i) {
+      const int p = i + Nx * j;
+
+      for (int dj = -1; dj <= 1; ++dj) {
+        for (int di = -1; di <= 1; ++di) {
+          const int
+            q = (i + di + Nx) % Nx + Nx * ((j + dj + Ny) % Ny);
+
+          if (q == p) {
+            // sub-domain is its own neighbor: no communication
+            continue;
+          }
+
+          const double
+            nx = di == 0 ? procs_x[i] : w,
+            ny = dj == 0 ? procs_y[j] : w,
+            n  = nx * ny;
+
+          result.total += n;
+          if (node[q] != node[p]) {
+            result.inter_node += n;
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/*!
+ * Computes the halo size of a 2D field using the actual distribution of `dm` (ownership
+ * ranges and neighbor ranks reported by PETSc).
+ *
+ * `node` is the node index of each rank in `com`.
+ */
+HaloSize halo_size(const petsc::DM &dm, const std::vector<int> &node, MPI_Comm com) {
+  DMDALocalInfo info;
+  PetscErrorCode ierr = DMDAGetLocalInfo(dm, &info);
+  PISM_CHK(ierr, "DMDAGetLocalInfo");
+
+  const PetscMPIInt *neighbors = nullptr;
+  ierr = DMDAGetNeighbors(dm, &neighbors);
+  PISM_CHK(ierr, "DMDAGetNeighbors");
+
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  // neighbors are stored in the row-major order (x changing fastest); neighbors[4] is self
+  double local[2] = {0.0, 0.0};
+  for (int dj = -1; dj <= 1; ++dj) {
+    for (int di = -1; di <= 1; ++di) {
+      const int q = neighbors[(dj + 1) * 3 + (di + 1)];
+
+      if (q < 0 or q == rank) {
+        continue;
+      }
+
+      const double
+        nx = di == 0 ? info.xm : info.sw,
+        ny = dj == 0 ? info.ym : info.sw,
+        n  = nx * ny;
+
+      local[0] += n;
+      if (node[q] != node[rank]) {
+        local[1] += n;
+      }
+    }
+  }
+
+  double global[2] = {0.0, 0.0};
+  MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_SUM, com);
+
+  HaloSize result;
+  result.total      = global[0];
+  result.inter_node = global[1];
+  return result;
+}
+
+/*!
+ * Chooses the process grid (`Nx` by `Ny`) and the assignment of sub-domains to ranks that
+ * minimizes the cost of a ghost exchange, assuming that sending a value to a different
+ * shared memory node costs `inter_node_cost` times more than sending it within a node.
+ *
+ * If all nodes run the same number of ranks `n`, nodes are assigned compact `bx` by `by`
+ * blocks of sub-domains (`bx * by = n`). Otherwise each node gets a contiguous run of
+ * sub-domains in the row-major order.
+ *
+ * Rank 0 always gets the sub-domain 0.
+ *
+ * Note that the halo size is the same for all fields (it is proportional to the number of
+ * values per grid point), so it is enough to consider a 2D scalar field.
+ *
+ * Does not communicate: `nodes` describes all ranks (see find_nodes()).
+ */
+ProcessGrid choose_process_grid(const Nodes &nodes, unsigned int Mx, unsigned int My,
+                                unsigned int stencil_width, double inter_node_cost) {
+  const int size = static_cast<int>(nodes.node.size());
+
+  const int N_nodes = static_cast<int>(nodes.size.size());
+  const int node_size = nodes.size[0];
+  const bool uniform = std::all_of(nodes.size.begin(), nodes.size.end(),
+                                   [node_size](int s) { return s == node_size; });
+
+  // offset of the first rank of each node in the row-major order
+  std::vector<int> offset(N_nodes, 0);
+  for (int n = 1; n < N_nodes; ++n) {
+    offset[n] = offset[n - 1] + nodes.size[n - 1];
+  }
+
+  ProcessGrid result;
+  double best_cost = 0.0;
+  bool found = false;
+
+  // position of each rank in the row-major order
+  std::vector<int> position(size);
+
+  for (int Nx = 1; Nx <= size; ++Nx) {
+    if (size % Nx != 0) {
+      continue;
+    }
+    const int Ny = size / Nx;
+
+    // note: integer division
+    if (Mx / Nx < 2 or My / Ny < 2) {
+      continue;
+    }
+
+    auto procs_x = ownership_ranges(Mx, Nx);
+    auto procs_y = ownership_ranges(My, Ny);
+
+    // block sizes to try; (0, 0) corresponds to contiguous runs in the row-major order
+    std::vector<std::pair<int, int> > blocks = { { 0, 0 } };
+    if (uniform) {
+      for (int bx = 1; bx <= node_size; ++bx) {
+        const int by = node_size / bx;
+        if (bx * by == node_size and Nx % bx == 0 and Ny % by == 0) {
+          blocks.emplace_back(bx, by);
+        }
+      }
+    }
+
+    for (const auto &b : blocks) {
+      const int bx = b.first, by = b.second;
+
+      for (int r = 0; r < size; ++r) {
+        const int n = nodes.node[r], l = nodes.local_rank[r];
+
+        if (bx == 0) {
+          position[r] = offset[n] + l;
+        } else {
+          const int
+            i = (n % (Nx / bx)) * bx + l % bx,
+            j = (n / (Nx / bx)) * by + l / bx;
+          position[r] = i + Nx * j;
+        }
+      }
+
+      std::vector<int> node(size);
+      for (int r = 0; r < size; ++r) {
+        node[position[r]] = nodes.node[r];
+      }
+
+      auto halo = halo_size(procs_x, procs_y, node, stencil_width);
+      double cost = halo.total + (inter_node_cost - 1.0) * halo.inter_node;
+
+      if (not found or cost < best_cost) {
+        found           = true;
+        best_cost       = cost;
+        result.procs_x  = procs_x;
+        result.procs_y  = procs_y;
+        result.block_x  = bx;
+        result.block_y  = by;
+        result.node     = node;
+        result.halo     = halo;
+        result.position = position;
+      }
+    }
+  }
+
+  if (not found) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "Can't split a %d x %d grid into %d parts", Mx, My, size);
+  }
+
+  return result;
+}
+
+/*!
+ * Chooses the process grid using choose_process_grid() and creates a communicator with
+ * ranks ordered according to the selected assignment of sub-domains to ranks (the caller
+ * has to free it). Rank 0 in the new communicator is rank 0 in `com`.
+ */
+ProcessGrid node_aware_process_grid(MPI_Comm com, unsigned int Mx, unsigned int My,
+                                    unsigned int stencil_width, double inter_node_cost) {
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  auto result = choose_process_grid(find_nodes(com), Mx, My, stencil_width, inter_node_cost);
+
+  int ierr = MPI_Comm_split(com, 0, result.position[rank], &result.com);
+  if (ierr != MPI_SUCCESS) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "MPI_Comm_split failed");
+  }
+
+  return result;
+}
+
+} // end of namespace grid
+} // end of namespace pism
@@ -0,0 +1,108 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_PROCESSGRID_H
+#define PISM_PROCESSGRID_H
+
+#include <vector>
+
+#include <mpi.h>
+
+namespace pism {
+
+namespace petsc {
+class DM;
+} // end of namespace petsc
+
+namespace grid {
+
+//! Computes processor ownership ranges corresponding to equal area distribution among
+//! processors.
+std::vector<unsigned int> ownership_ranges(unsigned int M, unsigned int N);
+
+//! Number of ghost values received during one ghost exchange of a scalar 2D field.
+struct HaloSize {
+  HaloSize();
+
+  //! total, summed over all ranks
+  double total;
+  //! received from ranks running on a different (shared memory) node
+  double inter_node;
+};
+
+//! Assignment of MPI ranks to shared memory nodes.
+struct Nodes {
+  //! node index of each rank
+  std::vector<int> node;
+  //! rank within the node of each rank
+  std::vector<int> local_rank;
+  //! number of ranks on each node
+  std::vector<int> size;
+};
+
+Nodes find_nodes(MPI_Comm com);
+
+//! Process grid and the mapping from MPI ranks to sub-domains.
+/*!
+ * DMDA assigns sub-domains to ranks in the row-major order (x index changing fastest), so
+ * the mapping is defined by the order of ranks in `com`.
+ */
+struct ProcessGrid {
+  ProcessGrid();
+
+  //! Lengths of sub-domains in the x direction.
+  std::vector<unsigned int> procs_x;
+  //! Lengths of sub-domains in the y direction.
+  std::vector<unsigned int> procs_y;
+
+  //! Size of the block of sub-domains assigned to a node (zero if nodes are assigned
+  //! contiguous runs of sub-domains in the row-major order).
+  unsigned int block_x, block_y;
+
+  //! Communicator with ranks re-ordered so that rank `r` gets the sub-domain number `r`.
+  //! MPI_COMM_NULL if the original communicator should be used.
+  MPI_Comm com;
+
+  //! Node index of each sub-domain (in the row-major order).
+  std::vector<int> node;
+
+  //! Sub-domain index (in the row-major order) of each rank in the original communicator.
+  std::vector<int> position;
+
+  //! Predicted halo size.
+  HaloSize halo;
+};
+
+HaloSize halo_size(const std::vector<unsigned int> &procs_x,
+                   const std::vector<unsigned int> &procs_y,
+                   const std::vector<int> &node,
+                   unsigned int stencil_width);
+
+HaloSize halo_size(const petsc::DM &dm, const std::vector<int> &node, MPI_Comm com);
+
+ProcessGrid choose_process_grid(const Nodes &nodes, unsigned int Mx, unsigned int My,
+                                unsigned int stencil_width, double inter_node_cost);
+
+ProcessGrid node_aware_process_grid(MPI_Comm com, unsigned int Mx, unsigned int My,
+                                    unsigned int stencil_width, double inter_node_cost);
+
+} // end of namespace grid
+} // end of namespace pism
+
+#endif /* PISM_PROCESSGRID_H */
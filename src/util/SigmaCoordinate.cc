@@ -0,0 +1,185 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/SigmaCoordinate.hh"
+
+#include <cmath>                // std::fabs
+
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/VariableMetadata.hh"
+#include "pism/util/array/Array3D.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/io/File.hh"
+
+namespace pism {
+
+std::vector<double> sigma_levels(const Config &config) {
+  auto Mz = static_cast<unsigned int>(config.get_number("grid.sigma.Mz"));
+
+  return grid::compute_vertical_levels(1.0, Mz, grid::QUADRATIC,
+                                       config.get_number("grid.sigma.lambda"));
+}
+
+std::shared_ptr<array::Array3D> allocate_sigma_field(std::shared_ptr<const Grid> grid,
+                                                     const std::string &name,
+                                                     bool ghosted) {
+  auto sigma = sigma_levels(*grid->ctx()->config());
+
+  std::shared_ptr<array::Array3D> result;
+  if (ghosted) {
+    result = std::make_shared<array::Array3D>(grid, name, array::WITH_GHOSTS, sigma);
+  } else {
+    result = std::make_shared<array::Array3D>(grid, name, array::WITHOUT_GHOSTS, sigma);
+  }
+
+  auto &z = result->metadata(0).z();
+  z.set_name("sigma").long_name("terrain-following vertical coordinate").units("1");
+  z["positive"] = "up";
+
+  return result;
+}
+
+namespace {
+
+/*!
+ * Linear interpolation of values `y` defined at increasing levels `x` to `x_new`.
+ *
+ * `k` is the index of the level just below `x_new` found during the previous call. It is
+ * updated so that a sweep over increasing `x_new` takes O(N) operations in total.
+ */
+double interpolate(const std::vector<double> &x, const double *y, double x_new,
+                   unsigned int &k) {
+  const unsigned int N = x.size();
+
+  if (x_new <= x[0]) {
+    return y[0];
+  }
+
+  if (x_new >= x[N - 1]) {
+    return y[N - 1];
+  }
+
+  while (k + 2 < N and x[k + 1] <= x_new) {
+    ++k;
+  }
+
+  const double lambda = (x_new - x[k]) / (x[k + 1] - x[k]);
+
+  return y[k] + lambda * (y[k + 1] - y[k]);
+}
+
+} // end of anonymous namespace
+
+/*!
+ * Values above the ice surface are set to the value at the surface.
+ */
+void sigma_to_z(const array::Array3D &input, const array::Scalar &ice_thickness,
+                array::Array3D &result) {
+  const auto &sigma = input.levels();
+  const auto &z     = result.levels();
+
+  {
+    array::AccessScope list{ &input, &ice_thickness, &result };
+
+    auto grid = result.grid();
+    for (auto p = grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double H = ice_thickness(i, j), *column = input.get_column(i, j);
+      double *output = result.get_column(i, j);
+
+      unsigned int m = 0;
+      for (unsigned int k = 0; k < z.size(); ++k) {
+        if (H > 0.0 and z[k] < H) {
+          output[k] = interpolate(sigma, column, z[k] / H, m);
+        } else {
+          output[k] = column[sigma.size() - 1];
+        }
+      }
+    }
+  }
+
+  result.update_ghosts();
+  result.inc_state_counter();
+}
+
+void z_to_sigma(const array::Array3D &input, const array::Scalar &ice_thickness,
+                array::Array3D &result) {
+  const auto &z     = input.levels();
+  const auto &sigma = result.levels();
+
+  {
+    array::AccessScope list{ &input, &ice_thickness, &result };
+
+    auto grid = result.grid();
+    for (auto p = grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double H = ice_thickness(i, j), *column = input.get_column(i, j);
+      double *output = result.get_column(i, j);
+
+      unsigned int m = 0;
+      for (unsigned int k = 0; k < sigma.size(); ++k) {
+        output[k] = interpolate(z, column, H * sigma[k], m);
+      }
+    }
+  }
+
+  result.update_ghosts();
+  result.inc_state_counter();
+}
+
+/*!
+ * Returns true if `result` was read from `file`.
+ *
+ * Returns false if `file` does not contain this field or if it uses different sigma
+ * levels (e.g. `grid.sigma.Mz` was changed). Callers should then interpolate from the
+ * corresponding field in z.
+ */
+bool read_sigma_field(const File &file, unsigned int record, array::Array3D &result) {
+  const auto &metadata = result.metadata(0);
+
+  const auto &dimension_name = metadata.z().get_name();
+
+  if (not file.find_variable(metadata.get_name()) or
+      not file.find_dimension(dimension_name)) {
+    return false;
+  }
+
+  const auto &sigma = result.levels();
+  auto sigma_file   = file.read_dimension(dimension_name);
+
+  if (sigma_file.size() != sigma.size()) {
+    return false;
+  }
+
+  for (unsigned int k = 0; k < sigma.size(); ++k) {
+    if (std::fabs(sigma_file[k] - sigma[k]) > 1e-12) {
+      return false;
+    }
+  }
+
+  result.read(file, record);
+
+  return true;
+}
+
+} // end of namespace pism
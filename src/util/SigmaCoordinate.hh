@@ -0,0 +1,72 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_SIGMACOORDINATE_H
+#define PISM_SIGMACOORDINATE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pism {
+
+class Config;
+class File;
+class Grid;
+
+namespace array {
+class Array3D;
+class Scalar;
+} // end of namespace array
+
+/*!
+ * Terrain-following ("sigma") vertical coordinate @f$ \sigma = z / H @f$, where @f$ z @f$
+ * is the height above the base of the ice and @f$ H @f$ is the ice thickness.
+ *
+ * Energy and age models can store their 3D prognostic fields on `grid.sigma.Mz` sigma
+ * levels (set `grid.sigma.enabled`) instead of the `Mz` levels of the grid. Fields on the
+ * grid (in z) are then computed for consumers (stress balance, output) after each update.
+ *
+ * Fields on sigma levels are saved to output files and used when the model is restarted,
+ * so restarting does not interpolate from z to sigma levels. Note that fields in z are
+ * still allocated (and updated) in addition to the ones on sigma levels.
+ */
+
+//! Sigma levels in [0, 1] set using `grid.sigma.Mz` and `grid.sigma.lambda`.
+std::vector<double> sigma_levels(const Config &config);
+
+//! Allocate a 3D field using sigma levels.
+std::shared_ptr<array::Array3D> allocate_sigma_field(std::shared_ptr<const Grid> grid,
+                                                     const std::string &name,
+                                                     bool ghosted);
+
+//! Interpolate a field on sigma levels to the vertical grid of `result` (in z).
+void sigma_to_z(const array::Array3D &input, const array::Scalar &ice_thickness,
+                array::Array3D &result);
+
+//! Interpolate a field on the vertical grid (in z) to sigma levels of `result`.
+void z_to_sigma(const array::Array3D &input, const array::Scalar &ice_thickness,
+                array::Array3D &result);
+
+//! Read a field on sigma levels if `file` contains it on the same sigma levels.
+bool read_sigma_field(const File &file, unsigned int record, array::Array3D &result);
+
+} // end of namespace pism
+
+#endif /* PISM_SIGMACOORDINATE_H */
@@ -0,0 +1,564 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::find
+#include <cctype>               // isalpha
+#include <cmath>                // std::fabs
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "pism/util/SolverTuner.hh"
+
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/array/CellType.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+
+namespace {
+
+//! Tuning results of all solvers in this process, indexed by solver names. Stored here so
+//! that all solvers can save their results to the same file.
+std::map<std::string, std::string> tuning_results;
+
+} // end of anonymous namespace
+
+SolverTuner::SolverTuner(std::shared_ptr<const Grid> grid, const std::string &name,
+                         const std::string &prefix)
+  : m_grid(grid),
+    m_config(grid->ctx()->config()),
+    m_log(grid->ctx()->log()),
+    m_name(name),
+    m_prefix(prefix),
+    m_tune(false),
+    m_fixed(false),
+    m_selected(-1),
+    m_configure(true),
+    m_tuning(false),
+    m_tuned(false),
+    m_round_solves(0),
+    m_solves(0),
+    m_problem_size(0.0),
+    m_tuned_problem_size(0.0) {
+
+  auto input_file = m_config->get_string("solver_tuning.input_file");
+
+  if (not input_file.empty()) {
+    load(input_file);
+  } else {
+    m_tune = m_config->get_flag("solver_tuning.enabled");
+  }
+}
+
+/*!
+ * Add a candidate configuration `options` (PETSc options without the prefix, separated by
+ * spaces).
+ */
+void SolverTuner::add_candidate(const std::string &name, const std::string &options) {
+  Candidate c;
+  c.name       = name;
+  c.options    = parse(options);
+  c.time       = 0.0;
+  c.iterations = 0;
+  c.failures   = 0;
+
+  for (const auto &option : c.options) {
+    const auto &key = option.first;
+
+    if (std::find(m_option_names.begin(), m_option_names.end(), key) != m_option_names.end()) {
+      continue;
+    }
+    m_option_names.push_back(key);
+
+    // save the current value of this option to be able to restore it if all candidates
+    // fail
+    char value[PETSC_MAX_PATH_LEN] = "";
+    PetscBool flag = PETSC_FALSE;
+    PetscErrorCode ierr = PetscOptionsGetString(NULL, m_prefix.c_str(), ("-" + key).c_str(),
+                                                value, sizeof(value), &flag);
+    PISM_CHK(ierr, "PetscOptionsGetString");
+
+    if (flag == PETSC_TRUE) {
+      m_original_options.push_back({key, value});
+    }
+  }
+
+  m_candidates.push_back(c);
+}
+
+bool SolverTuner::enabled() const {
+  return m_fixed or (m_tune and not m_candidates.empty());
+}
+
+/*!
+ * Set the size of the problem solved next (e.g. the number of icy cells).
+ *
+ * Candidates are re-evaluated if the size changes by more than
+ * `solver_tuning.size_change_threshold`.
+ */
+void SolverTuner::set_problem_size(double size) {
+  m_problem_size = size;
+}
+
+void SolverTuner::solve(KSP ksp, Vec b, Vec x) {
+  auto configure = [ksp]() {
+    PetscErrorCode ierr;
+
+    // Reset the preconditioner to make sure that it is re-built using new options even if
+    // the operator did not change.
+    Mat A, P;
+    ierr = KSPGetOperators(ksp, &A, &P); PISM_CHK(ierr, "KSPGetOperators");
+    ierr = PetscObjectReference((PetscObject)A); PISM_CHK(ierr, "PetscObjectReference");
+    ierr = PetscObjectReference((PetscObject)P); PISM_CHK(ierr, "PetscObjectReference");
+
+    PC pc;
+    ierr = KSPGetPC(ksp, &pc); PISM_CHK(ierr, "KSPGetPC");
+    ierr = PCReset(pc); PISM_CHK(ierr, "PCReset");
+
+    ierr = KSPSetOperators(ksp, A, P); PISM_CHK(ierr, "KSPSetOperators");
+    ierr = MatDestroy(&A); PISM_CHK(ierr, "MatDestroy");
+    ierr = MatDestroy(&P); PISM_CHK(ierr, "MatDestroy");
+
+    ierr = KSPSetFromOptions(ksp); PISM_CHK(ierr, "KSPSetFromOptions");
+  };
+
+  auto solve_once = [ksp, b, x](int &iterations) {
+    PetscErrorCode ierr = KSPSolve(ksp, b, x); PISM_CHK(ierr, "KSPSolve");
+
+    KSPConvergedReason reason;
+    ierr = KSPGetConvergedReason(ksp, &reason); PISM_CHK(ierr, "KSPGetConvergedReason");
+
+    PetscInt its = 0;
+    ierr = KSPGetIterationNumber(ksp, &its); PISM_CHK(ierr, "KSPGetIterationNumber");
+
+    iterations = its;
+    return static_cast<int>(reason);
+  };
+
+  solve(x, configure, solve_once);
+}
+
+void SolverTuner::solve(SNES snes, Vec x) {
+  auto configure = [snes]() {
+    PetscErrorCode ierr;
+
+    // Discard the preconditioner so that options of its sub-solvers (e.g. multigrid
+    // smoothers) are processed again during the next setup.
+    KSP ksp;
+    ierr = SNESGetKSP(snes, &ksp); PISM_CHK(ierr, "SNESGetKSP");
+
+    PC pc;
+    ierr = KSPGetPC(ksp, &pc); PISM_CHK(ierr, "KSPGetPC");
+
+    ierr = PCReset(pc); PISM_CHK(ierr, "PCReset");
+
+    ierr = SNESSetFromOptions(snes); PISM_CHK(ierr, "SNESSetFromOptions");
+  };
+
+  auto solve_once = [snes, x](int &iterations) {
+    PetscErrorCode ierr = SNESSolve(snes, NULL, x); PISM_CHK(ierr, "SNESSolve");
+
+    SNESConvergedReason reason;
+    ierr = SNESGetConvergedReason(snes, &reason); PISM_CHK(ierr, "SNESGetConvergedReason");
+
+    PetscInt its = 0;
+    ierr = SNESGetLinearSolveIterations(snes, &its);
+    PISM_CHK(ierr, "SNESGetLinearSolveIterations");
+
+    iterations = its;
+    return static_cast<int>(reason);
+  };
+
+  solve(x, configure, solve_once);
+}
+
+/*!
+ * Solve using the selected configuration or, during a tuning round, using all candidates.
+ *
+ * `configure` re-configures the solver using the PETSc options database, `solve_once`
+ * solves the system using the current contents of `x` as the initial guess and returns
+ * the converged reason (positive on success) and the number of (linear) iterations.
+ */
+void SolverTuner::solve(Vec x, const std::function<void()> &configure,
+                        const std::function<int(int &)> &solve_once) {
+  int iterations = 0;
+
+  if (not enabled()) {
+    solve_once(iterations);
+    return;
+  }
+
+  if (m_fixed) {
+    if (m_configure) {
+      set_options(m_fixed_options);
+      configure();
+      m_configure = false;
+    }
+    solve_once(iterations);
+    return;
+  }
+
+  if (not m_tuning and tuning_needed()) {
+    m_log->message(2, "* Evaluating %d configurations of the %s solver...\n",
+                   (int)m_candidates.size(), m_name.c_str());
+
+    for (auto &c : m_candidates) {
+      c.time       = 0.0;
+      c.iterations = 0;
+      c.failures   = 0;
+    }
+    m_tuning       = true;
+    m_round_solves = 0;
+  }
+
+  if (not m_tuning) {
+    if (m_configure) {
+      set_options(m_selected >= 0 ? m_candidates[m_selected].options : m_original_options);
+      configure();
+      m_configure = false;
+    }
+    solve_once(iterations);
+    m_solves += 1;
+    return;
+  }
+
+  // Tuning: solve the system using all candidates starting from the same initial guess.
+  petsc::Vec x0;
+  {
+    PetscErrorCode ierr = VecDuplicate(x, x0.rawptr()); PISM_CHK(ierr, "VecDuplicate");
+    ierr = VecCopy(x, x0); PISM_CHK(ierr, "VecCopy");
+  }
+
+  int fastest = -1;
+  double fastest_time = 0.0;
+  const int last = (int)m_candidates.size() - 1;
+  for (int k = 0; k <= last; ++k) {
+    auto &c = m_candidates[k];
+
+    PetscErrorCode ierr = VecCopy(x0, x); PISM_CHK(ierr, "VecCopy");
+
+    set_options(c.options);
+    configure();
+
+    double start = get_time(m_grid->com);
+    int reason = solve_once(iterations);
+    double time = get_time(m_grid->com) - start;
+
+    if (reason > 0) {
+      c.time += time;
+      c.iterations += iterations;
+
+      if (fastest < 0 or time < fastest_time) {
+        fastest      = k;
+        fastest_time = time;
+      }
+    } else {
+      c.failures += 1;
+    }
+
+    m_log->message(3, "  %s: %s: %s in %.3g seconds, %d iterations\n",
+                   m_name.c_str(), c.name.c_str(),
+                   reason > 0 ? "converged" : "failed", time, iterations);
+  }
+
+  m_round_solves += 1;
+  if (m_round_solves >= (int)m_config->get_number("solver_tuning.evaluation_solves")) {
+    select();
+  }
+
+  // Keep the result computed using the selected candidate (at the end of a round) or the
+  // fastest candidate. If all candidates failed, keep the last result: the caller will
+  // handle the failure.
+  int keep = m_tuning ? fastest : m_selected;
+  if (keep >= 0 and keep != last) {
+    PetscErrorCode ierr = VecCopy(x0, x); PISM_CHK(ierr, "VecCopy");
+
+    set_options(m_candidates[keep].options);
+    configure();
+    solve_once(iterations);
+  }
+
+  m_configure = m_tuning or (m_selected < 0) or (keep != m_selected);
+}
+
+//! Returns true if the candidates should be (re-)evaluated.
+bool SolverTuner::tuning_needed() const {
+  if (not m_tuned) {
+    return true;
+  }
+
+  int interval = static_cast<int>(m_config->get_number("solver_tuning.interval"));
+  if (interval > 0 and m_solves >= interval) {
+    return true;
+  }
+
+  double threshold = m_config->get_number("solver_tuning.size_change_threshold");
+  if (m_tuned_problem_size > 0.0 and
+      std::fabs(m_problem_size - m_tuned_problem_size) > threshold * m_tuned_problem_size) {
+    return true;
+  }
+
+  return false;
+}
+
+//! Select the fastest candidate that did not fail during the current tuning round.
+void SolverTuner::select() {
+  m_selected = -1;
+  for (int k = 0; k < (int)m_candidates.size(); ++k) {
+    const auto &c = m_candidates[k];
+    if (c.failures == 0 and (m_selected < 0 or c.time < m_candidates[m_selected].time)) {
+      m_selected = k;
+    }
+  }
+
+  m_tuning             = false;
+  m_tuned              = true;
+  m_solves             = 0;
+  m_tuned_problem_size = m_problem_size;
+
+  for (const auto &c : m_candidates) {
+    m_log->message(2, "  %-20s mean time %.3g seconds, mean iterations %.1f, failures %d\n",
+                   c.name.c_str(), c.time / m_round_solves,
+                   (double)c.iterations / m_round_solves, c.failures);
+  }
+
+  if (m_selected >= 0) {
+    m_log->message(2, "  %s solver: selected '%s' (%s)\n", m_name.c_str(),
+                   m_candidates[m_selected].name.c_str(),
+                   options_string(m_candidates[m_selected].options).c_str());
+  } else {
+    m_log->message(2, "PISM WARNING: all configurations of the %s solver failed;"
+                   " using default options\n", m_name.c_str());
+  }
+
+  save();
+}
+
+//! Parse PETSc options (`-name value` or `-name`) separated by spaces.
+SolverTuner::Options SolverTuner::parse(const std::string &options) const {
+  std::istringstream input(options);
+  std::vector<std::string> tokens;
+  std::string token;
+  while (input >> token) {
+    tokens.push_back(token);
+  }
+
+  // Returns true if `word` is an option name (as opposed to a negative number).
+  auto is_option = [](const std::string &word) {
+    return word.size() > 1 and word[0] == '-' and isalpha(word[1]) != 0;
+  };
+
+  Options result;
+  for (size_t k = 0; k < tokens.size(); ++k) {
+    if (not is_option(tokens[k])) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "invalid PETSc options for the %s solver: '%s'",
+                                    m_name.c_str(), options.c_str());
+    }
+
+    std::string key = tokens[k].substr(1), value;
+    if (k + 1 < tokens.size() and not is_option(tokens[k + 1])) {
+      value = tokens[k + 1];
+      ++k;
+    }
+
+    result.push_back({key, value});
+  }
+  return result;
+}
+
+/*!
+ * Clear all options used by candidates and set `options` in the PETSc options database.
+ */
+void SolverTuner::set_options(const Options &options) const {
+  PetscErrorCode ierr;
+
+  for (const auto &key : m_option_names) {
+    ierr = PetscOptionsClearValue(NULL, ("-" + m_prefix + key).c_str());
+    PISM_CHK(ierr, "PetscOptionsClearValue");
+  }
+
+  for (const auto &option : options) {
+    const auto &value = option.second;
+
+    ierr = PetscOptionsSetValue(NULL, ("-" + m_prefix + option.first).c_str(),
+                                value.empty() ? NULL : value.c_str());
+    PISM_CHK(ierr, "PetscOptionsSetValue");
+  }
+}
+
+//! Options (including the prefix) as a string that can be used on the command line.
+std::string SolverTuner::options_string(const Options &options) const {
+  std::vector<std::string> result;
+  for (const auto &option : options) {
+    result.push_back("-" + m_prefix + option.first);
+    if (not option.second.empty()) {
+      result.push_back(option.second);
+    }
+  }
+  return join(result, " ");
+}
+
+/*!
+ * Save tuning results of this solver to `solver_tuning.output_file` (in JSON format).
+ *
+ * The file contains results of all solvers in this process. It can be used as
+ * `solver_tuning.input_file` in later runs.
+ */
+void SolverTuner::save() const {
+  auto filename = m_config->get_string("solver_tuning.output_file");
+  if (filename.empty()) {
+    return;
+  }
+
+  {
+    std::vector<std::string> candidates;
+    for (const auto &c : m_candidates) {
+      candidates.push_back(pism::printf("      {\"name\": \"%s\", \"options\": \"%s\","
+                                        " \"mean_time\": %g, \"mean_iterations\": %g,"
+                                        " \"failures\": %d}",
+                                        c.name.c_str(), options_string(c.options).c_str(),
+                                        c.time / m_round_solves,
+                                        (double)c.iterations / m_round_solves,
+                                        c.failures));
+    }
+
+    std::string selected = "null", options;
+    if (m_selected >= 0) {
+      selected = "\"" + m_candidates[m_selected].name + "\"";
+      options  = options_string(m_candidates[m_selected].options);
+    }
+
+    tuning_results[m_name] =
+      pism::printf("  \"%s\": {\n"
+                   "    \"selected\": %s,\n"
+                   "    \"options\": \"%s\",\n"
+                   "    \"problem_size\": %g,\n"
+                   "    \"candidates\": [\n%s\n    ]\n"
+                   "  }",
+                   m_name.c_str(), selected.c_str(), options.c_str(), m_problem_size,
+                   join(candidates, ",\n").c_str());
+  }
+
+  int rank = 0;
+  MPI_Comm_rank(m_grid->com, &rank);
+
+  ParallelSection rank0(m_grid->com);
+  try {
+    if (rank == 0) {
+      std::vector<std::string> entries;
+      for (const auto &r : tuning_results) {
+        entries.push_back(r.second);
+      }
+
+      std::ofstream file(filename);
+      file << "{\n" << join(entries, ",\n") << "\n}\n";
+
+      if (not file.good()) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to write to '%s'",
+                                      filename.c_str());
+      }
+    }
+  } catch (...) {
+    rank0.failed();
+  }
+  rank0.check();
+}
+
+/*!
+ * Read the configuration of this solver from a file written by save().
+ */
+void SolverTuner::load(const std::string &filename) {
+  std::ifstream file(filename);
+  if (not file.good()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to open '%s'",
+                                  filename.c_str());
+  }
+
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string text = buffer.str();
+
+  // find the entry for this solver and the "options" key in it
+  std::string options;
+  bool found = false;
+  {
+    auto start = text.find("\"" + m_name + "\": {");
+    if (start != std::string::npos) {
+      const std::string key = "\"options\": \"";
+      auto k = text.find(key, start);
+      if (k != std::string::npos) {
+        k += key.size();
+        auto end = text.find('"', k);
+        if (end != std::string::npos) {
+          options = text.substr(k, end - k);
+          found   = true;
+        }
+      }
+    }
+  }
+
+  if (not found or options.empty()) {
+    m_log->message(2, "  %s solver: no configuration in '%s'; using default options\n",
+                   m_name.c_str(), filename.c_str());
+    return;
+  }
+
+  // strip the prefix
+  for (auto &option : parse(options)) {
+    const std::string prefix = m_prefix;
+    if (option.first.compare(0, prefix.size(), prefix) != 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "option '-%s' in '%s' does not use the prefix '%s'",
+                                    option.first.c_str(), filename.c_str(), prefix.c_str());
+    }
+    option.first = option.first.substr(prefix.size());
+
+    m_fixed_options.push_back(option);
+    m_option_names.push_back(option.first);
+  }
+
+  m_fixed = true;
+
+  m_log->message(2, "  %s solver: using '%s' from '%s'\n", m_name.c_str(), options.c_str(),
+                 filename.c_str());
+}
+
+double icy_cell_count(const array::CellType &cell_type) {
+  auto grid = cell_type.grid();
+
+  array::AccessScope list{&cell_type};
+
+  int result = 0;
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (cell_type.icy(i, j)) {
+      result += 1;
+    }
+  }
+
+  return GlobalSum(grid->com, result);
+}
+
+} // end of namespace pism
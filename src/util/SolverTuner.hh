@@ -0,0 +1,141 @@
+/* Copyright (C) 2023 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_SOLVERTUNER_H
+#define PISM_SOLVERTUNER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <petscsnes.h>
+
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Logger.hh"
+
+namespace pism {
+
+class Grid;
+
+namespace array {
+class CellType;
+}
+
+//! Selects the fastest configuration of a PETSc solver by trying candidate configurations
+//! on systems solved during a run.
+/*!
+ * Each candidate is a set of PETSc options (without the options prefix of the solver),
+ * for example `-ksp_type gmres -pc_type asm -pc_asm_overlap 1 -sub_pc_type ilu`.
+ *
+ * During a tuning round (the first `solver_tuning.evaluation_solves` solves of a run)
+ * each system is solved using all candidates, starting from the same initial guess. The
+ * fastest candidate that succeeded in all solves of the round is selected; then the
+ * system is solved again using the selected candidate (unless it was the last one tried)
+ * so that the state of the solver corresponds to the selected configuration.
+ *
+ * Tuning rounds are repeated every `solver_tuning.interval` solves and when the size of
+ * the problem (see set_problem_size()) changes by more than
+ * `solver_tuning.size_change_threshold`.
+ *
+ * Selected options are set in the PETSc options database, so they override command-line
+ * options with the same names.
+ */
+class SolverTuner {
+public:
+  SolverTuner(std::shared_ptr<const Grid> grid, const std::string &name,
+              const std::string &prefix);
+
+  void add_candidate(const std::string &name, const std::string &options);
+
+  //! True if tuning is enabled or a configuration was read from `solver_tuning.input_file`.
+  bool enabled() const;
+
+  void set_problem_size(double size);
+
+  void solve(KSP ksp, Vec b, Vec x);
+  void solve(SNES snes, Vec x);
+
+private:
+  typedef std::vector<std::pair<std::string, std::string> > Options;
+
+  struct Candidate {
+    std::string name;
+    Options options;
+    //! total time and number of iterations during the current tuning round
+    double time;
+    int iterations;
+    //! number of failed solves during the current tuning round
+    int failures;
+  };
+
+  void solve(Vec x, const std::function<void()> &configure,
+             const std::function<int(int &)> &solve_once);
+
+  bool tuning_needed() const;
+  void select();
+  Options parse(const std::string &options) const;
+  void set_options(const Options &options) const;
+  std::string options_string(const Options &options) const;
+  void save() const;
+  void load(const std::string &filename);
+
+  std::shared_ptr<const Grid> m_grid;
+  Config::ConstPtr m_config;
+  Logger::ConstPtr m_log;
+
+  std::string m_name, m_prefix;
+
+  std::vector<Candidate> m_candidates;
+  //! names of all options used by at least one candidate
+  std::vector<std::string> m_option_names;
+
+  //! values of options used by candidates before tuning started (e.g. set using
+  //! command-line options)
+  Options m_original_options;
+
+  //! true if tuning is enabled
+  bool m_tune;
+  //! true if a fixed configuration was read from a file
+  bool m_fixed;
+  Options m_fixed_options;
+
+  //! index of the selected candidate or -1
+  int m_selected;
+  //! true if the solver has to be re-configured before the next solve
+  bool m_configure;
+  //! true during a tuning round
+  bool m_tuning;
+  //! true after the first tuning round
+  bool m_tuned;
+  //! number of solves in the current tuning round
+  int m_round_solves;
+  //! number of solves since the end of the last tuning round
+  int m_solves;
+
+  double m_problem_size, m_tuned_problem_size;
+};
+
+//! Number of icy cells (used as the size of a stress balance problem).
+double icy_cell_count(const array::CellType &cell_type);
+
+} // end of namespace pism
+
+#endif /* PISM_SOLVERTUNER_H */
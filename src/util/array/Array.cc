@@ -20,6 +20,7 @@
 
 #include <cmath>
 #include <cstddef>
+#include <memory>
 #include <petscdraw.h>
 #include <string>
 
@@ -34,6 +35,7 @@
 #include "pism/util/io/io_helpers.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/petscwrappers/IS.hh"
 #include "pism/util/petscwrappers/VecScatter.hh"
 #include "pism/util/petscwrappers/Viewer.hh"
 #include "pism/util/Context.hh"
@@ -73,6 +75,9 @@ Array::Array(std::shared_ptr<const Grid> grid,
 
   const auto &config = grid->ctx()->config();
 
+  m_impl->skip_redundant_exchanges = config->get_flag("grid.ghost_exchanges.skip");
+  m_impl->check_skipped_exchanges  = config->get_flag("grid.ghost_exchanges.check");
+
   auto max_stencil_width = static_cast<size_t>(config->get_number("grid.max_stencil_width"));
   if ((dof != 1) or (stencil_width > max_stencil_width)) {
     // use the requested stencil width *if* we have to
@@ -125,7 +130,7 @@ Array::~Array() {
  *
  * See also inc_state_counter().
  */
-int Array::state_counter() const {
+uint64_t Array::state_counter() const {
   return m_impl->state_counter;
 }
 
@@ -195,11 +200,11 @@ std::array<double,2> Array::range() const {
   PetscErrorCode ierr;
 
   double min{0.0};
-  ierr = VecMin(vec(), NULL, &min);
+  ierr = VecMin(petsc_vec(), NULL, &min);
   PISM_CHK(ierr, "VecMin");
 
   double max{0.0};
-  ierr = VecMax(vec(), NULL, &max);
+  ierr = VecMax(petsc_vec(), NULL, &max);
   PISM_CHK(ierr, "VecMax");
 
   if (m_impl->ghosted) {
@@ -235,7 +240,7 @@ static NormType int_to_normtype(int input) {
 void Array::add(double alpha, const Array &x) {
   checkCompatibility("add", x);
 
-  PetscErrorCode ierr = VecAXPY(vec(), alpha, x.vec());
+  PetscErrorCode ierr = VecAXPY(petsc_vec(), alpha, x.petsc_vec());
   PISM_CHK(ierr, "VecAXPY");
 
   inc_state_counter();          // mark as modified
@@ -243,7 +248,7 @@ void Array::add(double alpha, const Array &x) {
 
 //! Result: v[j] <- v[j] + alpha for all j. Calls VecShift.
 void Array::shift(double alpha) {
-  PetscErrorCode ierr = VecShift(vec(), alpha);
+  PetscErrorCode ierr = VecShift(petsc_vec(), alpha);
   PISM_CHK(ierr, "VecShift");
 
   inc_state_counter();          // mark as modified
@@ -251,7 +256,7 @@ void Array::shift(double alpha) {
 
 //! Result: v <- v * alpha. Calls VecScale.
 void Array::scale(double alpha) {
-  PetscErrorCode ierr = VecScale(vec(), alpha);
+  PetscErrorCode ierr = VecScale(petsc_vec(), alpha);
   PISM_CHK(ierr, "VecScale");
 
   inc_state_counter(); // mark as modified
@@ -280,7 +285,7 @@ void Array::get_dof(std::shared_ptr<petsc::DM> da_result, petsc::Vec &result, un
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid argument (start); got %d", start);
   }
 
-  petsc::DMDAVecArrayDOF tmp_res(da_result, result), tmp_v(dm(), vec());
+  petsc::DMDAVecArrayDOF tmp_res(da_result, result), tmp_v(dm(), petsc_vec());
 
   double ***result_a = static_cast<double ***>(tmp_res.get()),
          ***source_a = static_cast<double ***>(tmp_v.get());
@@ -305,7 +310,7 @@ void Array::set_dof(std::shared_ptr<petsc::DM> da_source, petsc::Vec &source, un
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid argument (start); got %d", start);
   }
 
-  petsc::DMDAVecArrayDOF tmp_src(da_source, source), tmp_v(dm(), vec());
+  petsc::DMDAVecArrayDOF tmp_src(da_source, source), tmp_v(dm(), petsc_vec());
 
   double ***source_a = static_cast<double ***>(tmp_src.get()),
          ***result_a = static_cast<double ***>(tmp_v.get());
@@ -336,7 +341,18 @@ unsigned int Array::stencil_width() const {
   return 0;
 }
 
+/*!
+ * Returns the PETSc Vec storing values of this Array.
+ *
+ * Increments the state counter because the caller may use the Vec to modify stored values.
+ */
 petsc::Vec &Array::vec() const {
+  m_impl->state_counter++;
+  return petsc_vec();
+}
+
+//! Returns the PETSc Vec storing values of this Array. Does not increment the state counter.
+petsc::Vec &Array::petsc_vec() const {
   if (m_impl->v.get() == nullptr) {
     PetscErrorCode ierr = 0;
     if (m_impl->ghosted) {
@@ -503,9 +519,10 @@ void Array::read_impl(const File &file, const unsigned int time) {
       petsc::VecArray tmp_array(tmp);
       io::read_spatial_variable(metadata(0), *grid(), file, time, tmp_array.get());
 
-      global_to_local(*dm(), tmp, vec());
+      global_to_local(*dm(), tmp, petsc_vec());
+      m_impl->ghosts_updated();
     } else {
-      petsc::VecArray v_array(vec());
+      petsc::VecArray v_array(petsc_vec());
       io::read_spatial_variable(metadata(0), *grid(), file, time, v_array.get());
     }
     return;
@@ -579,7 +596,7 @@ void Array::write_impl(const File &file) const {
 
       io::write_spatial_variable(metadata(0), *grid(), file, tmp_array.get());
     } else {
-      petsc::VecArray v_array(vec());
+      petsc::VecArray v_array(petsc_vec());
       io::write_spatial_variable(metadata(0), *grid(), file, v_array.get());
     }
     return;
@@ -630,10 +647,10 @@ void Array::checkCompatibility(const char* func, const Array &other) const {
                                   func);
   }
 
-  ierr = VecGetSize(vec(), &X_size);
+  ierr = VecGetSize(petsc_vec(), &X_size);
   PISM_CHK(ierr, "VecGetSize");
 
-  ierr = VecGetSize(other.vec(), &Y_size);
+  ierr = VecGetSize(other.petsc_vec(), &Y_size);
   PISM_CHK(ierr, "VecGetSize");
 
   if (X_size != Y_size) {
@@ -642,8 +659,39 @@ void Array::checkCompatibility(const char* func, const Array &other) const {
   }
 }
 
+//! Begins access that may modify stored values. Increments the state counter.
+/*!
+ * Use begin_read_access() (or AccessScope with a const pointer) if stored values are not
+ * modified.
+ */
+void Array::begin_access() const {
+  begin_access_impl();
+
+  m_impl->write_access_counter++;
+  m_impl->state_counter++;
+}
+
+void Array::end_access() const {
+  if (m_impl->write_access_counter <= 0) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "Array::end_access(): no matching begin_access() call");
+  }
+  m_impl->write_access_counter--;
+
+  end_access_impl();
+}
+
+//! Begins access that does not modify stored values.
+void Array::begin_read_access() const {
+  begin_access_impl();
+}
+
+void Array::end_read_access() const {
+  end_access_impl();
+}
+
 //! Checks if an Array is allocated and calls DAVecGetArray.
-void  Array::begin_access() const {
+void Array::begin_access_impl() const {
 
   if (m_impl->access_counter < 0) {
     throw RuntimeError(PISM_ERROR_LOCATION, "Array::begin_access(): m_access_counter < 0");
@@ -652,10 +700,10 @@ void  Array::begin_access() const {
   if (m_impl->access_counter == 0) {
     PetscErrorCode ierr;
     if (m_impl->begin_access_use_dof) {
-      ierr = DMDAVecGetArrayDOF(*dm(), vec(), &m_array);
+      ierr = DMDAVecGetArrayDOF(*dm(), petsc_vec(), &m_array);
       PISM_CHK(ierr, "DMDAVecGetArrayDOF");
     } else {
-      ierr = DMDAVecGetArray(*dm(), vec(), &m_array);
+      ierr = DMDAVecGetArray(*dm(), petsc_vec(), &m_array);
       PISM_CHK(ierr, "DMDAVecGetArray");
     }
   }
@@ -664,7 +712,7 @@ void  Array::begin_access() const {
 }
 
 //! Checks if an Array is allocated and calls DAVecRestoreArray.
-void  Array::end_access() const {
+void Array::end_access_impl() const {
   PetscErrorCode ierr;
 
   if (m_array == NULL) {
@@ -679,36 +727,101 @@ void  Array::end_access() const {
   m_impl->access_counter--;
   if (m_impl->access_counter == 0) {
     if (m_impl->begin_access_use_dof) {
-      ierr = DMDAVecRestoreArrayDOF(*dm(), vec(), &m_array);
+      ierr = DMDAVecRestoreArrayDOF(*dm(), petsc_vec(), &m_array);
       PISM_CHK(ierr, "DMDAVecRestoreArrayDOF");
     } else {
-      ierr = DMDAVecRestoreArray(*dm(), vec(), &m_array);
+      ierr = DMDAVecRestoreArray(*dm(), petsc_vec(), &m_array);
       PISM_CHK(ierr, "DMDAVecRestoreArray");
     }
     m_array = NULL;
   }
 }
 
+static GhostExchangeCounts ghost_exchanges = {0, 0};
+
+GhostExchangeCounts ghost_exchange_counts() {
+  return ghost_exchanges;
+}
+
 //! Updates ghost points.
-void  Array::update_ghosts() {
+/*!
+ * If `grid.ghost_exchanges.skip` is set, does nothing if ghosts are up to date on all
+ * processes, i.e. if the state counter did not change since the last ghost update.
+ *
+ * Note that ghosts are never considered up to date while an access that may modify
+ * stored values is in progress.
+ *
+ * The decision to skip an exchange is collective (one MPI_Allreduce per call): a process
+ * that modified this Array has to take part in the exchange even if others did not.
+ * Set `grid.ghost_exchanges.check` to check that skipped exchanges would not change
+ * ghost values.
+ */
+void Array::update_ghosts() {
   PetscErrorCode ierr;
   if (not m_impl->ghosted) {
     return;
   }
 
-  ierr = DMLocalToLocalBegin(*dm(), vec(), INSERT_VALUES, vec());
+  MPI_Comm com = m_impl->grid->com;
+
+  bool up_to_date = false;
+  if (m_impl->skip_redundant_exchanges) {
+    bool local = (m_impl->write_access_counter == 0 and
+                  m_impl->ghosts_state == m_impl->state_counter);
+
+    up_to_date = GlobalMin(com, local ? 1.0 : 0.0) > 0.5;
+  }
+
+  if (m_impl->check_skipped_exchanges and up_to_date) {
+    petsc::Vec copy;
+    ierr = VecDuplicate(petsc_vec(), copy.rawptr());
+    PISM_CHK(ierr, "VecDuplicate");
+
+    ierr = VecCopy(petsc_vec(), copy);
+    PISM_CHK(ierr, "VecCopy");
+
+    ierr = DMLocalToLocalBegin(*dm(), petsc_vec(), INSERT_VALUES, copy);
+    PISM_CHK(ierr, "DMLocalToLocalBegin");
+
+    ierr = DMLocalToLocalEnd(*dm(), petsc_vec(), INSERT_VALUES, copy);
+    PISM_CHK(ierr, "DMLocalToLocalEnd");
+
+    PetscBool equal = PETSC_FALSE;
+    ierr = VecEqual(petsc_vec(), copy, &equal);
+    PISM_CHK(ierr, "VecEqual");
+
+    if (GlobalMin(com, equal == PETSC_TRUE ? 1.0 : 0.0) < 1.0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "ghosts of '%s' are out of date, but the state counter "
+                                    "did not change since the last ghost update",
+                                    m_impl->name.c_str());
+    }
+  }
+
+  if (up_to_date) {
+    ghost_exchanges.skipped++;
+    return;
+  }
+
+  ierr = DMLocalToLocalBegin(*dm(), petsc_vec(), INSERT_VALUES, petsc_vec());
   PISM_CHK(ierr, "DMLocalToLocalBegin");
 
-  ierr = DMLocalToLocalEnd(*dm(), vec(), INSERT_VALUES, vec());
+  ierr = DMLocalToLocalEnd(*dm(), petsc_vec(), INSERT_VALUES, petsc_vec());
   PISM_CHK(ierr, "DMLocalToLocalEnd");
+
+  ghost_exchanges.performed++;
+  m_impl->ghosts_updated();
 }
 
 //! Result: v[j] <- c for all j.
-void  Array::set(const double c) {
-  PetscErrorCode ierr = VecSet(vec(),c);
+void Array::set(const double c) {
+  inc_state_counter();          // mark as modified
+
+  PetscErrorCode ierr = VecSet(petsc_vec(), c);
   PISM_CHK(ierr, "VecSet");
 
-  inc_state_counter();          // mark as modified
+  // VecSet() sets ghosts as well
+  m_impl->ghosts_updated();
 }
 
 void Array::check_array_indices(int i, int j, unsigned int k) const {
@@ -749,10 +862,10 @@ std::vector<double> Array::norm(int n) const {
   NormType type = int_to_normtype(n);
 
   if (m_impl->dof > 1) {
-    PetscErrorCode ierr = VecStrideNormAll(vec(), type, result.data());
+    PetscErrorCode ierr = VecStrideNormAll(petsc_vec(), type, result.data());
     PISM_CHK(ierr, "VecStrideNormAll");
   } else {
-    PetscErrorCode ierr = VecNorm(vec(), type, result.data());
+    PetscErrorCode ierr = VecNorm(petsc_vec(), type, result.data());
     PISM_CHK(ierr, "VecNorm");
   }
 
@@ -847,8 +960,8 @@ void Array::regrid(const File &file, io::Default default_value) {
   double start_time = get_time(m_impl->grid->com);
   m_impl->grid->ctx()->profiling().begin("io.regridding");
   try {
-    this->regrid_impl(file, default_value);
     inc_state_counter();          // mark as modified
+    this->regrid_impl(file, default_value);
   } catch (RuntimeError &e) {
     e.add_context("regridding '%s' from '%s'",
                   this->get_name().c_str(), file.filename().c_str());
@@ -866,9 +979,293 @@ void Array::regrid(const File &file, io::Default default_value) {
   }
 }
 
+/*!
+ * Interpolate a field defined on a different grid (covering the same or a larger domain)
+ * onto the grid used by this Array, without using a file.
+ *
+ * This uses the same bi-(tri-)linear interpolation code as regrid() reading from a file.
+ * Each process gets the part of `source` covering its subdomain (plus the surrounding
+ * grid points needed for interpolation) using one scatter.
+ *
+ * If grid points of `source` coincide with grid points of this field (a cropped or an
+ * expanded domain, see `grid.cropping.enabled`), values are copied instead and the
+ * domains may differ: values at points outside the domain of `source` are not modified.
+ *
+ * Collective on the communicator of grid(); `source` has to use the same communicator.
+ */
+void Array::regrid(const Array &source) {
+  m_impl->grid->ctx()->log()->message(3, "  [%s] Regridding %s (in memory)...\n",
+                                      timestamp(m_impl->grid->com).c_str(), m_impl->name.c_str());
+  m_impl->grid->ctx()->profiling().begin("io.regridding");
+  try {
+    inc_state_counter();          // mark as modified
+    this->regrid_in_memory_impl(source);
+  } catch (RuntimeError &e) {
+    e.add_context("regridding '%s' from '%s' in memory",
+                  this->get_name().c_str(), source.get_name().c_str());
+    throw;
+  }
+  m_impl->grid->ctx()->profiling().end("io.regridding");
+}
+
+void Array::regrid_in_memory_impl(const Array &source) {
+  PetscErrorCode ierr = 0;
+
+  const auto &source_grid = *source.grid();
+
+  if (source.ndof() != ndof()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "incompatible number of degrees of freedom: %d != %d",
+                                  (int)source.ndof(), (int)ndof());
+  }
+
+  if ((source.levels().size() > 1) != (levels().size() > 1)) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "cannot regrid between 2D and 3D fields");
+  }
+
+  {
+    int comparison = 0;
+    MPI_Comm_compare(source_grid.com, m_impl->grid->com, &comparison);
+    if (comparison != MPI_IDENT and comparison != MPI_CONGRUENT) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "the source field has to use the same communicator");
+    }
+  }
+
+  const bool three_d = levels().size() > 1;
+
+  {
+    int di = 0, dj = 0;
+    if (aligned(source, di, dj)) {
+      copy_overlap(source, di, dj);
+      return;
+    }
+  }
+
+  grid::InputGridInfo input_grid(source_grid, source.levels());
+
+  io::check_input_grid(input_grid, *grid(), three_d ? levels() : std::vector<double>{0.0});
+
+  std::shared_ptr<LocalInterpCtx> lic;
+  if (three_d) {
+    lic = std::make_shared<LocalInterpCtx>(input_grid, *grid(), levels(),
+                                           m_impl->interpolation_type);
+  } else {
+    lic = std::make_shared<LocalInterpCtx>(input_grid, *grid(), m_impl->interpolation_type);
+  }
+
+  // Number of values per grid point in the source storage: components of 2D fields and
+  // levels of 3D fields are both stored as "degrees of freedom" of the DMDA.
+  const int block_size = std::max((int)source.ndof(), (int)source.levels().size());
+
+  const int
+    x_start = lic->start[X_AXIS],
+    x_count = lic->count[X_AXIS],
+    y_start = lic->start[Y_AXIS],
+    y_count = lic->count[Y_AXIS],
+    N       = x_count * y_count;
+
+  // get the window of the source field needed by this process, using the layout expected by
+  // io::regrid()
+  std::vector<double> buffer;
+  {
+    std::vector<int> indices(N);
+    for (int y = 0; y < y_count; ++y) {
+      for (int x = 0; x < x_count; ++x) {
+        indices[y * x_count + x] = (y_start + y) * (int)source_grid.Mx() + (x_start + x);
+      }
+    }
+
+    gather(source, indices, buffer);
+  }
+
+  if (three_d) {
+    petsc::TemporaryGlobalVec tmp(dm());
+    {
+      petsc::VecArray tmp_array(tmp);
+      io::regrid(*grid(), *lic, buffer.data(), tmp_array.get());
+    }
+
+    if (m_impl->ghosted) {
+      global_to_local(*dm(), tmp, petsc_vec());
+    } else {
+      ierr = VecCopy(tmp, petsc_vec());
+      PISM_CHK(ierr, "VecCopy");
+    }
+  } else {
+    auto da2 = grid()->get_dm(1, 0);
+    petsc::TemporaryGlobalVec tmp(da2);
+
+    std::vector<double> component(N);
+    for (unsigned int j = 0; j < ndof(); ++j) {
+      for (int n = 0; n < N; ++n) {
+        component[n] = buffer[n * block_size + j];
+      }
+
+      {
+        petsc::VecArray tmp_array(tmp);
+        io::regrid(*grid(), *lic, component.data(), tmp_array.get());
+      }
+
+      set_dof(da2, tmp, j);
+    }
+
+    if (m_impl->ghosted) {
+      update_ghosts();
+    }
+  }
+}
+
+/*!
+ * Get values of `source` at grid points with (block) indices `indices` in the natural
+ * ordering. Each process gets its values using one scatter.
+ *
+ * Values of all components (2D fields) or levels (3D fields) at a grid point are stored
+ * contiguously in `result`.
+ */
+void Array::gather(const Array &source, const std::vector<int> &indices,
+                   std::vector<double> &result) {
+  PetscErrorCode ierr = 0;
+
+  // Number of values per grid point in the source storage: components of 2D fields and
+  // levels of 3D fields are both stored as "degrees of freedom" of the DMDA.
+  const int block_size = std::max((int)source.ndof(), (int)source.levels().size());
+  const int N          = (int)indices.size();
+
+  result.resize(N * block_size);
+
+  petsc::Vec natural;
+  ierr = DMDACreateNaturalVector(*source.dm(), natural.rawptr());
+  PISM_CHK(ierr, "DMDACreateNaturalVector");
+
+  {
+    petsc::TemporaryGlobalVec global(source.dm());
+    source.copy_to_vec(source.dm(), global);
+
+    ierr = DMDAGlobalToNaturalBegin(*source.dm(), global, INSERT_VALUES, natural);
+    PISM_CHK(ierr, "DMDAGlobalToNaturalBegin");
+
+    ierr = DMDAGlobalToNaturalEnd(*source.dm(), global, INSERT_VALUES, natural);
+    PISM_CHK(ierr, "DMDAGlobalToNaturalEnd");
+  }
+
+  std::vector<PetscInt> block_indices(indices.begin(), indices.end());
+
+  petsc::IS is;
+  ierr = ISCreateBlock(PETSC_COMM_SELF, block_size, N, block_indices.data(), PETSC_COPY_VALUES,
+                       is.rawptr());
+  PISM_CHK(ierr, "ISCreateBlock");
+
+  petsc::Vec window;
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF, 1, N * block_size, result.data(),
+                               window.rawptr());
+  PISM_CHK(ierr, "VecCreateSeqWithArray");
+
+  petsc::VecScatter scatter;
+  ierr = VecScatterCreate(natural, is, window, NULL, scatter.rawptr());
+  PISM_CHK(ierr, "VecScatterCreate");
+
+  ierr = VecScatterBegin(scatter, natural, window, INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterBegin");
+
+  ierr = VecScatterEnd(scatter, natural, window, INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterEnd");
+}
+
+/*!
+ * Returns true if grid points of `source` coincide with grid points of this field (same
+ * grid spacing and vertical levels, possibly different domains).
+ *
+ * Sets `di` and `dj` to the offset of the first grid point of this field in the source
+ * grid.
+ */
+bool Array::aligned(const Array &source, int &di, int &dj) const {
+  const auto &source_grid = *source.grid();
+  const auto &target_grid = *grid();
+
+  const double
+    dx = target_grid.dx(),
+    dy = target_grid.dy(),
+    eps = 1e-6;
+
+  if (std::abs(source_grid.dx() - dx) > eps * dx or
+      std::abs(source_grid.dy() - dy) > eps * dy or
+      source.levels() != levels()) {
+    return false;
+  }
+
+  const double
+    x_offset = (target_grid.x(0) - source_grid.x(0)) / dx,
+    y_offset = (target_grid.y(0) - source_grid.y(0)) / dy;
+
+  di = static_cast<int>(std::round(x_offset));
+  dj = static_cast<int>(std::round(y_offset));
+
+  return std::abs(x_offset - di) < eps and std::abs(y_offset - dj) < eps;
+}
+
+/*!
+ * Copy values of `source` at grid points shared with this field. Values at points outside
+ * the domain of `source` are not modified.
+ *
+ * `di` and `dj` are offsets of the first grid point of this field in the source grid (see
+ * aligned()).
+ */
+void Array::copy_overlap(const Array &source, int di, int dj) {
+  PetscErrorCode ierr = 0;
+
+  const auto &source_grid = *source.grid();
+
+  const int
+    block_size = std::max((int)ndof(), (int)levels().size()),
+    Mx         = (int)source_grid.Mx(),
+    My         = (int)source_grid.My(),
+    xs         = grid()->xs(),
+    xm         = grid()->xm(),
+    ys         = grid()->ys(),
+    ym         = grid()->ym();
+
+  // indices of owned points in the overlap (in the source and in the local storage)
+  std::vector<int> indices, local;
+  for (int j = ys; j < ys + ym; ++j) {
+    for (int i = xs; i < xs + xm; ++i) {
+      int i_source = i + di, j_source = j + dj;
+
+      if (i_source >= 0 and i_source < Mx and j_source >= 0 and j_source < My) {
+        indices.push_back(j_source * Mx + i_source);
+        local.push_back((j - ys) * xm + (i - xs));
+      }
+    }
+  }
+
+  std::vector<double> buffer;
+  gather(source, indices, buffer);
+
+  petsc::TemporaryGlobalVec tmp(dm());
+  copy_to_vec(dm(), tmp);
+  {
+    petsc::VecArray tmp_array(tmp);
+    double *values = tmp_array.get();
+
+    for (size_t n = 0; n < local.size(); ++n) {
+      for (int k = 0; k < block_size; ++k) {
+        values[local[n] * block_size + k] = buffer[n * block_size + k];
+      }
+    }
+  }
+
+  if (m_impl->ghosted) {
+    global_to_local(*dm(), tmp, petsc_vec());
+  } else {
+    ierr = VecCopy(tmp, petsc_vec());
+    PISM_CHK(ierr, "VecCopy");
+  }
+}
+
 void Array::read(const File &file, const unsigned int time) {
-  this->read_impl(file, time);
   inc_state_counter();          // mark as modified
+  this->read_impl(file, time);
 }
 
 void Array::write(const File &file) const {
@@ -911,7 +1308,12 @@ AccessScope::AccessScope() {
 AccessScope::~AccessScope() {
   while (not m_vecs.empty()) {
     try {
-      m_vecs.back()->end_access();
+      const auto &item = m_vecs.back();
+      if (item.read_only) {
+        item.vec->end_read_access();
+      } else {
+        item.vec->end_access();
+      }
       m_vecs.pop_back();
     } catch (...) {
       handle_fatal_errors(MPI_COMM_SELF);
@@ -919,27 +1321,40 @@ AccessScope::~AccessScope() {
   }
 }
 
-AccessScope::AccessScope(std::initializer_list<const PetscAccessible *> vecs) {
-  for (const auto *j : vecs) {
-    assert(j != nullptr);
-    add(*j);
-  }
+AccessScope::AccessScope(std::initializer_list<Item> vecs) {
+  add(vecs);
 }
 
 AccessScope::AccessScope(const PetscAccessible &vec) {
   add(vec);
 }
 
+AccessScope::AccessScope(PetscAccessible &vec) {
+  add(vec);
+}
+
 void AccessScope::add(const PetscAccessible &vec) {
-  vec.begin_access();
-  m_vecs.push_back(&vec);
+  add(Item(&vec));
+}
+
+void AccessScope::add(PetscAccessible &vec) {
+  add(Item(&vec));
+}
+
+void AccessScope::add(std::initializer_list<Item> vecs) {
+  for (const auto &v : vecs) {
+    assert(v.vec != nullptr);
+    add(v);
+  }
 }
 
-void AccessScope::add(const std::vector<const PetscAccessible*> &vecs) {
-  for (const auto *v : vecs) {
-    assert(v != nullptr);
-    add(*v);
+void AccessScope::add(const Item &item) {
+  if (item.read_only) {
+    item.vec->begin_read_access();
+  } else {
+    item.vec->begin_access();
   }
+  m_vecs.push_back(item);
 }
 
 //! Return the total number of elements in the *owned* part of an array.
@@ -1055,7 +1470,7 @@ void Array::put_on_proc0(petsc::Vec &onp0) const {
     this->copy_to_vec(dm(), tmp);
     put_on_proc0(tmp, onp0);
   } else {
-    put_on_proc0(vec(), onp0);
+    put_on_proc0(petsc_vec(), onp0);
   }
 }
 
@@ -1093,14 +1508,16 @@ void Array::get_from_proc0(petsc::Vec &onp0, petsc::Vec &parallel) const {
 
 //! Gets a local Array2 from processor 0.
 void Array::get_from_proc0(petsc::Vec &onp0) {
+  inc_state_counter();          // mark as modified
+
   if (m_impl->ghosted) {
     petsc::TemporaryGlobalVec tmp(dm());
     get_from_proc0(onp0, tmp);
-    global_to_local(*dm(), tmp, vec());
+    global_to_local(*dm(), tmp, petsc_vec());
+    m_impl->ghosts_updated();
   } else {
-    get_from_proc0(onp0, vec());
+    get_from_proc0(onp0, petsc_vec());
   }
-  inc_state_counter();          // mark as modified
 }
 
 /*!
@@ -1157,10 +1574,10 @@ uint64_t Array::fletcher64() const {
   MPI_Comm_size(com, &comm_size);
 
   PetscInt local_size = 0;
-  PetscErrorCode ierr = VecGetLocalSize(vec(), &local_size); PISM_CHK(ierr, "VecGetLocalSize");
+  PetscErrorCode ierr = VecGetLocalSize(petsc_vec(), &local_size); PISM_CHK(ierr, "VecGetLocalSize");
   uint64_t sum = 0;
   {
-    petsc::VecArray v(vec());
+    petsc::VecArray v(petsc_vec());
     // compute checksums for local patches on all ranks
     sum = pism::fletcher64((uint32_t*)v.get(), static_cast<size_t>(local_size) * 2);
   }
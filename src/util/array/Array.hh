@@ -23,6 +23,7 @@
 #include <memory>               // shared_ptr, dynamic_pointer_cast
 #include <cstdint>              // uint64_t
 #include <array>
+#include <vector>
 
 #include "pism/util/error_handling.hh" // RuntimeError
 
@@ -52,8 +53,16 @@ class System;
 class PetscAccessible {
 public:
   virtual ~PetscAccessible() = default;
+  //! Begin access that may modify stored values.
   virtual void begin_access() const = 0;
   virtual void end_access() const = 0;
+  //! Begin access that does not modify stored values.
+  virtual void begin_read_access() const {
+    begin_access();
+  }
+  virtual void end_read_access() const {
+    end_access();
+  }
 };
 
 namespace array {
@@ -62,18 +71,42 @@ namespace array {
 enum Kind {WITHOUT_GHOSTS=0, WITH_GHOSTS=1};
 
 //! Makes sure that we call begin_access() and end_access() for all accessed array::Arrays.
+/*!
+ * Objects added using const pointers (references) are accessed using begin_read_access()
+ * and end_read_access(), i.e. without marking them as modified.
+ */
 class AccessScope {
 public:
+  //! An object to access. A non-const pointer means that stored values may be modified.
+  struct Item {
+    Item(const PetscAccessible *v) : vec(v), read_only(true) {}
+    Item(PetscAccessible *v) : vec(v), read_only(false) {}
+    const PetscAccessible *vec;
+    bool read_only;
+  };
+
   AccessScope();
-  AccessScope(std::initializer_list<const PetscAccessible *> vecs);
+  AccessScope(std::initializer_list<Item> vecs);
   AccessScope(const PetscAccessible &v);
+  AccessScope(PetscAccessible &v);
   ~AccessScope();
   void add(const PetscAccessible &v);
-  void add(const std::vector<const PetscAccessible*> &vecs);
+  void add(PetscAccessible &v);
+  void add(std::initializer_list<Item> vecs);
 private:
-  std::vector<const PetscAccessible*> m_vecs;
+  void add(const Item &item);
+  std::vector<Item> m_vecs;
 };
 
+//! Numbers of ghost exchanges performed and skipped by this process (see
+//! Array::update_ghosts()).
+struct GhostExchangeCounts {
+  unsigned long int performed;
+  unsigned long int skipped;
+};
+
+GhostExchangeCounts ghost_exchange_counts();
+
 /*!
  * Interpolation helper. Does not check if points needed for interpolation are within the current
  * processor's sub-domain.
@@ -189,7 +222,7 @@ T interpolate(const F &field, double x, double y) {
   ## Tracking if a field changed
 
   It is possible to track if a certain field changed with the help of
-  get_state_counter() and inc_state_counter() methods.
+  state_counter() and inc_state_counter() methods.
 
   For example, PISM's SIA code re-computes the smoothed bed only if the bed
   deformation code updated it:
@@ -201,9 +234,16 @@ T interpolate(const F &field, double x, double y) {
   }
   \endcode
 
-  The state counter is **not** updated automatically. For the code snippet above
-  to work, a bed deformation model has to call inc_state_counter() after an
-  update.
+  The state counter is incremented by all methods that may modify stored values
+  (set(), add(), copy_from(), read(), regrid(), vec(), etc) and every time an
+  Array is accessed point-wise using a non-const pointer or reference (see
+  AccessScope). Code calling begin_access() directly is assumed to modify values.
+
+  Note that the counter is updated *conservatively*: it may change even if
+  stored values did not.
+
+  If `grid.ghost_exchanges.skip` is set, update_ghosts() uses the state counter
+  to skip ghost exchanges if ghosts are known to be up to date on all processes.
 */
 class Array : public PetscAccessible {
 public:
@@ -226,6 +266,9 @@ public:
   void scale(double alpha);
 
   petsc::Vec& vec() const;
+  //! Returns the PETSc Vec storing values of this Array *without* incrementing the state
+  //! counter. Use for read-only access only.
+  petsc::Vec &petsc_vec() const;
   std::shared_ptr<petsc::DM> dm() const;
 
   void set_name(const std::string &name);
@@ -241,9 +284,12 @@ public:
 
   void regrid(const std::string &filename, io::Default default_value);
   void regrid(const File &file, io::Default default_value);
+  void regrid(const Array &source);
 
   virtual void begin_access() const;
   virtual void end_access() const;
+  virtual void begin_read_access() const;
+  virtual void end_read_access() const;
   void update_ghosts();
 
   std::shared_ptr<petsc::Vec> allocate_proc0_copy() const;
@@ -256,7 +302,7 @@ public:
 
   const SpatialVariableMetadata& metadata(unsigned int N = 0) const;
 
-  int state_counter() const;
+  uint64_t state_counter() const;
   void inc_state_counter();
 
   void set_interpolation_type(InterpolationType type);
@@ -294,6 +340,13 @@ protected:
   void set_dof(std::shared_ptr<petsc::DM> da_source, petsc::Vec &source, unsigned int start,
                unsigned int count=1);
 private:
+  void begin_access_impl() const;
+  void end_access_impl() const;
+  void regrid_in_memory_impl(const Array &source);
+  static void gather(const Array &source, const std::vector<int> &indices,
+                     std::vector<double> &result);
+  bool aligned(const Array &source, int &di, int &dj) const;
+  void copy_overlap(const Array &source, int di, int dj);
   size_t size() const;
   // disable copy constructor and the assignment operator:
   Array(const Array &other);
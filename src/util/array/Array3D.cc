@@ -206,8 +206,6 @@ void sum_columns(const Array3D &data, double A, double B, Scalar &output) {
 }
 
 void Array3D::copy_from(const Array3D &input) {
-  array::AccessScope list{ this, &input };
-
   assert(levels().size() == input.levels().size());
   assert(ndof() == input.ndof());
 
@@ -215,26 +213,31 @@ void Array3D::copy_from(const Array3D &input) {
   // level and ndof() > 1
   auto N = std::max((size_t)ndof(), levels().size());
 
-  ParallelSection loop(m_impl->grid->com);
-  try {
-    for (auto p = m_impl->grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
+  {
+    array::AccessScope list{ this, &input };
+
+    ParallelSection loop(m_impl->grid->com);
+    try {
+      for (auto p = m_impl->grid->points(); p; p.next()) {
+        const int i = p.i(), j = p.j();
 
 #if PETSC_VERSION_LT(3, 12, 0)
-      PetscMemmove(this->get_column(i, j), const_cast<double *>(input.get_column(i, j)),
-                   N * sizeof(double));
+        PetscMemmove(this->get_column(i, j), const_cast<double *>(input.get_column(i, j)),
+                     N * sizeof(double));
 #else
-      PetscArraymove(this->get_column(i, j), input.get_column(i, j), N);
+        PetscArraymove(this->get_column(i, j), input.get_column(i, j), N);
 #endif
+      }
+    } catch (...) {
+      loop.failed();
     }
-  } catch (...) {
-    loop.failed();
+    loop.check();
   }
-  loop.check();
-
-  update_ghosts();
 
   inc_state_counter();
+
+  // note: this is done after end_access() so that ghosts are recorded as up to date
+  update_ghosts();
 }
 
 std::shared_ptr<Array3D> Array3D::duplicate(Kind ghostedp) const {
@@ -275,9 +278,10 @@ void Array3D::regrid_impl(const File &file, io::Default default_value) {
   }
 
   if (m_impl->ghosted) {
-    global_to_local(*dm(), tmp, vec());
+    global_to_local(*dm(), tmp, petsc_vec());
+    m_impl->ghosts_updated();
   } else {
-    PetscErrorCode ierr = VecCopy(tmp, vec());
+    PetscErrorCode ierr = VecCopy(tmp, petsc_vec());
     PISM_CHK(ierr, "VecCopy");
   }
 }
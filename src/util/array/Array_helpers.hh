@@ -34,36 +34,41 @@ namespace details {
 template <class V>
 void add(const V &x, double alpha, const V &y, V &result, bool scatter = true) {
 
-  array::AccessScope list{ &x, &y, &result };
-  for (auto p = result.grid()->points(); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  {
+    array::AccessScope list{ &x, &y, &result };
+    for (auto p = result.grid()->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
 
-    result(i, j) = x(i, j) + y(i, j) * alpha;
+      result(i, j) = x(i, j) + y(i, j) * alpha;
+    }
   }
 
+  result.inc_state_counter();
+
   if (scatter) {
     result.update_ghosts();
   }
-
-  result.inc_state_counter();
 }
 
 template <class V>
 void copy(const V &input, V &result, bool scatter = true) {
 
-  array::AccessScope list{ &input, &result };
+  {
+    array::AccessScope list{ &input, &result };
 
-  for (auto p = result.grid()->points(); p; p.next()) {
-    const int i = p.i(), j = p.j();
+    for (auto p = result.grid()->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
 
-    result(i, j) = input(i, j);
+      result(i, j) = input(i, j);
+    }
   }
 
+  result.inc_state_counter();
+
+  // note: this is done after end_access() so that ghosts are recorded as up to date
   if (scatter) {
     result.update_ghosts();
   }
-
-  result.inc_state_counter();
 }
 
 } // namespace details
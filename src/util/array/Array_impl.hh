@@ -19,6 +19,8 @@
 #ifndef PISM_ARRAY_IMPL_HH
 #define PISM_ARRAY_IMPL_HH
 
+#include <cstdint>              // uint64_t
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -54,16 +56,29 @@ struct Array::Impl {
     zlevels = {0.0};
 
     state_counter = 0;
+    write_access_counter = 0;
+    ghosts_state = std::numeric_limits<uint64_t>::max();
+    skip_redundant_exchanges = true;
+    check_skipped_exchanges = false;
     interpolation_type = LINEAR;
 
     bsearch_accel = nullptr;
   }
+
+  //! Record that ghosts are up to date (unless an access modifying values is in progress).
+  void ghosts_updated() {
+    if (write_access_counter == 0) {
+      ghosts_state = state_counter;
+    }
+  }
+
   //! If true, report range when regridding.
   bool report_range;
 
   //! The array itself
   //!
-  //! Note: do not access this directly (via `m_impl->v`). Use `vec()` instead.
+  //! Note: do not access this directly (via `m_impl->v`). Use `vec()` (or `petsc_vec()`
+  //! if stored values are not modified) instead.
   petsc::Vec v;
 
   //! Name of the field. In general this is *not* the name of the corresponding NetCDF
@@ -99,7 +114,23 @@ struct Array::Impl {
   int access_counter;
 
   //! Internal array::Array "revision number"
-  int state_counter;
+  //!
+  //! Unsigned and 64-bit so that it cannot overflow in a long run: it is incremented on every
+  //! write access.
+  uint64_t state_counter;
+
+  //! number of active accesses that may modify stored values
+  int write_access_counter;
+
+  //! value of `state_counter` when ghosts were last known to be up to date (maximum
+  //! `uint64_t` if never)
+  uint64_t ghosts_state;
+
+  //! If true, skip ghost exchanges if ghosts are up to date.
+  bool skip_redundant_exchanges;
+
+  //! If true, check that skipped ghost exchanges would not change ghost values.
+  bool check_skipped_exchanges;
 
   // 2D Interpolation type (used by regrid())
   InterpolationType interpolation_type;
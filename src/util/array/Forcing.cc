@@ -231,6 +231,27 @@ void Forcing::end_access() const {
   }
 }
 
+void Forcing::begin_read_access() const {
+  if (m_impl->access_counter == 0) {
+    PetscErrorCode ierr = DMDAVecGetArrayDOF(*m_data->da, m_data->v, &m_data->array);
+    PISM_CHK(ierr, "DMDAVecGetArrayDOF");
+  }
+
+  // this call will increment the m_access_counter
+  array::Scalar::begin_read_access();
+}
+
+void Forcing::end_read_access() const {
+  // this call will decrement the m_access_counter
+  array::Scalar::end_read_access();
+
+  if (m_impl->access_counter == 0) {
+    PetscErrorCode ierr = DMDAVecRestoreArrayDOF(*m_data->da, m_data->v, &m_data->array);
+    PISM_CHK(ierr, "DMDAVecRestoreArrayDOF");
+    m_data->array = nullptr;
+  }
+}
+
 void Forcing::init(const std::string &filename, bool periodic) {
   try {
     auto ctx = m_impl->grid->ctx();
@@ -337,21 +358,21 @@ void Forcing::init_periodic_data(const File &file) {
 
   LocalInterpCtx lic(input_grid, *grid(), levels(), m_impl->interpolation_type);
 
-  for (unsigned int j = 0; j < n_records; ++j) {
-    {
-      lic.start[T_AXIS] = (int)j;
-      lic.count[T_AXIS] = 1;
+  // read all records using one call
+  {
+    lic.start[T_AXIS] = 0;
+    lic.count[T_AXIS] = (int)n_records;
 
-      petsc::VecArray tmp_array(vec());
-      io::regrid_spatial_variable(variable, *grid(), lic, file, tmp_array.get());
-    }
+    petsc::VecArray tmp_array(m_data->v);
+    io::regrid_records(variable, *grid(), lic, file, m_data->buffer_size,
+                       tmp_array.get() + offset);
+  }
 
-    auto time = ctx->time();
-    auto log  = ctx->log();
-    log->message(5, " %s: reading entry #%02d, time %s...\n", name.c_str(), j,
+  auto time = ctx->time();
+  auto log  = ctx->log();
+  for (unsigned int j = 0; j < n_records; ++j) {
+    log->message(5, " %s: read entry #%02d, time %s\n", name.c_str(), j,
                  time->date(m_data->time[j]).c_str());
-
-    set_record(offset + j);
   }
 
   m_data->n_records = buffer_required;
@@ -542,17 +563,19 @@ void Forcing::update(unsigned int start) {
 
     LocalInterpCtx lic(input_grid, *grid(), levels(), m_impl->interpolation_type);
 
-    for (unsigned int j = 0; j < missing; ++j) {
-      lic.start[T_AXIS] = (int)(start + j);
-      lic.count[T_AXIS] = 1;
+    // read all missing records using one call, storing them right after the ones we kept
+    {
+      lic.start[T_AXIS] = (int)start;
+      lic.count[T_AXIS] = (int)missing;
 
-      petsc::VecArray tmp_array(vec());
-      io::regrid_spatial_variable(variable, *m_impl->grid, lic, file, tmp_array.get());
+      petsc::VecArray tmp_array(m_data->v);
+      io::regrid_records(variable, *m_impl->grid, lic, file, m_data->buffer_size,
+                         tmp_array.get() + kept);
+    }
 
-      log->message(5, " %s: reading entry #%02d, year %s...\n", m_impl->name.c_str(), start + j,
+    for (unsigned int j = 0; j < missing; ++j) {
+      log->message(5, " %s: read entry #%02d, year %s\n", m_impl->name.c_str(), start + j,
                    t->date(m_data->time[start + j]).c_str());
-
-      set_record(kept + j);
     }
   } catch (RuntimeError &e) {
     e.add_context("regridding '%s' from '%s'", this->get_name().c_str(), m_data->filename.c_str());
@@ -69,6 +69,8 @@ public:
 
   void begin_access() const;
   void end_access() const;
+  void begin_read_access() const;
+  void end_read_access() const;
   void init_interpolation(const std::vector<double> &ts);
 
 private:
@@ -40,25 +40,27 @@ Staggered::Staggered(std::shared_ptr<const Grid> grid, const std::string &name,
 }
 
 void Staggered::copy_from(const Staggered &input) {
-  array::AccessScope list {this, &input};
-  // FIXME: this should be simplified
+  {
+    array::AccessScope list {this, &input};
+    // FIXME: this should be simplified
 
-  ParallelSection loop(grid()->com);
-  try {
-    for (auto p = grid()->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
+    ParallelSection loop(grid()->com);
+    try {
+      for (auto p = grid()->points(); p; p.next()) {
+        const int i = p.i(), j = p.j();
 
-      (*this)(i, j, 0) = input(i, j, 0);
-      (*this)(i, j, 1) = input(i, j, 1);
+        (*this)(i, j, 0) = input(i, j, 0);
+        (*this)(i, j, 1) = input(i, j, 1);
+      }
+    } catch (...) {
+      loop.failed();
     }
-  } catch (...) {
-    loop.failed();
+    loop.check();
   }
-  loop.check();
-
-  update_ghosts();
 
   inc_state_counter();
+
+  update_ghosts();
 }
 
 Staggered1::Staggered1(std::shared_ptr<const Grid> grid, const std::string &name)
@@ -66,6 +68,17 @@ Staggered1::Staggered1(std::shared_ptr<const Grid> grid, const std::string &name
   // empty
 }
 
+Staggered1::Staggered1(std::shared_ptr<const Grid> grid, const std::string &name,
+                       unsigned int stencil_width)
+    : Staggered(grid, name, stencil_width) {
+  // empty
+}
+
+Staggered2::Staggered2(std::shared_ptr<const Grid> grid, const std::string &name)
+    : Staggered1(grid, name, 2) {
+  // empty
+}
+
 std::array<double,2> absmax(const array::Staggered &input) {
 
   double z[2] = {0.0, 0.0};
@@ -68,6 +68,17 @@ public:
     this context.
   */
   inline stencils::Star<double> star(int i, int j) const;
+protected:
+  Staggered1(std::shared_ptr<const Grid> grid, const std::string &name,
+             unsigned int stencil_width);
+};
+
+/*!
+ * Staggered grid 2D array supporting width=2 stencil computations
+ */
+class Staggered2 : public Staggered1 {
+public:
+  Staggered2(std::shared_ptr<const Grid> grid, const std::string &name);
 };
 
 inline stencils::Star<double> Staggered1::star(int i, int j) const {
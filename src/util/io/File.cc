@@ -52,6 +52,54 @@ struct File::Impl {
   MPI_Comm com;
   io::Backend backend;
   io::NCFile::Ptr nc;
+
+  //! Metadata cache valid while the file is open.
+  /*!
+   * Most metadata queries are collective (and some require a broadcast from rank 0), so we
+   * remember answers to queries that are repeated every time a variable is written or
+   * read. This cache is updated by File's own "define" calls and cleared by close().
+   */
+  struct MetadataCache {
+    //! Existence of variables (true or false), indexed by name.
+    std::map<std::string, bool> variables;
+    //! Existence of dimensions (true or false), indexed by name.
+    std::map<std::string, bool> dimensions;
+    //! Dimensions of variables, indexed by variable name.
+    std::map<std::string, std::vector<std::string> > variable_dimensions;
+    //! Attribute types (PISM_NAT if an attribute is absent), indexed by variable name,
+    //! then by attribute name. Includes the "not_written" flag used by io_helpers.
+    std::map<std::string, std::map<std::string, io::Type> > attribute_types;
+    //! Axis types of dimensions, indexed by dimension name.
+    std::map<std::string, AxisType> axis_types;
+    //! Names of variables, indexed by the value of the standard_name attribute.
+    std::map<std::string, std::vector<std::string> > standard_names;
+    //! True if `standard_names` is up to date.
+    bool standard_names_valid = false;
+    //! Name of the unlimited dimension.
+    std::string unlimited_dimension;
+    //! True if `unlimited_dimension` is up to date.
+    bool unlimited_dimension_valid = false;
+
+    void clear() {
+      *this = MetadataCache();
+    }
+
+    //! Update the cache after an attribute was written (or removed if `type` is PISM_NAT).
+    void attribute_changed(const std::string &var_name, const std::string &att_name,
+                           io::Type type) {
+      attribute_types[var_name][att_name] = type;
+      // the axis type of a coordinate variable depends on its attributes
+      axis_types.erase(var_name);
+      if (att_name == "standard_name") {
+        standard_names_valid = false;
+      }
+    }
+  };
+
+  MetadataCache cache;
+
+  //! True if 3D fields on the ice grid should use the sparse encoding.
+  bool sparse_3d = false;
 };
 
 io::Backend string_to_backend(const std::string &backend) {
@@ -223,7 +271,23 @@ void File::set_compression_level(int level) const {
   m_impl->nc->set_compression_level(level);
 }
 
+/*!
+ * Use the sparse ("ice-only") encoding for 3D fields on the ice grid defined in this file
+ * from now on (see io::define_spatial_variable()).
+ *
+ * This encoding stores one time record per file, so it should only be used for files
+ * containing one record.
+ */
+void File::set_sparse_3d(bool flag) const {
+  m_impl->sparse_3d = flag;
+}
+
+bool File::sparse_3d() const {
+  return m_impl->sparse_3d;
+}
+
 void File::open(const std::string &filename, io::Mode mode) {
+  m_impl->cache.clear();
   try {
 
     // opening for reading
@@ -261,6 +325,8 @@ void File::open(const std::string &filename, io::Mode mode) {
 void File::remove_attribute(const std::string &variable_name, const std::string &att_name) const {
   try {
     m_impl->nc->del_att(variable_name, att_name);
+
+    m_impl->cache.attribute_changed(variable_name, att_name, io::PISM_NAT);
   } catch (RuntimeError &e) {
     e.add_context("deleting the attribute %s:%s", variable_name.c_str(), att_name.c_str());
     throw;
@@ -269,6 +335,7 @@ void File::remove_attribute(const std::string &variable_name, const std::string
 
 void File::close() {
   try {
+    m_impl->cache.clear();
     m_impl->nc->close();
   } catch (RuntimeError &e) {
     e.add_context("closing \"" + filename() + "\"");
@@ -304,6 +371,17 @@ void File::enddef() const {
   }
 }
 
+//! Set the fill mode (files are opened using io::PISM_NOFILL).
+void File::set_fill(io::Fill_Mode mode) const {
+  try {
+    int old_mode = 0;
+    m_impl->nc->set_fill(mode, old_mode);
+  } catch (RuntimeError &e) {
+    e.add_context("setting the fill mode; file \"" + filename() + "\"");
+    throw;
+  }
+}
+
 std::string File::filename() const {
   return m_impl->nc->filename();
 }
@@ -312,8 +390,12 @@ std::string File::filename() const {
 //! \brief Get the number of records. Uses the length of an unlimited dimension.
 unsigned int File::nrecords() const {
   try {
-    std::string dim;
-    m_impl->nc->inq_unlimdim(dim);
+    auto &cache = m_impl->cache;
+    if (not cache.unlimited_dimension_valid) {
+      m_impl->nc->inq_unlimdim(cache.unlimited_dimension);
+      cache.unlimited_dimension_valid = true;
+    }
+    const auto &dim = cache.unlimited_dimension;
 
     if (dim.empty()) {
       return 1;                 // one record
@@ -364,35 +446,44 @@ VariableLookupData File::find_variable(const std::string &short_name, const std:
     result.exists = false;
 
     if (not std_name.empty()) {
+      auto &cache = m_impl->cache;
 
-      int n_variables = nvariables();
+      if (not cache.standard_names_valid) {
+        // Build the index of standard names once: this requires reading the
+        // standard_name attribute of every variable in the file.
+        cache.standard_names.clear();
 
-      for (int j = 0; j < n_variables; ++j) {
-        std::string name      = variable_name(j);
-        std::string attribute = read_text_attribute(name, "standard_name");
+        int n_variables = nvariables();
+        for (int j = 0; j < n_variables; ++j) {
+          std::string name      = variable_name(j);
+          std::string attribute = read_text_attribute(name, "standard_name");
 
-        if (attribute.empty()) {
-          continue;
+          if (not attribute.empty()) {
+            cache.standard_names[attribute].push_back(name);
+          }
         }
+        cache.standard_names_valid = true;
+      }
 
-        if (attribute == std_name) {
-          if (not result.exists) {
-            result.exists = true;
-            result.found_using_standard_name = true;
-            result.name = name;
-          } else {
-            throw RuntimeError::formatted(PISM_ERROR_LOCATION, "inconsistency in '%s': variables '%s' and '%s'\n"
-                                          "have the same standard_name (%s)",
-                                          filename().c_str(), result.name.c_str(),
-                                          name.c_str(), attribute.c_str());
-          }
+      auto it = cache.standard_names.find(std_name);
+      if (it != cache.standard_names.end()) {
+        const auto &names = it->second;
+
+        if (names.size() > 1) {
+          throw RuntimeError::formatted(PISM_ERROR_LOCATION, "inconsistency in '%s': variables '%s' and '%s'\n"
+                                        "have the same standard_name (%s)",
+                                        filename().c_str(), names[0].c_str(),
+                                        names[1].c_str(), std_name.c_str());
         }
 
-      } // end of the for loop
+        result.exists = true;
+        result.found_using_standard_name = true;
+        result.name = names[0];
+      }
     } // end of if (not std_name.empty())
 
     if (not result.exists) {
-      m_impl->nc->inq_varid(short_name, result.exists);
+      result.exists = find_variable(short_name);
       if (result.exists) {
         result.name = short_name;
       } else {
@@ -413,8 +504,16 @@ VariableLookupData File::find_variable(const std::string &short_name, const std:
 //! \brief Checks if a variable exists.
 bool File::find_variable(const std::string &name) const {
   try {
+    auto &variables = m_impl->cache.variables;
+
+    auto it = variables.find(name);
+    if (it != variables.end()) {
+      return it->second;
+    }
+
     bool exists = false;
     m_impl->nc->inq_varid(name, exists);
+    variables[name] = exists;
     return exists;
   } catch (RuntimeError &e) {
     e.add_context("searching for variable '%s' in '%s'", name.c_str(), filename().c_str());
@@ -424,8 +523,16 @@ bool File::find_variable(const std::string &name) const {
 
 std::vector<std::string> File::dimensions(const std::string &variable_name) const {
   try {
+    auto &dimensions = m_impl->cache.variable_dimensions;
+
+    auto it = dimensions.find(variable_name);
+    if (it != dimensions.end()) {
+      return it->second;
+    }
+
     std::vector<std::string> result;
     m_impl->nc->inq_vardimid(variable_name, result);
+    dimensions[variable_name] = result;
     return result;
   } catch (RuntimeError &e) {
     e.add_context("getting dimensions of variable '%s' in '%s'", variable_name.c_str(),
@@ -438,8 +545,16 @@ std::vector<std::string> File::dimensions(const std::string &variable_name) cons
 //! \brief Checks if a dimension exists.
 bool File::find_dimension(const std::string &name) const {
   try {
+    auto &dimensions = m_impl->cache.dimensions;
+
+    auto it = dimensions.find(name);
+    if (it != dimensions.end()) {
+      return it->second;
+    }
+
     bool exists = false;
     m_impl->nc->inq_dimid(name, exists);
+    dimensions[name] = exists;
     return exists;
   } catch (RuntimeError &e) {
     e.add_context("searching for dimension '%s' in '%s'", name.c_str(), filename().c_str());
@@ -492,6 +607,20 @@ AxisType axis_type_from_string(const std::string &input) {
  */
 AxisType File::dimension_type(const std::string &name,
                               units::System::Ptr unit_system) const {
+  auto &axis_types = m_impl->cache.axis_types;
+
+  auto it = axis_types.find(name);
+  if (it != axis_types.end()) {
+    return it->second;
+  }
+
+  AxisType result = dimension_type_impl(name, unit_system);
+  axis_types[name] = result;
+  return result;
+}
+
+AxisType File::dimension_type_impl(const std::string &name,
+                                   units::System::Ptr unit_system) const {
   try {
     if (not find_variable(name)) {
       throw RuntimeError(PISM_ERROR_LOCATION, "coordinate variable " + name + " is missing");
@@ -563,6 +692,9 @@ AxisType File::dimension_type(const std::string &name,
 void File::define_dimension(const std::string &name, size_t length) const {
   try {
     m_impl->nc->def_dim(name, length);
+
+    m_impl->cache.dimensions[name]         = true;
+    m_impl->cache.unlimited_dimension_valid = false;
   } catch (RuntimeError &e) {
     e.add_context("defining dimension '%s' in '%s'", name.c_str(), filename().c_str());
     throw;
@@ -574,6 +706,14 @@ void File::define_variable(const std::string &name, io::Type nctype, const std::
   try {
     m_impl->nc->def_var(name, nctype, dims);
 
+    auto &cache = m_impl->cache;
+    cache.variables[name]           = true;
+    cache.variable_dimensions[name] = dims;
+    cache.attribute_types.erase(name);
+    cache.axis_types.erase(name);
+    // the standard name index does not need to be invalidated here: a new variable does
+    // not have any attributes yet
+
     // FIXME: I need to write and tune chunk_dimensions that would be called below before we use
     // this.
     //
@@ -640,6 +780,8 @@ void File::write_attribute(const std::string &var_name, const std::string &att_n
   try {
     redef();
     m_impl->nc->put_att_double(var_name, att_name, nctype, values);
+
+    m_impl->cache.attribute_changed(var_name, att_name, nctype);
   } catch (RuntimeError &e) {
     e.add_context("writing double attribute '%s:%s' in '%s'",
                   var_name.c_str(), att_name.c_str(), filename().c_str());
@@ -654,6 +796,8 @@ void File::write_attribute(const std::string &var_name, const std::string &att_n
     redef();
     // ensure that the string is null-terminated
     m_impl->nc->put_att_text(var_name, att_name, value + "\0");
+
+    m_impl->cache.attribute_changed(var_name, att_name, io::PISM_CHAR);
   } catch (RuntimeError &e) {
     e.add_context("writing text attribute '%s:%s' in '%s'",
                   var_name.c_str(), att_name.c_str(), filename().c_str());
@@ -734,8 +878,16 @@ std::string File::attribute_name(const std::string &var_name, unsigned int n) co
 
 io::Type File::attribute_type(const std::string &var_name, const std::string &att_name) const {
   try {
+    auto &types = m_impl->cache.attribute_types[var_name];
+
+    auto it = types.find(att_name);
+    if (it != types.end()) {
+      return it->second;
+    }
+
     io::Type result;
     m_impl->nc->inq_atttype(var_name, att_name, result);
+    types[att_name] = result;
     return result;
   } catch (RuntimeError &e) {
     e.add_context("getting the type of an attribute of variable '%s' in '%s'", var_name.c_str(), filename().c_str());
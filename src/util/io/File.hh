@@ -33,6 +33,7 @@ namespace io {
 enum Type : int;
 enum Backend : int;
 enum Mode : int;
+enum Fill_Mode : int;
 } // namespace io
 
 class Grid;
@@ -71,6 +72,8 @@ public:
 
   void sync() const;
 
+  void set_fill(io::Fill_Mode mode) const;
+
   std::string filename() const;
 
   unsigned int nrecords() const;
@@ -131,6 +134,10 @@ public:
 
   void set_compression_level(int level) const;
 
+  void set_sparse_3d(bool flag) const;
+
+  bool sparse_3d() const;
+
   // attributes
 
   void remove_attribute(const std::string &variable_name, const std::string &att_name) const;
@@ -157,6 +164,9 @@ private:
 
   void open(const std::string &filename, io::Mode mode);
 
+  AxisType dimension_type_impl(const std::string &name,
+                               units::System::Ptr unit_system) const;
+
   // disable copying and assignments
   File(const File &other);
   File & operator=(const File &);
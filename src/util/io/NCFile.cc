@@ -176,10 +176,10 @@ void NCFile::write_darray_impl(const std::string &variable_name,
   std::vector<unsigned int> start, count;
 
   if (time_dependent) {
-    start = { record, (unsigned)grid.ys(), (unsigned)grid.xs(), 0 };
-    count = { 1,      (unsigned)grid.ym(), (unsigned)grid.xm(), z_count };
+    start = { record, (unsigned)grid.output_ys(), (unsigned)grid.output_xs(), 0 };
+    count = { 1,      (unsigned)grid.ym(),        (unsigned)grid.xm(),        z_count };
   } else {
-    start = { (unsigned)grid.ys(), (unsigned)grid.xs(), 0 };
+    start = { (unsigned)grid.output_ys(), (unsigned)grid.output_xs(), 0 };
     count = { (unsigned)grid.ym(), (unsigned)grid.xm(), z_count };
   }
 
@@ -27,7 +27,11 @@
 #endif
 #include <netcdf.h>
 
+#include <algorithm>            // std::all_of
 #include <cstdio>               // stderr, fprintf
+#include <cstring>              // memcpy
+#include <limits>
+#include <map>
 
 #include "pism/util/pism_utilities.hh" // join
 #include "pism/util/error_handling.hh"
@@ -44,13 +48,48 @@ static void check(const ErrorLocation &where, int return_code) {
   }
 }
 
-//! call MPI_Abort() if a NetCDF call failed
-static void check_and_abort(MPI_Comm com, const ErrorLocation &where, int return_code) {
-  if (return_code != NC_NOERR) {
-    fprintf(stderr, "%s:%d: %s\n", where.filename, where.line_number, nc_strerror(return_code));
-    MPI_Abort(com, -1);
-  }
-}
+/*!
+ * The header (dimensions, variables and attributes) of a NetCDF file.
+ *
+ * Rank 0 reads the header of a file opened for reading and broadcasts it using *one*
+ * MPI_Bcast() call. All metadata queries are then answered on all ranks without
+ * communication.
+ */
+struct NC_Serial::Header {
+  struct Attribute {
+    //! NetCDF type
+    int type;
+    //! values of a numeric attribute
+    std::vector<double> values;
+    //! value of a text or string attribute
+    std::string text;
+  };
+
+  struct Variable {
+    std::string name;
+    std::vector<std::string> dimensions;
+    //! attribute names (in the order used in the file)
+    std::vector<std::string> attribute_names;
+    std::map<std::string, Attribute> attributes;
+  };
+
+  std::map<std::string, unsigned int> dimensions;
+  std::string unlimited_dimension;
+  //! variables (indexed by varid)
+  std::vector<Variable> variables;
+  //! global attributes
+  Variable global;
+  //! map from variable names to varids
+  std::map<std::string, int> varids;
+
+  int read(int ncid);
+  static int read_attributes(int ncid, int varid, Variable &variable);
+  std::vector<char> serialize() const;
+  void deserialize(const std::vector<char> &buffer);
+
+  const Variable *find(const std::string &variable_name) const;
+  const Variable &get(const std::string &variable_name) const;
+};
 
 NC_Serial::NC_Serial(MPI_Comm c)
   : NCFile(c), m_rank(0) {
@@ -88,6 +127,12 @@ void NC_Serial::open_impl(const std::string &fname, io::Mode mode) {
   MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
 
   check(PISM_ERROR_LOCATION, stat);
+
+  m_header.reset();
+  if (mode == io::PISM_READONLY) {
+    // the header of a file opened for reading cannot change
+    read_header();
+  }
 }
 
 //! \brief Create a NetCDF file.
@@ -114,6 +159,7 @@ void NC_Serial::close_impl() {
   }
 
   m_file_id = -1;
+  m_header.reset();
 
   MPI_Barrier(m_com);
   MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
@@ -156,6 +202,9 @@ void NC_Serial::enddef_impl() const {
 void NC_Serial::redef_impl() const {
   int stat = NC_NOERR;
 
+  // the header may change
+  m_header.reset();
+
   if (m_rank == 0) {
     stat = nc_redef(m_file_id);
   }
@@ -183,6 +232,11 @@ void NC_Serial::def_dim_impl(const std::string &name, size_t length) const {
 }
 
 void NC_Serial::inq_dimid_impl(const std::string &dimension_name, bool &exists) const {
+  if (m_header) {
+    exists = m_header->dimensions.count(dimension_name) > 0;
+    return;
+  }
+
   int stat, flag = -1;
 
   if (m_rank == 0) {
@@ -199,6 +253,15 @@ void NC_Serial::inq_dimid_impl(const std::string &dimension_name, bool &exists)
 
 //! \brief Get a dimension length.
 void NC_Serial::inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const {
+  if (m_header) {
+    auto d = m_header->dimensions.find(dimension_name);
+    if (d == m_header->dimensions.end()) {
+      check(PISM_ERROR_LOCATION, NC_EBADDIM);
+    }
+    result = d->second;
+    return;
+  }
+
   int stat = NC_NOERR;
 
   if (m_rank == 0) {
@@ -222,6 +285,11 @@ void NC_Serial::inq_dimlen_impl(const std::string &dimension_name, unsigned int
 
 //! \brief Get an unlimited dimension.
 void NC_Serial::inq_unlimdim_impl(std::string &result) const {
+  if (m_header) {
+    result = m_header->unlimited_dimension;
+    return;
+  }
+
   int stat = NC_NOERR;
   std::vector<char> dimname(NC_MAX_NAME + 1, 0);
 
@@ -292,185 +360,480 @@ void NC_Serial::get_vara_double_impl(const std::string &variable_name,
   return this->get_var_double(variable_name, start, count, dummy, op, false);
 }
 
-//! \brief Get variable data.
-void NC_Serial::get_var_double(const std::string &variable_name,
-                               const std::vector<unsigned int> &start_input,
-                               const std::vector<unsigned int> &count_input,
-                               const std::vector<unsigned int> &imap_input, double *ip,
-                               bool transposed) const {
-  std::vector<unsigned int> start = start_input;
-  std::vector<unsigned int> count = count_input;
-  std::vector<unsigned int> imap  = imap_input;
-  const int start_tag = 1, count_tag = 2, data_tag = 3, imap_tag = 4, chunk_size_tag = 5;
-  int stat = NC_NOERR, com_size, ndims = static_cast<int>(start.size());
-  MPI_Status mpi_stat;
-  unsigned int local_chunk_size = 1, processor_0_chunk_size = 0;
+namespace {
 
-  if (not transposed) {
-    imap.resize(ndims);
+/*!
+ * Hyperslabs (start, count and imap) of all ranks in a communicator, gathered on rank 0
+ * using one collective call.
+ *
+ * Rank 0 uses this to assemble (or split) the whole field, so that it can be written (or
+ * read) using *one* NetCDF call.
+ *
+ * If all ranks use the same hyperslab (e.g. when reading time, time bounds or a scalar
+ * time series) the decomposition is *replicated*: only the hyperslab of rank 0 is used
+ * and the data are broadcast (read) or taken from rank 0 (write) instead of being
+ * scattered or gathered.
+ */
+class Decomposition {
+public:
+  Decomposition(MPI_Comm com,
+                const std::vector<unsigned int> &start,
+                const std::vector<unsigned int> &count,
+                const std::vector<unsigned int> &imap,
+                bool transposed);
+
+  //! True if all ranks use the same hyperslab.
+  bool replicated() const {
+    return m_replicated;
   }
 
-  // get the size of the communicator
-  MPI_Comm_size(m_com, &com_size);
+  //! Size of the chunk of rank `r`.
+  int size(int r) const {
+    return m_sizes[r];
+  }
 
-  // compute the size of a local chunk
-  for (int k = 0; k < ndims; ++k) {
-    local_chunk_size *= count[k];
+  //! Sizes of chunks of all ranks (for MPI_Gatherv() and MPI_Scatterv()).
+  const std::vector<int> &sizes() const {
+    return m_sizes;
   }
 
-  // compute the maximum and send it to processor 0; this is the size of the
-  // buffer processor 0 will need
-  MPI_Reduce(&local_chunk_size, &processor_0_chunk_size, 1, MPI_UNSIGNED, MPI_MAX, 0, m_com);
+  //! Offsets of chunks of all ranks in the buffer containing all chunks.
+  const std::vector<int> &offsets() const {
+    return m_offsets;
+  }
 
-  // now we need to send start, count and imap data to processor 0 and receive data
-  if (m_rank == 0) {
-    std::vector<double> processor_0_buffer;
-    // Note: this could be optimized: if processor_0_chunk_size <=
-    // max(local_chunk_size) we can avoid allocating this buffer. The inner for
-    // loop will have to be re-ordered, though.
-    processor_0_buffer.resize(processor_0_chunk_size);
+  //! Total size of all chunks.
+  size_t total_size() const {
+    return m_total_size;
+  }
 
-    // MPI calls below require C datatypes (so that we don't have to worry
-    // about sizes of size_t and ptrdiff_t), so we make local copies of start,
-    // count, and imap to use in the nc_get_varm_double() call.
-    std::vector<size_t> nc_start(ndims), nc_count(ndims);
-    std::vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims);
-    int varid;
+  //! Start of the bounding box of all non-empty hyperslabs.
+  const std::vector<size_t> &box_start() const {
+    return m_box_start;
+  }
 
-    stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
-    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+  //! Count of the bounding box of all non-empty hyperslabs.
+  const std::vector<size_t> &box_count() const {
+    return m_box_count;
+  }
 
-    for (int r = 0; r < com_size; ++r) {
+  //! Number of elements in the bounding box.
+  size_t box_size() const {
+    return m_box_size;
+  }
+
+  void start(int r, std::vector<size_t> &result) const;
+  void count(int r, std::vector<size_t> &result) const;
+
+  /*!
+   * Call `f(chunk_offset, box_offset)` for each element in the hyperslab of rank `r`.
+   *
+   * Here `chunk_offset` is the position of an element in the chunk of rank `r` and
+   * `box_offset` is its position in the bounding box (stored in the row-major order).
+   */
+  template <class F>
+  void for_each(int r, F f) const;
+
+private:
+  int m_ndims;
+  bool m_transposed;
+  bool m_replicated;
+  //! start, count and imap of all ranks (`3 * m_ndims` entries per rank)
+  std::vector<unsigned int> m_slabs;
+  std::vector<int> m_sizes, m_offsets;
+  size_t m_total_size;
+  std::vector<size_t> m_box_start, m_box_count;
+  size_t m_box_size;
+};
+
+Decomposition::Decomposition(MPI_Comm com,
+                             const std::vector<unsigned int> &start,
+                             const std::vector<unsigned int> &count,
+                             const std::vector<unsigned int> &imap,
+                             bool transposed)
+  : m_ndims(static_cast<int>(start.size())),
+    m_transposed(transposed),
+    m_replicated(false),
+    m_total_size(0),
+    m_box_size(0) {
+
+  int rank = 0, size = 0;
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &size);
+
+  const int n = m_ndims;
+
+  std::vector<unsigned int> local(3 * n);
+  for (int k = 0; k < n; ++k) {
+    local[k]         = start[k];
+    local[n + k]     = count[k];
+    local[2 * n + k] = transposed ? imap[k] : 0;
+  }
+
+  if (rank == 0) {
+    m_slabs.resize(3 * n * size);
+  }
+
+  if (n > 0) {
+    MPI_Gather(local.data(), 3 * n, MPI_UNSIGNED,
+               m_slabs.data(), 3 * n, MPI_UNSIGNED, 0, com);
+  }
 
-      if (r != 0) {
-        // Note: start, count, imap, and local_chunk_size on processor zero are
-        // used *before* they get overwritten by these calls
-        MPI_Recv(start.data(), ndims, MPI_UNSIGNED, r, start_tag, m_com, &mpi_stat);
-        MPI_Recv(count.data(), ndims, MPI_UNSIGNED, r, count_tag, m_com, &mpi_stat);
-        MPI_Recv(imap.data(), ndims, MPI_UNSIGNED, r, imap_tag, m_com, &mpi_stat);
-        MPI_Recv(&local_chunk_size, 1, MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
+  // Sizes and offsets of chunks are computed on rank 0, but all ranks have to know if
+  // they overflow (ranks other than 0 would otherwise wait in the next collective call)
+  // and if the decomposition is replicated.
+  int flags[2] = {0, 0};        // too big, replicated
+  int &too_big = flags[0], &replicated = flags[1];
+  if (rank == 0) {
+    replicated = 1;
+    for (int r = 1; r < size and replicated == 1; ++r) {
+      replicated = std::equal(m_slabs.begin(), m_slabs.begin() + 3 * n,
+                              m_slabs.begin() + 3 * n * r) ? 1 : 0;
+    }
+
+    // only the chunk of rank 0 is used if the decomposition is replicated
+    const int N = replicated == 1 ? 1 : size;
+
+    m_sizes.resize(N);
+    m_offsets.resize(N);
+
+    for (int r = 0; r < N; ++r) {
+      const unsigned int *C = &m_slabs[3 * n * r + n];
+
+      size_t chunk_size = 1;
+      for (int k = 0; k < n; ++k) {
+        chunk_size *= C[k];
       }
 
-      // This for loop uses start, count and imap passed in as arguments when r
-      // == 0. For r > 0 they are overwritten by MPI_Recv calls above.
-      for (int k = 0; k < ndims; ++k) {
-        nc_start[k]  = start[k];
-        nc_count[k]  = count[k];
-        nc_imap[k]   = imap[k];
-        nc_stride[k] = 1; // fill with ones; this way it works even with
-                          // NetCDF versions with a bug affecting the
-                          // stride == NULL case.
+      if (chunk_size > (size_t)std::numeric_limits<int>::max() or
+          m_total_size + chunk_size > (size_t)std::numeric_limits<int>::max()) {
+        too_big = 1;
+        break;
       }
 
-      if (transposed) {
-        stat = nc_get_varm_double(m_file_id, varid, nc_start.data(), nc_count.data(),
-                                  nc_stride.data(), nc_imap.data(), processor_0_buffer.data());
+      m_sizes[r]   = static_cast<int>(chunk_size);
+      m_offsets[r] = static_cast<int>(m_total_size);
+      m_total_size += chunk_size;
+    }
+  }
+
+  MPI_Bcast(flags, 2, MPI_INT, 0, com);
+
+  m_replicated = (replicated == 1);
+
+  if (too_big != 0) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "a variable is too big to be gathered on one rank;"
+                       " please use a parallel I/O backend");
+  }
+
+  if (rank != 0) {
+    return;
+  }
+
+  m_box_start.resize(n);
+  m_box_count.resize(n);
+
+  std::vector<size_t> box_end(n, 0);
+  bool empty = true;
+  for (int r = 0; r < (int)m_sizes.size(); ++r) {
+    if (m_sizes[r] == 0) {
+      continue;
+    }
+
+    const unsigned int *S = &m_slabs[3 * n * r], *C = S + n;
+
+    for (int k = 0; k < n; ++k) {
+      if (empty) {
+        m_box_start[k] = S[k];
+        box_end[k]     = S[k] + C[k];
       } else {
-        stat = nc_get_vara_double(m_file_id, varid, nc_start.data(), nc_count.data(),
-                                  processor_0_buffer.data());
+        m_box_start[k] = std::min(m_box_start[k], (size_t)S[k]);
+        box_end[k]     = std::max(box_end[k], (size_t)(S[k] + C[k]));
       }
-      check(PISM_ERROR_LOCATION, stat);
+    }
+    empty = false;
+  }
 
-      if (r != 0) {
-        MPI_Send(processor_0_buffer.data(), (int)local_chunk_size, MPI_DOUBLE, r, data_tag, m_com);
-      } else {
-        for (unsigned int k = 0; k < local_chunk_size; ++k) {
-          ip[k] = processor_0_buffer[k];
+  m_box_size = empty ? 0 : 1;
+  for (int k = 0; k < n; ++k) {
+    m_box_count[k] = empty ? 0 : box_end[k] - m_box_start[k];
+    m_box_size *= m_box_count[k];
+  }
+}
+
+void Decomposition::start(int r, std::vector<size_t> &result) const {
+  const unsigned int *S = &m_slabs[3 * m_ndims * r];
+  result.assign(S, S + m_ndims);
+}
+
+void Decomposition::count(int r, std::vector<size_t> &result) const {
+  const unsigned int *C = &m_slabs[3 * m_ndims * r + m_ndims];
+  result.assign(C, C + m_ndims);
+}
+
+template <class F>
+void Decomposition::for_each(int r, F f) const {
+  const int n = m_ndims;
+
+  if (m_sizes[r] == 0) {
+    return;
+  }
+
+  if (n == 0) {
+    f(0, 0);
+    return;
+  }
+
+  const unsigned int
+    *S = &m_slabs[3 * n * r],
+    *C = S + n,
+    *M = S + 2 * n;
+
+  // strides in the chunk and in the box
+  std::vector<size_t> chunk_stride(n), box_stride(n);
+  {
+    size_t c = 1, b = 1;
+    for (int k = n - 1; k >= 0; --k) {
+      chunk_stride[k] = m_transposed ? M[k] : c;
+      box_stride[k]   = b;
+      c *= C[k];
+      b *= m_box_count[k];
+    }
+  }
+
+  // offset of the first element of the hyperslab in the box
+  size_t box_origin = 0;
+  for (int k = 0; k < n; ++k) {
+    box_origin += (S[k] - m_box_start[k]) * box_stride[k];
+  }
+
+  // iterate over all dimensions except for the last one (the "odometer" `index`); the
+  // last dimension is contiguous in the box
+  const size_t
+    N            = C[n - 1],
+    chunk_step   = chunk_stride[n - 1];
+  std::vector<unsigned int> index(n, 0);
+  while (true) {
+    size_t chunk_offset = 0, box_offset = box_origin;
+    for (int k = 0; k < n - 1; ++k) {
+      chunk_offset += index[k] * chunk_stride[k];
+      box_offset += index[k] * box_stride[k];
+    }
+
+    for (size_t m = 0; m < N; ++m) {
+      f(chunk_offset + m * chunk_step, box_offset + m);
+    }
+
+    int k = n - 2;
+    for (; k >= 0; --k) {
+      index[k] += 1;
+      if (index[k] < C[k]) {
+        break;
+      }
+      index[k] = 0;
+    }
+    if (k < 0) {
+      break;
+    }
+  }
+}
+
+} // end of anonymous namespace
+
+//! \brief Get variable data.
+/*!
+ * Rank 0 reads the bounding box of hyperslabs of all ranks using one NetCDF call and
+ * sends each rank its part using MPI_Scatterv().
+ *
+ * If all ranks read the same hyperslab, rank 0 reads it and broadcasts it (this avoids
+ * allocating a buffer for copies of the same data for all ranks).
+ *
+ * If hyperslabs cover less than half of their bounding box, rank 0 reads them one at a
+ * time instead.
+ */
+void NC_Serial::get_var_double(const std::string &variable_name,
+                               const std::vector<unsigned int> &start,
+                               const std::vector<unsigned int> &count,
+                               const std::vector<unsigned int> &imap, double *ip,
+                               bool transposed) const {
+  int stat = NC_NOERR;
+
+  Decomposition D(m_com, start, count, imap, transposed);
+
+  std::vector<double> chunks;
+
+  if (m_rank == 0) {
+    int varid = 0;
+    stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
+
+    // Use the stride of 1 instead of NULL to avoid a bug in some NetCDF versions.
+    std::vector<ptrdiff_t> stride(start.size(), 1);
+
+    // Hyperslabs that cover a small part of their bounding box (e.g. columns of a 3D
+    // field stored using the sparse encoding) are read one at a time.
+    const bool scattered = (not transposed and not D.replicated() and
+                            2 * D.total_size() < D.box_size());
+
+    std::vector<double> box(scattered ? 0 : D.box_size());
+
+    if (stat == NC_NOERR and D.box_size() > 0 and not scattered) {
+      stat = nc_get_vars_double(m_file_id, varid, D.box_start().data(), D.box_count().data(),
+                                stride.data(), box.data());
+    }
+
+    if (stat == NC_NOERR and scattered) {
+      chunks.resize(D.total_size());
+
+      int com_size = 0;
+      MPI_Comm_size(m_com, &com_size);
+
+      std::vector<size_t> nc_start, nc_count;
+      for (int r = 0; r < com_size and stat == NC_NOERR; ++r) {
+        if (D.size(r) == 0) {
+          continue;
         }
+        D.start(r, nc_start);
+        D.count(r, nc_count);
+
+        stat = nc_get_vars_double(m_file_id, varid, nc_start.data(), nc_count.data(),
+                                  stride.data(), chunks.data() + D.offsets()[r]);
       }
-    } // end of the for loop
+    } else if (stat == NC_NOERR and D.replicated()) {
+      D.for_each(0, [&](size_t c, size_t b) { ip[c] = box[b]; });
+    } else if (stat == NC_NOERR) {
+      chunks.resize(D.total_size());
+
+      int com_size = 0;
+      MPI_Comm_size(m_com, &com_size);
+      for (int r = 0; r < com_size; ++r) {
+        double *chunk = chunks.data() + D.offsets()[r];
+        D.for_each(r, [&](size_t c, size_t b) { chunk[c] = box[b]; });
+      }
+    }
+  }
 
-  } else {
-    MPI_Send(start.data(), ndims, MPI_UNSIGNED, 0, start_tag, m_com);
-    MPI_Send(count.data(), ndims, MPI_UNSIGNED, 0, count_tag, m_com);
-    MPI_Send(imap.data(), ndims, MPI_UNSIGNED, 0, imap_tag, m_com);
-    MPI_Send(&local_chunk_size, 1, MPI_UNSIGNED, 0, chunk_size_tag, m_com);
+  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  check(PISM_ERROR_LOCATION, stat);
+
+  int local_size = 1;
+  for (auto c : count) {
+    local_size *= static_cast<int>(c);
+  }
 
-    MPI_Recv(ip, (int)local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com, &mpi_stat);
+  if (D.replicated()) {
+    MPI_Bcast(ip, local_size, MPI_DOUBLE, 0, m_com);
+    return;
   }
+
+  MPI_Scatterv(chunks.data(), D.sizes().data(), D.offsets().data(), MPI_DOUBLE,
+               ip, local_size, MPI_DOUBLE, 0, m_com);
 }
 
+/*!
+ * Rank 0 gathers hyperslabs of all ranks using MPI_Gatherv() and writes them using one
+ * NetCDF call if they cover their bounding box. Otherwise (this does not happen when
+ * writing distributed fields) it writes each hyperslab separately.
+ *
+ * If all ranks write the same hyperslab (e.g. time or a scalar time series), rank 0
+ * writes its own data and nothing is gathered.
+ */
 void NC_Serial::put_vara_double_impl(const std::string &variable_name,
-                                     const std::vector<unsigned int> &start_input,
-                                     const std::vector<unsigned int> &count_input,
+                                     const std::vector<unsigned int> &start,
+                                     const std::vector<unsigned int> &count,
                                      const double *op) const {
-  // make copies of start and count so that we can use them in MPI_Recv() calls below
-  std::vector<unsigned int> start = start_input;
-  std::vector<unsigned int> count = count_input;
-  const int start_tag = 1, count_tag = 2, data_tag = 3, chunk_size_tag = 4;
-  int stat = NC_NOERR, com_size = 0, ndims = static_cast<int>(start.size());
-  MPI_Status mpi_stat;
-  unsigned int local_chunk_size = 1, processor_0_chunk_size = 0;
-
-  // get the size of the communicator
-  MPI_Comm_size(m_com, &com_size);
-
-  // compute the size of a local chunk
-  for (int k = 0; k < ndims; ++k) {
-    local_chunk_size *= count[k];
+  int stat = NC_NOERR;
+
+  Decomposition D(m_com, start, count, {}, false);
+
+  int local_size = 1;
+  for (auto c : count) {
+    local_size *= static_cast<int>(c);
   }
 
-  // compute the maximum and send it to processor 0; this is the size of the
-  // buffer processor 0 will need
-  MPI_Reduce(&local_chunk_size, &processor_0_chunk_size, 1, MPI_UNSIGNED, MPI_MAX, 0, m_com);
+  if (D.replicated()) {
+    if (m_rank == 0) {
+      int varid = 0;
+      stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
+
+      if (stat == NC_NOERR and local_size > 0) {
+        std::vector<size_t> nc_start(start.begin(), start.end()),
+          nc_count(count.begin(), count.end());
+        // Use the stride of 1 instead of NULL to avoid a bug in some NetCDF versions.
+        std::vector<ptrdiff_t> stride(start.size(), 1);
+
+        stat = nc_put_vars_double(m_file_id, varid, nc_start.data(), nc_count.data(),
+                                  stride.data(), op);
+      }
+    }
+
+    MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+    check(PISM_ERROR_LOCATION, stat);
+    return;
+  }
 
-  // now we need to send start and count data to processor 0 and receive data
+  std::vector<double> chunks;
   if (m_rank == 0) {
-    std::vector<double> processor_0_buffer;
-    processor_0_buffer.resize(processor_0_chunk_size);
+    chunks.resize(D.total_size());
+  }
 
-    // MPI calls below require C datatypes (so that we don't have to worry about sizes of
-    // size_t and ptrdiff_t), so we make local copies of start and count to use in the
-    // nc_get_vara_double() call.
-    std::vector<size_t> nc_start(ndims), nc_count(ndims);
-    std::vector<ptrdiff_t> nc_stride(ndims);
-    int varid;
+  MPI_Gatherv(const_cast<double *>(op), local_size, MPI_DOUBLE,
+              chunks.data(), D.sizes().data(), D.offsets().data(), MPI_DOUBLE, 0, m_com);
 
+  if (m_rank == 0) {
+    int varid = 0;
     stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
-    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
 
+    int com_size = 0;
+    MPI_Comm_size(m_com, &com_size);
+
+    std::vector<double> box(D.box_size());
+    std::vector<char> covered(D.box_size(), 0);
     for (int r = 0; r < com_size; ++r) {
+      const double *chunk = chunks.data() + D.offsets()[r];
+      D.for_each(r, [&](size_t c, size_t b) {
+        box[b]     = chunk[c];
+        covered[b] = 1;
+      });
+    }
 
-      if (r != 0) {
-        // Note: start, count, and local_chunk_size on processor zero are used *before*
-        // they get overwritten by these calls
-        MPI_Recv(start.data(), ndims, MPI_UNSIGNED, r, start_tag, m_com, &mpi_stat);
-        MPI_Recv(count.data(), ndims, MPI_UNSIGNED, r, count_tag, m_com, &mpi_stat);
-        MPI_Recv(&local_chunk_size, 1, MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
+    const bool whole_box = std::all_of(covered.begin(), covered.end(),
+                                       [](char c) { return c != 0; });
 
-        MPI_Recv(processor_0_buffer.data(), local_chunk_size, MPI_DOUBLE, r, data_tag, m_com,
-                 &mpi_stat);
-      } else {
-        for (unsigned int k = 0; k < local_chunk_size; ++k) {
-          processor_0_buffer[k] = op[k];
+    // Use the stride of 1 instead of NULL to avoid a bug in some NetCDF versions.
+    std::vector<ptrdiff_t> stride(start.size(), 1);
+
+    if (stat != NC_NOERR or D.box_size() == 0) {
+      // nothing to do
+    } else if (whole_box) {
+      stat = nc_put_vars_double(m_file_id, varid, D.box_start().data(),
+                                D.box_count().data(), stride.data(), box.data());
+    } else {
+      std::vector<size_t> nc_start, nc_count;
+      for (int r = 0; r < com_size and stat == NC_NOERR; ++r) {
+        if (D.size(r) == 0) {
+          continue;
         }
-      }
+        D.start(r, nc_start);
+        D.count(r, nc_count);
 
-      // This for loop uses start and count passed in as arguments when r == 0. For r > 0
-      // they are overwritten by MPI_Recv calls above.
-      for (int k = 0; k < ndims; ++k) {
-        nc_start[k]  = start[k];
-        nc_count[k]  = count[k];
-        nc_stride[k] = 1; // fill with ones; this way it works even with
-                          // NetCDF versions with a bug affecting the
-                          // stride == NULL case.
+        stat = nc_put_vars_double(m_file_id, varid, nc_start.data(), nc_count.data(),
+                                  stride.data(), chunks.data() + D.offsets()[r]);
       }
-
-      stat = nc_put_vara_double(m_file_id, varid, nc_start.data(), nc_count.data(),
-                                processor_0_buffer.data());
-      check(PISM_ERROR_LOCATION, stat);
-    } // end of the for loop
-  } else {
-    MPI_Send(start.data(), ndims, MPI_UNSIGNED, 0, start_tag, m_com);
-    MPI_Send(count.data(), ndims, MPI_UNSIGNED, 0, count_tag, m_com);
-    MPI_Send(&local_chunk_size, 1, MPI_UNSIGNED, 0, chunk_size_tag, m_com);
-
-    MPI_Send(const_cast<double *>(op), (int)local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com);
+    }
   }
+
+  MPI_Bcast(&stat, 1, MPI_INT, 0, m_com);
+  check(PISM_ERROR_LOCATION, stat);
 }
 
 //! \brief Get the number of variables.
 void NC_Serial::inq_nvars_impl(int &result) const {
+  if (m_header) {
+    result = static_cast<int>(m_header->variables.size());
+    return;
+  }
+
   int stat = NC_NOERR;
 
   if (m_rank == 0) {
@@ -487,6 +850,11 @@ void NC_Serial::inq_nvars_impl(int &result) const {
 //! \brief Get dimensions a variable depends on.
 void NC_Serial::inq_vardimid_impl(const std::string &variable_name,
                                   std::vector<std::string> &result) const {
+  if (m_header) {
+    result = m_header->get(variable_name).dimensions;
+    return;
+  }
+
   int stat, ndims, varid = -1;
   std::vector<int> dimids;
 
@@ -542,6 +910,11 @@ void NC_Serial::inq_vardimid_impl(const std::string &variable_name,
  * Use "PISM_GLOBAL" as the "variable_name" to get the number of global attributes.
  */
 void NC_Serial::inq_varnatts_impl(const std::string &variable_name, int &result) const {
+  if (m_header) {
+    result = static_cast<int>(m_header->get(variable_name).attribute_names.size());
+    return;
+  }
+
   int stat = NC_NOERR;
 
   if (m_rank == 0) {
@@ -563,6 +936,11 @@ void NC_Serial::inq_varnatts_impl(const std::string &variable_name, int &result)
 
 //! \brief Finds a variable and sets the "exists" flag.
 void NC_Serial::inq_varid_impl(const std::string &variable_name, bool &exists) const {
+  if (m_header) {
+    exists = m_header->varids.count(variable_name) > 0;
+    return;
+  }
+
   int stat, flag = -1;
 
   if (m_rank == 0) {
@@ -577,6 +955,14 @@ void NC_Serial::inq_varid_impl(const std::string &variable_name, bool &exists) c
 }
 
 void NC_Serial::inq_varname_impl(unsigned int j, std::string &result) const {
+  if (m_header) {
+    if (j >= m_header->variables.size()) {
+      check(PISM_ERROR_LOCATION, NC_ENOTVAR);
+    }
+    result = m_header->variables[j].name;
+    return;
+  }
+
   int stat = NC_NOERR;
   std::vector<char> varname(NC_MAX_NAME + 1, 0);
 
@@ -600,6 +986,22 @@ void NC_Serial::inq_varname_impl(unsigned int j, std::string &result) const {
  */
 void NC_Serial::get_att_double_impl(const std::string &variable_name, const std::string &att_name,
                                     std::vector<double> &result) const {
+  if (m_header) {
+    result.clear();
+
+    auto *var = m_header->find(variable_name);
+    if (var != nullptr) {
+      auto a = var->attributes.find(att_name);
+      if (a != var->attributes.end()) {
+        if (not a->second.text.empty()) {
+          check(PISM_ERROR_LOCATION, NC_ECHAR);
+        }
+        result = a->second.values;
+      }
+    }
+    return;
+  }
+
   int stat = NC_NOERR, len = 0;
 
   int varid = get_varid(variable_name);
@@ -698,6 +1100,14 @@ static int get_att_string(int ncid, int varid, const std::string &att_name, std:
  */
 void NC_Serial::get_att_text_impl(const std::string &variable_name, const std::string &att_name,
                                   std::string &result) const {
+  if (m_header) {
+    const auto &attributes = m_header->get(variable_name).attributes;
+
+    auto a = attributes.find(att_name);
+    result = a != attributes.end() ? a->second.text : "";
+    return;
+  }
+
   int stat = NC_NOERR;
 
   // Read and broadcast the attribute length:
@@ -796,6 +1206,15 @@ void NC_Serial::put_att_text_impl(const std::string &variable_name, const std::s
  */
 void NC_Serial::inq_attname_impl(const std::string &variable_name, unsigned int n,
                                  std::string &result) const {
+  if (m_header) {
+    const auto &names = m_header->get(variable_name).attribute_names;
+    if (n >= names.size()) {
+      check(PISM_ERROR_LOCATION, NC_ENOTATT);
+    }
+    result = names[n];
+    return;
+  }
+
   int stat = NC_NOERR;
   std::vector<char> name(NC_MAX_NAME + 1, 0);
 
@@ -824,6 +1243,14 @@ void NC_Serial::inq_attname_impl(const std::string &variable_name, unsigned int
  */
 void NC_Serial::inq_atttype_impl(const std::string &variable_name, const std::string &att_name,
                                  io::Type &result) const {
+  if (m_header) {
+    const auto &attributes = m_header->get(variable_name).attributes;
+
+    auto a = attributes.find(att_name);
+    result = nc_type_to_pism_type(a != attributes.end() ? a->second.type : NC_NAT);
+    return;
+  }
+
   int stat, tmp;
 
   if (m_rank == 0) {
@@ -908,6 +1335,363 @@ void NC_Serial::del_att_impl(const std::string &variable_name, const std::string
   check(PISM_ERROR_LOCATION, stat);
 }
 
+namespace {
+
+//! Serialization of the header of a NetCDF file.
+class Buffer {
+public:
+  Buffer() : m_position(0) {
+    // empty
+  }
+
+  Buffer(const std::vector<char> &data) : m_data(data), m_position(0) {
+    // empty
+  }
+
+  void put(unsigned int value) {
+    put_bytes(&value, sizeof(value));
+  }
+
+  void put(double value) {
+    put_bytes(&value, sizeof(value));
+  }
+
+  void put(const std::string &value) {
+    put(static_cast<unsigned int>(value.size()));
+    put_bytes(value.data(), value.size());
+  }
+
+  unsigned int get_unsigned() {
+    unsigned int result = 0;
+    get_bytes(&result, sizeof(result));
+    return result;
+  }
+
+  double get_double() {
+    double result = 0.0;
+    get_bytes(&result, sizeof(result));
+    return result;
+  }
+
+  std::string get_string() {
+    std::string result(get_unsigned(), '\0');
+    get_bytes(&result[0], result.size());
+    return result;
+  }
+
+  const std::vector<char> &data() const {
+    return m_data;
+  }
+
+private:
+  void put_bytes(const void *data, size_t size) {
+    auto N = m_data.size();
+    m_data.resize(N + size);
+    if (size > 0) {
+      memcpy(&m_data[N], data, size);
+    }
+  }
+
+  void get_bytes(void *data, size_t size) {
+    if (m_position + size > m_data.size()) {
+      throw RuntimeError(PISM_ERROR_LOCATION, "corrupted NetCDF header snapshot");
+    }
+    if (size > 0) {
+      memcpy(data, &m_data[m_position], size);
+    }
+    m_position += size;
+  }
+
+  std::vector<char> m_data;
+  size_t m_position;
+};
+
+} // end of anonymous namespace
+
+//! Read attributes of the variable `varid` on rank 0.
+int NC_Serial::Header::read_attributes(int ncid, int varid, Variable &variable) {
+  int natts = 0;
+  int stat = nc_inq_varnatts(ncid, varid, &natts);
+  if (stat != NC_NOERR) {
+    return stat;
+  }
+
+  for (int k = 0; k < natts; ++k) {
+    std::vector<char> name(NC_MAX_NAME + 1, 0);
+    stat = nc_inq_attname(ncid, varid, k, name.data());
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    Attribute a;
+    nc_type type = NC_NAT;
+    stat = nc_inq_atttype(ncid, varid, name.data(), &type);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+    a.type = type;
+
+    switch (type) {
+    case NC_CHAR:
+      stat = pism::io::get_att_text(ncid, varid, name.data(), a.text);
+      break;
+    case NC_STRING:
+      stat = pism::io::get_att_string(ncid, varid, name.data(), a.text);
+      break;
+    default:
+      {
+        size_t length = 0;
+        stat = nc_inq_attlen(ncid, varid, name.data(), &length);
+        if (stat == NC_NOERR) {
+          a.values.resize(length);
+          stat = nc_get_att_double(ncid, varid, name.data(), a.values.data());
+        }
+      }
+    }
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    variable.attribute_names.push_back(name.data());
+    variable.attributes[name.data()] = a;
+  }
+
+  return NC_NOERR;
+}
+
+//! Read the header of the file `ncid` on rank 0. Returns a NetCDF error code.
+int NC_Serial::Header::read(int ncid) {
+  int stat = NC_NOERR;
+
+  // dimensions
+  {
+    int ndims = 0;
+    stat = nc_inq_dimids(ncid, &ndims, NULL, 0);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    std::vector<int> dimids(ndims);
+    stat = nc_inq_dimids(ncid, &ndims, dimids.data(), 0);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    for (auto d : dimids) {
+      std::vector<char> name(NC_MAX_NAME + 1, 0);
+      size_t length = 0;
+      stat = nc_inq_dim(ncid, d, name.data(), &length);
+      if (stat != NC_NOERR) {
+        return stat;
+      }
+      dimensions[name.data()] = static_cast<unsigned int>(length);
+    }
+
+    int unlimdim = -1;
+    stat = nc_inq_unlimdim(ncid, &unlimdim);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    if (unlimdim != -1) {
+      std::vector<char> name(NC_MAX_NAME + 1, 0);
+      stat = nc_inq_dimname(ncid, unlimdim, name.data());
+      if (stat != NC_NOERR) {
+        return stat;
+      }
+      unlimited_dimension = name.data();
+    }
+  }
+
+  // variables
+  int nvars = 0;
+  stat = nc_inq_nvars(ncid, &nvars);
+  if (stat != NC_NOERR) {
+    return stat;
+  }
+
+  variables.resize(nvars);
+  for (int varid = 0; varid < nvars; ++varid) {
+    auto &variable = variables[varid];
+
+    std::vector<char> name(NC_MAX_NAME + 1, 0);
+    stat = nc_inq_varname(ncid, varid, name.data());
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+    variable.name = name.data();
+    varids[variable.name] = varid;
+
+    int ndims = 0;
+    stat = nc_inq_varndims(ncid, varid, &ndims);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    std::vector<int> dimids(ndims);
+    stat = nc_inq_vardimid(ncid, varid, dimids.data());
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+
+    for (auto d : dimids) {
+      std::vector<char> dimname(NC_MAX_NAME + 1, 0);
+      stat = nc_inq_dimname(ncid, d, dimname.data());
+      if (stat != NC_NOERR) {
+        return stat;
+      }
+      variable.dimensions.push_back(dimname.data());
+    }
+
+    stat = read_attributes(ncid, varid, variable);
+    if (stat != NC_NOERR) {
+      return stat;
+    }
+  }
+
+  global.name = "PISM_GLOBAL";
+  return read_attributes(ncid, NC_GLOBAL, global);
+}
+
+std::vector<char> NC_Serial::Header::serialize() const {
+  Buffer buffer;
+
+  auto put_variable = [&buffer](const Variable &v) {
+    buffer.put(v.name);
+
+    buffer.put(static_cast<unsigned int>(v.dimensions.size()));
+    for (const auto &d : v.dimensions) {
+      buffer.put(d);
+    }
+
+    buffer.put(static_cast<unsigned int>(v.attribute_names.size()));
+    for (const auto &name : v.attribute_names) {
+      const auto &a = v.attributes.at(name);
+
+      buffer.put(name);
+      buffer.put(static_cast<unsigned int>(a.type));
+      buffer.put(a.text);
+      buffer.put(static_cast<unsigned int>(a.values.size()));
+      for (auto x : a.values) {
+        buffer.put(x);
+      }
+    }
+  };
+
+  buffer.put(static_cast<unsigned int>(dimensions.size()));
+  for (const auto &d : dimensions) {
+    buffer.put(d.first);
+    buffer.put(d.second);
+  }
+  buffer.put(unlimited_dimension);
+
+  buffer.put(static_cast<unsigned int>(variables.size()));
+  for (const auto &v : variables) {
+    put_variable(v);
+  }
+  put_variable(global);
+
+  return buffer.data();
+}
+
+void NC_Serial::Header::deserialize(const std::vector<char> &data) {
+  Buffer buffer(data);
+
+  auto get_variable = [&buffer](Variable &v) {
+    v.name = buffer.get_string();
+
+    v.dimensions.resize(buffer.get_unsigned());
+    for (auto &d : v.dimensions) {
+      d = buffer.get_string();
+    }
+
+    v.attribute_names.resize(buffer.get_unsigned());
+    for (auto &name : v.attribute_names) {
+      name = buffer.get_string();
+
+      Attribute a;
+      a.type = static_cast<int>(buffer.get_unsigned());
+      a.text = buffer.get_string();
+      a.values.resize(buffer.get_unsigned());
+      for (auto &x : a.values) {
+        x = buffer.get_double();
+      }
+      v.attributes[name] = a;
+    }
+  };
+
+  unsigned int ndims = buffer.get_unsigned();
+  for (unsigned int k = 0; k < ndims; ++k) {
+    auto name = buffer.get_string();
+    dimensions[name] = buffer.get_unsigned();
+  }
+  unlimited_dimension = buffer.get_string();
+
+  variables.resize(buffer.get_unsigned());
+  for (unsigned int k = 0; k < variables.size(); ++k) {
+    get_variable(variables[k]);
+    varids[variables[k].name] = static_cast<int>(k);
+  }
+  get_variable(global);
+}
+
+//! Find a variable. Returns NULL if not found.
+const NC_Serial::Header::Variable *NC_Serial::Header::find(const std::string &variable_name) const {
+  if (variable_name == "PISM_GLOBAL") {
+    return &global;
+  }
+
+  auto v = varids.find(variable_name);
+  if (v == varids.end()) {
+    return nullptr;
+  }
+  return &variables[v->second];
+}
+
+//! Get a variable. Throws if not found.
+const NC_Serial::Header::Variable &NC_Serial::Header::get(const std::string &variable_name) const {
+  auto *result = find(variable_name);
+  if (result == nullptr) {
+    throw RuntimeError(PISM_ERROR_LOCATION, nc_strerror(NC_ENOTVAR));
+  }
+  return *result;
+}
+
+/*!
+ * Read the header of the file on rank 0 and broadcast it to all ranks using one
+ * MPI_Bcast() call.
+ *
+ * If reading the header fails metadata queries use NetCDF calls on rank 0 (one
+ * broadcast per query).
+ */
+void NC_Serial::read_header() {
+  std::vector<char> buffer;
+  int info[2] = {NC_NOERR, 0}; // NetCDF status and the buffer size
+
+  if (m_rank == 0) {
+    Header header;
+    info[0] = header.read(m_file_id);
+
+    if (info[0] == NC_NOERR) {
+      buffer  = header.serialize();
+      info[1] = static_cast<int>(buffer.size());
+    }
+  }
+
+  MPI_Bcast(info, 2, MPI_INT, 0, m_com);
+
+  if (info[0] != NC_NOERR) {
+    m_header.reset();
+    return;
+  }
+
+  buffer.resize(info[1]);
+  MPI_Bcast(buffer.data(), info[1], MPI_CHAR, 0, m_com);
+
+  m_header.reset(new Header());
+  m_header->deserialize(buffer);
+}
+
 /*!
  * return the varid corresponding to a variable.
  *
@@ -19,6 +19,8 @@
 #ifndef PISM_NC_SERIAL_H
 #define PISM_NC_SERIAL_H
 
+#include <memory>
+
 #include "pism/util/io/NCFile.hh"
 
 namespace pism {
@@ -111,6 +113,11 @@ protected:
   int get_varid(const std::string &variable_name) const;
 
 private:
+  struct Header;
+  //! Copy of the header of a file opened for reading (see read_header()).
+  mutable std::unique_ptr<Header> m_header;
+
+  void read_header();
 
   void get_var_double(const std::string &variable_name,
                      const std::vector<unsigned int> &start,
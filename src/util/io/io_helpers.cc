@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <memory>
 #include <array>
+#include <numeric>
 #include <vector>
 
 #include "pism/util/ConfigInterface.hh"
@@ -30,7 +31,9 @@
 #include "pism/util/Logger.hh"
 #include "pism/util/Profiling.hh"
 #include "pism/util/Time.hh"
+#include "pism/util/Vars.hh"
 #include "pism/util/VariableMetadata.hh"
+#include "pism/util/array/Scalar.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/interpolation.hh"
 #include "pism/util/io/File.hh"
@@ -59,8 +62,8 @@ namespace io {
  * We should be able to switch to using an external interpolation library
  * fairly easily...
  */
-static void regrid(const Grid &grid, const LocalInterpCtx &lic, double const *input_array,
-                   double *output_array) {
+void regrid(const Grid &grid, const LocalInterpCtx &lic, double const *input_array,
+            double *output_array) {
   // We'll work with the raw storage here so that the array we are filling is
   // indexed the same way as the buffer we are pulling from (input_array)
 
@@ -270,7 +273,7 @@ static void define_dimensions(const SpatialVariableMetadata &var, const Grid &gr
   // x
   std::string x_name = var.x().get_name();
   if (not file.find_dimension(x_name)) {
-    define_dimension(file, grid.Mx(), var.x());
+    define_dimension(file, grid.output_x().size(), var.x());
     file.write_attribute(x_name, "spacing_meters", PISM_DOUBLE, { grid.x(1) - grid.x(0) });
     file.write_attribute(x_name, "not_written", PISM_INT, { 1.0 });
   }
@@ -278,7 +281,7 @@ static void define_dimensions(const SpatialVariableMetadata &var, const Grid &gr
   // y
   std::string y_name = var.y().get_name();
   if (not file.find_dimension(y_name)) {
-    define_dimension(file, grid.My(), var.y());
+    define_dimension(file, grid.output_y().size(), var.y());
     file.write_attribute(y_name, "spacing_meters", PISM_DOUBLE, { grid.y(1) - grid.y(0) });
     file.write_attribute(y_name, "not_written", PISM_INT, { 1.0 });
   }
@@ -326,13 +329,13 @@ void write_dimensions(const SpatialVariableMetadata &var, const Grid &grid, cons
   // x
   std::string x_name = var.x().get_name();
   if (file.find_dimension(x_name)) {
-    write_dimension_data(file, x_name, grid.x());
+    write_dimension_data(file, x_name, grid.output_x());
   }
 
   // y
   std::string y_name = var.y().get_name();
   if (file.find_dimension(y_name)) {
-    write_dimension_data(file, y_name, grid.y());
+    write_dimension_data(file, y_name, grid.output_y());
   }
 
   // z
@@ -385,16 +388,514 @@ static bool use_transposed_io(std::vector<AxisType> dimension_types) {
 static std::vector<AxisType> dimension_types(const File &file, const std::string &var_name,
                                              std::shared_ptr<units::System> unit_system) {
   std::vector<AxisType> result;
-  for (const auto &dimension : file.dimensions(var_name)) {
+  for (const auto &dimension : uncompressed_dimensions(file, var_name)) {
     result.push_back(file.dimension_type(dimension, unit_system));
   }
   return result;
 }
 
+/*
+ * Sparse ("ice-only") encoding of 3D fields
+ *
+ * Values of a 3D field on the vertical grid used for ice are only meaningful in the ice,
+ * i.e. at levels `0, ..., kBelowHeight(H)` of a column with thickness `H`. This encoding
+ * stores these levels only, using a CF "contiguous ragged array":
+ *
+ * - `ice_column(ice_column)` contains indices `j * Mx + i` of stored columns (in the
+ *   sense of CF's "compression by gathering"),
+ * - `ice_column_count(ice_column)` contains numbers of stored levels in these columns,
+ * - a field `F` is stored as `F(time, ice_column_sample)`; levels of a column are
+ *   contiguous and columns are stored in the order of `ice_column`.
+ *
+ * The attribute `dense_dimensions` of `F` lists dimensions of the dense layout.
+ *
+ * All columns are stored, including ice-free ones (one level each): values in ice-free
+ * columns (e.g. the enthalpy at the ice surface temperature) are used after a restart and
+ * cannot be reconstructed by the reader. This costs two integers per column plus one
+ * value per field.
+ *
+ * Each process writes columns of its sub-domain, so all fields in a file share the
+ * layout. The layout depends on the ice thickness, so a file can contain one record
+ * only.
+ */
+
+static const std::string column_dimension = "ice_column";
+static const std::string sample_dimension = "ice_column_sample";
+static const std::string count_variable = "ice_column_count";
+static const std::string dense_dimensions_attribute = "dense_dimensions";
+//! NetCDF's default fill value for doubles (NC_FILL_DOUBLE)
+static const double default_fill_value = 9.9692099683868690e+36;
+
+//! NetCDF's default fill value for variables of type `type` (NC_FILL_BYTE, etc).
+static double default_fill_value_of(io::Type type) {
+  switch (type) {
+  case PISM_BYTE:
+    return -127.0;
+  case PISM_CHAR:
+    return 0.0;
+  case PISM_SHORT:
+    return -32767.0;
+  case PISM_INT:
+    return -2147483647.0;
+  case PISM_FLOAT:
+    return 9.9692099683868690e+36f;
+  default:
+    return default_fill_value;
+  }
+}
+
+//! Returns true if `variable_name` in `file` uses the sparse encoding.
+bool sparse_3d_variable(const File &file, const std::string &variable_name) {
+  return file.attribute_type(variable_name, dense_dimensions_attribute) == PISM_CHAR;
+}
+
+//! Names of dimensions of a variable (dimensions of the dense layout if it uses the
+//! sparse encoding).
+std::vector<std::string> uncompressed_dimensions(const File &file,
+                                                 const std::string &variable_name) {
+  if (sparse_3d_variable(file, variable_name)) {
+    return split(file.read_text_attribute(variable_name, dense_dimensions_attribute), ' ');
+  }
+  return file.dimensions(variable_name);
+}
+
+//! Returns true if `var` should be defined in `file` using the sparse encoding.
+static bool use_sparse_3d(const SpatialVariableMetadata &var, const Grid &grid,
+                          const File &file) {
+  if (not file.sparse_3d()) {
+    return false;
+  }
+
+  // PIO writes data provided by I/O tasks only, so processes cannot write their columns
+  switch (file.backend()) {
+  case PISM_PIO_PNETCDF:
+  case PISM_PIO_NETCDF:
+  case PISM_PIO_NETCDF4C:
+  case PISM_PIO_NETCDF4P:
+    return false;
+  default:
+    break;
+  }
+
+  // only fields on the vertical grid used for ice
+  if (var.z().get_name() != "z" or var.levels() != grid.z()) {
+    return false;
+  }
+
+  return grid.variables().is_available("land_ice_thickness");
+}
+
+//! Columns of the sub-domain of this process stored using the sparse encoding.
+struct SparseLayout {
+  //! number of stored levels in each column (storage order: `j`, `i`)
+  std::vector<int> counts;
+  //! index of the first column of this process
+  unsigned int column_start;
+  //! index of the first sample of this process
+  unsigned int sample_start;
+  //! number of samples of this process
+  unsigned int n_samples;
+  //! total number of samples
+  unsigned int total_samples;
+};
+
+static SparseLayout sparse_layout(const Grid &grid, unsigned int nlevels) {
+  SparseLayout result;
+
+  const auto &H = *grid.variables().get_2d_scalar("land_ice_thickness");
+
+  result.counts.resize(grid.xm() * grid.ym());
+
+  array::AccessScope list{ &H };
+
+  for (auto p = grid.points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    int k = H(i, j) >= grid.Lz() ? nlevels - 1 : grid.kBelowHeight(std::max(H(i, j), 0.0));
+
+    result.counts[(j - grid.ys()) * grid.xm() + (i - grid.xs())] = std::min(k + 1, (int)nlevels);
+  }
+
+  long long local[2] = { (long long)result.counts.size(),
+                         std::accumulate(result.counts.begin(), result.counts.end(), 0LL) };
+  long long start[2] = { 0, 0 }, total[2] = { 0, 0 };
+
+  MPI_Exscan(local, start, 2, MPI_LONG_LONG, MPI_SUM, grid.com);
+  MPI_Allreduce(local, total, 2, MPI_LONG_LONG, MPI_SUM, grid.com);
+
+  if (grid.rank() == 0) {
+    // the result of MPI_Exscan() is undefined on rank 0
+    start[0] = 0;
+    start[1] = 0;
+  }
+
+  result.column_start  = start[0];
+  result.sample_start  = start[1];
+  result.n_samples     = local[1];
+  result.total_samples = total[1];
+
+  return result;
+}
+
+//! Define dimensions and variables describing columns stored using the sparse encoding.
+static void define_sparse_layout(const SpatialVariableMetadata &var, const Grid &grid,
+                                 const File &file) {
+  if (file.find_dimension(column_dimension)) {
+    return;
+  }
+
+  auto layout = sparse_layout(grid, var.levels().size());
+
+  file.define_dimension(column_dimension, grid.Mx() * grid.My());
+  file.define_dimension(sample_dimension, layout.total_samples);
+
+  file.define_variable(column_dimension, PISM_INT, { column_dimension });
+  file.write_attribute(column_dimension, "long_name", "index j * Mx + i of a stored column");
+  file.write_attribute(column_dimension, "compress",
+                       var.y().get_name() + " " + var.x().get_name());
+  file.write_attribute(column_dimension, "not_written", PISM_INT, { 1.0 });
+
+  file.define_variable(count_variable, PISM_INT, { column_dimension });
+  file.write_attribute(count_variable, "long_name", "number of stored levels in a column");
+  file.write_attribute(count_variable, "sample_dimension", sample_dimension);
+}
+
+//! Write indices and level counts of columns (once per file).
+/*!
+ * If they were written already, check that level counts in `file` match `layout`.
+ */
+static void write_sparse_layout(const Grid &grid, const File &file,
+                                const SparseLayout &layout) {
+  if (file.attribute_type(column_dimension, "not_written") == PISM_NAT) {
+    const unsigned int n_columns = layout.counts.size();
+
+    std::vector<double> stored(n_columns);
+    file.read_variable(count_variable, { layout.column_start }, { n_columns }, stored.data());
+
+    double changed = 0.0;
+    for (unsigned int c = 0; c < n_columns; ++c) {
+      if ((int)stored[c] != layout.counts[c]) {
+        changed = 1.0;
+        break;
+      }
+    }
+
+    if (GlobalMax(grid.com, changed) > 0.0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot write to '%s': the ice thickness changed"
+                                    " after the sparse layout was written",
+                                    file.filename().c_str());
+    }
+    return;
+  }
+
+  const int Mx = grid.output_x().size(), xm = grid.xm(), ym = grid.ym();
+
+  std::vector<double> index(xm * ym), count(xm * ym);
+  for (int j = 0; j < ym; ++j) {
+    for (int i = 0; i < xm; ++i) {
+      const int c = j * xm + i;
+      index[c] = (grid.output_ys() + j) * Mx + (grid.output_xs() + i);
+      count[c] = layout.counts[c];
+    }
+  }
+
+  const unsigned int n_columns = index.size();
+
+  file.write_variable(column_dimension, { layout.column_start }, { n_columns }, index.data());
+  file.write_variable(count_variable, { layout.column_start }, { n_columns }, count.data());
+
+  file.redef();
+  file.remove_attribute(column_dimension, "not_written");
+}
+
+//! Write a 3D field using the sparse encoding.
+static void write_sparse_variable(const SpatialVariableMetadata &var, const Grid &grid,
+                                  const File &file, unsigned int nlevels, const double *input) {
+  auto name   = var.get_name();
+  auto layout = sparse_layout(grid, nlevels);
+
+  if (layout.total_samples != file.dimension_length(sample_dimension)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot write '%s' to '%s': the ice thickness changed"
+                                  " after the sparse layout was defined",
+                                  name.c_str(), file.filename().c_str());
+  }
+
+  write_sparse_layout(grid, file, layout);
+
+  std::vector<double> packed;
+  packed.reserve(layout.n_samples);
+  for (size_t c = 0; c < layout.counts.size(); ++c) {
+    for (int k = 0; k < layout.counts[c]; ++k) {
+      packed.push_back(input[c * nlevels + k]);
+    }
+  }
+
+  units::Converter(var.unit_system(), var["units"], var["output_units"])
+      .convert_doubles(packed.data(), packed.size());
+
+  auto dims = file.dimensions(name);
+  if (dims.size() == 2) {
+    // time-dependent
+    auto n_records = file.dimension_length(dims[0]);
+    if (n_records != 1) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot write '%s' to '%s': the sparse encoding supports"
+                                    " files containing one record only (got %d)",
+                                    name.c_str(), file.filename().c_str(), (int)n_records);
+    }
+    file.write_variable(name, { 0, layout.sample_start }, { 1, layout.n_samples },
+                        packed.data());
+  } else {
+    file.write_variable(name, { layout.sample_start }, { layout.n_samples }, packed.data());
+  }
+}
+
+/*!
+ * Read the part of the sparse layout in `file` assigned to this process and send
+ * descriptions of stored columns to processes that need them.
+ *
+ * Process `r` needs columns in the box `boxes[4*r ... 4*r + 3]` (x start, x count, y
+ * start, y count) of the (y, x) grid containing `Mx` columns in each row.
+ *
+ * Returns (index, number of levels, index of the first sample) for each column in the
+ * box of this process, sorted by the index of the first sample.
+ *
+ * Each process reads an equal share of `ice_column` and `ice_column_count`, so the memory
+ * needed does not depend on the decomposition used to write `file`.
+ */
+static std::vector<long long> sparse_columns(const File &file, int Mx,
+                                             const std::vector<int> &boxes) {
+  MPI_Comm com = file.com();
+  int rank = 0, size = 1;
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &size);
+
+  const long long n_columns = file.dimension_length(column_dimension);
+
+  // read this process' share of the layout...
+  const long long
+    share_start = n_columns * rank / size,
+    share_end   = n_columns * (rank + 1) / size;
+  const unsigned int share_size = share_end - share_start;
+
+  std::vector<double> index(share_size), counts(share_size);
+  file.read_variable(column_dimension, { (unsigned int)share_start }, { share_size },
+                     index.data());
+  file.read_variable(count_variable, { (unsigned int)share_start }, { share_size },
+                     counts.data());
+
+  // ... compute the offset of its first sample...
+  long long local_samples = 0;
+  for (auto c : counts) {
+    local_samples += (long long)c;
+  }
+
+  long long offset = 0;
+  MPI_Exscan(&local_samples, &offset, 1, MPI_LONG_LONG, MPI_SUM, com);
+  if (rank == 0) {
+    // the result of MPI_Exscan() is undefined on rank 0
+    offset = 0;
+  }
+
+  // ... and send columns to processes that need them
+  std::vector<std::vector<long long> > outgoing(size);
+  for (unsigned int c = 0; c < share_size; ++c) {
+    const int
+      i = (int)index[c] % Mx,
+      j = (int)index[c] / Mx;
+
+    for (int r = 0; r < size; ++r) {
+      const int *box = &boxes[4 * r];
+      if (i >= box[0] and i < box[0] + box[1] and j >= box[2] and j < box[2] + box[3]) {
+        outgoing[r].insert(outgoing[r].end(), { (long long)index[c], (long long)counts[c], offset });
+      }
+    }
+    offset += (long long)counts[c];
+  }
+
+  std::vector<int> send_counts(size), send_offsets(size), recv_counts(size), recv_offsets(size);
+  std::vector<long long> send_buffer;
+  for (int r = 0; r < size; ++r) {
+    send_counts[r]  = outgoing[r].size();
+    send_offsets[r] = send_buffer.size();
+    send_buffer.insert(send_buffer.end(), outgoing[r].begin(), outgoing[r].end());
+  }
+
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, com);
+
+  int recv_size = 0;
+  for (int r = 0; r < size; ++r) {
+    recv_offsets[r] = recv_size;
+    recv_size += recv_counts[r];
+  }
+
+  std::vector<long long> columns(recv_size);
+  MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_offsets.data(), MPI_LONG_LONG,
+                columns.data(), recv_counts.data(), recv_offsets.data(), MPI_LONG_LONG, com);
+
+  // columns are received in the storage order of each sender and senders are ordered by
+  // rank, so they are sorted by the index of the first sample already
+
+  return columns;
+}
+
+/*!
+ * Read a box of a 3D field stored using the sparse encoding, restoring the dense layout.
+ *
+ * `start` and `count` are indexed by axis types (see compute_start_and_count()); `output`
+ * uses the storage order (y, x, z).
+ *
+ * Levels above the top of a stored column get the value at the top. Columns that are not
+ * stored get the fill value.
+ *
+ * Each process reads samples of columns in its box only, using one call for each run of
+ * consecutive columns in the file.
+ */
+static void read_sparse_variable(const File &file, const std::string &var_name,
+                                 units::System::Ptr unit_system, std::array<int, 4> start,
+                                 std::array<int, 4> count, double *output) {
+
+  if (count[T_AXIS] > 1) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot read more than one record of '%s': it uses the"
+                                  " sparse encoding",
+                                  var_name.c_str());
+  }
+
+  // the number of columns in the (y, x) grid of the file
+  int Mx = 0;
+  for (const auto &d : uncompressed_dimensions(file, var_name)) {
+    if (file.dimension_type(d, unit_system) == X_AXIS) {
+      Mx = file.dimension_length(d);
+    }
+  }
+
+  if (Mx == 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "'%s' does not depend on x",
+                                  var_name.c_str());
+  }
+
+  const int
+    x_start = start[X_AXIS],
+    x_count = count[X_AXIS],
+    y_start = start[Y_AXIS],
+    y_count = count[Y_AXIS],
+    z_start = start[Z_AXIS],
+    z_count = count[Z_AXIS];
+
+  // boxes of all processes
+  std::vector<int> boxes;
+  {
+    int size = 1;
+    MPI_Comm_size(file.com(), &size);
+
+    int box[4] = { x_start, x_count, y_start, y_count };
+    boxes.resize(4 * size);
+    MPI_Allgather(box, 4, MPI_INT, boxes.data(), 4, MPI_INT, file.com());
+  }
+
+  // (index, number of levels, first sample) of columns in the box of this process
+  auto columns = sparse_columns(file, Mx, boxes);
+  const size_t n_columns = columns.size() / 3;
+
+  // runs of columns stored next to each other: (first column, first sample, number of
+  // samples)
+  std::vector<std::array<long long, 3> > runs;
+  int invalid_column = -1;
+  for (size_t n = 0; n < n_columns; ++n) {
+    const long long column_count = columns[3 * n + 1], first_sample = columns[3 * n + 2];
+
+    if (column_count < 1) {
+      invalid_column = columns[3 * n];
+    }
+
+    if (not runs.empty() and runs.back()[1] + runs.back()[2] == first_sample) {
+      runs.back()[2] += column_count;
+    } else {
+      runs.push_back({ (long long)n, first_sample, column_count });
+    }
+  }
+
+  double fill_value = default_fill_value;
+  {
+    auto attribute = file.read_double_attribute(var_name, "_FillValue");
+    if (attribute.size() == 1) {
+      fill_value = attribute[0];
+    }
+  }
+
+  const size_t size = (size_t)x_count * y_count * z_count;
+  for (size_t k = 0; k < size; ++k) {
+    output[k] = fill_value;
+  }
+
+  const bool time_dependent = file.dimensions(var_name).size() == 2;
+
+  // reading is collective: all processes have to make the same number of calls (and
+  // stop if any of them found an invalid column)
+  int n_reads = 0;
+  {
+    int local[2] = { (int)runs.size(), invalid_column }, result[2] = { 0, -1 };
+    GlobalMax(file.com(), local, result, 2);
+
+    if (result[1] >= 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "invalid number of levels in the column %d of '%s'",
+                                    result[1], var_name.c_str());
+    }
+    n_reads = result[0];
+  }
+
+  std::vector<double> packed;
+  for (int r = 0; r < n_reads; ++r) {
+    unsigned int first_sample = 0, n_samples = 0;
+    if (r < (int)runs.size()) {
+      first_sample = runs[r][1];
+      n_samples    = runs[r][2];
+    }
+
+    packed.resize(n_samples);
+    if (time_dependent) {
+      file.read_variable(var_name, { (unsigned int)start[T_AXIS], first_sample },
+                         { 1, n_samples }, packed.data());
+    } else {
+      file.read_variable(var_name, { first_sample }, { n_samples }, packed.data());
+    }
+
+    if (r >= (int)runs.size()) {
+      continue;
+    }
+
+    const size_t run_end = (r + 1 < (int)runs.size()) ? runs[r + 1][0] : n_columns;
+    for (size_t n = runs[r][0]; n < run_end; ++n) {
+      const long long index = columns[3 * n];
+      const int
+        i         = (int)(index % Mx) - x_start,
+        j         = (int)(index / Mx) - y_start,
+        top_level = (int)columns[3 * n + 1] - 1;
+
+      const double *column = &packed[columns[3 * n + 2] - first_sample];
+
+      for (int k = 0; k < z_count; ++k) {
+        output[(j * x_count + i) * z_count + k] = column[std::min(z_start + k, top_level)];
+      }
+    }
+  }
+}
+
 //! \brief Read an array distributed according to the grid.
 static void read_distributed_array(const File &file, const Grid &grid, const std::string &var_name,
                                    unsigned int z_count, unsigned int t_start, double *output) {
   try {
+    if (sparse_3d_variable(file, var_name)) {
+      read_sparse_variable(file, var_name, grid.ctx()->unit_system(),
+                           { (int)t_start, grid.xs(), grid.ys(), 0 },
+                           { 1, grid.xm(), grid.ym(), (int)z_count }, output);
+      return;
+    }
+
     auto dim_types = dimension_types(file, var_name, grid.ctx()->unit_system());
 
     auto sc = compute_start_and_count(dim_types,
@@ -427,16 +928,23 @@ static std::vector<double> read_for_interpolation(const File &file,
   try {
     auto unit_system = internal_grid.ctx()->unit_system();
 
-    std::vector<double> buffer(lic.buffer_size());
+    // note: lic.count[T_AXIS] consecutive records are read using one call
+    std::vector<double> buffer(lic.buffer_size() * std::max(lic.count[T_AXIS], 1));
 
-    auto dim_types = dimension_types(file, variable_name, internal_grid.ctx()->unit_system());
+    if (sparse_3d_variable(file, variable_name)) {
+      read_sparse_variable(file, variable_name, unit_system, lic.start, lic.count,
+                           buffer.data());
+    } else {
+      auto dim_types = dimension_types(file, variable_name, unit_system);
 
-    auto sc = compute_start_and_count(dim_types, lic.start, lic.count);
+      auto sc = compute_start_and_count(dim_types, lic.start, lic.count);
 
-    if (use_transposed_io(dim_types)) {
-      file.read_variable_transposed(variable_name, sc.start, sc.count, sc.imap, buffer.data());
-    } else {
-      file.read_variable(variable_name, sc.start, sc.count, buffer.data());
+      if (use_transposed_io(dim_types)) {
+        file.read_variable_transposed(variable_name, sc.start, sc.count, sc.imap,
+                                      buffer.data());
+      } else {
+        file.read_variable(variable_name, sc.start, sc.count, buffer.data());
+      }
     }
 
     // Stop with an error message if some values match the _FillValue attribute:
@@ -499,14 +1007,46 @@ void define_spatial_variable(const SpatialVariableMetadata &metadata, const Grid
 
   assert(dims.size() > 1);
 
+  // dimensions of the dense layout (used if this variable uses the sparse encoding)
+  auto dense_dims = dims;
+  bool sparse     = use_sparse_3d(var, grid, file);
+  if (sparse) {
+    define_sparse_layout(var, grid, file);
+
+    dims.clear();
+    if (not var.get_time_independent()) {
+      dims.push_back(config->get_string("time.dimension_name"));
+    }
+    dims.push_back(sample_dimension);
+  }
+
   io::Type type = var.get_output_type();
   if (type == PISM_NAT) {
     type = default_type;
   }
+
+  const bool partial = (grid.output_x().size() != grid.Mx() or
+                        grid.output_y().size() != grid.My());
+  if (partial) {
+    // Only the part of this variable covered by the grid is written (see
+    // Grid::set_output_domain()). Make sure that the rest contains fill values.
+    file.set_fill(io::PISM_FILL);
+  }
+
   file.define_variable(name, type, dims);
 
   write_attributes(file, var, type);
 
+  if (partial and not var.has_attribute("_FillValue")) {
+    // Record the fill value so that reading the part that was not written (e.g. to
+    // re-start from this file) stops with an error instead of using fill values as data.
+    file.write_attribute(name, "_FillValue", type, {default_fill_value_of(type)});
+  }
+
+  if (sparse) {
+    file.write_attribute(name, dense_dimensions_attribute, join(dense_dims, " "));
+  }
+
   // add the "grid_mapping" attribute if the grid has an associated mapping. Variables lat, lon,
   // lat_bnds, and lon_bnds should not have the grid_mapping attribute to support CDO (see issue
   // #384).
@@ -551,7 +1091,7 @@ void read_spatial_variable(const SpatialVariableMetadata &variable, const Grid &
     int input_spatial_dim_count = 0; // number of spatial dimensions (input file)
     size_t matching_dim_count   = 0; // number of matching dimensions
 
-    auto input_dims = file.dimensions(var.name);
+    auto input_dims = uncompressed_dimensions(file, var.name);
     for (const auto &d : input_dims) {
       auto dim_type = file.dimension_type(d, variable.unit_system());
 
@@ -658,6 +1198,11 @@ void write_spatial_variable(const SpatialVariableMetadata &metadata, const Grid
   // make sure we have at least one level
   unsigned int nlevels = std::max(var.levels().size(), (size_t)1);
 
+  if (sparse_3d_variable(file, name)) {
+    write_sparse_variable(var, grid, file, nlevels, input);
+    return;
+  }
+
   std::string units = var["units"], output_units = var["output_units"];
 
   if (units != output_units) {
@@ -779,6 +1324,32 @@ void check_input_grid(const grid::InputGridInfo &input_grid,
   }
 }
 
+/*!
+ * Returns units of `variable_name` in `file`.
+ *
+ * Assumes that the variable uses internal units of `variable` if it does not have the units
+ * attribute.
+ */
+static std::string input_units(const File &file,
+                               const std::string &variable_name,
+                               const SpatialVariableMetadata &variable,
+                               const Grid &internal_grid) {
+  std::string input_units    = file.read_text_attribute(variable_name, "units");
+  std::string internal_units = variable["units"];
+
+  if (input_units.empty() and not internal_units.empty()) {
+    const Logger &log = *internal_grid.ctx()->log();
+    log.message(2,
+                "PISM WARNING: Variable '%s' ('%s') does not have the units attribute.\n"
+                "              Assuming that it is in '%s'.\n",
+                variable.get_name().c_str(), variable.get_string("long_name").c_str(),
+                internal_units.c_str());
+    return internal_units;
+  }
+
+  return input_units;
+}
+
 //! \brief Regrid from a NetCDF file into a distributed array `output`.
 /*!
   - if `flag` is `CRITICAL` or `CRITICAL_FILL_MISSING`, stops if the
@@ -809,31 +1380,107 @@ void regrid_spatial_variable(SpatialVariableMetadata &variable,
   regrid(internal_grid, lic, buffer.data(), output);
   profiling.end("io.regridding.interpolate");
 
-  // Get the units string from the file and convert the units:
+  // Convert data:
   {
-    std::string input_units    = file.read_text_attribute(variable_name, "units");
-    std::string internal_units = variable["units"];
-
-    if (input_units.empty() and not internal_units.empty()) {
-      const Logger &log = *internal_grid.ctx()->log();
-      log.message(2,
-                  "PISM WARNING: Variable '%s' ('%s') does not have the units attribute.\n"
-                  "              Assuming that it is in '%s'.\n",
-                  variable.get_name().c_str(), variable.get_string("long_name").c_str(),
-                  internal_units.c_str());
-      input_units = internal_units;
-    }
-
     const size_t data_size = internal_grid.xm() * internal_grid.ym() * lic.z->n_output();
 
-    // Convert data:
-    units::Converter(variable.unit_system(), input_units, internal_units)
+    units::Converter(variable.unit_system(),
+                     input_units(file, variable_name, variable, internal_grid),
+                     variable["units"])
         .convert_doubles(output, data_size);
   }
 
   read_valid_range(file, variable_name, variable);
 }
 
+//! \brief Regrid `lic.count[T_AXIS]` consecutive records of a 2D variable starting at
+//! `lic.start[T_AXIS]`.
+/*!
+ * Reads all the records using *one* call (i.e. one collective operation when using a
+ * parallel I/O backend) and converts units of the whole block at once.
+ *
+ * The record `n` at the grid point `(i, j)` is stored in
+ *
+ * `output[((j - ys) * xm + (i - xs)) * stride + n]`,
+ *
+ * i.e. `output` is expected to have the layout of a non-ghosted Vec with `stride` degrees of
+ * freedom (the storage used by array::Forcing).
+ */
+void regrid_records(SpatialVariableMetadata &variable,
+                    const Grid &internal_grid,
+                    const LocalInterpCtx &lic, const File &file,
+                    unsigned int stride,
+                    double *output) {
+
+  const int n_records = lic.count[T_AXIS];
+
+  if (lic.z->n_output() != 1) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot read multiple records of a 3D variable '%s'",
+                                  variable.get_name().c_str());
+  }
+
+  if (n_records < 1 or n_records > (int)stride) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid number of records to read: %d (stride: %d)",
+                                  n_records, (int)stride);
+  }
+
+  auto var_info = file.find_variable(variable.get_name(), variable["standard_name"]);
+  auto variable_name = var_info.name;
+
+  const Profiling &profiling = internal_grid.ctx()->profiling();
+
+  profiling.begin("io.regridding.read");
+  auto buffer = read_for_interpolation(file, variable_name, internal_grid, lic);
+  profiling.end("io.regridding.read");
+
+  // Convert data. Note that unit conversions are affine and interpolation weights add up
+  // to 1, so converting before interpolating is equivalent to converting after.
+  units::Converter(variable.unit_system(),
+                   input_units(file, variable_name, variable, internal_grid),
+                   variable["units"])
+      .convert_doubles(buffer.data(), buffer.size());
+
+  // interpolate
+  profiling.begin("io.regridding.interpolate");
+  {
+    // size of one record in the buffer
+    const int record_size = lic.buffer_size();
+    const int x_count     = lic.count[X_AXIS];
+
+    for (auto p = internal_grid.points(); p; p.next()) {
+      const int i = p.i() - internal_grid.xs(), j = p.j() - internal_grid.ys();
+
+      // Indices of neighboring points.
+      const int
+        mm = lic.y->left(j) * x_count + lic.x->left(i),
+        mp = lic.y->left(j) * x_count + lic.x->right(i),
+        pm = lic.y->right(j) * x_count + lic.x->left(i),
+        pp = lic.y->right(j) * x_count + lic.x->right(i);
+
+      const double x_alpha = lic.x->alpha(i), y_alpha = lic.y->alpha(j);
+
+      double *result = &output[(j * internal_grid.xm() + i) * stride];
+
+      for (int n = 0; n < n_records; ++n) {
+        const double *input = &buffer[n * record_size];
+
+        // interpolate in x direction
+        const double
+          a_m = input[mm] * (1.0 - x_alpha) + input[mp] * x_alpha,
+          a_p = input[pm] * (1.0 - x_alpha) + input[pp] * x_alpha;
+
+        // interpolate in y direction
+        result[n] = a_m * (1.0 - y_alpha) + a_p * y_alpha;
+      }
+    }
+  }
+  profiling.end("io.regridding.interpolate");
+
+  read_valid_range(file, variable_name, variable);
+}
+
 
 //! Define a NetCDF variable corresponding to a time-series.
 void define_timeseries(const VariableMetadata &var, const std::string &dimension_name,
@@ -55,12 +55,22 @@ void check_input_grid(const grid::InputGridInfo &input_grid,
                       const Grid& internal_grid,
                       const std::vector<double> &internal_z_levels);
 
+void regrid(const Grid &grid, const LocalInterpCtx &lic, double const *input_array,
+            double *output_array);
+
 void regrid_spatial_variable(SpatialVariableMetadata &variable,
                              const Grid& internal_grid,
                              const LocalInterpCtx &lic,
                              const File &file,
                              double *output);
 
+void regrid_records(SpatialVariableMetadata &variable,
+                    const Grid& internal_grid,
+                    const LocalInterpCtx &lic,
+                    const File &file,
+                    unsigned int stride,
+                    double *output);
+
 void read_spatial_variable(const SpatialVariableMetadata &variable,
                            const Grid& grid, const File &file,
                            unsigned int time, double *output);
@@ -84,6 +94,11 @@ void define_spatial_variable(const SpatialVariableMetadata &metadata,
                              const Grid &grid, const File &file,
                              io::Type default_type);
 
+bool sparse_3d_variable(const File &file, const std::string &variable_name);
+
+std::vector<std::string> uncompressed_dimensions(const File &file,
+                                                 const std::string &variable_name);
+
 void define_timeseries(const VariableMetadata& var,
                        const std::string &dimension_name,
                        const File &nc, io::Type nctype);
@@ -9,6 +9,7 @@ first-order Stokes approximation ice sheet solver built for advanced analysis
 """
 
 from unittest import TestCase
+import time
 
 import PISM
 import PISM.util
@@ -965,6 +966,130 @@ class TestXZHalfar(TestCase):
         f.line(Mzs, fit, legend_label=f"O(Mz^{p[0]:1.2f})")
         show(f)
 
+class TestIceOnly(TestCase):
+    "Compare solutions computed with and without stress_balance.blatter.ice_only"
+    def setUp(self):
+        self.R0 = 50e3
+        self.H0 = 1000.0
+
+        self.opt = PISM.PETSc.Options()
+
+        self.opts = {"-bp_ksp_type": "gmres",
+                     "-bp_pc_type": "mg",
+                     "-bp_pc_mg_levels": "3",
+                     "-bp_snes_rtol": "1e-12",
+                     "-bp_snes_atol": "1e-16",
+                     "-bp_ksp_rtol": "1e-12"}
+
+        for k, v in self.opts.items():
+            self.opt.setValue(k, v)
+
+        # Set sliding law parameters to make "tauc" equivalent to "beta"
+        config.set_flag("basal_resistance.pseudo_plastic.enabled", True)
+        config.set_number("basal_resistance.pseudo_plastic.q", 1.0)
+        config.set_number("basal_resistance.pseudo_plastic.u_threshold",
+                          PISM.util.convert(1.0, "m / s", "m / year"))
+
+    def tearDown(self):
+        for k in self.opts.keys():
+            self.opt.delValue(k)
+        config.import_from(config_clean)
+
+    def grid(self, Mx):
+        # the domain extends past the ice margin at x = R0, so that it contains ice-free
+        # columns
+        Lx = 0.75 * self.R0
+        dx = (2 * Lx) / (Mx - 1)
+
+        P = PISM.GridParameters(config)
+
+        P.Lx = Lx
+        P.Mx = Mx
+        P.x0 = Lx
+
+        P.Ly = dx
+        P.My = 3
+        P.y0 = 0.0
+
+        P.z = PISM.DoubleVector([0.0, self.H0])
+        P.registration = PISM.CELL_CORNER
+        P.periodicity = PISM.Y_PERIODIC
+        P.ownership_ranges_from_options(ctx.size)
+
+        return PISM.Grid(ctx.ctx, P)
+
+    def compute(self, grid, ice_only):
+        config.set_flag("stress_balance.blatter.ice_only", ice_only)
+
+        tauc = PISM.Scalar(grid, "tauc")
+        tauc.set(1e10)
+
+        enthalpy = PISM.Array3D(grid, "enthalpy", PISM.WITHOUT_GHOSTS, grid.z())
+        enthalpy.set(0.0)
+
+        Mz = 5
+        coarsening_factor = 2
+        model = PISM.Blatter(grid, Mz, coarsening_factor)
+
+        geometry = PISM.Geometry(grid)
+
+        with PISM.vec.Access(geometry.ice_thickness):
+            for (i, j) in grid.points():
+                x = grid.x(i) / self.R0
+                geometry.ice_thickness[i, j] = self.H0 * np.sqrt(max(1.0 - x**2, 0.0))
+
+        geometry.bed_elevation.set(0.0)
+        geometry.sea_level_elevation.set(-1000.0)
+        geometry.ensure_consistency(0.0)
+
+        model.init()
+
+        inputs = PISM.StressBalanceInputs()
+        inputs.geometry = geometry
+        inputs.basal_yield_stress = tauc
+        inputs.enthalpy = enthalpy
+
+        start = time.perf_counter()
+        model.update(inputs, True)
+        self.elapsed = time.perf_counter() - start
+
+        return model
+
+    def test_cost(self):
+        "Compare iteration counts and solve times with and without preconditioning icy columns only"
+
+        grid = self.grid(81)
+
+        stats = {}
+        for ice_only in [False, True]:
+            model = self.compute(grid, ice_only)
+            stats[ice_only] = (model.snes_iterations(), model.ksp_iterations(), self.elapsed)
+
+        for ice_only, (snes_it, ksp_it, elapsed) in stats.items():
+            print(f"ice_only = {ice_only}: SNES {snes_it}, KSP {ksp_it}, {elapsed:.3f} s")
+
+        # restricting the preconditioner does not change the nonlinear problem
+        assert abs(stats[True][0] - stats[False][0]) <= 1
+        assert stats[True][1] > 0
+
+    def test(self):
+        "Check that preconditioning icy columns only does not change the solution"
+
+        grid = self.grid(41)
+
+        default = self.compute(grid, ice_only=False)
+        ice_only = self.compute(grid, ice_only=True)
+
+        u = default.velocity_u_sigma()
+        scale = u.norm(PISM.PETSc.NormType.NORM_INFINITY)[0]
+        assert scale > 0.0
+
+        diff = PISM.Array3D(grid, "diff", PISM.WITHOUT_GHOSTS, u.levels())
+        diff.copy_from(u)
+        diff.add(-1.0, ice_only.velocity_u_sigma())
+
+        assert diff.norm(PISM.PETSc.NormType.NORM_INFINITY)[0] / scale < 1e-6
+
 if __name__ == "__main__":
 
     for test in [TestXY(),
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Regression tests of the DIVA stress balance model: uniform flow of a slab of ice down
+an inclined plane, using the geometries of ISMIP-HOM experiments A (frozen bed) and C
+(sliding) without the bed and basal resistance perturbations.
+
+In this case the basal shear stress is equal to the driving stress and the
+vertically-integrated viscosity does not depend on the horizontal strain rate, so the
+surface speed computed by DIVA is known exactly:
+
+  u_s = u_b + 2 A tau_b^n \int_0^H s^n dz, s = (H - z) / H,
+
+where the integral is approximated by the trapezoidal rule on the vertical grid (this is
+the quadrature used by DIVA). We check both the discrete value (to solver tolerances) and
+the continuous one, 2 A tau_b^n H / (n + 1) (to the quadrature error, computed below).
+"""
+
+import numpy as np
+import PISM
+from PISM.util import convert
+
+# Keep petsc4py from suppressing error messages
+PISM.PETSc.Sys.popErrorHandler()
+
+ctx = PISM.Context()
+config = ctx.config
+
+seconds_per_year = convert(1.0, "year", "second")
+
+# Set up the sliding law so that beta (in Pa s / m) is equal to tauc (in Pa):
+config.set_flag("basal_resistance.pseudo_plastic.enabled", True)
+config.set_number("basal_resistance.pseudo_plastic.q", 1.0)
+config.set_number("basal_resistance.pseudo_plastic.u_threshold",
+                  convert(1.0, "m / s", "m / year"))
+
+n = 3.0
+A = 1e-16                       # Pa-3 year-1
+config.set_string("stress_balance.ssa.flow_law", "isothermal_glen")
+config.set_number("stress_balance.ssa.Glen_exponent", n)
+config.set_number("flow_law.isothermal_Glen.ice_softness",
+                  convert(A, "Pa-3 year-1", "Pa-3 s-1"))
+
+rho = 910.0
+g = 9.81
+config.set_number("constants.ice.density", rho)
+config.set_number("constants.standard_gravity", g)
+
+# Ice thickness
+H = 1000.0
+# Vertical grid: H is one of the grid levels, so the surface speed is not interpolated
+z = np.linspace(0, 2000, 41)
+
+# Surface slopes: 0.5 degrees in A, 0.1 degrees in C
+alpha = {"A": 0.5 * np.pi / 180.0,
+         "C": 0.1 * np.pi / 180.0}
+
+# Basal drag coefficient (Pa year / m) in A (approximates infinity) and C
+beta = {"A": 1e16,
+        "C": 1000.0}
+
+# Both the KSP and the Picard iteration converge in a few steps (the basal shear stress
+# is equal to the driving stress after the first linear solve), so the only remaining
+# error is due to the tolerance of the Newton solve computing the viscosity in a column
+# (stress_balance.diva.viscosity.relative_tolerance = 1e-6 in ln(eta)). We use a direct
+# solver and allow for two orders of magnitude more than that.
+tolerance = 1e-4
+
+def init(test, M):
+    "Set up the grid and model inputs for the slab version of experiment 'test'."
+    L = 80e3
+    P = PISM.GridParameters(config)
+    P.Lx = L / 2.0
+    P.Ly = L / 2.0
+    P.x0 = L / 2.0
+    P.y0 = L / 2.0
+    P.Mx = M
+    P.My = M
+    P.periodicity = PISM.XY_PERIODIC
+    P.z = PISM.DoubleVector(z)
+    P.registration = PISM.CELL_CENTER
+    P.ownership_ranges_from_options(ctx.size)
+
+    grid = PISM.Grid(ctx.ctx, P)
+
+    geometry = PISM.Geometry(grid)
+
+    # enthalpy values are irrelevant: these tests use an isothermal flow law
+    enthalpy = PISM.Array3D(grid, "enthalpy", PISM.WITHOUT_GHOSTS, grid.z())
+    enthalpy.set(0.0)
+
+    # Convert from "Pa year / m" to "Pa s / m"
+    yield_stress = PISM.Scalar(grid, "tauc")
+    yield_stress.set(beta[test] * seconds_per_year)
+
+    # DIVAISMIPHOM uses the surface slope alpha to compute the driving stress, so the
+    # surface and the bed can be flat
+    geometry.ice_thickness.set(H)
+    geometry.bed_elevation.set(0.0)
+    geometry.sea_level_elevation.set(-100.0)
+    geometry.ensure_consistency(0.0)
+
+    inputs = PISM.StressBalanceInputs()
+    inputs.geometry = geometry
+    inputs.basal_yield_stress = yield_stress
+    inputs.enthalpy = enthalpy
+
+    return grid, inputs
+
+def surface_speed(test, M=5):
+    "Compute the surface speed using DIVA."
+    opt = PISM.PETSc.Options()
+    opts = {"-ssafd_ksp_type": "preonly",
+            "-ssafd_pc_type": "lu"}
+    for k, v in opts.items():
+        opt.setValue(k, v)
+    try:
+        grid, inputs = init(test, M)
+
+        model = PISM.DIVAISMIPHOM(grid, PISM.HOM_A if test == "A" else PISM.HOM_C)
+        stress_balance = PISM.StressBalance(grid, model, PISM.DIVAMod(model))
+        stress_balance.init()
+        stress_balance.update(inputs, True)
+
+        speed = stress_balance.diagnostics()["velsurf_mag"].compute().numpy()
+    finally:
+        for k in opts.keys():
+            opt.delValue(k)
+
+    return (PISM.GlobalMin(ctx.com, np.min(speed)),
+            PISM.GlobalMax(ctx.com, np.max(speed)))
+
+def exact(test):
+    """Return the exact surface speed (m/year) computed using the trapezoidal rule on the
+    vertical grid, the exact surface speed of the continuous problem and the relative
+    quadrature error."""
+    tau_b = rho * g * H * np.tan(alpha[test])
+    u_b = tau_b / beta[test]
+
+    zz = z[z <= H]
+    s = (H - zz) / H
+    integral = np.sum(0.5 * (s[1:]**n + s[:-1]**n) * np.diff(zz))
+
+    discrete = u_b + 2 * A * tau_b**n * integral
+    continuous = u_b + 2 * A * tau_b**n * H / (n + 1)
+
+    return discrete, continuous, abs(discrete - continuous) / continuous
+
+def check(test):
+    u_min, u_max = surface_speed(test)
+    discrete, continuous, quadrature_error = exact(test)
+
+    # the flow is uniform
+    assert (u_max - u_min) / u_max < tolerance, \
+        f"{test}: surface speed varies from {u_min} to {u_max}"
+
+    error = abs(u_max - discrete) / discrete
+    assert error < tolerance, \
+        f"{test}: surface speed {u_max}, expected {discrete} (relative error {error})"
+
+    error = abs(u_max - continuous) / continuous
+    assert error < quadrature_error + tolerance, \
+        f"{test}: surface speed {u_max}, exact {continuous} (relative error {error})"
+
+def slab_frozen_bed_test():
+    "DIVA: uniform flow of a slab (ISMIP-HOM A geometry without the bed perturbation)"
+    check("A")
+
+def slab_sliding_test():
+    "DIVA: uniform flow of a slab (ISMIP-HOM C geometry without the drag perturbation)"
+    check("C")
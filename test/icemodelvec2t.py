@@ -407,3 +407,76 @@ class ForcingInput(unittest.TestCase):
         dt = seconds(self.t[-1]) - t
         forcing.average(t, dt)
         numpy.testing.assert_almost_equal(forcing.numpy()[0,0], 0.0)
+
+    def test_multi_record_read(self):
+        "Reading several records at once matches reading them one at a time"
+        # The input grid is coarser than the internal one (reading requires interpolation)
+        # and the input file uses different units (reading requires unit conversion).
+        internal_grid = PISM.Grid.Shallow(ctx.ctx, 1, 1, 0, 0, 7, 7, PISM.CELL_CORNER,
+                                          PISM.NOT_PERIODIC)
+        input_grid = PISM.Grid.Shallow(ctx.ctx, 1, 1, 0, 0, 4, 4, PISM.CELL_CORNER,
+                                       PISM.NOT_PERIODIC)
+
+        units = "30 days since 1-1-1"
+        N = len(self.t)
+
+        v = PISM.Scalar(input_grid, "v")
+        v.metadata(0).units("km")
+
+        def set_record(k):
+            with PISM.vec.Access(v):
+                for (i, j, x, y) in input_grid.coords():
+                    v[i, j] = 1.0 + x + 2.0 * y**2 + 0.25 * k
+
+        suffix = filename("")
+        multi_record = "multi_record_" + suffix
+        single_record = ["record_{}_{}".format(k, suffix) for k in range(N)]
+
+        bounds = PISM.VariableMetadata("time_bounds", ctx.unit_system)
+        bounds.set_string("units", units)
+
+        output = PISM.util.prepare_output(multi_record, append_time=False)
+        output.write_attribute("time", "units", units)
+        PISM.define_time_bounds(bounds, "time", "nv", output, PISM.PISM_DOUBLE)
+        output.write_attribute("time", "bounds", "time_bounds")
+        for k in range(N):
+            PISM.append_time(output, "time", self.t[k])
+            PISM.write_time_bounds(output, bounds, k, (self.tb[k], self.tb[k + 1]))
+            set_record(k)
+            v.write(output)
+        output.close()
+
+        # reference values: records read one at a time
+        reference = []
+        for k in range(N):
+            set_record(k)
+            v.dump(single_record[k])
+
+            ref = PISM.Scalar(internal_grid, "v")
+            ref.metadata(0).units("m")
+            ref.regrid(single_record[k], critical=True)
+            reference.append(ref.numpy())
+
+        try:
+            # all records in one read (non-periodic and periodic), and several reads of
+            # blocks of records that re-use some of the records in the buffer
+            for buffer_size, periodic in [(N, False), (N, True), (5, False)]:
+                input_file = PISM.File(ctx.com, multi_record, PISM.PISM_NETCDF3,
+                                       PISM.PISM_READONLY)
+                forcing = PISM.Forcing(internal_grid, input_file, "v", "",
+                                       buffer_size, periodic, PISM.PIECEWISE_CONSTANT)
+                input_file.close()
+
+                forcing.metadata(0).units("m")
+                forcing.init(multi_record, periodic)
+
+                for k in range(N):
+                    forcing.update(seconds(self.tb[k]), seconds(self.tb[k + 1] - self.tb[k]))
+                    forcing.interp(seconds(self.t[k]))
+
+                    if ctx.rank == 0:
+                        numpy.testing.assert_allclose(forcing.numpy(), reference[k],
+                                                      rtol=1e-12)
+        finally:
+            for f in [multi_record] + single_record:
+                os.remove(f)
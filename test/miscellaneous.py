@@ -670,6 +670,88 @@ def flowlaw_test():
         check_flow_law(factory, flow_law_name, EC, np.array(data))
 
 
+def arrhenius_table_test():
+    "Relative errors of tabulated Arrhenius factors"
+    config = PISM.Context().config
+
+    R = config.get_number("constants.ideal_gas_constant")
+    n = 3.0
+    relative_error = config.get_number("flow_law.Arrhenius_table.relative_error")
+
+    Q_cold = config.get_number("flow_law.Paterson_Budd.Q_cold")
+    Q_warm = config.get_number("flow_law.Paterson_Budd.Q_warm")
+    # Paterson-Budd softness and hardness, then activation energies used by
+    # GoldsbyKohlstedt (diffusion, dislocation creep, grain boundary sliding, basal slip)
+    Q = [Q_cold, Q_warm, -Q_cold / n, -Q_warm / n,
+         59.4e3, 49e3, 60e3, 180e3, 192e3]
+
+    # tables cover [200, 300] Kelvin; include points outside of this range
+    T = np.linspace(190, 310, 120001)
+
+    for q in Q:
+        table = PISM.ArrheniusTable(q, R, 200.0, 300.0, relative_error)
+        assert table.size() > 0
+
+        exact = np.exp(-q / (R * T))
+        approximate = np.array([table(t) for t in T])
+
+        error = np.max(np.fabs(approximate - exact) / exact)
+
+        # allow for rounding errors
+        assert error <= relative_error + 1e-14, (q, error)
+
+    # zero relative error disables tables
+    assert PISM.ArrheniusTable(Q_cold, R, 200.0, 300.0, 0.0).size() == 0
+
+
+def flow_law_batched_test():
+    "Batched flow law evaluation (flow_n(), hardness_n()) vs flow() and hardness()"
+    ctx = PISM.Context()
+    config = ctx.config
+    EC = ctx.enthalpy_converter
+
+    N = 1000
+    np.random.seed(0)
+
+    depth = np.random.uniform(0, 3000, N)
+    p = np.array([EC.pressure(d) for d in depth])
+    T_pa = np.random.uniform(-60, 0, N)
+    # temperate ice with a non-zero water fraction at 10% of the points
+    omega = np.where(np.random.uniform(0, 1, N) < 0.1, np.random.uniform(0, 0.01, N), 0)
+    T_pa[omega > 0] = 0.0
+    E = np.array([EC.enthalpy(EC.melting_temperature(P) + t, o, P)
+                  for P, t, o in zip(p, T_pa, omega)])
+    stress = np.random.uniform(1e3, 2e5, N)
+    stress[::100] = 0.0
+    # the batched GK code re-computes grain size factors only when the grain size changes
+    gs = np.repeat(np.random.uniform(1e-3, 5e-3, N // 10), 10)
+
+    flow_laws = ["arr", "arrwarm", "gk", "gpbld", "hooke", "isothermal_glen", "pb"]
+
+    original = config.get_number("flow_law.Arrhenius_table.relative_error")
+    try:
+        # Batched code uses tables for all Arrhenius factors, while GK's flow() uses exp():
+        # allow for several factors with the relative error of 1e-10 each.
+        for table_error, tolerance in [(original, 1e-9), (0.0, 1e-12)]:
+            config.set_number("flow_law.Arrhenius_table.relative_error", table_error)
+
+            factory = PISM.FlowLawFactory("stress_balance.sia.", config, EC)
+            for name in flow_laws:
+                factory.set_default(name)
+                law = factory.create()
+
+                F = np.array([law.flow(s, e, P, g) for s, e, P, g in zip(stress, E, p, gs)])
+                B = np.array([law.hardness(e, P) for e, P in zip(E, p)])
+
+                np.testing.assert_allclose(law.flow_n(stress.tolist(), E.tolist(),
+                                                      p.tolist(), gs.tolist()), F,
+                                           rtol=tolerance, atol=0, err_msg=name)
+                np.testing.assert_allclose(law.hardness_n(E.tolist(), p.tolist()), B,
+                                           rtol=tolerance, atol=0, err_msg=name)
+    finally:
+        config.set_number("flow_law.Arrhenius_table.relative_error", original)
+
+
 def ssa_trivial_test():
     "Test the SSA solver using a trivial setup."
 
@@ -802,6 +884,131 @@ def regridding_test():
     finally:
         os.remove(file_name)
 
+def in_memory_regridding_test():
+    "Test regridding from a field using a different grid (in memory)."
+    import numpy as np
+
+    ctx = PISM.Context().ctx
+
+    Lx = 1e5
+    Ly = 2e5
+    coarse = PISM.Grid_Shallow(ctx, Lx, Ly, 0, 0, 11, 21, PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+    fine = PISM.Grid_Shallow(ctx, Lx, Ly, 0, 0, 41, 81, PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+    def F(x, y):
+        "a linear function is recovered exactly by bilinear interpolation"
+        return 2.0 * x + 3.0 * y + 1.0
+
+    # 2D, one component
+    source = PISM.Scalar(coarse, "thk")
+    target = PISM.Scalar1(fine, "thk")
+
+    with PISM.vec.Access(nocomm=[source]):
+        for (i, j) in coarse.points():
+            source[i, j] = F(coarse.x(i), coarse.y(j))
+
+    target.regrid(source)
+
+    with PISM.vec.Access(nocomm=[target]):
+        for (i, j) in fine.points():
+            np.testing.assert_almost_equal(target[i, j], F(fine.x(i), fine.y(j)))
+
+    # 2D, two components
+    source = PISM.Vector(coarse, "velocity")
+    target = PISM.Vector(fine, "velocity")
+
+    with PISM.vec.Access(nocomm=[source]):
+        for (i, j) in coarse.points():
+            source.setitem(i, j, F(coarse.x(i), coarse.y(j)), -F(coarse.x(i), coarse.y(j)))
+
+    target.regrid(source)
+
+    with PISM.vec.Access(nocomm=[target]):
+        for (i, j) in fine.points():
+            v = target.getitem(i, j)
+            np.testing.assert_almost_equal(v.u, F(fine.x(i), fine.y(j)))
+            np.testing.assert_almost_equal(v.v, -F(fine.x(i), fine.y(j)))
+
+    # 3D, using different vertical grids
+    z_coarse = np.linspace(0, 1000, 11)
+    z_fine = np.linspace(0, 1000, 31)
+
+    source = PISM.Array3D(coarse, "enthalpy", PISM.WITHOUT_GHOSTS, z_coarse)
+    target = PISM.Array3D(fine, "enthalpy", PISM.WITH_GHOSTS, z_fine)
+
+    with PISM.vec.Access(nocomm=[source]):
+        for (i, j) in coarse.points():
+            source.set_column(i, j, F(coarse.x(i), coarse.y(j)) + z_coarse)
+
+    target.regrid(source)
+
+    with PISM.vec.Access(nocomm=[target]):
+        for (i, j) in fine.points():
+            np.testing.assert_almost_equal(target.get_column(i, j),
+                                           F(fine.x(i), fine.y(j)) + z_fine)
+
+def cropped_domain_test():
+    "Test copying fields between a grid and its part and writing using the full domain."
+    import numpy as np
+
+    ctx = PISM.Context().ctx
+
+    # dx = dy = 10 km; grid points of "part" coincide with grid points of "full"
+    full = PISM.Grid_Shallow(ctx, 1e5, 2e5, 0, 0, 21, 41, PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+    part = PISM.Grid_Shallow(ctx, 3e4, 5e4, 2e4, -3e4, 7, 11, PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+    def F(x, y):
+        return 2.0 * x + 3.0 * y + 1.0
+
+    source = PISM.Scalar(full, "thk")
+    with PISM.vec.Access(nocomm=[source]):
+        for (i, j) in full.points():
+            source[i, j] = F(full.x(i), full.y(j))
+
+    # cropping
+    cropped = PISM.Scalar(part, "thk")
+    cropped.regrid(source)
+
+    with PISM.vec.Access(nocomm=[cropped]):
+        for (i, j) in part.points():
+            np.testing.assert_almost_equal(cropped[i, j], F(part.x(i), part.y(j)))
+
+    # expanding: points outside of the part are not modified
+    cropped.shift(1.0)
+    expanded = PISM.Scalar(full, "thk")
+    expanded.set(-1.0)
+    expanded.regrid(cropped)
+
+    x_min, x_max = part.x(0), part.x(part.Mx() - 1)
+    y_min, y_max = part.y(0), part.y(part.My() - 1)
+    with PISM.vec.Access(nocomm=[expanded]):
+        for (i, j) in full.points():
+            x, y = full.x(i), full.y(j)
+            if x_min <= x <= x_max and y_min <= y <= y_max:
+                np.testing.assert_almost_equal(expanded[i, j], F(x, y) + 1.0)
+            else:
+                assert expanded[i, j] == -1.0
+
+    # output uses coordinates of the full domain
+    part.set_output_domain(full)
+    file_name = filename("cropped")
+    try:
+        cropped.dump(file_name)
+
+        f = PISM.File(part.com, file_name, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        assert f.dimension_length("x") == full.Mx()
+        assert f.dimension_length("y") == full.My()
+        f.close()
+
+        copy = PISM.Scalar(part, "thk")
+        copy.regrid(file_name, critical=True)
+
+        with PISM.vec.Access(nocomm=[cropped, copy]):
+            for (i, j) in part.points():
+                np.testing.assert_almost_equal(copy[i, j], cropped[i, j])
+    finally:
+        os.remove(file_name)
+
 def interpolation_weights_test():
     "Test 2D interpolation weights."
 
@@ -1571,3 +1778,1090 @@ def grounding_line_flux_test():
 
     NORM_INFINITY = 3
     np.testing.assert_almost_equal(gl_flux.norm(NORM_INFINITY), 0.0)
+
+def fused_flux_limiter_test():
+    "Flux limiting in GeometryEvolution matches make_nonnegative_preserving()"
+    ctx = PISM.Context()
+    grid = PISM.Grid.Shallow(ctx.ctx, 1e5, 1e5, 0, 0, 31, 31, PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+    dt = PISM.util.convert(1, "year", "second")
+
+    # thin grounded ice (1 to 10 m) and a diffusive flux that is large enough to require
+    # limiting in some cells but not in others
+    def thickness(i, j):
+        return 5.5 + 4.5 * np.sin(1.7 * i + 2.3 * j)
+
+    Q0 = 5.0 * grid.dx() / dt
+    def flux(i, j, n):
+        return Q0 * np.sin(0.9 * i - 1.3 * j + 0.7 * n) * np.cos(0.4 * j + n)
+
+    geometry = PISM.Geometry(grid)
+    geometry.bed_elevation.set(0.0)
+    geometry.sea_level_elevation.set(-1000.0)
+    with PISM.vec.Access(geometry.ice_thickness):
+        for (i, j) in grid.points():
+            geometry.ice_thickness[i, j] = thickness(i, j)
+    geometry.ice_area_specific_volume.set(0.0)
+    geometry.ensure_consistency(0.0)
+
+    velocity = PISM.Vector(grid, "velocity")
+    velocity.set(0.0)
+    thk_bc_mask = PISM.Scalar(grid, "thk_bc_mask")
+    thk_bc_mask.set(0.0)
+
+    diffusive_flux = PISM.Staggered(grid, "diffusive_flux")
+    flux_unlimited = PISM.Staggered1(grid, "flux_unlimited")
+    with PISM.vec.Access([diffusive_flux, flux_unlimited]):
+        for (i, j) in grid.points():
+            for n in range(2):
+                diffusive_flux[i, j, n] = flux(i, j, n)
+                flux_unlimited[i, j, n] = flux(i, j, n)
+    flux_unlimited.update_ghosts()
+
+    # fused: limiting and the flux divergence in one pass
+    ge = PISM.GeometryEvolution(grid)
+    ge.flow_step(geometry, dt, velocity, diffusive_flux, thk_bc_mask)
+
+    # reference: the stand-alone limiter (used by GeometryEvolution before fusing)
+    H = PISM.Scalar1(grid, "thk")
+    H.copy_from(geometry.ice_thickness)
+    flux_limited = PISM.Staggered(grid, "flux_limited")
+    PISM.make_nonnegative_preserving(dt, H, flux_unlimited, flux_limited)
+
+    Q_unlimited = flux_unlimited.numpy()
+    Q_fused = ge.flux_staggered().numpy()
+    Q = flux_limited.numpy()
+    div_Q = ge.flux_divergence().numpy()
+
+    if ctx.rank == 0:
+        # the limiter is active in some cells
+        assert np.any(Q != Q_unlimited)
+        assert np.any(Q == Q_unlimited)
+
+        np.testing.assert_array_equal(Q_fused, Q)
+
+        # flux divergence computed using limited fluxes (periodic, like DMs used by PISM)
+        dx, dy = grid.dx(), grid.dy()
+        Q_e, Q_n = Q[:, :, 0], Q[:, :, 1]
+        Q_w, Q_s = np.roll(Q_e, 1, axis=1), np.roll(Q_n, 1, axis=0)
+        np.testing.assert_array_equal(div_Q, (Q_e - Q_w) / dx + (Q_n - Q_s) / dy)
+
+class IceVolumeAnalysis(PISM.Analysis):
+    "In-situ analysis computing the ice volume using a read-only view of ice thickness."
+    def __init__(self, cell_area):
+        super().__init__()
+        self.cell_area = cell_area
+
+    def inputs(self):
+        return ["thk"]
+
+    def outputs(self):
+        return ["volume"]
+
+    def units(self, name):
+        return "m3"
+
+    def compute(self, inputs):
+        H = inputs.get("thk").local_view()
+        assert not H.flags.writeable
+        return [PISM.GlobalSum(inputs.com(), float(H.sum()) * self.cell_area)]
+
+def in_situ_analysis_test():
+    "In-situ analysis callbacks"
+    ctx = PISM.Context()
+    grid = PISM.Grid.Shallow(ctx.ctx, 1e5, 1e5, 0, 0, 11, 11, PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+    H = PISM.Scalar1(grid, "thk")
+    H.set(1.0)
+
+    analysis = IceVolumeAnalysis(grid.cell_area())
+
+    inputs = PISM.AnalysisInputs(grid.com, 0.0)
+    inputs.add("thk", H)
+
+    assert inputs.is_available("thk")
+    assert not inputs.is_available("missing")
+
+    volume = analysis.compute(inputs)[0]
+
+    np.testing.assert_almost_equal(volume, grid.Mx() * grid.My() * grid.cell_area())
+
+def in_situ_analysis_run_test():
+    "In-situ analyses performed during a run (-analysis_times)"
+    ctx = PISM.Context()
+    config = ctx.config
+
+    grid = PISM.Grid.Shallow(ctx.ctx, 250e3, 250e3, 0, 0, 11, 11,
+                             PISM.CELL_CENTER, PISM.NOT_PERIODIC)
+
+    # a parabolic ice cap
+    thk = PISM.Scalar(grid, "thk")
+    thk.metadata(0).units("m").standard_name("land_ice_thickness")
+    topg = PISM.Scalar(grid, "topg")
+    topg.metadata(0).units("m").standard_name("bedrock_altitude")
+    smb = PISM.Scalar(grid, "climatic_mass_balance")
+    smb.metadata(0).units("kg m-2 s-1")
+    ts = PISM.Scalar(grid, "ice_surface_temp")
+    ts.metadata(0).units("Kelvin")
+
+    with PISM.vec.Access([thk]):
+        for (i, j) in grid.points():
+            r = np.sqrt(grid.x(i)**2 + grid.y(j)**2)
+            thk[i, j] = max(2000.0 * (1.0 - (r / 200e3)**2), 0.0)
+    topg.set(0.0)
+    smb.set(0.0)
+    ts.set(250.0)
+
+    input_file = filename("analysis_input")
+    output_file = filename("analysis_output")
+
+    year = PISM.util.convert(1.0, "year", "second")
+    t0 = ctx.time.current()
+    times = [t0 + k * year for k in [1, 2, 3]]
+
+    parameters = {"input.file": input_file,
+                  "input.bootstrap": True,
+                  "surface.models": "given",
+                  "surface.given.file": input_file,
+                  "stress_balance.model": "sia",
+                  "output.analysis.file": output_file,
+                  "output.analysis.times": ",".join(["{} seconds".format(t) for t in times])}
+    original = {}
+    for k, v in parameters.items():
+        if isinstance(v, bool):
+            original[k] = config.get_flag(k)
+            config.set_flag(k, v)
+        else:
+            original[k] = config.get_string(k)
+            config.set_string(k, v)
+
+    try:
+        output = PISM.util.prepare_output(input_file)
+        for v in [thk, topg, smb, ts]:
+            v.write(output)
+        output.close()
+
+        model = PISM.IceModel(grid, ctx.ctx)
+        model.add_analysis(IceVolumeAnalysis(grid.cell_area()))
+        model.init()
+
+        model.run_to(times[-1])
+
+        # ice volume at the end of the run (the time of the last analysis)
+        H = model.geometry().ice_thickness.numpy()
+
+        f = PISM.File(ctx.com, output_file, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        t = f.read_dimension("time")
+        volume = f.read_variable("volume", [0], [len(t)])
+        f.close()
+
+        # analyses were performed at requested times (the time step is shortened to hit
+        # them)...
+        np.testing.assert_allclose(t, times, rtol=0, atol=1e-3)
+        # ... and their results were saved
+        assert np.all(np.array(volume) > 0.0)
+        if ctx.rank == 0:
+            np.testing.assert_allclose(volume[-1], H.sum() * grid.cell_area(), rtol=1e-12)
+    finally:
+        for k, v in original.items():
+            if isinstance(v, bool):
+                config.set_flag(k, v)
+            else:
+                config.set_string(k, v)
+        for f in [input_file, output_file]:
+            if os.path.exists(f):
+                os.remove(f)
+
+def mohr_coulomb_effective_pressure_test():
+    "Mohr-Coulomb effective pressure and yield stress"
+    config = ctx.config
+    mc = PISM.MohrCoulombPointwise(config)
+
+    W_max = config.get_number("hydrology.tillwat_max")
+    N0 = config.get_number("basal_yield_stress.mohr_coulomb.till_reference_effective_pressure")
+    e0 = config.get_number("basal_yield_stress.mohr_coulomb.till_reference_void_ratio")
+    Cc = config.get_number("basal_yield_stress.mohr_coulomb.till_compressibility_coefficient")
+    c0 = config.get_number("basal_yield_stress.mohr_coulomb.till_cohesion")
+
+    delta = 0.02
+    phi = 30.0
+    for P in [0.0, 1e3, 1e6, 3e7]:
+        for W in np.linspace(0, W_max, 11):
+            s = W / W_max
+            N = min(P, N0 * (delta * P / N0)**s * 10**((e0 / Cc) * (1.0 - s)))
+
+            np.testing.assert_allclose(mc.effective_pressure(delta, P, W), N, rtol=1e-12)
+
+            tauc = mc.yield_stress(delta, P, W, phi)
+            np.testing.assert_allclose(tauc, c0 + N * np.tan(np.deg2rad(phi)), rtol=1e-12)
+            np.testing.assert_allclose(mc.yield_stress_tan_phi(delta, P, W, np.tan(np.deg2rad(phi))),
+                                       tauc, rtol=1e-12)
+
+def pseudo_plastic_drag_test():
+    "Pseudo-plastic drag (including values of q that avoid pow())"
+    config = PISM.DefaultConfig(ctx.com, "pism_config", "-config", ctx.unit_system)
+    config.init_with_default(ctx.log)
+
+    eps = config.get_number("basal_resistance.plastic.regularization", "m second-1")
+    u_threshold = config.get_number("basal_resistance.pseudo_plastic.u_threshold", "m second-1")
+    A = 2.0
+    config.set_number("basal_resistance.pseudo_plastic.sliding_scale_factor", A)
+
+    tauc = 1e5
+    for q in [0.0, 0.25, 1.0 / 3.0, 0.5, 1.0]:
+        config.set_number("basal_resistance.pseudo_plastic.q", q)
+        law = PISM.IceBasalResistancePseudoPlasticLaw(config)
+
+        for u, v in [(0.0, 0.0), (1e-6, 0.0), (3e-6, -4e-6), (1e-3, 2e-4)]:
+            magreg2 = eps**2 + u**2 + v**2
+            beta = tauc / A**q * magreg2**(0.5 * (q - 1)) * u_threshold**(-q)
+
+            np.testing.assert_allclose(law.drag(tauc, u, v), beta, rtol=1e-12)
+
+def tillphi_optimization_test():
+    "Convergence of the till friction angle optimization (all methods)"
+    ctx = PISM.Context()
+    config = ctx.config
+
+    grid = PISM.testing.shallow_grid(Mx=11, My=11, Lx=50e3, Ly=50e3)
+
+    # The "true" till friction angle and the sensitivity of the surface elevation to
+    # tillphi (m / degree) vary in space. The ice is thicker if tillphi is higher.
+    H_target = 1000.0
+    phi_true = PISM.Scalar(grid, "phi_true")
+    sensitivity = PISM.Scalar(grid, "sensitivity")
+    with PISM.vec.Access([phi_true, sensitivity]):
+        for (i, j) in grid.points():
+            x = grid.x(i) / 50e3
+            y = grid.y(j) / 50e3
+            phi_true[i, j] = 25.0 + 10.0 * x * y
+            sensitivity[i, j] = 50.0 + 10.0 * x
+
+    def thickness(tillphi, result):
+        "synthetic response of the ice thickness to the till friction angle"
+        with PISM.vec.Access([tillphi, phi_true, sensitivity, result]):
+            for (i, j) in grid.points():
+                result[i, j] = H_target + sensitivity[i, j] * (tillphi[i, j] - phi_true[i, j])
+
+    def max_error(tillphi):
+        result = 0.0
+        with PISM.vec.Access([tillphi, phi_true]):
+            for (i, j) in grid.points():
+                result = max(result, abs(tillphi[i, j] - phi_true[i, j]))
+        return PISM.GlobalMax(grid.com, result)
+
+    geometry = PISM.Geometry(grid)
+    geometry.bed_elevation.set(0.0)
+    geometry.sea_level_elevation.set(-1000.0)
+
+    W = PISM.Scalar(grid, "W")
+    W.set(0.0)
+
+    inputs = PISM.YieldStressInputs()
+    inputs.geometry = geometry
+    inputs.till_water_thickness = W
+    inputs.subglacial_water_thickness = W
+
+    # the input file contains the target surface elevation and the initial guess
+    file_name = filename("tillphi_opt")
+    try:
+        usurf = PISM.Scalar(grid, "usurf")
+        usurf.metadata(0).units("m")
+        usurf.set(H_target)
+
+        tillphi = PISM.Scalar(grid, "tillphi")
+        tillphi.metadata(0).units("degrees")
+        tillphi.copy_from(phi_true)
+        tillphi.shift(5.0)
+
+        tauc = PISM.Scalar(grid, "tauc")
+        tauc.metadata(0).units("Pa")
+        tauc.set(1e5)
+
+        output = PISM.util.prepare_output(file_name)
+        for v in [usurf, tillphi, tauc]:
+            v.write(output)
+        output.close()
+
+        dt = config.get_number("basal_yield_stress.mohr_coulomb.tillphi_opt.dt", "seconds")
+
+        errors = {}
+        for method in ["proportional", "secant", "anderson"]:
+            config.set_string("basal_yield_stress.mohr_coulomb.tillphi_opt.method", method)
+
+            model = PISM.OptTillphiYieldStress(grid)
+            model.restart(PISM.File(ctx.com, file_name, PISM.PISM_NETCDF3, PISM.PISM_READONLY), 0)
+
+            t = ctx.time.current()
+            for n in range(10):
+                phi = model.diagnostics()["tillphi"].compute()
+                thickness(phi, geometry.ice_thickness)
+                geometry.ensure_consistency(0.0)
+
+                model.update(inputs, t, dt)
+                t += dt
+
+            errors[method] = max_error(model.diagnostics()["tillphi"].compute())
+
+        # the proportional rule converges slowly (the error is reduced by 10% per iteration)...
+        assert errors["proportional"] > 1.0
+        # ... while the secant method and Anderson mixing converge in a few iterations
+        assert errors["secant"] < 0.1
+        assert errors["anderson"] < 0.1
+
+        # adaptive update interval: starts at dt_min and stays in [dt_min, dt]
+        config.set_string("basal_yield_stress.mohr_coulomb.tillphi_opt.method", "secant")
+        config.set_flag("basal_yield_stress.mohr_coulomb.tillphi_opt.dt_adaptive", True)
+        dt_min = config.get_number("basal_yield_stress.mohr_coulomb.tillphi_opt.dt_min", "seconds")
+
+        model = PISM.OptTillphiYieldStress(grid)
+        model.restart(PISM.File(ctx.com, file_name, PISM.PISM_NETCDF3, PISM.PISM_READONLY), 0)
+
+        t = ctx.time.current()
+        intervals = []
+        for n in range(10):
+            phi = model.diagnostics()["tillphi"].compute()
+            thickness(phi, geometry.ice_thickness)
+            geometry.ensure_consistency(0.0)
+
+            interval = model.max_timestep(t).value()
+            intervals.append(interval)
+
+            model.update(inputs, t, interval)
+            t += interval
+
+        np.testing.assert_allclose(intervals[0], dt_min)
+        assert min(intervals) >= dt_min * (1 - 1e-12)
+        assert max(intervals) <= dt * (1 + 1e-12)
+        assert max_error(model.diagnostics()["tillphi"].compute()) < 0.1
+    finally:
+        config.set_string("basal_yield_stress.mohr_coulomb.tillphi_opt.method", "proportional")
+        config.set_flag("basal_yield_stress.mohr_coulomb.tillphi_opt.dt_adaptive", False)
+        os.remove(file_name)
+
+def velocity_derived_fields_test():
+    "Caching of strain rates and deviatoric stresses in VelocityDerivedFields"
+    grid = create_dummy_grid()
+
+    model = PISM.ZeroSliding(grid)
+    fields = PISM.VelocityDerivedFields(grid, model)
+
+    cell_type = PISM.CellType1(grid, "cell_type")
+    cell_type.set(PISM.MASK_GROUNDED)
+
+    hardness = PISM.Scalar(grid, "hardness")
+    hardness.set(1e8)
+
+    # A recomputation modifies the cached field, incrementing its state counter. Note that
+    # fields are not accessed here: that would increment state counters as well.
+    def strain_rates():
+        return fields.principal_strain_rates(cell_type).state_counter()
+
+    def stresses(H=hardness, mask=cell_type):
+        return fields.deviatoric_stresses(H, mask).state_counter()
+
+    # nothing changed: no recomputation
+    s, d = strain_rates(), stresses()
+    assert strain_rates() == s
+    assert stresses() == d
+
+    # velocity
+    model.velocity().inc_state_counter()
+    assert strain_rates() != s
+    assert stresses() != d
+    s, d = strain_rates(), stresses()
+
+    # cell type mask (state counter)
+    cell_type.inc_state_counter()
+    assert strain_rates() != s
+    assert stresses() != d
+    s, d = strain_rates(), stresses()
+
+    # cell type mask (a different field with the same values)
+    other_cell_type = PISM.CellType1(grid, "cell_type")
+    other_cell_type.copy_from(cell_type)
+    assert fields.principal_strain_rates(other_cell_type).state_counter() != s
+    assert stresses(mask=other_cell_type) != d
+    s, d = strain_rates(), stresses()
+
+    # hardness: stresses only
+    hardness.inc_state_counter()
+    assert stresses() != d
+    assert strain_rates() == s
+    d = stresses()
+
+    other_hardness = PISM.Scalar(grid, "hardness")
+    other_hardness.copy_from(hardness)
+    assert stresses(H=other_hardness) != d
+    d = stresses()
+
+    # invalidate() (called by StressBalance::update())
+    fields.invalidate()
+    assert strain_rates() != s
+    assert stresses() != d
+    s, d = strain_rates(), stresses()
+
+    assert strain_rates() == s
+    assert stresses() == d
+
+def process_grid_test():
+    "Node-aware process grid: mapping of ranks to sub-domains and halo sizes"
+    ctx = PISM.Context()
+
+    # halo sizes computed by hand (periodic domain, box stencil)
+    h = PISM.halo_size([5, 5], [10], [0, 1], 1)
+    assert (h.total, h.inter_node) == (48, 48)
+    h = PISM.halo_size([5, 5], [10], [0, 0], 1)
+    assert (h.total, h.inter_node) == (48, 0)
+    h = PISM.halo_size([5, 5], [5, 5], [0, 1, 2, 3], 2)
+    assert (h.total, h.inter_node) == (224, 224)
+
+    def make_nodes(node, local_rank, size):
+        result = PISM.Nodes()
+        result.node = PISM.IntVector(node)
+        result.local_rank = PISM.IntVector(local_rank)
+        result.size = PISM.IntVector(size)
+        return result
+
+    def check(nodes, pg, N):
+        position = list(pg.position)
+        # each rank gets exactly one sub-domain; rank 0 gets the sub-domain 0
+        assert sorted(position) == list(range(N))
+        assert position[0] == 0
+        # the node of each sub-domain is the node of the rank it is assigned to
+        for r in range(N):
+            assert pg.node[position[r]] == nodes.node[r]
+        # the predicted halo size corresponds to the selected process grid
+        h = PISM.halo_size(pg.procs_x, pg.procs_y, pg.node, 2)
+        assert (h.total, h.inter_node) == (pg.halo.total, pg.halo.inter_node)
+
+    # 4 nodes with 4 ranks each, ranks assigned to nodes round-robin
+    N = 16
+    nodes = make_nodes([r % 4 for r in range(N)], [r // 4 for r in range(N)], [4] * 4)
+    pg = PISM.choose_process_grid(nodes, 81, 81, 2, 10.0)
+    check(nodes, pg, N)
+
+    assert (len(pg.procs_x), len(pg.procs_y)) == (4, 4)
+    assert (pg.block_x, pg.block_y) == (2, 2)
+    assert list(pg.position) == [0, 2, 8, 10, 1, 3, 9, 11, 4, 6, 12, 14, 5, 7, 13, 15]
+    assert (pg.halo.total, pg.halo.inter_node) == (2848, 1488)
+    # using the original order of ranks would send more data between nodes
+    h = PISM.halo_size(pg.procs_x, pg.procs_y, nodes.node, 2)
+    assert h.total == pg.halo.total
+    assert h.inter_node > pg.halo.inter_node
+
+    # nodes of different sizes get contiguous runs of sub-domains
+    N = 6
+    nodes = make_nodes([0, 0, 0, 0, 1, 1], [0, 1, 2, 3, 0, 1], [4, 2])
+    pg = PISM.choose_process_grid(nodes, 41, 41, 2, 10.0)
+    check(nodes, pg, N)
+    assert (pg.block_x, pg.block_y) == (0, 0)
+    assert list(pg.position) == list(range(N))
+    assert list(pg.node) == [0, 0, 0, 0, 1, 1]
+
+    # predicted halo sizes match the ones computed using neighbors reported by PETSc
+    # (trivial on one rank; run with mpiexec to test the rest)
+    P = PISM.GridParameters(ctx.config)
+    P.Lx = 1e5
+    P.Ly = 1e5
+    P.Mx = 41
+    P.My = 31
+    P.z = PISM.DoubleVector([0.0, 1000.0])
+    P.registration = PISM.CELL_CORNER
+    P.periodicity = PISM.XY_PERIODIC
+    P.ownership_ranges_from_options(ctx.size)
+    grid = PISM.Grid(ctx.ctx, P)
+
+    node = [r % 2 for r in range(grid.size())]
+    for stencil_width in [1, 2]:
+        predicted = PISM.halo_size(P.procs_x, P.procs_y, node, stencil_width)
+        actual = PISM.halo_size(grid.get_dm(1, stencil_width), node, grid.com)
+        assert predicted.total == actual.total
+        assert predicted.inter_node == actual.inter_node
+
+def step_rollback_test():
+    "Restoring the model state saved at the beginning of a time step"
+    ctx = PISM.Context()
+    config = ctx.config
+
+    P = PISM.GridParameters(config)
+    P.Lx = 500e3
+    P.Ly = 500e3
+    P.Mx = 21
+    P.My = 21
+    P.z = PISM.DoubleVector(np.linspace(0, 4000, 21))
+    P.registration = PISM.CELL_CENTER
+    P.ownership_ranges_from_options(ctx.size)
+    grid = PISM.Grid(ctx.ctx, P)
+
+    # a parabolic ice cap with a positive surface mass balance
+    thk = PISM.Scalar(grid, "thk")
+    thk.metadata(0).units("m").standard_name("land_ice_thickness")
+    topg = PISM.Scalar(grid, "topg")
+    topg.metadata(0).units("m").standard_name("bedrock_altitude")
+    smb = PISM.Scalar(grid, "climatic_mass_balance")
+    smb.metadata(0).units("kg m-2 s-1")
+    ts = PISM.Scalar(grid, "ice_surface_temp")
+    ts.metadata(0).units("Kelvin")
+
+    with PISM.vec.Access([thk]):
+        for (i, j) in grid.points():
+            r = np.sqrt(grid.x(i)**2 + grid.y(j)**2)
+            thk[i, j] = max(3000.0 * (1.0 - (r / 400e3)**2), 0.0)
+    topg.set(0.0)
+    smb.set(PISM.util.convert(0.3 * 910.0, "kg m-2 year-1", "kg m-2 s-1"))
+    ts.set(250.0)
+
+    file_name = filename("rollback")
+
+    parameters = {"input.file": file_name,
+                  "input.bootstrap": True,
+                  "surface.models": "given",
+                  "surface.given.file": file_name,
+                  "stress_balance.model": "sia",
+                  "time_stepping.rollback.enabled": False}
+    original = {}
+    for k, v in parameters.items():
+        if isinstance(v, bool):
+            original[k] = config.get_flag(k)
+            config.set_flag(k, v)
+        else:
+            original[k] = config.get_string(k)
+            config.set_string(k, v)
+
+    def copy(field):
+        result = field.duplicate()
+        result.copy_from(field)
+        return result
+
+    def max_difference(a, b):
+        d = copy(a)
+        d.add(-1.0, b)
+        return d.norm(PISM.PETSc.NormType.NORM_INFINITY)[0]
+
+    try:
+        output = PISM.util.prepare_output(file_name)
+        for v in [thk, topg, smb, ts]:
+            v.write(output)
+        output.close()
+
+        model = PISM.IceModel(grid, ctx.ctx)
+        model.init()
+
+        year = PISM.util.convert(1.0, "year", "second")
+
+        model.run_to(ctx.time.current() + 10 * year)
+
+        # save the state and take a few steps
+        model.save_step_state()
+        t0 = ctx.time.current()
+        H0 = copy(model.geometry().ice_thickness)
+        E0 = copy(model.energy_balance_model().enthalpy())
+
+        model.run_to(t0 + 10 * year)
+        H1 = copy(model.geometry().ice_thickness)
+        E1 = copy(model.energy_balance_model().enthalpy())
+        assert max_difference(H1, H0) > 0.0
+
+        # reject these steps: the saved state is restored exactly...
+        model.restore_step_state()
+        assert ctx.time.current() == t0
+        assert max_difference(model.geometry().ice_thickness, H0) == 0.0
+        assert max_difference(model.energy_balance_model().enthalpy(), E0) == 0.0
+
+        # ... and repeating them reproduces the result
+        model.run_to(t0 + 10 * year)
+        assert max_difference(model.geometry().ice_thickness, H1) < 1e-6
+        assert max_difference(model.energy_balance_model().enthalpy(), E1) < 1e-9 * E1.norm(PISM.PETSc.NormType.NORM_INFINITY)[0]
+
+        # saving the state does not mark fields as modified...
+        geometry = model.geometry()
+        fields = [geometry.bed_elevation, geometry.sea_level_elevation,
+                  geometry.ice_thickness, geometry.cell_type,
+                  model.energy_balance_model().enthalpy()]
+        counters = [f.state_counter() for f in fields]
+        model.save_step_state()
+        assert [f.state_counter() for f in fields] == counters
+
+        # ... so steps with rollback enabled do not change state counters of fields these
+        # steps do not modify (bed and sea level elevations are constant here)
+        def counter_changes(rollback):
+            config.set_flag("time_stepping.rollback.enabled", rollback)
+            fields = [geometry.bed_elevation, geometry.sea_level_elevation]
+            before = [f.state_counter() for f in fields]
+            model.run_to(ctx.time.current() + 10 * year)
+            return [f.state_counter() - b for f, b in zip(fields, before)]
+
+        assert counter_changes(True) == counter_changes(False)
+    finally:
+        for k, v in original.items():
+            if isinstance(v, bool):
+                config.set_flag(k, v)
+            else:
+                config.set_string(k, v)
+        os.remove(file_name)
+
+def sigma_coordinate_test():
+    "Interpolation between z and sigma levels"
+    params = PISM.GridParameters(ctx.config)
+    params.ownership_ranges_from_options(ctx.size)
+    grid = PISM.Grid(ctx.ctx, params)
+
+    z = np.array(grid.z())
+    H = 0.3 * z[-1]
+
+    ice_thickness = PISM.model.createIceThicknessVec(grid)
+    ice_thickness.set(H)
+
+    def F(z):
+        return 2.0 * z + 1.0
+
+    f = PISM.Array3D(grid, "f", PISM.WITHOUT_GHOSTS, z)
+    with PISM.vec.Access(nocomm=[f]):
+        for (i, j) in grid.points():
+            f.set_column(i, j, F(z))
+
+    f_sigma = PISM.allocate_sigma_field(grid, "f_sigma", False)
+    sigma = np.array(f_sigma.levels())
+
+    np.testing.assert_almost_equal(sigma[0], 0.0)
+    np.testing.assert_almost_equal(sigma[-1], 1.0)
+
+    PISM.z_to_sigma(f, ice_thickness, f_sigma)
+
+    g = PISM.Array3D(grid, "g", PISM.WITHOUT_GHOSTS, z)
+    PISM.sigma_to_z(f_sigma, ice_thickness, g)
+
+    # linear interpolation reproduces linear functions; values above the surface are
+    # equal to the value at the surface
+    with PISM.vec.Access(nocomm=[f_sigma, g]):
+        for (i, j) in grid.points():
+            np.testing.assert_almost_equal(f_sigma.get_column(i, j), F(H * sigma))
+            np.testing.assert_almost_equal(g.get_column(i, j), F(np.minimum(z, H)))
+
+def sigma_coordinate_enthalpy_test():
+    """Steady-state heat conduction computed using the sigma coordinate
+
+    With no advection and no strain heating the temperature profile is linear: it matches
+    the surface temperature at the top and the geothermal flux at the base."""
+    config = ctx.config
+
+    H = 1000.0
+    T_s = 260.0
+    G = PISM.util.convert(10, "mW m-2", "W m-2")
+    k = config.get_number("constants.ice.thermal_conductivity")
+
+    grid = create_dummy_grid()
+
+    zero = PISM.Scalar(grid, "zero")
+    zero.set(0.0)
+
+    cell_type = PISM.CellType(grid, "mask")
+    cell_type.set(PISM.MASK_GROUNDED)
+
+    basal_heat_flux = PISM.Scalar(grid, "bheatflx")
+    basal_heat_flux.set(G)
+
+    ice_thickness = PISM.model.createIceThicknessVec(grid)
+    ice_thickness.set(H)
+    # EnthalpyModel::restart() gets ice thickness from the dictionary of variables
+    grid.variables().add(ice_thickness)
+
+    surface_temp = PISM.Scalar(grid, "surface_temp")
+    surface_temp.set(T_s)
+
+    u = PISM.Array3D(grid, "u", PISM.WITHOUT_GHOSTS)
+    u.set(0.0)
+
+    inputs = PISM.EnergyModelInputs()
+    inputs.cell_type = cell_type
+    inputs.basal_frictional_heating = zero
+    inputs.basal_heat_flux = basal_heat_flux
+    inputs.ice_thickness = ice_thickness
+    inputs.surface_liquid_fraction = zero
+    inputs.shelf_base_temp = surface_temp
+    inputs.surface_temp = surface_temp
+    inputs.till_water_thickness = zero
+    inputs.volumetric_heating_rate = u
+    inputs.u3 = u
+    inputs.v3 = u
+    inputs.w3 = u
+
+    output_file = filename("enthalpy-sigma")
+
+    config.set_flag("grid.sigma.enabled", True)
+    try:
+        model = PISM.EnthalpyModel(grid, None)
+        model.initialize(zero, ice_thickness, surface_temp, zero, basal_heat_flux)
+
+        # the diffusion time scale H**2 * rho * c / k is about 30,000 years
+        dt = PISM.util.convert(5000, "years", "seconds")
+        N = 50
+        for n in range(N):
+            model.update(n * dt, dt, inputs)
+
+        EC = PISM.EnthalpyConverter(config)
+        z = np.array(grid.z())
+        depth = np.maximum(H - z, 0.0)
+        T_exact = T_s + G / k * depth
+
+        E = model.enthalpy()
+        with PISM.vec.Access(nocomm=E):
+            for (i, j) in grid.points():
+                column = E.get_column(i, j)
+                T = [EC.temperature(column[m], EC.pressure(depth[m])) for m in range(len(z))]
+                np.testing.assert_allclose(T, T_exact, atol=1e-2)
+
+        # enthalpy on sigma levels is saved, so a re-started model takes the same step
+        output = PISM.util.prepare_output(output_file)
+        model.write_model_state(output)
+        assert output.find_variable("enthalpy_sigma")
+
+        restarted = PISM.EnthalpyModel(grid, None)
+        restarted.restart(output, 0)
+        output.close()
+
+        model.update(N * dt, dt, inputs)
+        restarted.update(N * dt, dt, inputs)
+
+        diff = PISM.Array3D(grid, "diff", PISM.WITHOUT_GHOSTS)
+        diff.copy_from(model.enthalpy())
+        diff.add(-1.0, restarted.enthalpy())
+        assert diff.norm(PISM.PETSc.NormType.NORM_INFINITY)[0] == 0.0
+    finally:
+        config.set_flag("grid.sigma.enabled", False)
+        if os.path.exists(output_file):
+            os.remove(output_file)
+
+def incremental_geometry_consistency_test():
+    "Geometry::ensure_consistency() re-computing changed cells only"
+    grid = PISM.testing.shallow_grid(Mx=11, My=11)
+
+    def init(geometry):
+        geometry.bed_elevation.set(-100.0)
+        geometry.sea_level_elevation.set(0.0)
+        geometry.ice_area_specific_volume.set(0.0)
+        with PISM.vec.Access(geometry.ice_thickness):
+            for i, j in grid.points():
+                geometry.ice_thickness[i, j] = 200.0 if i < 5 else 0.0
+
+    def compare(a, b):
+        for name in ["cell_type", "ice_surface_elevation", "cell_grounded_fraction"]:
+            np.testing.assert_equal(getattr(a, name).numpy(), getattr(b, name).numpy())
+
+    a = PISM.Geometry(grid)
+    init(a)
+    a.ensure_consistency(0.0)
+
+    # modify ice thickness in a few cells (without updating ghosts) and the sea level in a
+    # part of the domain
+    with PISM.vec.Access([a.ice_thickness, a.sea_level_elevation]):
+        for i, j in grid.points():
+            if i == 5 and j < 3:
+                a.ice_thickness[i, j] = 50.0
+            if j > 7:
+                a.sea_level_elevation[i, j] = -200.0
+    a.sea_level_elevation.update_ghosts()
+    a.ensure_consistency(0.0)
+
+    b = PISM.Geometry(grid)
+    init(b)
+    with PISM.vec.Access([b.ice_thickness, b.sea_level_elevation]):
+        for i, j in grid.points():
+            if i == 5 and j < 3:
+                b.ice_thickness[i, j] = 50.0
+            if j > 7:
+                b.sea_level_elevation[i, j] = -200.0
+    b.sea_level_elevation.update_ghosts()
+    b.ensure_consistency(0.0)
+
+    compare(a, b)
+
+    # a different threshold triggers re-computation everywhere
+    a.ensure_consistency(100.0)
+    b.ensure_consistency(100.0)
+    compare(a, b)
+
+    # ghosts of ice thickness are up to date
+    with PISM.vec.Access(a.ice_thickness):
+        for i, j in grid.points():
+            if i == 4 and j < 3:
+                np.testing.assert_equal(a.ice_thickness[i + 1, j], 50.0)
+
+def skip_redundant_ghost_exchanges_test():
+    "Skipping ghost exchanges when ghosts are up to date"
+    ctx = PISM.Context()
+    ctx.config.set_flag("grid.ghost_exchanges.skip", True)
+    ctx.config.set_flag("grid.ghost_exchanges.check", True)
+    try:
+        grid = PISM.testing.shallow_grid(Mx=5, My=5)
+
+        v = PISM.Scalar1(grid, "v")
+
+        def counts():
+            c = PISM.ghost_exchange_counts()
+            return c.performed, c.skipped
+
+        # set() updates ghosts, so this exchange is redundant
+        v.set(1.0)
+        performed, skipped = counts()
+        v.update_ghosts()
+        assert counts() == (performed, skipped + 1)
+
+        # write access invalidates ghosts
+        with PISM.vec.Access(nocomm=v):
+            v[0, 0] = 2.0
+        v.update_ghosts()
+        assert counts() == (performed + 1, skipped + 1)
+
+        v.update_ghosts()
+        assert counts() == (performed + 1, skipped + 2)
+
+        # the decision is collective: if only one process modifies the field, all of them
+        # take part in the exchange (run with mpiexec to test this)
+        if ctx.rank == 0:
+            with PISM.vec.Access(nocomm=v):
+                v[grid.xs(), grid.ys()] = 3.0
+        v.update_ghosts()
+        assert counts() == (performed + 2, skipped + 2)
+    finally:
+        ctx.config.set_flag("grid.ghost_exchanges.skip", False)
+        ctx.config.set_flag("grid.ghost_exchanges.check", False)
+
+def sparse_3d_output_test():
+    "Test writing and reading 3D fields using the sparse encoding."
+    ctx = PISM.Context()
+    params = PISM.GridParameters(ctx.config)
+    params.Lx = 1e5
+    params.Ly = 1e5
+    params.Mx = 11
+    params.My = 13
+    params.Mz = 11
+    params.Lz = 1000
+    params.registration = PISM.CELL_CORNER
+    params.periodicity = PISM.NOT_PERIODIC
+    params.ownership_ranges_from_options(ctx.size)
+
+    z = np.linspace(0, params.Lz, params.Mz)
+    params.z[:] = z
+
+    grid = PISM.Grid(ctx.ctx, params)
+
+    # columns with i = 0 are ice-free, the rest contain i + 1 levels in the ice
+    thk = PISM.model.createIceThicknessVec(grid)
+    with PISM.vec.Access(nocomm=[thk]):
+        for (i, j) in grid.points():
+            thk[i, j] = 100.0 * i
+    grid.variables().add(thk)
+
+    def F(i, j):
+        column = grid.x(i) + 2.0 * grid.y(j) + z
+        # values above the top of a stored column are replaced by the value at the top
+        column[i + 1:] = column[i]
+        return column
+
+    v = PISM.Array3D(grid, "test", PISM.WITHOUT_GHOSTS, grid.z())
+    with PISM.vec.Access(nocomm=[v]):
+        for (i, j) in grid.points():
+            v.set_column(i, j, F(i, j))
+
+    file_name = filename("sparse")
+    try:
+        f = PISM.util.prepare_output(file_name)
+        f.set_sparse_3d(True)
+        v.write(f)
+        f.close()
+
+        f = PISM.File(grid.com, file_name, PISM.PISM_NETCDF3, PISM.PISM_READONLY)
+        assert f.dimension_length("ice_column") == params.Mx * params.My
+        assert f.dimension_length("ice_column_sample") == params.My * sum(range(1, params.Mx + 1))
+        f.close()
+
+        # reading restores the dense layout
+        w = PISM.Array3D(grid, "test", PISM.WITHOUT_GHOSTS, grid.z())
+        w.read(file_name, 0)
+
+        # regridding onto the same grid reproduces the field
+        u = PISM.Array3D(grid, "test", PISM.WITHOUT_GHOSTS, grid.z())
+        u.regrid(file_name, PISM.Default.Nil())
+
+        with PISM.vec.Access(nocomm=[w, u]):
+            for (i, j) in grid.points():
+                np.testing.assert_almost_equal(w.get_column(i, j), F(i, j))
+                np.testing.assert_almost_equal(u.get_column(i, j), F(i, j))
+
+        # read using a different domain decomposition (processes split the grid in the y
+        # direction only)
+        size = ctx.size
+        params.procs_x = PISM.UnsignedIntVector([params.Mx])
+        params.procs_y = PISM.UnsignedIntVector([params.My * (r + 1) // size - params.My * r // size
+                                                 for r in range(size)])
+        rows = PISM.Grid(ctx.ctx, params)
+
+        r = PISM.Array3D(rows, "test", PISM.WITHOUT_GHOSTS, rows.z())
+        r.read(file_name, 0)
+
+        with PISM.vec.Access(nocomm=[r]):
+            for (i, j) in rows.points():
+                np.testing.assert_almost_equal(r.get_column(i, j), F(i, j))
+
+        # writing to the same file fails if the number of levels in some columns changed,
+        # even if the total number of stored levels is the same
+        with PISM.vec.Access(nocomm=[thk]):
+            for (i, j) in grid.points():
+                if j == 0 and i in [1, 2]:
+                    thk[i, j] = 100.0 * (3 - i)
+
+        f = PISM.File(grid.com, file_name, PISM.PISM_NETCDF3, PISM.PISM_READWRITE)
+        f.set_sparse_3d(True)
+        try:
+            PISM.Array3D(grid, "other", PISM.WITHOUT_GHOSTS, grid.z()).write(f)
+            assert False, "failed to detect a changed sparse layout"
+        except RuntimeError:
+            pass
+        f.close()
+    finally:
+        os.remove(file_name)
+
+def solver_tuner_test():
+    "Selecting, saving and re-using PETSc solver configurations"
+    import json
+
+    ctx = PISM.Context()
+    config = ctx.config
+
+    grid = PISM.testing.shallow_grid(Mx=21, My=21)
+
+    # solve in the interior, Dirichlet BC at the boundary
+    mask = PISM.Scalar(grid, "mask")
+    bc = PISM.Scalar(grid, "bc")
+    bc.set(0.0)
+    with PISM.vec.Access(mask):
+        for (i, j) in grid.points():
+            boundary = i in [0, grid.Mx() - 1] or j in [0, grid.My() - 1]
+            mask[i, j] = 0.0 if boundary else 1.0
+
+    def solve():
+        # solve twice to complete a tuning round (see solver_tuning.evaluation_solves)
+        poisson = PISM.Poisson(grid)
+        poisson.solve(mask, bc, 1.0)
+        poisson.solve(mask, bc, 1.0)
+        result = PISM.Scalar(grid, "result")
+        result.copy_from(poisson.solution())
+        return result
+
+    def check(result, reference):
+        result.add(-1.0, reference)
+        max_error = result.norm(PISM.PETSc.NormType.NORM_INFINITY)[0]
+        assert max_error < 1e-8 * reference.norm(PISM.PETSc.NormType.NORM_INFINITY)[0]
+
+    opt = PISM.PETSc.Options()
+    opt.setValue("-poisson_ksp_rtol", "1e-12")
+
+    output_file = filename("solver_tuning_") + ".json"
+    input_file = filename("solver_tuning_input_") + ".json"
+    try:
+        config.set_number("solver_tuning.evaluation_solves", 2)
+
+        reference = solve()
+
+        # tune and save results
+        config.set_flag("solver_tuning.enabled", True)
+        config.set_string("solver_tuning.output_file", output_file)
+
+        check(solve(), reference)
+
+        with open(output_file) as f:
+            results = json.load(f)["Poisson"]
+
+        names = [c["name"] for c in results["candidates"]]
+        assert names == ["bjacobi_ilu0", "asm1_ilu0", "gamg"]
+        for c in results["candidates"]:
+            assert c["failures"] == 0
+            assert c["mean_iterations"] > 0
+        assert results["selected"] in names
+
+        selected = [c for c in results["candidates"] if c["name"] == results["selected"]][0]
+        assert results["options"] == selected["options"]
+        assert results["options"].startswith("-poisson_ksp_type gmres -poisson_pc_type")
+
+        # re-use the saved configuration
+        config.set_flag("solver_tuning.enabled", False)
+        config.set_string("solver_tuning.output_file", "")
+        config.set_string("solver_tuning.input_file", output_file)
+
+        check(solve(), reference)
+        pc_type = opt.getString("-poisson_pc_type")
+        assert "-poisson_pc_type " + pc_type in results["options"]
+
+        # a hand-written configuration: a flag without a value, an option with a value
+        with open(input_file, "w") as f:
+            json.dump({"Poisson": {"options": "-poisson_ksp_type cg -poisson_ksp_norm_type"
+                                   " unpreconditioned -poisson_pc_type jacobi"}}, f)
+        config.set_string("solver_tuning.input_file", input_file)
+
+        check(solve(), reference)
+        assert opt.getString("-poisson_ksp_type") == "cg"
+        assert opt.getString("-poisson_pc_type") == "jacobi"
+
+        # options that do not use the prefix of the solver are rejected
+        with open(input_file, "w") as f:
+            json.dump({"Poisson": {"options": "-ksp_type cg"}}, f)
+        try:
+            PISM.Poisson(grid)
+            assert False, "failed to reject an option without the prefix"
+        except RuntimeError:
+            pass
+    finally:
+        for name in ["ksp_rtol", "ksp_type", "ksp_norm_type", "pc_type", "sub_pc_type",
+                     "pc_asm_overlap"]:
+            opt.delValue("-poisson_" + name)
+        config.set_flag("solver_tuning.enabled", False)
+        config.set_string("solver_tuning.output_file", "")
+        config.set_string("solver_tuning.input_file", "")
+        config.set_number("solver_tuning.evaluation_solves", 2)
+        for f in [output_file, input_file]:
+            if os.path.exists(f):
+                os.remove(f)
+
+def adaptive_skipping_test():
+    "Adaptive skipping: the number of skipped steps follows the rates of change"
+    skip_max = 10
+    max_enthalpy_change = 2000.0  # J/kg
+    max_thickness_change = 10.0   # m
+    dt = 1.0
+
+    def skipped_steps(enthalpy_change_rate, dt_cfl=PISM.MaxTimestep(), thickness_change_rate=0.0):
+        """Emulate IceModel::step() and IceModel::adapt_skip_countdown() and return the number
+        of steps between two energy and age updates."""
+        countdown = skip_max
+        dt_energy_age = 0.0
+        steps = 0
+        while True:
+            countdown -= 1
+            dt_energy_age += dt
+            steps += 1
+
+            if countdown == 0:
+                return steps
+
+            if PISM.energy_age_update_due(dt_energy_age, dt, dt_cfl,
+                                          enthalpy_change_rate, max_enthalpy_change,
+                                          thickness_change_rate * dt_energy_age,
+                                          max_thickness_change):
+                return steps
+
+    # the number of skipped steps shrinks as the rate of change of enthalpy grows and grows
+    # back as it decreases
+    rates = [10.0, 400.0, 1000.0, 400.0, 10.0]
+    steps = [skipped_steps(r) for r in rates]
+    assert steps == [skip_max, 5, 2, 5, skip_max], steps
+
+    # the same for thickness changes
+    rates = [0.1, 2.0, 5.0, 2.0, 0.1]
+    steps = [skipped_steps(0.0, thickness_change_rate=r) for r in rates]
+    assert steps == [skip_max, 6, 3, 6, skip_max], steps
+
+    # the 3D CFL condition limits the accumulated energy and age time step
+    assert skipped_steps(0.0, dt_cfl=PISM.MaxTimestep(6.0)) == 5
+    assert skipped_steps(0.0, dt_cfl=PISM.MaxTimestep(100.0)) == skip_max
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# Checks that the output file of a run using a cropped computational domain can be used
+# to re-start: it has to contain values everywhere in the full domain (no ice and the bed
+# elevation from the bootstrapping file outside of the cropped domain).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+set -e
+
+grid="-Mx 31 -My 31 -Mz 11 -Lz 4000"
+
+# Create a file to bootstrap from:
+$MPIEXEC -n 1 $PISM_PATH/pismv -test G $grid -y 0 -o input.nc
+
+# The dome of test G covers most of the domain: use a high threshold to crop it.
+$MPIEXEC -n 2 $PISM_PATH/pismr -i input.nc -bootstrap $grid -y 2 -o cropped.nc \
+         -crop_domain -crop_domain_threshold 0.95 -crop_domain_interval 1 \
+         | tee cropped.log
+
+grep -q "Domain cropping: switching to the full" cropped.log
+
+# Re-start from the output of the cropped run:
+$MPIEXEC -n 2 $PISM_PATH/pismr -i cropped.nc -y 1 -o restart.nc
+
+set +e
+
+# The bed elevation is not modified by the run:
+$PISM_PATH/nccmp.py -v topg input.nc cropped.nc || exit 1
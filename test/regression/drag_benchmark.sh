@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Checks that the row-batched evaluation of the pseudo-plastic sliding law matches the
+# point-wise one (drag_benchmark exits with a non-zero status if they differ).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+$PISM_PATH/drag_benchmark -Mx 101 -repeat 10
@@ -350,6 +350,36 @@ class File(TestCase):
             except RuntimeError:
                 pass
 
+    def test_metadata_cache(self):
+        "File: cached metadata is updated by define calls"
+        for backend in backends:
+            f = PISM.File(ctx.com(), self.file_with_time, backend, PISM.PISM_READWRITE,
+                          ctx.pio_iosys_id())
+            name = "cached_{}".format(backend)
+
+            # populate the cache
+            assert not f.find_variable(name)
+            assert not f.find_variable(name, "cached_standard_name").exists
+            assert f.find_variable("v", "standard_name").name == "v"
+
+            f.define_variable(name, PISM.PISM_DOUBLE, ["y", "x"])
+            assert f.find_variable(name)
+            assert f.dimensions(name) == ("y", "x")
+
+            f.write_attribute(name, "standard_name", "cached_standard_name")
+            assert f.find_variable("missing", "cached_standard_name").name == name
+
+            f.remove_attribute(name, "standard_name")
+            assert not f.find_variable("missing", "cached_standard_name").exists
+            f.close()
+
+            # a re-opened file should see the same metadata
+            f = PISM.File(ctx.com(), self.file_with_time, backend, PISM.PISM_READONLY,
+                          ctx.pio_iosys_id())
+            assert f.find_variable(name)
+            assert f.attribute_type(name, "standard_name") == PISM.PISM_NAT
+            f.close()
+
     def test_read_variable(self):
         "File.read_variable()"
         for backend in backends:
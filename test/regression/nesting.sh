@@ -0,0 +1,89 @@
+#!/bin/bash
+
+# Runs a regional model nested in a parent model using two groups of processes and checks
+# that ice thickness and enthalpy in the "no model" strip of the regional model match the
+# parent model at the last coupling time. The regional grid is a subset of the parent grid,
+# so interpolation does not change boundary values.
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+set -e
+
+# Create the input file:
+$MPIEXEC -n 1 $PISM_PATH/pismr -eisII A -Mx 16 -My 16 -Mz 21 -Lz 5000 -Mbz 1 -y 1000 -o input.nc
+
+# Use time steps that are shorter than the SIA time step restriction so that both runs
+# below take the same time steps.
+options="-bootstrap -i input.nc -grid.registration corner -Mz 21 -Lz 5000 -Mbz 1 -max_dt 0.25"
+
+parent_grid="-Mx 16 -My 16 -x_range -750e3,750e3 -y_range -750e3,750e3"
+
+# The reference run of the parent model. It stops at the last coupling time of the nested
+# run below.
+$MPIEXEC -n 2 $PISM_PATH/pismr $options $parent_grid -y 1 -o parent_1.nc
+
+# The nested run: 2 processes run the parent model, 1 process runs the regional model. The
+# only coupling time (not counting the start and the end of the run) is 1 year after the
+# start.
+echo "$parent_grid -o parent.nc" > parent_options.txt
+
+$MPIEXEC -n 3 $PISM_PATH/pismr -nesting_parent_size 2 \
+         -nesting_parent_options parent_options.txt \
+         -regional -x_range -350e3,350e3 -y_range -350e3,350e3 \
+         -no_model_strip 200 -nesting_dt 1 \
+         $options -y 2 -o regional.nc
+
+set +e
+
+# Check results:
+/usr/bin/env python3 <<END
+import numpy as np
+from netCDF4 import Dataset as NC
+from sys import exit
+
+# (x, y) coordinates of the regional grid
+with NC("regional.nc") as f:
+    x_regional = f.variables["x"][:]
+    y_regional = f.variables["y"][:]
+
+def read(filename, name):
+    "Read the last record of a variable in the regional domain, as (y, x, ...)."
+    with NC(filename) as f:
+        f.set_auto_mask(False)
+        v = f.variables[name]
+        dims = [d for d in ["time", "y", "x", "z"] if d in v.dimensions]
+        data = np.transpose(v[:], [v.dimensions.index(d) for d in dims])
+        if "time" in dims:
+            data = data[-1]
+        J = np.isin(np.around(f.variables["y"][:]), np.around(y_regional))
+        I = np.isin(np.around(f.variables["x"][:]), np.around(x_regional))
+        return data[J][:, I]
+
+strip = read("regional.nc", "no_model_mask") > 0.5
+
+if not strip.any():
+    print("the 'no model' strip is empty")
+    exit(1)
+
+# make sure that the regional model could not pass this test by keeping its initial state
+if np.max(np.abs(read("parent_1.nc", "thk")[strip] - read("input.nc", "thk")[strip])) < 1e-3:
+    print("ice thickness in the strip did not change: the test is not sensitive")
+    exit(1)
+
+for name, tolerance in [("thk", 1e-6), ("enthalpy", 1e-3)]:
+    parent = read("parent_1.nc", name)[strip]
+    regional = read("regional.nc", name)[strip]
+
+    error = np.max(np.abs(parent - regional))
+    print("%s: max. difference in the 'no model' strip: %e" % (name, error))
+    if error > tolerance:
+        exit(1)
+exit(0)
+END
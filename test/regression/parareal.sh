@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# Compares results of a thermal spin-up using two parareal time slices (two groups of
+# processes) to the sequential run using one slice. After as many iterations as there are
+# time slices parareal has to reproduce the sequential result.
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+set -e
+
+# Create the input file containing the geometry and the ice velocity:
+$MPIEXEC -n 1 $PISM_PATH/pismr -eisII A -Mx 16 -My 16 -Mz 21 -Mbz 1 -age -y 1000 \
+         -o_size big -output.sizes.big strainheat,uvel,vvel,wvel_rel -o input.nc
+
+# Use time steps that are shorter than the CFL time step and divide the length of each
+# slice so that all runs take the same time steps. Zero tolerances make parareal perform
+# exactly as many iterations as there are slices.
+options="-i input.nc -age -y 100 -max_dt 1 -energy.parareal.max_iterations 0 \
+         -energy.parareal.enthalpy_tolerance 0 -energy.parareal.age_tolerance 0"
+
+$MPIEXEC -n 1 $PISM_PATH/pism_parareal $options -parareal_slices 1 -o sequential.nc
+
+$MPIEXEC -n 2 $PISM_PATH/pism_parareal $options -parareal_slices 2 -o parareal.nc
+
+set +e
+
+# Check results:
+$PISM_PATH/nccmp.py -t 1e-6 -v enthalpy,age sequential.nc parareal.nc
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Checks that the serial NetCDF I/O backend reads and writes variables that have the same
+# hyperslab on all ranks (time, time bounds, scalar time series) correctly: results of
+# runs using 1 and 3 processes have to match, including the run restarted from a file
+# written by 3 processes.
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+set -e
+
+options="-eisII A -Mx 15 -My 15 -Mz 11 -o_format netcdf3 -max_dt 10"
+outputs="-ts_times 10 -extra_times 50 -extra_vars thk,velbar_mag"
+
+for n in 1 3;
+do
+  $MPIEXEC -n $n $PISM_PATH/pismr $options -y 100 \
+           $outputs -ts_file ts-$n.nc -extra_file ex-$n.nc -o o-$n.nc
+
+  # restarting reads time and time bounds on all ranks
+  $MPIEXEC -n $n $PISM_PATH/pismr -i o-$n.nc -o_format netcdf3 -max_dt 10 -y 100 \
+           -ts_times 10 -ts_file ts-restart-$n.nc -o restart-$n.nc
+done
+
+set +e
+
+for f in ts ex o ts-restart restart;
+do
+  $PISM_PATH/nccmp.py -t 1e-6 -x -v timestamp,run_stats $f-1.nc $f-3.nc || exit 1
+done